@@ -0,0 +1,242 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "affinity.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define AFFINITY_MAX_CPUS 4096
+
+/* we parse a kernel style cpu list (0-3,8,10-11) into out, returning the number of cpus */
+static int parse_cpu_list(const char *s, int *out, int max)
+{
+    int n = 0;
+    while (*s && *s != '\n')
+    {
+        char *end;
+        long lo = strtol(s, &end, 10);
+        if (end == s || lo < 0) return -1;
+        long hi = lo;
+        s = end;
+        if (*s == '-')
+        {
+            hi = strtol(s + 1, &end, 10);
+            if (end == s + 1 || hi < lo) return -1;
+            s = end;
+        }
+        for (long c = lo; c <= hi; c++)
+        {
+            if (n >= max || c >= AFFINITY_MAX_CPUS) return -1;
+            out[n++] = (int)c;
+        }
+        if (*s == ',') s++;
+        else if (*s && *s != '\n') return -1;
+    }
+    return n;
+}
+
+int affinity_parse(const char *spec, cpu_affinity_t *mode)
+{
+    if (strcmp(spec, "none") == 0)
+    {
+        *mode = AFFINITY_NONE;
+        return 0;
+    }
+    if (strcmp(spec, "compact") == 0)
+    {
+        *mode = AFFINITY_COMPACT;
+        return 0;
+    }
+    if (strcmp(spec, "scatter") == 0)
+    {
+        *mode = AFFINITY_SCATTER;
+        return 0;
+    }
+
+    int cpus[AFFINITY_MAX_CPUS];
+    if (!isdigit((unsigned char)spec[0]) || parse_cpu_list(spec, cpus, AFFINITY_MAX_CPUS) <= 0)
+    {
+        return -1;
+    }
+    *mode = AFFINITY_LIST;
+    return 0;
+}
+
+const char *affinity_to_string(cpu_affinity_t mode)
+{
+    switch (mode)
+    {
+        case AFFINITY_COMPACT:
+            return "compact";
+        case AFFINITY_SCATTER:
+            return "scatter";
+        case AFFINITY_LIST:
+            return "list";
+        default:
+            return "none";
+    }
+}
+
+/* we map every cpu to its NUMA node from /sys/devices/system/node/node<N>/cpulist, cpus of a
+ * host without that directory all land on node 0 */
+static int load_cpu_nodes(int *node_of)
+{
+    int num_nodes = 1;
+    for (int c = 0; c < AFFINITY_MAX_CPUS; c++) node_of[c] = 0;
+
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (!dir) return num_nodes;
+
+    int *cpus = malloc(AFFINITY_MAX_CPUS * sizeof(int));
+    struct dirent *entry;
+    while (cpus && (entry = readdir(dir)) != NULL)
+    {
+        if (strncmp(entry->d_name, "node", 4) != 0 || !isdigit((unsigned char)entry->d_name[4]))
+        {
+            continue;
+        }
+        int node = atoi(entry->d_name + 4);
+
+        char path[512];
+        char line[8192];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", entry->d_name);
+        FILE *fp = fopen(path, "r");
+        if (!fp) continue;
+        int n = fgets(line, sizeof(line), fp) ? parse_cpu_list(line, cpus, AFFINITY_MAX_CPUS) : 0;
+        fclose(fp);
+
+        for (int i = 0; i < n; i++) node_of[cpus[i]] = node;
+        if (n > 0 && node + 1 > num_nodes) num_nodes = node + 1;
+    }
+    free(cpus);
+    closedir(dir);
+    return num_nodes;
+}
+
+int affinity_plan_init(affinity_plan_t *plan, const benchmark_config_t *config)
+{
+    memset(plan, 0, sizeof(*plan));
+    if (config->cpu_affinity == AFFINITY_NONE) return 0;
+
+#ifdef __linux__
+    int *node_of = malloc(AFFINITY_MAX_CPUS * sizeof(int));
+    plan->cpus = malloc(AFFINITY_MAX_CPUS * sizeof(int));
+    plan->nodes = malloc(AFFINITY_MAX_CPUS * sizeof(int));
+    if (!node_of || !plan->cpus || !plan->nodes)
+    {
+        free(node_of);
+        affinity_plan_free(plan);
+        return -1;
+    }
+    plan->num_nodes = load_cpu_nodes(node_of);
+
+    if (config->cpu_affinity == AFFINITY_LIST)
+    {
+        plan->count = parse_cpu_list(config->cpu_list, plan->cpus, AFFINITY_MAX_CPUS);
+        if (plan->count < 0) plan->count = 0;
+    }
+    else
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        {
+            free(node_of);
+            affinity_plan_free(plan);
+            return -1;
+        }
+
+        /* compact walks nodes in order, scatter takes the next cpu of each node in turn */
+        int taken[AFFINITY_MAX_CPUS] = {0};
+        int remaining = CPU_COUNT(&allowed);
+        while (remaining > 0)
+        {
+            int progress = 0;
+            for (int node = 0; node < plan->num_nodes && remaining > 0; node++)
+            {
+                for (int c = 0; c < CPU_SETSIZE && c < AFFINITY_MAX_CPUS; c++)
+                {
+                    if (taken[c] || node_of[c] != node || !CPU_ISSET(c, &allowed)) continue;
+                    plan->cpus[plan->count++] = c;
+                    taken[c] = 1;
+                    remaining--;
+                    progress = 1;
+                    if (config->cpu_affinity == AFFINITY_SCATTER) break;
+                }
+            }
+            if (!progress) break;
+        }
+    }
+
+    for (int i = 0; i < plan->count; i++) plan->nodes[i] = node_of[plan->cpus[i]];
+    free(node_of);
+    return 0;
+#else
+    fprintf(stderr, "Warning: --cpu-affinity is not supported on this platform, ignoring\n");
+    return 0;
+#endif
+}
+
+void affinity_plan_free(affinity_plan_t *plan)
+{
+    free(plan->cpus);
+    free(plan->nodes);
+    plan->cpus = NULL;
+    plan->nodes = NULL;
+    plan->count = 0;
+}
+
+int affinity_set_attr(const affinity_plan_t *plan, int thread_id, pthread_attr_t *attr)
+{
+    if (plan->count == 0) return -1;
+    int cpu = plan->cpus[thread_id % plan->count];
+
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) return -1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_attr_setaffinity_np(attr, sizeof(set), &set) != 0) return -1;
+    return cpu;
+#else
+    (void)attr;
+    return -1;
+#endif
+}
+
+void *affinity_alloc_local(size_t size)
+{
+    /* fresh anonymous pages, zero-filled on the first write by whichever cpu makes it */
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+void affinity_free_local(void *p, size_t size)
+{
+    if (p) munmap(p, size);
+}
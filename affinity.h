@@ -0,0 +1,97 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AFFINITY_H__
+#define __AFFINITY_H__
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "benchmark.h"
+
+/*
+ * worker thread placement. a plan is the ordered list of cpus the workers of a phase are pinned
+ * to, thread i runs on cpus[i % count]. compact fills one NUMA node before moving to the next,
+ * scatter deals threads round-robin across nodes, list takes the cpus in the order given. only
+ * cpus in the process affinity mask are used for compact and scatter, so taskset and cgroup
+ * cpusets are respected.
+ */
+typedef struct
+{
+    int *cpus;  /* cpu of each slot, in placement order */
+    int *nodes; /* NUMA node of each slot */
+    int count;
+    int num_nodes;
+} affinity_plan_t;
+
+/**
+ * affinity_parse
+ * parses a --cpu-affinity argument
+ * @param spec "none", "compact", "scatter" or a cpu list such as 0-7,16-23
+ * @param mode output placement mode, AFFINITY_LIST for a cpu list
+ * @return 0 on success, -1 on a malformed spec
+ */
+int affinity_parse(const char *spec, cpu_affinity_t *mode);
+
+/**
+ * affinity_to_string
+ * @param mode placement mode
+ * @return display name of the mode
+ */
+const char *affinity_to_string(cpu_affinity_t mode);
+
+/**
+ * affinity_plan_init
+ * builds the placement plan for config->cpu_affinity from the host topology
+ * @param plan plan to fill, count is 0 when pinning is off or unsupported on this platform
+ * @param config benchmark configuration
+ * @return 0 on success, -1 on failure
+ */
+int affinity_plan_init(affinity_plan_t *plan, const benchmark_config_t *config);
+
+/**
+ * affinity_plan_free
+ * @param plan plan built with affinity_plan_init
+ */
+void affinity_plan_free(affinity_plan_t *plan);
+
+/**
+ * affinity_set_attr
+ * pins the thread created with attr to the plan's cpu for thread_id
+ * @param plan placement plan
+ * @param thread_id worker index
+ * @param attr initialized thread attributes
+ * @return the cpu, or -1 when the plan is empty or the cpu could not be set
+ */
+int affinity_set_attr(const affinity_plan_t *plan, int thread_id, pthread_attr_t *attr);
+
+/**
+ * affinity_alloc_local
+ * allocates zeroed, page-aligned memory whose pages are not touched until first written. memory
+ * first written by a pinned worker is therefore placed on that worker's NUMA node by the
+ * kernel's first-touch policy, and no two allocations share a cache line
+ * @param size bytes to allocate
+ * @return the memory, or NULL on failure
+ */
+void *affinity_alloc_local(size_t size);
+
+/**
+ * affinity_free_local
+ * @param p memory from affinity_alloc_local
+ * @param size size passed to affinity_alloc_local
+ */
+void affinity_free_local(void *p, size_t size);
+
+#endif /* __AFFINITY_H__ */
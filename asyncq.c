@@ -0,0 +1,242 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "asyncq.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct asyncq_t
+{
+    storage_engine_t *engine;
+    asyncq_op_t op;
+    int depth;
+    size_t key_size;
+    void *native; /* engine queue, NULL when the helper threads serve the requests */
+
+    /* helper thread pool */
+    pthread_mutex_t lock;
+    pthread_cond_t work; /* a request was submitted, or the queue is closing */
+    pthread_cond_t done; /* a request completed */
+    uint8_t *keys;       /* depth slots of key_size bytes */
+    const uint8_t **values; /* per slot value of a put, owned by the caller until reaped */
+    size_t *value_sizes;
+    int *pending;        /* ring of submitted slots, helpers take from the head */
+    int pending_head;
+    int pending_count;
+    engine_completion_t *completed; /* completions the worker has not reaped yet */
+    int completed_count;
+    int outstanding; /* submitted and not reaped */
+    pthread_t *helpers;
+    int num_helpers;
+    int stop;
+};
+
+static int asyncq_has_native(const storage_engine_ops_t *ops, asyncq_op_t op)
+{
+    return op == ASYNCQ_GET && ops->queue_open && ops->queue_get && ops->queue_reap &&
+           ops->queue_close;
+}
+
+const char *asyncq_mode(const storage_engine_ops_t *ops, asyncq_op_t op)
+{
+    return asyncq_has_native(ops, op) ? "engine async" : "helper threads";
+}
+
+/* we run one request synchronously, the helper thread is its only caller */
+static int asyncq_run(asyncq_t *q, int slot)
+{
+    storage_engine_t *engine = q->engine;
+    const uint8_t *key = q->keys + (size_t)slot * q->key_size;
+
+    if (q->op == ASYNCQ_PUT)
+    {
+        return engine->ops->put(engine, key, q->key_size, q->values[slot], q->value_sizes[slot]);
+    }
+
+    uint8_t *value = NULL;
+    size_t value_size = 0;
+    int rc = engine->ops->get(engine, key, q->key_size, &value, &value_size);
+    free(value);
+    return rc;
+}
+
+static void *asyncq_helper(void *arg)
+{
+    asyncq_t *q = (asyncq_t *)arg;
+
+    pthread_mutex_lock(&q->lock);
+    for (;;)
+    {
+        while (q->pending_count == 0 && !q->stop) pthread_cond_wait(&q->work, &q->lock);
+        if (q->pending_count == 0) break;
+
+        int slot = q->pending[q->pending_head];
+        q->pending_head = (q->pending_head + 1) % q->depth;
+        q->pending_count--;
+        pthread_mutex_unlock(&q->lock);
+
+        int rc = asyncq_run(q, slot);
+
+        pthread_mutex_lock(&q->lock);
+        q->completed[q->completed_count].tag = (uint64_t)slot;
+        q->completed[q->completed_count].status = rc;
+        q->completed_count++;
+        pthread_cond_signal(&q->done);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return NULL;
+}
+
+int asyncq_open(asyncq_t **q, storage_engine_t *engine, asyncq_op_t op,
+                const benchmark_config_t *config)
+{
+    asyncq_t *nq = calloc(1, sizeof(asyncq_t));
+    if (!nq) return -1;
+
+    nq->engine = engine;
+    nq->op = op;
+    nq->depth = config->queue_depth > 1 ? config->queue_depth : 1;
+    nq->key_size = (size_t)config->key_size;
+
+    if (asyncq_has_native(engine->ops, op))
+    {
+        if (engine->ops->queue_open(engine, nq->depth, &nq->native) != 0)
+        {
+            free(nq);
+            return -1;
+        }
+        *q = nq;
+        return 0;
+    }
+
+    size_t depth = (size_t)nq->depth;
+    nq->keys = malloc(depth * nq->key_size);
+    nq->values = op == ASYNCQ_PUT ? malloc(depth * sizeof(*nq->values)) : NULL;
+    nq->value_sizes = op == ASYNCQ_PUT ? malloc(depth * sizeof(size_t)) : NULL;
+    nq->pending = malloc(depth * sizeof(int));
+    nq->completed = malloc(depth * sizeof(engine_completion_t));
+    nq->helpers = malloc(depth * sizeof(pthread_t));
+    if (!nq->keys || (op == ASYNCQ_PUT && (!nq->values || !nq->value_sizes)) || !nq->pending ||
+        !nq->completed || !nq->helpers)
+    {
+        asyncq_close(nq);
+        return -1;
+    }
+
+    pthread_mutex_init(&nq->lock, NULL);
+    pthread_cond_init(&nq->work, NULL);
+    pthread_cond_init(&nq->done, NULL);
+
+    /* one helper per slot, every outstanding request has a thread blocked in the engine */
+    for (; nq->num_helpers < nq->depth; nq->num_helpers++)
+    {
+        if (pthread_create(&nq->helpers[nq->num_helpers], NULL, asyncq_helper, nq) != 0) break;
+    }
+    if (nq->num_helpers == 0)
+    {
+        asyncq_close(nq);
+        return -1;
+    }
+
+    *q = nq;
+    return 0;
+}
+
+int asyncq_submit(asyncq_t *q, int slot, const uint8_t *key, const uint8_t *value,
+                  size_t value_size)
+{
+    if (slot < 0 || slot >= q->depth) return -1;
+
+    if (q->native)
+    {
+        if (q->engine->ops->queue_get(q->native, key, q->key_size, (uint64_t)slot) != 0) return -1;
+        q->outstanding++;
+        return 0;
+    }
+
+    memcpy(q->keys + (size_t)slot * q->key_size, key, q->key_size);
+    if (q->op == ASYNCQ_PUT)
+    {
+        q->values[slot] = value;
+        q->value_sizes[slot] = value_size;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    q->pending[(q->pending_head + q->pending_count) % q->depth] = slot;
+    q->pending_count++;
+    q->outstanding++;
+    pthread_cond_signal(&q->work);
+    pthread_mutex_unlock(&q->lock);
+    return 0;
+}
+
+int asyncq_reap(asyncq_t *q, engine_completion_t *done, int max)
+{
+    if (q->outstanding == 0 || max <= 0) return 0;
+
+    if (q->native)
+    {
+        int n = q->engine->ops->queue_reap(q->native, done, max);
+        if (n > 0) q->outstanding -= n;
+        return n;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    while (q->completed_count == 0) pthread_cond_wait(&q->done, &q->lock);
+
+    int n = q->completed_count < max ? q->completed_count : max;
+    memcpy(done, q->completed, (size_t)n * sizeof(engine_completion_t));
+    q->completed_count -= n;
+    memmove(q->completed, q->completed + n, (size_t)q->completed_count * sizeof(*q->completed));
+    q->outstanding -= n;
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+void asyncq_close(asyncq_t *q)
+{
+    if (!q) return;
+
+    if (q->native)
+    {
+        q->engine->ops->queue_close(q->native);
+        free(q);
+        return;
+    }
+
+    if (q->num_helpers > 0)
+    {
+        pthread_mutex_lock(&q->lock);
+        q->stop = 1;
+        pthread_cond_broadcast(&q->work);
+        pthread_mutex_unlock(&q->lock);
+
+        for (int i = 0; i < q->num_helpers; i++) pthread_join(q->helpers[i], NULL);
+
+        pthread_cond_destroy(&q->done);
+        pthread_cond_destroy(&q->work);
+        pthread_mutex_destroy(&q->lock);
+    }
+
+    free(q->helpers);
+    free(q->completed);
+    free(q->pending);
+    free(q->values);
+    free(q->value_sizes);
+    free(q->keys);
+    free(q);
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __ASYNCQ_H__
+#define __ASYNCQ_H__
+
+#include <stdint.h>
+
+#include "benchmark.h"
+
+/*
+ * per-worker request queue for --queue-depth. a worker keeps up to depth requests outstanding,
+ * submitting into free slots and reaping completions, so few threads can drive a deep device
+ * or object store queue. lookups go to the engine's own queue_* ops when it has them (RocksDB
+ * multi_get with async_io), everything else is served by depth helper threads of the queue
+ * calling the synchronous op. requests are tagged with their slot, 0..depth-1, and a slot is
+ * free again once its completion was reaped.
+ */
+
+typedef enum
+{
+    ASYNCQ_GET,
+    ASYNCQ_PUT
+} asyncq_op_t;
+
+typedef struct asyncq_t asyncq_t;
+
+/**
+ * asyncq_open
+ * creates the request queue of one worker
+ * @param q the new queue
+ * @param engine the engine requests run against
+ * @param op the request type of the queue
+ * @param config queue depth and key size
+ * @return 0 on success, -1 on failure
+ */
+int asyncq_open(asyncq_t **q, storage_engine_t *engine, asyncq_op_t op,
+                const benchmark_config_t *config);
+
+/**
+ * asyncq_submit
+ * submits a request into a free slot and returns without waiting for it. the key is copied, the
+ * value is not and must stay valid until the completion is reaped
+ * @param q the queue
+ * @param slot a free slot, it is busy until its completion is reaped
+ * @param key key_size bytes
+ * @param value the value of a put, NULL for a get
+ * @param value_size size of the value
+ * @return 0 on success, -1 when the request could not be queued
+ */
+int asyncq_submit(asyncq_t *q, int slot, const uint8_t *key, const uint8_t *value,
+                  size_t value_size);
+
+/**
+ * asyncq_reap
+ * waits until at least one submitted request has completed
+ * @param q the queue
+ * @param done receives up to max completions, tag is the slot
+ * @param max capacity of done
+ * @return the number of completions, 0 when nothing is outstanding
+ */
+int asyncq_reap(asyncq_t *q, engine_completion_t *done, int max);
+
+/**
+ * asyncq_close
+ * stops the helper threads and frees the queue, outstanding requests are finished first
+ * @param q the queue
+ */
+void asyncq_close(asyncq_t *q);
+
+/**
+ * asyncq_mode
+ * @param ops engine ops
+ * @param op the request type
+ * @return "engine async" when the engine queues the requests itself, else "helper threads"
+ */
+const char *asyncq_mode(const storage_engine_ops_t *ops, asyncq_op_t op);
+
+#endif /* __ASYNCQ_H__ */
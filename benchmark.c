@@ -20,15 +20,35 @@
 #include <inttypes.h>
 #include <math.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdlib.h>
+#include <signal.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
-#include <sys/time.h>
+#include <sys/wait.h>
 #include <tidesdb/tidesdb_version.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "affinity.h"
+#include "asyncq.h"
+#include "cfroute.h"
+#include "dataset.h"
+#include "histogram.h"
+#include "iostat.h"
+#include "keygen.h"
+#include "memlimit.h"
+#include "memstat.h"
+#include "profile.h"
+#include "reporter.h"
+#include "timing.h"
+#include "trace.h"
+#include "valuegen.h"
+
 #ifdef HAVE_ROCKSDB
 #include <rocksdb/c.h>
 extern const char* rocksdb_version_str;
@@ -41,6 +61,11 @@ extern const char* lmdb_version_str;
 
 const char* get_engine_version(const char* engine_name)
 {
+    const char* plugin_version = engine_plugin_version(engine_name);
+    if (plugin_version)
+    {
+        return plugin_version;
+    }
     if (strcmp(engine_name, "tidesdb") == 0)
     {
         return TIDESDB_VERSION;
@@ -111,187 +136,139 @@ static void append_debug_log(const char* db_path, const char* engine_name)
     fclose(dst);
 }
 
-/**
- *  calculates H(x) the continuous approximation of the discrete pmf.
- *  @param x candidate
- *
- *  @return calculated h(x)
- */
-double calc_continuous_approximation(double offset, double zipf_exponent, double x)
-{
-    double h_x = pow(offset + x, 1 - zipf_exponent) / (1 - zipf_exponent);
-    return h_x;
-}
+/* next_ops calls between two reads of the clock for the warmup end and the deadline */
+#define BENCHMARK_CLOCK_CHECK_CALLS 32
 
-/**
- *  maps the point  u ∈ [0,1] into the total integrated mass.
- *  @param hlow
- *  @u - randomly generated value u ∈ [0,1)
- *  @returns calculated area
- */
-double cumulative_area(double hlow, double tot_area, double u)
+/* open-loop arrival schedule of one worker. every worker starts from the same phase start and
+ * owns every num_threads-th arrival, so together they issue config->target_rate ops/sec on one
+ * global timeline no matter how long individual ops take */
+typedef struct
 {
-    assert(u >= 0);
+    double next_us;     /* intended start of the next arrival, 0 = closed loop */
+    double interval_us; /* mean gap between this worker's arrivals */
+    int poisson;
+    uint64_t rng;
+} pacer_t;
 
-    return hlow + (u * tot_area);
-}
+typedef struct
+{
+    benchmark_config_t* config;
+    storage_engine_t* engine;
+    int thread_id;
+    atomic_int_fast64_t* next_op; /* shared cursor into the phase's op index space */
+    int64_t chunk_ops;            /* ops claimed from next_op at a time */
+    int64_t chunk_next;           /* next op of the claimed chunk */
+    int64_t chunk_end;            /* end of the claimed chunk */
+    int64_t ops_done;             /* ops this worker claimed and ran */
+    double finish_us;             /* when the worker found the cursor exhausted */
+    double warmup_end_us;         /* --warmup, ops claimed before this are not measured */
+    double deadline_us;           /* --duration, the cursor wraps until this time, 0 = off */
+    int measuring;                /* past the warmup, ops are timed and counted */
+    int64_t ops_measured;         /* ops claimed while measuring */
+    int64_t clock_check_left;     /* next_ops calls until the clock is read again */
+    histogram_t* hist;                /* per-thread latency histogram (ns), merged after join */
+    histogram_t* op_hists;            /* mixed workload, one histogram per mix_op_t */
+    atomic_int_fast64_t* next_insert; /* mixed workload, shared cursor for fresh insert keys */
+    int64_t op_counts[MIX_OP_COUNT];
+    histogram_t* raw_hist; /* open-loop, latency from the actual issue time */
+    histogram_t* hit_hist;  /* object store GET phase, lookups that fetched nothing remotely */
+    histogram_t* miss_hist; /* object store GET phase, lookups that issued a remote fetch */
+    pacer_t pacer;
+    keygen_t keygen; /* per-thread key stream */
+    void* (*thread_fn)(void*);   /* phase body, run by profiled_worker under --perf-counters */
+    perf_counts_t perf;          /* --perf-counters, this worker's counts over the phase */
+    int64_t sample_every;        /* --latency-sample, 1 times every op */
+    int64_t sample_left;         /* ops until the next timed one */
+    int64_t chunk_lap;           /* --duration, passes over the op index space before the chunk */
+    double phase_start_us;       /* timed replay, the trace's time zero */
+    trace_cursor_t trace_cursor; /* replay, position in the mapped trace */
+    uint64_t bytes_written;      /* replay, logical bytes of the records run */
+    uint64_t bytes_read;
+    uint64_t items; /* scan phases, entries the iterator returned */
+    histogram_t* cf_hists; /* --column-families, one histogram per family */
+    uint64_t cf_ops[BENCHMARK_MAX_COLUMN_FAMILIES]; /* keys this worker routed to each family */
+} thread_context_t;
 
-/**
- * hinv - finds x by finding h inverse
- * @param zipf_eponent zipf exponent(s)
- * @param c_area cumulative area
- *
- * @return value of x retrieved from inversing H(x)
- */
-double hinv(double zipf_exponent, double c_area)
+static inline double get_time_microseconds(void)
 {
-    return floor(exp((log((1 - zipf_exponent) * c_area)) / (1 - zipf_exponent)));
+    return timing_now_us();
 }
 
-/**
- *  passes k through an acceptance test and returns 1 if value is
- * accepted else 0.
- *  @param hlow value of the cumulative intergal function at the lower bound.
- *  @param off offset
- *  @param c_area amount of probability mass the sample picks a random point from.
- *  @param k candidate
- *
- *  @return 1 if accepted, 0 if rejected.
- */
-int is_accepted(double hlow, double off, double zipf_exp, double c_area, double k)
+/* splitmix64, cheap per-thread generator so workers never contend on rand() state */
+static uint64_t mix_rand_next(uint64_t* state)
 {
-    double l = hlow - pow(off + k, (-zipf_exp));
-
-    if (c_area >= l)
-    {
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
 }
 
-/**
- * applies Hörmann-Derflinger rejection-inversion sampling to generate a value that
- * follows zipfian distribution
- *  @param zipf_exponent Constant used to alter howmuch skew to apply. FOr zipfian distributions
- * ~1.13. should be > 1
- *  @param off offset(v) is a non-negative constant that shifts keyspace while preserving zipfian
- * shape.
- *  @param imax upper bound of the distribution. Values generated will be 1...imax. Should be > 0.
- *
- * @return generated 64 bit unsigned integer
- */
-static uint64_t zipf_next(double zipf_exponent, double off, double imax)
+static void pacer_init(pacer_t* p, const benchmark_config_t* config, int thread_id,
+                       double phase_start_us)
 {
-    assert(zipf_exponent > 1);
-    assert(imax >= 1);
-    assert(off >= 0);
-
-    double xmin = 0.5;
-    double xmax = imax + 0.5;
-
-    /* calculate hlow, hupp and tot_area */
-    double hlow = calc_continuous_approximation(off, zipf_exponent, xmin);
-    double hupp = calc_continuous_approximation(off, zipf_exponent, xmax);
-    double tot_area = hupp - hlow;
+    memset(p, 0, sizeof(*p));
+    if (config->target_rate <= 0.0) return;
 
-    /* Find next uint64 zipf value */
-    int accepted = 0;
-    double u, k, c_area;
+    double global_interval_us = 1000000.0 / config->target_rate;
+    p->interval_us = global_interval_us * config->num_threads;
+    p->poisson = config->arrival == ARRIVAL_POISSON;
+    p->rng = 0x243F6A8885A308D3ULL * (uint64_t)(thread_id + 1);
 
-    while (!accepted)
-    {
-        u = (double)rand() / (double)RAND_MAX;
-        c_area = cumulative_area(hlow, tot_area, u);
-        k = hinv(zipf_exponent, c_area);
-        accepted = is_accepted(hlow, off, zipf_exponent, c_area, k);
-    }
-
-    return (uint64_t)k;
+    /* fixed arrivals interleave thread by thread, poisson streams are independent and their
+     * superposition is again poisson at the full rate */
+    p->next_us = phase_start_us + (p->poisson ? 0.0 : global_interval_us * thread_id);
 }
 
-static void generate_key(uint8_t* key, size_t key_size, int64_t index, key_pattern_t pattern,
-                         int64_t max_operations)
+/* waits for an absolute time on the op clock. we sleep off most of the gap and spin the last
+ * stretch, nanosleep overshoots by tens of microseconds which would smear the schedule at high
+ * rates */
+static void sleep_until(double when_us)
 {
-    uint64_t key_num = 0;
-
-    /* we ensure we have space for null terminator */
-    int available_digits = (int)(key_size - 1); /* -1 for null terminator */
-
-    switch (pattern)
+    for (;;)
     {
-        case KEY_PATTERN_SEQUENTIAL:
-            /* sequential use index directly for uniqueness */
-            snprintf((char*)key, key_size, "%0*" PRId64, available_digits, index);
-            break;
-
-        case KEY_PATTERN_RANDOM:
-            /* we use index directly in hex format to ensure uniqueness */
-            /* shuffle bits for randomness while preserving uniqueness */
-            key_num = (uint64_t)index;
-            /* byte-reverse for pseudo-random distribution (full 64-bit) */
-            key_num = ((key_num & 0xFFFFFFFF00000000ULL) >> 32) |
-                      ((key_num & 0x00000000FFFFFFFFULL) << 32);
-            key_num = ((key_num & 0xFFFF0000FFFF0000ULL) >> 16) |
-                      ((key_num & 0x0000FFFF0000FFFFULL) << 16);
-            key_num =
-                ((key_num & 0xFF00FF00FF00FF00ULL) >> 8) | ((key_num & 0x00FF00FF00FF00FFULL) << 8);
-            snprintf((char*)key, key_size, "%0*llx", available_digits, (unsigned long long)key_num);
-            break;
-
-        case KEY_PATTERN_ZIPFIAN:
-            /* zipfian distribution -- 80% of accesses to 20% of keys */
-            /* intentionally creates duplicates for hot-key simulation */
-            key_num = zipf_next(1.3, 0.99, (double)max_operations);
-            snprintf((char*)key, key_size, "%0*llu", available_digits, (unsigned long long)key_num);
-            break;
-
-        case KEY_PATTERN_UNIFORM:
-            /* true uniform random, may have collisions */
-            key_num = ((uint64_t)rand() << 32) | rand();
-            snprintf((char*)key, key_size, "%0*llx", available_digits, (unsigned long long)key_num);
-            break;
-
-        case KEY_PATTERN_TIMESTAMP:
-            /* monotonically increasing timestamp-like keys */
-            key_num = ((uint64_t)time(NULL) << 32) | index;
-            snprintf((char*)key, key_size, "%0*llx", available_digits, (unsigned long long)key_num);
-            break;
+        double remaining = when_us - get_time_microseconds();
+        if (remaining <= 0.0) break;
 
-        case KEY_PATTERN_REVERSE:
-            /* reverse sequential */
-            key_num = (uint64_t)(max_operations - index);
-            snprintf((char*)key, key_size, "%0*llu", available_digits, (unsigned long long)key_num);
-            break;
-
-        default:
-            /* fallback to sequential */
-            snprintf((char*)key, key_size, "%0*" PRId64, available_digits, index);
-            break;
+        if (remaining > 200.0)
+        {
+            double sleep_us = remaining - 100.0;
+            struct timespec ts = {(time_t)(sleep_us / 1000000.0),
+                                  (long)(fmod(sleep_us, 1000000.0) * 1000.0)};
+            nanosleep(&ts, NULL);
+        }
     }
 }
 
-typedef struct
+/* draws the gap to the arrival after the current one */
+static double pacer_gap(pacer_t* p)
 {
-    benchmark_config_t* config;
-    storage_engine_t* engine;
-    int thread_id;
-    int64_t ops_per_thread;
-    double* latencies;
-    int latency_count;
-} thread_context_t;
+    if (!p->poisson) return p->interval_us;
+    double u = (double)(mix_rand_next(&p->rng) >> 11) * (1.0 / 9007199254740992.0);
+    return -log(1.0 - u) * p->interval_us;
+}
 
-static double get_time_microseconds(void)
+/**
+ * pacer_wait
+ * blocks until the intended start of the next arrival and claims n arrivals (a batch counts
+ * once per op it carries). when the engine has fallen behind the schedule it returns at once,
+ * the backlog is what the corrected latency then accounts for
+ * @param p the worker's pacer
+ * @param n number of arrivals to claim
+ * @return intended start time in microseconds, 0 in closed-loop mode
+ */
+static double pacer_wait(pacer_t* p, int64_t n)
 {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec * 1000000.0 + tv.tv_usec;
+    if (p->next_us <= 0.0) return 0.0;
+
+    double intended = p->next_us;
+    for (int64_t i = 0; i < n; i++) p->next_us += pacer_gap(p);
+
+    sleep_until(intended);
+    return intended;
 }
 
 /* get memory usage from /proc/self/status */
-static void get_memory_usage(size_t* rss_bytes, size_t* vms_bytes)
+void get_memory_usage(size_t* rss_bytes, size_t* vms_bytes)
 {
     FILE* fp = fopen("/proc/self/status", "r");
     if (!fp)
@@ -319,7 +296,7 @@ static void get_memory_usage(size_t* rss_bytes, size_t* vms_bytes)
 }
 
 /* get I/O statistics from /proc/self/io */
-static void get_io_stats(size_t* bytes_read, size_t* bytes_written)
+void get_io_stats(size_t* bytes_read, size_t* bytes_written)
 {
     FILE* fp = fopen("/proc/self/io", "r");
     if (!fp)
@@ -344,6 +321,86 @@ static void get_io_stats(size_t* bytes_read, size_t* bytes_written)
     fclose(fp);
 }
 
+typedef enum
+{
+    STAT_COUNT,
+    STAT_BYTES, /* shown in MB */
+    STAT_MICROS /* shown in ms */
+} stat_unit_t;
+
+/* engine_stats_t fields in report order, counters are turned into per-phase deltas */
+typedef struct
+{
+    const char* label;
+    size_t offset;
+    int counter;
+    stat_unit_t unit;
+} engine_stat_field_t;
+
+static const engine_stat_field_t engine_stat_fields[] = {
+    {"Write stall (ms)", offsetof(engine_stats_t, stall_us), 1, STAT_MICROS},
+    {"Flush writes (MB)", offsetof(engine_stats_t, flush_write_bytes), 1, STAT_BYTES},
+    {"Compaction reads (MB)", offsetof(engine_stats_t, compaction_read_bytes), 1, STAT_BYTES},
+    {"Compaction writes (MB)", offsetof(engine_stats_t, compaction_write_bytes), 1, STAT_BYTES},
+    {"Block cache hits", offsetof(engine_stats_t, block_cache_hits), 1, STAT_COUNT},
+    {"Block cache misses", offsetof(engine_stats_t, block_cache_misses), 1, STAT_COUNT},
+    {"Bloom useful", offsetof(engine_stats_t, bloom_useful), 1, STAT_COUNT},
+    {"Pending compaction (MB)", offsetof(engine_stats_t, pending_compaction_bytes), 0, STAT_BYTES},
+    {"Immutable memtables", offsetof(engine_stats_t, immutable_memtables), 0, STAT_COUNT},
+    {"Memtable (MB)", offsetof(engine_stats_t, memtable_bytes), 0, STAT_BYTES},
+    {"Block cache (MB)", offsetof(engine_stats_t, block_cache_bytes), 0, STAT_BYTES},
+    {"L0 files", offsetof(engine_stats_t, l0_files), 0, STAT_COUNT},
+    {"Table files", offsetof(engine_stats_t, table_files), 0, STAT_COUNT},
+    {"Live data (MB)", offsetof(engine_stats_t, live_data_bytes), 0, STAT_BYTES},
+    {"Keys", offsetof(engine_stats_t, num_keys), 0, STAT_COUNT},
+    {"Tree depth", offsetof(engine_stats_t, tree_depth), 0, STAT_COUNT},
+};
+#define ENGINE_STAT_FIELDS (sizeof(engine_stat_fields) / sizeof(engine_stat_fields[0]))
+
+static int64_t* engine_stat_at(engine_stats_t* stats, size_t i)
+{
+    return (int64_t*)((char*)stats + engine_stat_fields[i].offset);
+}
+
+static int64_t engine_stat_value(const engine_stats_t* stats, size_t i)
+{
+    return *(const int64_t*)((const char*)stats + engine_stat_fields[i].offset);
+}
+
+void engine_stats_reset(engine_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (size_t i = 0; i < ENGINE_STAT_FIELDS; i++) *engine_stat_at(stats, i) = -1;
+}
+
+int sample_engine_stats(storage_engine_t* engine, engine_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!engine->ops->get_stats) return -1;
+
+    engine_stats_reset(stats);
+    if (engine->ops->get_stats(engine, stats) != 0)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return -1;
+    }
+    stats->valid = 1;
+    return 0;
+}
+
+/* end becomes the phase snapshot, counters relative to start and gauges as they are */
+static void engine_stats_delta(engine_stats_t* end, const engine_stats_t* start)
+{
+    if (!end->valid || !start->valid) return;
+    for (size_t i = 0; i < ENGINE_STAT_FIELDS; i++)
+    {
+        int64_t* e = engine_stat_at(end, i);
+        int64_t s = engine_stat_value(start, i);
+        if (!engine_stat_fields[i].counter || *e < 0) continue;
+        *e = s < 0 ? -1 : *e - s;
+    }
+}
+
 /* get CPU usage statistics */
 static void get_cpu_stats(double* user_time, double* system_time)
 {
@@ -453,189 +510,509 @@ static size_t get_directory_size(const char* path)
     return get_directory_size_recursive(path, 0);
 }
 
-static void generate_value(uint8_t* value, size_t value_size, int64_t index)
+/* logical bytes of one entry, with the mean value size of a size distribution */
+static size_t entry_bytes(const benchmark_config_t* config)
+{
+    double value = config->value_pool ? config->value_pool->mean_size : config->value_size;
+    if (config->num_column_families > 1) return (size_t)(cfroute_mean_entry(config, value) + 0.5);
+    return (size_t)config->key_size + (size_t)(value + 0.5);
+}
+
+/* records one latency sample standing for weight ops, timestamps are in microseconds, the
+ * histogram keeps ns */
+static inline void record_latency(histogram_t* hist, double start_us, double end_us,
+                                  int64_t weight)
+{
+    double elapsed_ns = (end_us - start_us) * 1000.0;
+    histogram_record_n(hist, elapsed_ns > 0.0 ? (uint64_t)elapsed_ns : 0, (uint64_t)weight);
+}
+
+/* --latency-sample, 1 when the worker's next single op is one of the timed 1 in N. the others
+ * skip both clock reads and are counted through the weight of the timed one. warmup ops are
+ * never timed */
+static inline int sample_op(thread_context_t* ctx)
+{
+    if (!ctx->measuring) return 0;
+    if (--ctx->sample_left > 0) return 0;
+    ctx->sample_left = ctx->sample_every;
+    return 1;
+}
+
+/* records an op of the worker, open-loop runs measure from the intended start (pacer_wait) and
+ * keep the plain service time on the side */
+static inline void record_op(thread_context_t* ctx, histogram_t* hist, double intended_us,
+                             double start_us, double end_us)
+{
+    /* the op went to the family the router picked for the thread's last key */
+    if (ctx->cf_hists)
+    {
+        record_latency(&ctx->cf_hists[cfroute_last_cf], intended_us > 0.0 ? intended_us : start_us,
+                       end_us, ctx->sample_every);
+    }
+    if (intended_us > 0.0)
+    {
+        record_latency(ctx->raw_hist, start_us, end_us, ctx->sample_every);
+        record_latency(hist, intended_us, end_us, ctx->sample_every);
+        return;
+    }
+    record_latency(hist, start_us, end_us, ctx->sample_every);
+}
+
+/* hands out up to max_ops consecutive op indexes of the phase, claiming a new chunk from the
+ * shared cursor once the worker's current one is used up. workers that run fast simply claim
+ * more chunks, so a straggler no longer holds back a fixed share, and every index below
+ * num_operations is issued exactly once. with a deadline the cursor instead wraps over the
+ * keyspace until the deadline passes. returns the count (0 when the phase is done) and the
+ * first index in *first */
+static int64_t next_ops(thread_context_t* ctx, int64_t max_ops, int64_t* first)
 {
-    for (size_t i = 0; i < value_size; i++)
+    /* the warmup end and the deadline are checked every few calls, not on every op */
+    if ((!ctx->measuring || ctx->deadline_us > 0.0) && --ctx->clock_check_left <= 0)
+    {
+        double now = get_time_microseconds();
+        ctx->clock_check_left = BENCHMARK_CLOCK_CHECK_CALLS;
+        if (!ctx->measuring && now >= ctx->warmup_end_us) ctx->measuring = 1;
+        if (ctx->deadline_us > 0.0 && now >= ctx->deadline_us)
+        {
+            if (ctx->finish_us == 0.0) ctx->finish_us = now;
+            return 0;
+        }
+    }
+
+    if (ctx->chunk_next == ctx->chunk_end)
     {
-        value[i] = (uint8_t)((index + i) % 256);
+        int64_t total = ctx->config->num_operations;
+        int64_t start = atomic_fetch_add_explicit(ctx->next_op, ctx->chunk_ops,
+                                                  memory_order_relaxed);
+        if (ctx->deadline_us > 0.0)
+        {
+            ctx->chunk_lap = start / total;
+            start %= total;
+        }
+        else if (start >= total)
+        {
+            if (ctx->finish_us == 0.0) ctx->finish_us = get_time_microseconds();
+            return 0;
+        }
+        ctx->chunk_next = start;
+        ctx->chunk_end = start + ctx->chunk_ops < total ? start + ctx->chunk_ops : total;
     }
+
+    int64_t n = ctx->chunk_end - ctx->chunk_next;
+    if (n > max_ops) n = max_ops;
+    *first = ctx->chunk_next;
+    ctx->chunk_next += n;
+    ctx->ops_done += n;
+    if (ctx->measuring) ctx->ops_measured += n;
+    return n;
 }
 
-static int compare_double(const void* a, const void* b)
+static void calculate_stats(const histogram_t* hist, operation_stats_t* stats)
 {
-    double da = *(const double*)a;
-    double db = *(const double*)b;
-    return (da > db) - (da < db);
+    if (hist->count == 0) return;
+
+    stats->min_latency_us = hist->min / 1000.0;
+    stats->max_latency_us = hist->max / 1000.0;
+    stats->avg_latency_us = histogram_mean(hist) / 1000.0;
+    stats->std_dev_us = histogram_stddev(hist) / 1000.0;
+
+    stats->cv_percent =
+        (stats->avg_latency_us > 0.0) ? (stats->std_dev_us / stats->avg_latency_us) * 100.0 : 0.0;
+
+    stats->p50_latency_us = histogram_value_at_percentile(hist, 50.0) / 1000.0;
+    stats->p95_latency_us = histogram_value_at_percentile(hist, 95.0) / 1000.0;
+    stats->p99_latency_us = histogram_value_at_percentile(hist, 99.0) / 1000.0;
+    stats->p999_latency_us = histogram_value_at_percentile(hist, 99.9) / 1000.0;
+    stats->p9999_latency_us = histogram_value_at_percentile(hist, 99.99) / 1000.0;
 }
 
-static void calculate_stats(double* latencies, int count, operation_stats_t* stats)
+static void calculate_uncorrected_stats(const histogram_t* hist, operation_stats_t* stats)
 {
-    if (count == 0) return;
+    if (hist->count == 0) return;
 
-    qsort(latencies, count, sizeof(double), compare_double);
+    stats->uncorrected_avg_us = histogram_mean(hist) / 1000.0;
+    stats->uncorrected_p50_us = histogram_value_at_percentile(hist, 50.0) / 1000.0;
+    stats->uncorrected_p99_us = histogram_value_at_percentile(hist, 99.0) / 1000.0;
+    stats->uncorrected_p999_us = histogram_value_at_percentile(hist, 99.9) / 1000.0;
+    stats->uncorrected_max_us = hist->max / 1000.0;
+}
 
-    double sum = 0.0;
-    stats->min_latency_us = latencies[0];
-    stats->max_latency_us = latencies[count - 1];
+/* with config->keep_histograms, copies the histogram behind stats into the results. stats
+ * outside the results (the sweep points' scratch runs) are left out */
+static void keep_histogram(const benchmark_config_t* config, benchmark_results_t* results,
+                           const operation_stats_t* stats, const histogram_t* hist)
+{
+    const char* p = (const char*)stats;
+    if (!config->keep_histograms || p < (const char*)results ||
+        p >= (const char*)(results + 1))
+    {
+        return;
+    }
 
-    for (int i = 0; i < count; i++)
+    /* a phase that runs again (a rerun sweep phase) replaces its earlier copy */
+    result_hist_t* kept = NULL;
+    for (int i = 0; i < results->hist_count; i++)
+    {
+        if (results->hists[i].stats == stats) kept = &results->hists[i];
+    }
+    if (!kept)
     {
-        sum += latencies[i];
+        if (results->hist_count == BENCHMARK_MAX_RESULT_OPS) return;
+        histogram_t* copy = malloc(sizeof(*copy));
+        if (!copy) return;
+        kept = &results->hists[results->hist_count++];
+        kept->stats = stats;
+        kept->hist = copy;
     }
+    memcpy(kept->hist, hist, sizeof(*hist));
+}
 
-    stats->avg_latency_us = sum / count;
+const histogram_t* results_histogram(const benchmark_results_t* results,
+                                     const operation_stats_t* stats)
+{
+    for (int i = 0; i < results->hist_count; i++)
+    {
+        if (results->hists[i].stats == stats) return results->hists[i].hist;
+    }
+    return NULL;
+}
 
-    double variance = 0.0;
-    for (int i = 0; i < count; i++)
+/**
+ * run_async_ops
+ * --queue-depth worker loop, keeps up to queue_depth requests of the phase outstanding. latency
+ * runs from submission to the reap that returned the completion
+ * @param ctx worker context
+ * @param op request type of the phase
+ */
+static void run_async_ops(thread_context_t* ctx, asyncq_op_t op)
+{
+    int depth = ctx->config->queue_depth;
+    ctx->sample_every = 1; /* a completion needs its submit stamp, every request is timed */
+    double* submitted = malloc(depth * sizeof(double));
+    int* free_slots = malloc(depth * sizeof(int));
+    engine_completion_t* done = malloc(depth * sizeof(engine_completion_t));
+    asyncq_t* q = NULL;
+
+    if (!submitted || !free_slots || !done || asyncq_open(&q, ctx->engine, op, ctx->config) != 0)
     {
-        double diff = latencies[i] - stats->avg_latency_us;
-        variance += diff * diff;
+        fprintf(stderr, "Failed to open the request queue of thread %d\n", ctx->thread_id);
+        free(submitted);
+        free(free_slots);
+        free(done);
+        return;
     }
-    stats->std_dev_us = sqrt(variance / count);
 
-    stats->cv_percent =
-        (stats->avg_latency_us > 0.0) ? (stats->std_dev_us / stats->avg_latency_us) * 100.0 : 0.0;
+    int num_free = depth;
+    for (int slot = 0; slot < depth; slot++) free_slots[slot] = depth - 1 - slot;
+
+    int exhausted = 0;
+    int64_t i;
+    int64_t retry = -1; /* claimed op the queue refused, submitted again after a reap */
+    for (;;)
+    {
+        /* we refill every free slot before waiting, the queue stays at depth until the tail */
+        while (num_free > 0 && !exhausted)
+        {
+            if (retry >= 0)
+            {
+                i = retry;
+                retry = -1;
+            }
+            else if (next_ops(ctx, 1, &i) == 0)
+            {
+                exhausted = 1;
+                break;
+            }
+            int slot = free_slots[num_free - 1];
+            const uint8_t* key = keygen_key(&ctx->keygen, i);
+            const uint8_t* value = NULL;
+            size_t value_size = 0;
+            if (op == ASYNCQ_PUT) value = value_pool_get(ctx->config->value_pool, i, &value_size);
+
+            submitted[slot] = get_time_microseconds();
+            if (asyncq_submit(q, slot, key, value, value_size) == 0)
+            {
+                num_free--;
+                continue;
+            }
+
+            /* the op is claimed and counted, we wait for a completion to make room for it. with
+             * nothing outstanding the queue is broken, the op is taken back out of the totals */
+            if (num_free < depth)
+            {
+                retry = i;
+                break;
+            }
+            fprintf(stderr, "Request queue of thread %d failed at key %" PRId64 "\n",
+                    ctx->thread_id, i);
+            ctx->ops_done--;
+            if (ctx->measuring) ctx->ops_measured--;
+            exhausted = 1;
+        }
+        if (num_free == depth) break;
+
+        int n = asyncq_reap(q, done, depth);
+        double end = get_time_microseconds();
+        for (int k = 0; k < n; k++)
+        {
+            int slot = (int)done[k].tag;
+            if (submitted[slot] >= ctx->warmup_end_us)
+            {
+                record_op(ctx, ctx->hist, 0.0, submitted[slot], end);
+            }
+            free_slots[num_free++] = slot;
+        }
+    }
 
-    int p50_idx = (int)(count * 0.50);
-    int p95_idx = (int)(count * 0.95);
-    int p99_idx = (int)(count * 0.99);
-    if (p50_idx >= count) p50_idx = count - 1;
-    if (p95_idx >= count) p95_idx = count - 1;
-    if (p99_idx >= count) p99_idx = count - 1;
-    stats->p50_latency_us = latencies[p50_idx];
-    stats->p95_latency_us = latencies[p95_idx];
-    stats->p99_latency_us = latencies[p99_idx];
+    asyncq_close(q);
+    free(submitted);
+    free(free_slots);
+    free(done);
 }
 
 static void* benchmark_put_thread(void* arg)
 {
     thread_context_t* ctx = (thread_context_t*)arg;
-    uint8_t* key = malloc(ctx->config->key_size);
-    uint8_t* value = malloc(ctx->config->value_size);
+    if (ctx->config->queue_depth > 1)
+    {
+        run_async_ops(ctx, ASYNCQ_PUT);
+        return NULL;
+    }
 
-    int64_t start_index = (int64_t)ctx->thread_id * ctx->ops_per_thread;
+    const value_pool_t* pool = ctx->config->value_pool;
     int batch_size = ctx->config->batch_size;
+    int64_t i, n;
 
     /* we use use batched API if available, otherwise fall back to single operations */
     if (ctx->engine->ops->batch_begin && ctx->engine->ops->batch_put &&
         ctx->engine->ops->batch_commit && batch_size > 1)
     {
         /* batched path -- group operations into transactions */
-        for (int64_t i = 0; i < ctx->ops_per_thread; i += batch_size)
+        while ((n = next_ops(ctx, batch_size, &i)) > 0)
         {
             void* batch_ctx = NULL;
-            double batch_start = get_time_microseconds();
+            int64_t batch_end = i + n;
+            double intended = pacer_wait(&ctx->pacer, n);
+            int timed = sample_op(ctx);
+            double batch_start = timed ? get_time_microseconds() : 0.0;
 
             if (ctx->engine->ops->batch_begin(ctx->engine, &batch_ctx) != 0) continue;
 
-            int64_t batch_end =
-                (i + batch_size < ctx->ops_per_thread) ? i + batch_size : ctx->ops_per_thread;
-
             for (int64_t j = i; j < batch_end; j++)
             {
-                generate_key(key, ctx->config->key_size, start_index + j, ctx->config->key_pattern,
-                             ctx->config->num_operations);
-                generate_value(value, ctx->config->value_size, start_index + j);
+                const uint8_t* key = keygen_key(&ctx->keygen, j);
+                size_t value_size;
+                const uint8_t* value = value_pool_get(pool, j, &value_size);
 
                 ctx->engine->ops->batch_put(batch_ctx, ctx->engine, key, ctx->config->key_size,
-                                            value, ctx->config->value_size);
+                                            value, value_size);
             }
 
             ctx->engine->ops->batch_commit(batch_ctx);
-            double batch_end_time = get_time_microseconds();
 
             /* we record record latency for the entire batch */
-            double batch_latency = batch_end_time - batch_start;
-            ctx->latencies[ctx->latency_count++] = batch_latency;
+            if (timed) record_op(ctx, ctx->hist, intended, batch_start, get_time_microseconds());
         }
     }
     else
     {
         /* single operation path (legacy) */
-        for (int64_t i = 0; i < ctx->ops_per_thread; i++)
+        while (next_ops(ctx, 1, &i) > 0)
         {
-            generate_key(key, ctx->config->key_size, start_index + i, ctx->config->key_pattern,
-                         ctx->config->num_operations);
-            generate_value(value, ctx->config->value_size, start_index + i);
+            const uint8_t* key = keygen_key(&ctx->keygen, i);
+            size_t value_size;
+            const uint8_t* value = value_pool_get(pool, i, &value_size);
+
+            double intended = pacer_wait(&ctx->pacer, 1);
+            int timed = sample_op(ctx);
+            double start = timed ? get_time_microseconds() : 0.0;
+            ctx->engine->ops->put(ctx->engine, key, ctx->config->key_size, value, value_size);
+            if (timed) record_op(ctx, ctx->hist, intended, start, get_time_microseconds());
+        }
+    }
+
+    return NULL;
+}
+
+/* sorted bulk load, one writer streams the keyspace in order and the engine ingests it at the
+ * end. a failed add stops the stream and drops the load, the zero op count tells run_ingest
+ * the load failed */
+static void* benchmark_ingest_thread(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    storage_engine_t* engine = ctx->engine;
+    void* bulk_ctx = NULL;
+    int64_t i;
 
-            double start = get_time_microseconds();
-            ctx->engine->ops->put(ctx->engine, key, ctx->config->key_size, value,
-                                  ctx->config->value_size);
-            double end = get_time_microseconds();
+    if (engine->ops->bulk_begin(engine, &bulk_ctx) != 0)
+    {
+        fprintf(stderr, "Failed to start the bulk load\n");
+        return NULL;
+    }
 
-            ctx->latencies[ctx->latency_count++] = end - start;
+    while (next_ops(ctx, 1, &i) > 0)
+    {
+        const uint8_t* key = keygen_key(&ctx->keygen, i);
+        size_t value_size;
+        const uint8_t* value = value_pool_get(ctx->config->value_pool, i, &value_size);
+
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
+        int rc = engine->ops->bulk_add(bulk_ctx, key, ctx->config->key_size, value, value_size);
+        if (timed) record_op(ctx, ctx->hist, 0.0, start, get_time_microseconds());
+        if (rc != 0)
+        {
+            fprintf(stderr, "Bulk load failed at key %" PRId64 "\n", i);
+            ctx->ops_done = 0;
+            if (engine->ops->bulk_abort)
+                engine->ops->bulk_abort(bulk_ctx);
+            else
+                engine->ops->bulk_finish(bulk_ctx);
+            return NULL;
         }
     }
 
-    free(key);
-    free(value);
+    if (engine->ops->bulk_finish(bulk_ctx) != 0)
+    {
+        fprintf(stderr, "Failed to ingest the bulk load\n");
+        ctx->ops_done = 0;
+    }
     return NULL;
 }
 
+/* --zero-copy-reads is honoured only when the engine implements both pinned ops */
+static int use_pinned_reads(const thread_context_t* ctx)
+{
+    return ctx->config->zero_copy_reads && ctx->engine->ops->get_pinned &&
+           ctx->engine->ops->release_pinned;
+}
+
+/**
+ * read_value
+ * point lookup used by the mixed and replay workloads, optionally copying the value into out
+ * @param ctx worker context
+ * @param key the key
+ * @param key_size size of key
+ * @param out buffer receiving up to out_size bytes of the value, or NULL
+ * @param out_size size of out
+ * @param value_size set to the size of the stored value
+ * @return 0 if the key was found, -1 otherwise
+ */
+static int read_value(thread_context_t* ctx, const uint8_t* key, size_t key_size, uint8_t* out,
+                      size_t out_size, size_t* value_size)
+{
+    storage_engine_t* engine = ctx->engine;
+    *value_size = 0;
+
+    if (use_pinned_reads(ctx))
+    {
+        const uint8_t* pinned = NULL;
+        void* pin = NULL;
+        if (engine->ops->get_pinned(engine, key, key_size, &pinned, value_size, &pin) != 0)
+            return -1;
+        if (out) memcpy(out, pinned, *value_size < out_size ? *value_size : out_size);
+        engine->ops->release_pinned(engine, pin);
+        return 0;
+    }
+
+    uint8_t* found = NULL;
+    int rc = engine->ops->get(engine, key, key_size, &found, value_size);
+    if (rc == 0 && found && out)
+    {
+        memcpy(out, found, *value_size < out_size ? *value_size : out_size);
+    }
+    if (found) free(found);
+    return rc == 0 && found ? 0 : -1;
+}
+
 static void* benchmark_get_thread(void* arg)
 {
     thread_context_t* ctx = (thread_context_t*)arg;
-    uint8_t* key = malloc(ctx->config->key_size);
+    if (ctx->config->queue_depth > 1)
+    {
+        run_async_ops(ctx, ASYNCQ_GET);
+        return NULL;
+    }
 
-    int64_t start_index = (int64_t)ctx->thread_id * ctx->ops_per_thread;
+    int pinned_reads = use_pinned_reads(ctx);
+    int split = ctx->hit_hist != NULL;
 
-    for (int64_t i = 0; i < ctx->ops_per_thread; i++)
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
     {
-        generate_key(key, ctx->config->key_size, start_index + i, ctx->config->key_pattern,
-                     ctx->config->num_operations);
+        const uint8_t* key = keygen_key(&ctx->keygen, i);
 
         uint8_t* value = NULL;
         size_t value_size = 0;
 
-        double start = get_time_microseconds();
-        ctx->engine->ops->get(ctx->engine, key, ctx->config->key_size, &value, &value_size);
-        double end = get_time_microseconds();
+        double intended = pacer_wait(&ctx->pacer, 1);
+        uint64_t fetches = split ? ctx->engine->ops->thread_fetches(ctx->engine) : 0;
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
+        if (pinned_reads)
+        {
+            /* the value is read in place, unpinning is engine work and stays in the timing */
+            const uint8_t* pinned = NULL;
+            void* pin = NULL;
+            if (ctx->engine->ops->get_pinned(ctx->engine, key, ctx->config->key_size, &pinned,
+                                             &value_size, &pin) == 0)
+            {
+                ctx->engine->ops->release_pinned(ctx->engine, pin);
+            }
+        }
+        else
+        {
+            ctx->engine->ops->get(ctx->engine, key, ctx->config->key_size, &value, &value_size);
+        }
+        double end = timed ? get_time_microseconds() : 0.0;
 
         if (value) free(value);
-        ctx->latencies[ctx->latency_count++] = end - start;
+        if (!timed) continue;
+        record_op(ctx, ctx->hist, intended, start, end);
+        if (split)
+        {
+            /* a lookup that reached the connector from this thread was a local cache miss */
+            int missed = ctx->engine->ops->thread_fetches(ctx->engine) != fetches;
+            record_latency(missed ? ctx->miss_hist : ctx->hit_hist, start, end, ctx->sample_every);
+        }
     }
 
-    free(key);
     return NULL;
 }
 
 static void* benchmark_delete_thread(void* arg)
 {
     thread_context_t* ctx = (thread_context_t*)arg;
-    uint8_t* key = malloc(ctx->config->key_size);
 
-    int64_t start_index = (int64_t)ctx->thread_id * ctx->ops_per_thread;
     int batch_size = ctx->config->batch_size;
+    int64_t i, n;
 
     /* we use batched API if available, otherwise fall back to single operations */
     if (ctx->engine->ops->batch_begin && ctx->engine->ops->batch_delete &&
         ctx->engine->ops->batch_commit && batch_size > 1)
     {
         /* batched path -- group operations into transactions */
-        for (int64_t i = 0; i < ctx->ops_per_thread; i += batch_size)
+        while ((n = next_ops(ctx, batch_size, &i)) > 0)
         {
             void* batch_ctx = NULL;
-            double batch_start = get_time_microseconds();
+            int64_t batch_end = i + n;
+            double intended = pacer_wait(&ctx->pacer, n);
+            int timed = sample_op(ctx);
+            double batch_start = timed ? get_time_microseconds() : 0.0;
 
             if (ctx->engine->ops->batch_begin(ctx->engine, &batch_ctx) != 0) continue;
 
-            int64_t batch_end =
-                (i + batch_size < ctx->ops_per_thread) ? i + batch_size : ctx->ops_per_thread;
-
             for (int64_t j = i; j < batch_end; j++)
             {
-                generate_key(key, ctx->config->key_size, start_index + j, ctx->config->key_pattern,
-                             ctx->config->num_operations);
+                const uint8_t* key = keygen_key(&ctx->keygen, j);
 
                 ctx->engine->ops->batch_delete(batch_ctx, ctx->engine, key, ctx->config->key_size);
             }
 
             ctx->engine->ops->batch_commit(batch_ctx);
-            double batch_end_time = get_time_microseconds();
 
             /* record latency for the entire batch */
-            double batch_latency = batch_end_time - batch_start;
-            ctx->latencies[ctx->latency_count++] = batch_latency;
+            if (timed) record_op(ctx, ctx->hist, intended, batch_start, get_time_microseconds());
 
             /* progress indicator every 10K ops for debugging */
             if ((i + batch_size) % 10000 < batch_size && ctx->thread_id == 0)
@@ -648,17 +1025,17 @@ static void* benchmark_delete_thread(void* arg)
     else
     {
         /* single operation path (legacy) */
-        for (int64_t i = 0; i < ctx->ops_per_thread; i++)
+        while (next_ops(ctx, 1, &i) > 0)
         {
-            generate_key(key, ctx->config->key_size, start_index + i, ctx->config->key_pattern,
-                         ctx->config->num_operations);
+            const uint8_t* key = keygen_key(&ctx->keygen, i);
 
-            double start = get_time_microseconds();
+            double intended = pacer_wait(&ctx->pacer, 1);
+            int timed = sample_op(ctx);
+            double start = timed ? get_time_microseconds() : 0.0;
             int del_result = ctx->engine->ops->del(ctx->engine, key, ctx->config->key_size);
-            double end = get_time_microseconds();
 
             /* track latency even if delete fails (key not found is OK) */
-            ctx->latencies[ctx->latency_count++] = end - start;
+            if (timed) record_op(ctx, ctx->hist, intended, start, get_time_microseconds());
 
             /* progress indicator every 10K ops for debugging */
             if ((i + 1) % 10000 == 0 && ctx->thread_id == 0)
@@ -669,31 +1046,28 @@ static void* benchmark_delete_thread(void* arg)
         }
     }
 
-    free(key);
     return NULL;
 }
 
 static void* benchmark_seek_thread(void* arg)
 {
     thread_context_t* ctx = (thread_context_t*)arg;
-    uint8_t* key = malloc(ctx->config->key_size);
-
-    int64_t start_index = (int64_t)ctx->thread_id * ctx->ops_per_thread;
 
     /* w ecreate iterator once per thread, reuse for all seeks */
     void* iter = NULL;
     if (ctx->engine->ops->iter_new(ctx->engine, &iter) != 0)
     {
-        free(key);
         return NULL;
     }
 
-    for (int64_t i = 0; i < ctx->ops_per_thread; i++)
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
     {
-        generate_key(key, ctx->config->key_size, start_index + i, ctx->config->key_pattern,
-                     ctx->config->num_operations);
+        const uint8_t* key = keygen_key(&ctx->keygen, i);
 
-        double start = get_time_microseconds();
+        double intended = pacer_wait(&ctx->pacer, 1);
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
 
         ctx->engine->ops->iter_seek(iter, key, ctx->config->key_size);
 
@@ -707,606 +1081,3654 @@ static void* benchmark_seek_thread(void* arg)
             ctx->engine->ops->iter_key(iter, &found_key, &found_key_size);
         }
 
-        double end = get_time_microseconds();
-        ctx->latencies[ctx->latency_count++] = end - start;
+        if (timed) record_op(ctx, ctx->hist, intended, start, get_time_microseconds());
     }
 
     /* cleanup iterator once at the end */
     ctx->engine->ops->iter_free(iter);
-    free(key);
     return NULL;
 }
 
+/* range and scan phases create their iterator with the --scan-readahead hint, on engines that
+ * take one */
+static int open_scan_iter(thread_context_t* ctx, void** iter)
+{
+    const storage_engine_ops_t* ops = ctx->engine->ops;
+    size_t readahead = ctx->config->scan_readahead;
+    int rc = readahead > 0 && ops->iter_new_opts
+                 ? ops->iter_new_opts(ctx->engine, readahead, iter)
+                 : ops->iter_new(ctx->engine, iter);
+    if (rc != 0)
+    {
+        fprintf(stderr, "[T%d iter_new failed] ", ctx->thread_id);
+        fflush(stderr);
+    }
+    return rc;
+}
+
+/* the entry under the iterator, in one call where the engine offers it. the iterator owns the
+ * memory, don't free it */
+static inline int iter_entry_of(const storage_engine_ops_t* ops, void* iter, uint8_t** key,
+                                size_t* key_size, uint8_t** value, size_t* value_size)
+{
+    if (ops->iter_entry) return ops->iter_entry(iter, key, key_size, value, value_size);
+    if (ops->iter_key(iter, key, key_size) != 0) return -1;
+    return ops->iter_value(iter, value, value_size);
+}
+
+/* we read the entry under the iterator and return the bytes of its key and value */
+static inline size_t read_iter_entry(const storage_engine_ops_t* ops, void* iter)
+{
+    uint8_t* key = NULL;
+    uint8_t* value = NULL;
+    size_t key_size = 0;
+    size_t value_size = 0;
+    if (iter_entry_of(ops, iter, &key, &key_size, &value, &value_size) != 0) return 0;
+    return key_size + value_size;
+}
+
 static void* benchmark_range_thread(void* arg)
 {
     thread_context_t* ctx = (thread_context_t*)arg;
-    uint8_t* key = malloc(ctx->config->key_size);
+    const storage_engine_ops_t* ops = ctx->engine->ops;
 
-    int64_t start_index = (int64_t)ctx->thread_id * ctx->ops_per_thread;
     int range_size = ctx->config->range_size;
 
     /* we create iterator once per thread, we reuse for all range queries */
     void* iter = NULL;
-    if (ctx->engine->ops->iter_new(ctx->engine, &iter) != 0)
-    {
-        fprintf(stderr, "[T%d iter_new failed] ", ctx->thread_id);
-        fflush(stderr);
-        free(key);
-        return NULL;
-    }
+    if (open_scan_iter(ctx, &iter) != 0) return NULL;
 
-    for (int64_t i = 0; i < ctx->ops_per_thread; i++)
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
     {
-        generate_key(key, ctx->config->key_size, start_index + i, ctx->config->key_pattern,
-                     ctx->config->num_operations);
+        const uint8_t* key = keygen_key(&ctx->keygen, i);
 
-        double start = get_time_microseconds();
+        double intended = pacer_wait(&ctx->pacer, 1);
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
 
         /* seek to starting key */
-        ctx->engine->ops->iter_seek(iter, key, ctx->config->key_size);
+        ops->iter_seek(iter, key, ctx->config->key_size);
 
-        /* iterate through range_size keys */
+        /* iterate through range_size keys, reading key and value to simulate a real query */
         int count = 0;
-        while (ctx->engine->ops->iter_valid(iter) && count < range_size)
+        while (ops->iter_valid(iter) && count < range_size)
         {
-            /* read key and value to simulate real range query */
-            /* the iterator owns this memory, don't free it */
-            uint8_t* found_key = NULL;
-            uint8_t* found_value = NULL;
-            size_t found_key_size = 0;
-            size_t found_value_size = 0;
+            read_iter_entry(ops, iter);
+            ops->iter_next(iter);
+            count++;
+        }
 
-            ctx->engine->ops->iter_key(iter, &found_key, &found_key_size);
-            ctx->engine->ops->iter_value(iter, &found_value, &found_value_size);
-
-            ctx->engine->ops->iter_next(iter);
-            count++;
-        }
-
-        double end = get_time_microseconds();
-        ctx->latencies[ctx->latency_count++] = end - start;
+        if (timed) record_op(ctx, ctx->hist, intended, start, get_time_microseconds());
     }
 
     /* cleanup iterator once at the end */
-    ctx->engine->ops->iter_free(iter);
-    free(key);
+    ops->iter_free(iter);
     return NULL;
 }
 
-int run_benchmark(benchmark_config_t* config, benchmark_results_t** results)
+/* the smallest power of ten of at least keys, a run of that many aligned sequential keys shares
+ * a decimal prefix */
+static int64_t scan_prefix_block(int64_t keys)
 {
-    *results = calloc(1, sizeof(benchmark_results_t));
-    if (!*results) return -1;
-
-    (*results)->engine_name = config->engine_name;
-    (*results)->config = *config;
-
-    const storage_engine_ops_t* ops = get_engine_ops(config->engine_name);
-    if (!ops)
-    {
-        fprintf(stderr, "Unknown engine: %s\n", config->engine_name);
-        free(*results);
-        return -1;
-    }
+    int64_t block = 1;
+    while (block < keys) block *= 10;
+    return block;
+}
 
-    storage_engine_t* engine = NULL;
-    if (ops->open(&engine, config->db_path, config) != 0)
+/**
+ * scan_worker
+ * scans key ranges [lower, upper) of the sequential layout. a sequential pattern starts the scans
+ * at consecutive keys and any other at uniformly random ones, the length is drawn from
+ * [scan_min, scan_max] unless --scan-prefix makes every scan one whole prefix. the range is
+ * handed to the engine as iterator bounds, or with --scan-unbounded (and on engines without
+ * iter_seek_bounded) walked from a plain seek while counting entries
+ * @param ctx the worker
+ * @param reverse every range is walked from its last key with iter_prev
+ * @return NULL
+ */
+static void* scan_worker(thread_context_t* ctx, int reverse)
+{
+    const benchmark_config_t* config = ctx->config;
+    const storage_engine_ops_t* ops = ctx->engine->ops;
+    int key_size = config->key_size;
+    int64_t keys = config->num_operations;
+    int64_t span = (int64_t)config->scan_max - config->scan_min + 1;
+    int64_t block = config->scan_prefix_keys > 0 ? scan_prefix_block(config->scan_prefix_keys) : 0;
+    int bounded = !config->scan_unbounded && ops->iter_seek_bounded;
+    int consecutive = config->key_pattern == KEY_PATTERN_SEQUENTIAL;
+
+    uint8_t* lower = malloc(2 * (size_t)key_size);
+    if (!lower)
     {
-        fprintf(stderr, "Failed to open engine\n");
-        free(*results);
-        return -1;
+        fprintf(stderr, "[T%d scan alloc failed] ", ctx->thread_id);
+        return NULL;
     }
+    uint8_t* upper = lower + key_size;
 
-    /* we apply sync mode if supported */
-    if (engine->ops->set_sync)
+    void* iter = NULL;
+    if (open_scan_iter(ctx, &iter) != 0)
     {
-        engine->ops->set_sync(engine, config->sync_enabled);
+        free(lower);
+        return NULL;
     }
 
-    printf("Running %s benchmark...\n", ops->name);
-
-    /* baseline captured after first thread allocation to exclude benchmark infrastructure */
-    size_t baseline_rss = 0, baseline_vms = 0, baseline_io_read = 0, baseline_io_write = 0;
-    double baseline_cpu_user = 0.0, baseline_cpu_system = 0.0;
-    double benchmark_start_time = get_time_microseconds();
-    int baseline_captured = 0;
-
-    if (config->workload_type == WORKLOAD_WRITE || config->workload_type == WORKLOAD_MIXED)
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
     {
-        printf("  PUT: ");
-        fflush(stdout);
-
-        pthread_t* threads = malloc(config->num_threads * sizeof(pthread_t));
-        thread_context_t* contexts = calloc(config->num_threads, sizeof(thread_context_t));
-
-        int64_t ops_per_thread = config->num_operations / config->num_threads;
-
-        for (int i = 0; i < config->num_threads; i++)
+        int64_t first = consecutive ? i % keys : (int64_t)(keygen_rand(&ctx->keygen) % keys);
+        int64_t len = config->scan_min;
+        if (span > 1) len += (int64_t)(keygen_rand(&ctx->keygen) % (uint64_t)span);
+        if (block > 0)
         {
-            contexts[i].latencies = malloc(ops_per_thread * sizeof(double));
+            first -= first % block;
+            len = block;
         }
+        if (first + len > keys) len = keys - first;
 
-        if (!baseline_captured)
+        keygen_format_index(&ctx->keygen, lower, first);
+        if (!bounded && reverse)
         {
-            get_memory_usage(&baseline_rss, &baseline_vms);
-            get_io_stats(&baseline_io_read, &baseline_io_write);
-            get_cpu_stats(&baseline_cpu_user, &baseline_cpu_system);
-            baseline_captured = 1;
+            /* seek_for_prev lands on the last key of the range itself */
+            keygen_format_index(&ctx->keygen, upper, first + len - 1);
         }
-
-        double start_time = get_time_microseconds();
-
-        for (int i = 0; i < config->num_threads; i++)
+        else if (first + len < keys)
         {
-            contexts[i].config = config;
-            contexts[i].engine = engine;
-            contexts[i].thread_id = i;
-            contexts[i].ops_per_thread = ops_per_thread;
-            contexts[i].latency_count = 0;
-            pthread_create(&threads[i], NULL, benchmark_put_thread, &contexts[i]);
+            keygen_format_index(&ctx->keygen, upper, first + len);
         }
-
-        for (int i = 0; i < config->num_threads; i++)
+        else
         {
-            pthread_join(threads[i], NULL);
+            /* the range runs to the end, an upper bound of 0xff sorts after every digit key */
+            memset(upper, 0xff, (size_t)key_size);
         }
 
-        double end_time = get_time_microseconds();
-        (*results)->put_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        (*results)->put_stats.ops_per_second =
-            config->num_operations / (*results)->put_stats.duration_seconds;
+        double intended = pacer_wait(&ctx->pacer, 1);
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
 
-        int total_latencies = 0;
-        for (int i = 0; i < config->num_threads; i++)
+        int64_t count = 0;
+        if (bounded)
         {
-            total_latencies += contexts[i].latency_count;
+            ops->iter_seek_bounded(iter, lower, key_size, upper, key_size, reverse);
         }
-
-        double* all_latencies = malloc(total_latencies * sizeof(double));
-        int offset = 0;
-        for (int i = 0; i < config->num_threads; i++)
+        else if (reverse)
         {
-            memcpy(all_latencies + offset, contexts[i].latencies,
-                   contexts[i].latency_count * sizeof(double));
-            offset += contexts[i].latency_count;
-            free(contexts[i].latencies);
+            ops->iter_seek_for_prev(iter, upper, key_size);
+        }
+        else
+        {
+            ops->iter_seek(iter, lower, key_size);
         }
 
-        calculate_stats(all_latencies, total_latencies, &(*results)->put_stats);
-        free(all_latencies);
-        free(threads);
-        free(contexts);
-
-        size_t data_size = (size_t)config->num_operations * (config->key_size + config->value_size);
-        (*results)->total_bytes_written += data_size;
-        (*results)->net_logical_data_size += data_size;
+        /* a bounded iterator runs dry at the end of the range, the unbounded one counts */
+        while ((bounded || count < len) && ops->iter_valid(iter))
+        {
+            ctx->bytes_read += read_iter_entry(ops, iter);
+            if (reverse)
+            {
+                ops->iter_prev(iter);
+            }
+            else
+            {
+                ops->iter_next(iter);
+            }
+            count++;
+        }
+        ctx->items += (uint64_t)count;
 
-        printf("%.2f ops/sec\n", (*results)->put_stats.ops_per_second);
+        if (timed) record_op(ctx, ctx->hist, intended, start, get_time_microseconds());
     }
 
-    if (config->workload_type == WORKLOAD_READ || config->workload_type == WORKLOAD_MIXED)
-    {
-        printf("  GET: ");
-        fflush(stdout);
+    ops->iter_free(iter);
+    free(lower);
+    return NULL;
+}
 
-        pthread_t* threads = malloc(config->num_threads * sizeof(pthread_t));
-        thread_context_t* contexts = calloc(config->num_threads, sizeof(thread_context_t));
+static void* benchmark_scan_thread(void* arg)
+{
+    return scan_worker((thread_context_t*)arg, 0);
+}
 
-        int64_t ops_per_thread = config->num_operations / config->num_threads;
+static void* benchmark_reverse_scan_thread(void* arg)
+{
+    return scan_worker((thread_context_t*)arg, 1);
+}
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            contexts[i].latencies = malloc(ops_per_thread * sizeof(double));
-        }
+static void* benchmark_multiget_thread(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
 
-        if (!baseline_captured)
-        {
-            get_memory_usage(&baseline_rss, &baseline_vms);
-            get_io_stats(&baseline_io_read, &baseline_io_write);
-            get_cpu_stats(&baseline_cpu_user, &baseline_cpu_system);
-            baseline_captured = 1;
-        }
+    int batch_size = ctx->config->batch_size > 1 ? ctx->config->batch_size : 1;
+    int key_size = ctx->config->key_size;
+
+    /* keygen_key reuses its buffer, so each batch copies its keys out first */
+    uint8_t* key_buf = malloc((size_t)batch_size * key_size);
+    const uint8_t** keys = malloc(batch_size * sizeof(*keys));
+    size_t* key_sizes = malloc(batch_size * sizeof(*key_sizes));
+    uint8_t** values = calloc(batch_size, sizeof(*values));
+    size_t* value_sizes = calloc(batch_size, sizeof(*value_sizes));
+    if (!key_buf || !keys || !key_sizes || !values || !value_sizes)
+    {
+        fprintf(stderr, "[T%d multiget alloc failed] ", ctx->thread_id);
+        batch_size = 0;
+    }
 
-        double start_time = get_time_microseconds();
+    for (int i = 0; i < batch_size; i++)
+    {
+        keys[i] = key_buf + (size_t)i * key_size;
+        key_sizes[i] = key_size;
+    }
 
-        for (int i = 0; i < config->num_threads; i++)
+    int64_t i, claimed;
+    while (batch_size > 0 && (claimed = next_ops(ctx, batch_size, &i)) > 0)
+    {
+        int n = (int)claimed;
+        for (int j = 0; j < n; j++)
         {
-            contexts[i].config = config;
-            contexts[i].engine = engine;
-            contexts[i].thread_id = i;
-            contexts[i].ops_per_thread = ops_per_thread;
-            contexts[i].latency_count = 0;
-            pthread_create(&threads[i], NULL, benchmark_get_thread, &contexts[i]);
+            memcpy(key_buf + (size_t)j * key_size, keygen_key(&ctx->keygen, i + j), key_size);
         }
 
-        for (int i = 0; i < config->num_threads; i++)
+        double intended = pacer_wait(&ctx->pacer, n);
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
+        if (ctx->engine->ops->multi_get)
         {
-            pthread_join(threads[i], NULL);
+            ctx->engine->ops->multi_get(ctx->engine, n, keys, key_sizes, values, value_sizes);
         }
-
-        double end_time = get_time_microseconds();
-        (*results)->get_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        (*results)->get_stats.ops_per_second =
-            config->num_operations / (*results)->get_stats.duration_seconds;
-
-        int total_latencies = 0;
-        for (int i = 0; i < config->num_threads; i++)
+        else
         {
-            total_latencies += contexts[i].latency_count;
+            /* engines without a batched lookup pay one get per key */
+            for (int j = 0; j < n; j++)
+            {
+                ctx->engine->ops->get(ctx->engine, keys[j], key_size, &values[j],
+                                      &value_sizes[j]);
+            }
         }
+        double end = timed ? get_time_microseconds() : 0.0;
 
-        double* all_latencies = malloc(total_latencies * sizeof(double));
-        int offset = 0;
-        for (int i = 0; i < config->num_threads; i++)
+        for (int j = 0; j < n; j++)
         {
-            memcpy(all_latencies + offset, contexts[i].latencies,
-                   contexts[i].latency_count * sizeof(double));
-            offset += contexts[i].latency_count;
-            free(contexts[i].latencies);
+            free(values[j]);
+            values[j] = NULL;
         }
 
-        calculate_stats(all_latencies, total_latencies, &(*results)->get_stats);
-        free(all_latencies);
-        free(threads);
-        free(contexts);
+        /* one sample per batch, like the batched write path */
+        if (timed) record_op(ctx, ctx->hist, intended, start, end);
+    }
 
-        (*results)->total_bytes_read =
-            (size_t)config->num_operations * (config->key_size + config->value_size);
+    free(key_buf);
+    free(keys);
+    free(key_sizes);
+    free(values);
+    free(value_sizes);
+    return NULL;
+}
 
-        printf("%.2f ops/sec\n", (*results)->get_stats.ops_per_second);
-    }
+static const char* mix_op_names[MIX_OP_COUNT] = {"PUT", "GET", "DELETE", "RANGE", "RMW", "INSERT"};
 
-    if (config->workload_type == WORKLOAD_DELETE)
-    {
-        printf("  DELETE: ");
-        fflush(stdout);
+const char* mix_op_to_string(mix_op_t op)
+{
+    if ((int)op < 0 || op >= MIX_OP_COUNT) return "UNKNOWN";
+    return mix_op_names[op];
+}
 
-        pthread_t* threads = malloc(config->num_threads * sizeof(pthread_t));
-        thread_context_t* contexts = calloc(config->num_threads, sizeof(thread_context_t));
+int parse_mix_spec(const char* spec, int* weights)
+{
+    if (!spec || !weights) return -1;
 
-        int64_t ops_per_thread = config->num_operations / config->num_threads;
+    memset(weights, 0, MIX_OP_COUNT * sizeof(int));
 
-        for (int i = 0; i < config->num_threads; i++)
+    /* YCSB core workload presets */
+    if (strncmp(spec, "ycsb-", 5) == 0 && strlen(spec) == 6)
+    {
+        switch (spec[5])
         {
-            contexts[i].latencies = malloc(ops_per_thread * sizeof(double));
+            case 'a': /* update heavy */
+                weights[MIX_OP_GET] = 50;
+                weights[MIX_OP_PUT] = 50;
+                return 0;
+            case 'b': /* read mostly */
+                weights[MIX_OP_GET] = 95;
+                weights[MIX_OP_PUT] = 5;
+                return 0;
+            case 'c': /* read only */
+                weights[MIX_OP_GET] = 100;
+                return 0;
+            case 'd': /* read latest */
+                weights[MIX_OP_GET] = 95;
+                weights[MIX_OP_INSERT] = 5;
+                return 0;
+            case 'e': /* short ranges */
+                weights[MIX_OP_RANGE] = 95;
+                weights[MIX_OP_INSERT] = 5;
+                return 0;
+            case 'f': /* read-modify-write */
+                weights[MIX_OP_GET] = 50;
+                weights[MIX_OP_RMW] = 50;
+                return 0;
+            default:
+                return -1;
         }
+    }
 
-        if (!baseline_captured)
-        {
-            get_memory_usage(&baseline_rss, &baseline_vms);
-            get_io_stats(&baseline_io_read, &baseline_io_write);
-            get_cpu_stats(&baseline_cpu_user, &baseline_cpu_system);
-            baseline_captured = 1;
-        }
+    char buf[256];
+    if (strlen(spec) >= sizeof(buf)) return -1;
+    strcpy(buf, spec);
 
-        double start_time = get_time_microseconds();
+    int total = 0;
+    char* saveptr = NULL;
+    for (char* tok = strtok_r(buf, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr))
+    {
+        char* eq = strchr(tok, '=');
+        if (!eq) return -1;
+        *eq = '\0';
+
+        char* end = NULL;
+        long weight = strtol(eq + 1, &end, 10);
+        if (end == eq + 1 || *end != '\0' || weight < 0) return -1;
+
+        mix_op_t op;
+        if (strcmp(tok, "put") == 0 || strcmp(tok, "update") == 0)
+            op = MIX_OP_PUT;
+        else if (strcmp(tok, "get") == 0 || strcmp(tok, "read") == 0)
+            op = MIX_OP_GET;
+        else if (strcmp(tok, "del") == 0 || strcmp(tok, "delete") == 0)
+            op = MIX_OP_DELETE;
+        else if (strcmp(tok, "range") == 0 || strcmp(tok, "scan") == 0)
+            op = MIX_OP_RANGE;
+        else if (strcmp(tok, "rmw") == 0)
+            op = MIX_OP_RMW;
+        else if (strcmp(tok, "insert") == 0)
+            op = MIX_OP_INSERT;
+        else
+            return -1;
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            contexts[i].config = config;
-            contexts[i].engine = engine;
-            contexts[i].thread_id = i;
-            contexts[i].ops_per_thread = ops_per_thread;
-            contexts[i].latency_count = 0;
-            int rc = pthread_create(&threads[i], NULL, benchmark_delete_thread, &contexts[i]);
-            if (rc != 0)
-            {
-                fprintf(stderr, "Failed to create thread %d\n", i);
-            }
-        }
+        weights[op] = (int)weight;
+        total += (int)weight;
+    }
 
-        fprintf(stderr, "[%d threads started] ", config->num_threads);
-        fflush(stderr);
+    return total > 0 ? 0 : -1;
+}
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            pthread_join(threads[i], NULL);
-            fprintf(stderr, "[T%d done] ", i);
-            fflush(stderr);
-        }
+int parse_thread_sweep(const char* spec, int* counts)
+{
+    if (!spec || !counts) return -1;
 
-        double end_time = get_time_microseconds();
-        (*results)->delete_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        (*results)->delete_stats.ops_per_second =
-            config->num_operations / (*results)->delete_stats.duration_seconds;
+    char buf[256];
+    if (strlen(spec) >= sizeof(buf)) return -1;
+    strcpy(buf, spec);
 
-        int total_latencies = 0;
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            total_latencies += contexts[i].latency_count;
-        }
+    int n = 0;
+    char* saveptr = NULL;
+    for (char* tok = strtok_r(buf, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr))
+    {
+        char* end = NULL;
+        long threads = strtol(tok, &end, 10);
+        if (end == tok || *end != '\0' || threads < 1 || threads > 4096) return -1;
+        if (n >= BENCHMARK_MAX_SWEEP) return -1;
+        counts[n++] = (int)threads;
+    }
+    if (n != 1) return n > 0 ? n : -1;
 
-        double* all_latencies = malloc(total_latencies * sizeof(double));
-        int offset = 0;
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            memcpy(all_latencies + offset, contexts[i].latencies,
-                   contexts[i].latency_count * sizeof(double));
-            offset += contexts[i].latency_count;
-            free(contexts[i].latencies);
-        }
+    /* a lone N is the usual 1,2,4,... curve up to N */
+    int max_threads = counts[0];
+    n = 0;
+    for (int t = 1; t < max_threads && n < BENCHMARK_MAX_SWEEP - 1; t *= 2)
+    {
+        counts[n++] = t;
+    }
+    counts[n++] = max_threads;
+    return n;
+}
 
-        calculate_stats(all_latencies, total_latencies, &(*results)->delete_stats);
-        free(all_latencies);
-        free(threads);
-        free(contexts);
+int parse_cache_sweep(const char* spec, double* fractions)
+{
+    if (!spec || !fractions) return -1;
 
-        size_t data_size = (size_t)config->num_operations * (config->key_size + config->value_size);
-        (*results)->total_bytes_written += data_size;
-        if ((*results)->net_logical_data_size >= data_size)
-        {
-            (*results)->net_logical_data_size -= data_size;
-        }
-        else
-        {
-            (*results)->net_logical_data_size = 0;
-        }
+    char buf[256];
+    if (strlen(spec) >= sizeof(buf)) return -1;
+    strcpy(buf, spec);
 
-        printf("%.2f ops/sec\n", (*results)->delete_stats.ops_per_second);
+    int n = 0;
+    char* saveptr = NULL;
+    for (char* tok = strtok_r(buf, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr))
+    {
+        char* end = NULL;
+        double fraction = strtod(tok, &end);
+        if (end == tok || *end != '\0' || !(fraction > 0.0) || fraction > 64.0) return -1;
+        if (n >= BENCHMARK_MAX_SWEEP) return -1;
+        fractions[n++] = fraction;
     }
+    return n > 0 ? n : -1;
+}
 
-    if (config->workload_type == WORKLOAD_SEEK)
+static void* benchmark_mix_thread(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    const benchmark_config_t* config = ctx->config;
+    const value_pool_t* pool = config->value_pool;
+    uint8_t* key = malloc(config->key_size);
+    uint8_t* rmw_value = malloc(pool->span); /* read-modify-write copy of the stored value */
+    if (!key || !rmw_value)
     {
-        printf("  SEEK: ");
-        fflush(stdout);
-
-        pthread_t* threads = malloc(config->num_threads * sizeof(pthread_t));
-        thread_context_t* contexts = calloc(config->num_threads, sizeof(thread_context_t));
-
-        int64_t ops_per_thread = config->num_operations / config->num_threads;
+        fprintf(stderr, "[T%d mix alloc failed] ", ctx->thread_id);
+        free(key);
+        free(rmw_value);
+        return NULL;
+    }
+    uint64_t rng = 0xA0761D6478BD642FULL * (uint64_t)(ctx->thread_id + 1);
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            contexts[i].latencies = malloc(ops_per_thread * sizeof(double));
-        }
+    /* cumulative weights so each pick is a single draw + linear scan over 6 slots */
+    int cumulative[MIX_OP_COUNT];
+    int total_weight = 0;
+    for (int op = 0; op < MIX_OP_COUNT; op++)
+    {
+        total_weight += config->mix_weights[op];
+        cumulative[op] = total_weight;
+    }
 
-        if (!baseline_captured)
-        {
-            get_memory_usage(&baseline_rss, &baseline_vms);
-            get_io_stats(&baseline_io_read, &baseline_io_write);
-            get_cpu_stats(&baseline_cpu_user, &baseline_cpu_system);
-            baseline_captured = 1;
-        }
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
+    {
+        int pick = (int)(mix_rand_next(&rng) % (uint64_t)total_weight);
+        mix_op_t op = MIX_OP_PUT;
+        while (pick >= cumulative[op]) op++;
+
+        /* we target a key inside the preloaded keyspace, inserts grow it instead */
+        int64_t index = (int64_t)(mix_rand_next(&rng) % (uint64_t)config->num_operations);
+        if (op == MIX_OP_INSERT) index = atomic_fetch_add(ctx->next_insert, 1);
+        if (op == MIX_OP_INSERT)
+            keygen_format_index(&ctx->keygen, key, index);
+        else
+            keygen_format(&ctx->keygen, key, index);
 
-        double start_time = get_time_microseconds();
+        size_t found_size = 0;
+        double intended = pacer_wait(&ctx->pacer, 1);
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
 
-        for (int i = 0; i < config->num_threads; i++)
+        switch (op)
         {
-            contexts[i].config = config;
-            contexts[i].engine = engine;
-            contexts[i].thread_id = i;
-            contexts[i].ops_per_thread = ops_per_thread;
-            contexts[i].latency_count = 0;
-            int rc = pthread_create(&threads[i], NULL, benchmark_seek_thread, &contexts[i]);
-            if (rc != 0)
+            case MIX_OP_PUT:
+            case MIX_OP_INSERT:
             {
-                fprintf(stderr, "Failed to create thread %d\n", i);
+                size_t value_size;
+                const uint8_t* value = value_pool_get(pool, index, &value_size);
+                ctx->engine->ops->put(ctx->engine, key, config->key_size, value, value_size);
+                break;
             }
-        }
 
-        fprintf(stderr, "[%d threads started] ", config->num_threads);
-        fflush(stderr);
+            case MIX_OP_GET:
+                read_value(ctx, key, config->key_size, NULL, 0, &found_size);
+                break;
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            pthread_join(threads[i], NULL);
-            fprintf(stderr, "[T%d done] ", i);
-            fflush(stderr);
-        }
+            case MIX_OP_DELETE:
+                ctx->engine->ops->del(ctx->engine, key, config->key_size);
+                break;
 
-        double end_time = get_time_microseconds();
-        fprintf(stderr, "\n");
+            case MIX_OP_RANGE:
+            {
+                /* fresh iterator per scan so it observes concurrent writes */
+                void* iter = NULL;
+                if (ctx->engine->ops->iter_new(ctx->engine, &iter) != 0) break;
+                ctx->engine->ops->iter_seek(iter, key, config->key_size);
+                int count = 0;
+                while (ctx->engine->ops->iter_valid(iter) && count < config->range_size)
+                {
+                    read_iter_entry(ctx->engine->ops, iter);
+                    ctx->engine->ops->iter_next(iter);
+                    count++;
+                }
+                ctx->engine->ops->iter_free(iter);
+                break;
+            }
 
-        (*results)->seek_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        (*results)->seek_stats.ops_per_second =
-            config->num_operations / (*results)->seek_stats.duration_seconds;
+            case MIX_OP_RMW:
+            {
+                const uint8_t* value = rmw_value;
+                size_t value_size = 0;
+                if (read_value(ctx, key, config->key_size, rmw_value, pool->span,
+                               &found_size) == 0 &&
+                    found_size > 0)
+                {
+                    value_size = found_size < pool->span ? found_size : pool->span;
+                    rmw_value[0]++;
+                }
+                else
+                {
+                    value = value_pool_get(pool, index, &value_size);
+                }
+                ctx->engine->ops->put(ctx->engine, key, config->key_size, value, value_size);
+                break;
+            }
 
-        int total_latencies = 0;
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            total_latencies += contexts[i].latency_count;
+            default:
+                break;
         }
 
-        double* all_latencies = malloc(total_latencies * sizeof(double));
-        int offset = 0;
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            memcpy(all_latencies + offset, contexts[i].latencies,
-                   contexts[i].latency_count * sizeof(double));
-            offset += contexts[i].latency_count;
-            free(contexts[i].latencies);
-        }
+        if (ctx->measuring) ctx->op_counts[op]++;
+        if (!timed) continue;
 
-        calculate_stats(all_latencies, total_latencies, &(*results)->seek_stats);
-        free(all_latencies);
-        free(threads);
-        free(contexts);
+        double end = get_time_microseconds();
+        record_op(ctx, ctx->hist, intended, start, end);
+        record_latency(&ctx->op_hists[op], intended > 0.0 ? intended : start, end,
+                       ctx->sample_every);
+    }
 
-        (*results)->total_bytes_read +=
-            (size_t)config->num_operations * (config->key_size + config->value_size);
+    free(key);
+    free(rmw_value);
+    return NULL;
+}
 
-        printf("%.2f ops/sec\n", (*results)->seek_stats.ops_per_second);
+/* the mix op a trace op is reported under, a SEEK scans like a RANGE */
+static mix_op_t replay_op(trace_op_t op)
+{
+    switch (op)
+    {
+        case TRACE_OP_PUT:
+            return MIX_OP_PUT;
+        case TRACE_OP_GET:
+            return MIX_OP_GET;
+        case TRACE_OP_DELETE:
+            return MIX_OP_DELETE;
+        default:
+            return MIX_OP_RANGE;
     }
+}
 
-    if (config->workload_type == WORKLOAD_RANGE)
+/**
+ * benchmark_replay_thread
+ * -w replay worker. the op index space is the trace, a claimed chunk is one block of the
+ * mapping, so workers read disjoint pages and consecutive blocks run on different workers. a
+ * timed replay issues every record at phase start + ts_us / replay_speed, a --duration lap
+ * starts where the previous one ended. records only keep their order inside a block
+ * @param arg worker context
+ */
+static void* benchmark_replay_thread(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    const benchmark_config_t* config = ctx->config;
+    const trace_t* trace = config->trace;
+    const value_pool_t* pool = config->value_pool;
+    double speed = config->target_rate > 0.0 ? 0.0 : config->replay_speed;
+    /* a lap is the trace span plus one mean gap, the first record of a lap follows the last */
+    double lap_us = trace->num_records > 1 ? (double)trace->span_us * trace->num_records /
+                                                 (double)(trace->num_records - 1)
+                                           : 0.0;
+    trace_record_t rec;
+
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
     {
-        printf("  RANGE: ");
-        fflush(stdout);
-
-        pthread_t* threads = malloc(config->num_threads * sizeof(pthread_t));
-        thread_context_t* contexts = calloc(config->num_threads, sizeof(thread_context_t));
-
-        int64_t ops_per_thread = config->num_operations / config->num_threads;
-
-        for (int i = 0; i < config->num_threads; i++)
+        if (trace_read(trace, &ctx->trace_cursor, (uint64_t)i, &rec) != 0)
         {
-            contexts[i].latencies = malloc(ops_per_thread * sizeof(double));
+            fprintf(stderr, "[T%d truncated trace record %" PRId64 "] ", ctx->thread_id, i);
+            fflush(stderr);
+            break;
         }
+        mix_op_t op = replay_op(rec.op);
 
-        if (!baseline_captured)
+        /* --target-rate re-paces the trace, otherwise a timed replay follows its stamps */
+        double intended = pacer_wait(&ctx->pacer, 1);
+        if (speed > 0.0)
         {
-            get_memory_usage(&baseline_rss, &baseline_vms);
-            get_io_stats(&baseline_io_read, &baseline_io_write);
-            get_cpu_stats(&baseline_cpu_user, &baseline_cpu_system);
-            baseline_captured = 1;
+            intended = ctx->phase_start_us + (ctx->chunk_lap * lap_us + rec.ts_us) / speed;
+            sleep_until(intended);
         }
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
 
-        double start_time = get_time_microseconds();
-
-        for (int i = 0; i < config->num_threads; i++)
+        switch (rec.op)
         {
-            contexts[i].config = config;
-            contexts[i].engine = engine;
-            contexts[i].thread_id = i;
-            contexts[i].ops_per_thread = ops_per_thread;
-            contexts[i].latency_count = 0;
-            int rc = pthread_create(&threads[i], NULL, benchmark_range_thread, &contexts[i]);
-            if (rc != 0)
+            case TRACE_OP_PUT:
             {
-                fprintf(stderr, "Failed to create thread %d\n", i);
+                size_t value_size = rec.value_size < pool->max_size ? rec.value_size
+                                                                    : pool->max_size;
+                ctx->engine->ops->put(ctx->engine, rec.key, rec.key_size,
+                                      value_pool_slice(pool, i), value_size);
+                ctx->bytes_written += rec.key_size + value_size;
+                break;
             }
-        }
 
-        fprintf(stderr, "[%d threads started] ", config->num_threads);
-        fflush(stderr);
+            case TRACE_OP_GET:
+            {
+                size_t found_size = 0;
+                read_value(ctx, rec.key, rec.key_size, NULL, 0, &found_size);
+                ctx->bytes_read += rec.key_size + found_size;
+                break;
+            }
 
-        for (int i = 0; i < config->num_threads; i++)
-        {
-            pthread_join(threads[i], NULL);
-            fprintf(stderr, "[T%d done] ", i);
-            fflush(stderr);
+            case TRACE_OP_DELETE:
+                ctx->engine->ops->del(ctx->engine, rec.key, rec.key_size);
+                ctx->bytes_written += rec.key_size;
+                break;
+
+            default:
+            {
+                /* fresh iterator per scan so it observes the replayed writes */
+                void* iter = NULL;
+                if (ctx->engine->ops->iter_new(ctx->engine, &iter) != 0) break;
+                ctx->engine->ops->iter_seek(iter, rec.key, rec.key_size);
+                uint32_t count = 0;
+                while (ctx->engine->ops->iter_valid(iter) && count < rec.value_size)
+                {
+                    ctx->bytes_read += read_iter_entry(ctx->engine->ops, iter);
+                    ctx->engine->ops->iter_next(iter);
+                    count++;
+                }
+                ctx->engine->ops->iter_free(iter);
+                break;
+            }
         }
 
-        double end_time = get_time_microseconds();
-        fprintf(stderr, "\n");
+        if (ctx->measuring) ctx->op_counts[op]++;
+        if (!timed) continue;
+
+        double end = get_time_microseconds();
+        record_op(ctx, ctx->hist, intended, start, end);
+        record_latency(&ctx->op_hists[op], intended > 0.0 ? intended : start, end,
+                       ctx->sample_every);
+    }
+
+    return NULL;
+}
+
+/* --trace-preload, puts every key the trace touches so its reads find data. values are the
+ * traced size for PUT records and -v for the rest */
+static void* benchmark_trace_load_thread(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    const trace_t* trace = ctx->config->trace;
+    const value_pool_t* pool = ctx->config->value_pool;
+    trace_record_t rec;
+
+    int64_t i;
+    while (next_ops(ctx, 1, &i) > 0)
+    {
+        if (trace_read(trace, &ctx->trace_cursor, (uint64_t)i, &rec) != 0) break;
+
+        size_t value_size =
+            rec.op == TRACE_OP_PUT ? rec.value_size : (size_t)ctx->config->value_size;
+        if (value_size > pool->max_size) value_size = pool->max_size;
+
+        int timed = sample_op(ctx);
+        double start = timed ? get_time_microseconds() : 0.0;
+        ctx->engine->ops->put(ctx->engine, rec.key, rec.key_size, value_pool_slice(pool, i),
+                              value_size);
+        ctx->bytes_written += rec.key_size + value_size;
+        if (timed) record_op(ctx, ctx->hist, 0.0, start, get_time_microseconds());
+    }
+
+    return NULL;
+}
+
+typedef struct
+{
+    size_t rss;
+    size_t vms;
+    size_t io_read;
+    size_t io_write;
+    double cpu_user;
+    double cpu_system;
+    iostat_sample_t device;
+    int has_fsync;
+    histogram_t fsync;     /* shim histogram at the baseline, nanoseconds */
+    memstat_sampler_t mem; /* runs from the baseline to the end sample */
+    int captured;
+} resource_baseline_t;
+
+/* device counters and fsync histogram at the start of the measured phases */
+static void capture_io_baseline(const char* path, resource_baseline_t* base)
+{
+    iostat_sample(path, &base->device);
+    base->has_fsync = iostat_fsync_snapshot(&base->fsync) == 0;
+}
+
+/* device counters and fsync histogram at the end of the measured phases, taken with the
+ * /proc/self/io sample before the engine is closed */
+typedef struct
+{
+    iostat_sample_t device;
+    int has_fsync;
+    histogram_t fsync;
+} io_end_t;
 
-        (*results)->range_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        (*results)->range_stats.ops_per_second =
-            config->num_operations / (*results)->range_stats.duration_seconds;
+static void capture_io_end(const char* path, io_end_t* end)
+{
+    iostat_sample(path, &end->device);
+    end->has_fsync = iostat_fsync_snapshot(&end->fsync) == 0;
+}
 
-        int total_latencies = 0;
-        for (int i = 0; i < config->num_threads; i++)
+/**
+ * finish_device_io
+ * fills the device and fsync fields of res with what happened between the baseline and end, and
+ * moves the write and read amplification onto device bytes when the device counters are there
+ * @param base the baseline
+ * @param end the end sample
+ * @param res the resource stats, bytes_read/bytes_written already set from /proc/self/io
+ * @param logical_written logical bytes written, 0 = keep the write amplification as is
+ * @param logical_read logical bytes read, 0 = keep the read amplification as is
+ */
+static void finish_device_io(const resource_baseline_t* base, const io_end_t* end,
+                             resource_stats_t* res, size_t logical_written, size_t logical_read)
+{
+    const iostat_sample_t* now = &end->device;
+    if (base->device.valid && now->valid && strcmp(now->device, base->device.device) == 0)
+    {
+        double secs = (now->time_us - base->device.time_us) / 1e6;
+        double ms = secs * 1000.0;
+        snprintf(res->device, sizeof(res->device), "%s", now->device);
+        res->device_bytes_read =
+            (size_t)(now->sectors_read - base->device.sectors_read) * IOSTAT_SECTOR_BYTES;
+        res->device_bytes_written =
+            (size_t)(now->sectors_written - base->device.sectors_written) * IOSTAT_SECTOR_BYTES;
+        res->device_flushes = now->flushes - base->device.flushes;
+        if (secs > 0)
         {
-            total_latencies += contexts[i].latency_count;
+            res->device_read_iops = (now->reads - base->device.reads) / secs;
+            res->device_write_iops = (now->writes - base->device.writes) / secs;
+            res->device_util_percent =
+                (now->io_ticks_ms - base->device.io_ticks_ms) / ms * 100.0;
+            if (res->device_util_percent > 100.0) res->device_util_percent = 100.0;
+            res->device_queue_depth = (now->queue_ms - base->device.queue_ms) / ms;
         }
 
-        double* all_latencies = malloc(total_latencies * sizeof(double));
-        int offset = 0;
-        for (int i = 0; i < config->num_threads; i++)
+        /* the device sees writeback of data the process wrote before the baseline and misses
+         * nothing the page cache absorbed, so it is the better denominator for amplification */
+        if (logical_written > 0 && res->device_bytes_written > 0)
         {
-            memcpy(all_latencies + offset, contexts[i].latencies,
-                   contexts[i].latency_count * sizeof(double));
-            offset += contexts[i].latency_count;
-            free(contexts[i].latencies);
+            res->write_amplification = (double)res->device_bytes_written / logical_written;
         }
+        if (logical_read > 0 && res->device_bytes_read > 0)
+        {
+            res->read_amplification = (double)res->device_bytes_read / logical_read;
+        }
+    }
 
-        calculate_stats(all_latencies, total_latencies, &(*results)->range_stats);
-        free(all_latencies);
-        free(threads);
-        free(contexts);
+    if (!base->has_fsync || !end->has_fsync) return;
+    histogram_t delta;
+    histogram_delta(&delta, &end->fsync, &base->fsync);
+    res->has_fsync = 1;
+    res->fsync_count = delta.count;
+    if (delta.count > 0)
+    {
+        res->fsync_avg_us = (end->fsync.sum - base->fsync.sum) / delta.count / 1000.0;
+        res->fsync_p50_us = histogram_value_at_percentile(&delta, 50.0) / 1000.0;
+        res->fsync_p99_us = histogram_value_at_percentile(&delta, 99.0) / 1000.0;
+        res->fsync_max_us = delta.max / 1000.0;
+    }
+}
 
-        /* we range queries read range_size keys per operation */
-        (*results)->total_bytes_read += (size_t)config->num_operations * config->range_size *
-                                        (config->key_size + config->value_size);
+/**
+ * finish_memory
+ * stops the sampler and fills the memory breakdown of res, before the engine is closed
+ * @param engine the open engine, its cache and memtable gauges split the resident set
+ * @param mem the run's sampler
+ * @param results peak_rss_bytes already holds the larger of the baseline and end samples
+ */
+static void finish_memory(storage_engine_t* engine, memstat_sampler_t* mem,
+                          benchmark_results_t* results)
+{
+    resource_stats_t* res = &results->resources;
+    memstat_stop(mem);
 
-        printf("%.2f ops/sec\n", (*results)->range_stats.ops_per_second);
+    memstat_proc_t proc;
+    if (memstat_read_proc(&proc) == 0)
+    {
+        if (proc.hwm > res->peak_rss_bytes) res->peak_rss_bytes = proc.hwm;
+        res->rss_anon_bytes = proc.anon;
+        res->rss_file_bytes = proc.file;
+    }
+    res->mem_samples = mem->samples;
+    res->sampled_peak_rss_bytes = mem->peak_rss;
+    snprintf(res->sampled_peak_phase, sizeof(res->sampled_peak_phase), "%s", mem->peak_phase);
+    if (mem->peak_rss > res->peak_rss_bytes) res->peak_rss_bytes = mem->peak_rss;
+
+    memstat_alloc_t alloc;
+    memstat_read_allocator(&alloc);
+    snprintf(res->allocator, sizeof(res->allocator), "%s", alloc.name);
+    res->alloc_allocated_bytes = alloc.allocated;
+    res->alloc_active_bytes = alloc.active;
+    res->alloc_resident_bytes = alloc.resident;
+    res->alloc_mapped_bytes = alloc.mapped;
+    res->alloc_retained_bytes = alloc.retained;
+    res->alloc_peak_allocated_bytes =
+        mem->samples > 0 && mem->peak_allocated > alloc.allocated ? mem->peak_allocated
+                                                                  : alloc.allocated;
+    res->benchtool_bytes = memstat_tracked(&res->benchtool_peak_bytes);
+
+    engine_stats_t es;
+    res->block_cache_bytes = res->memtable_bytes = res->num_keys = -1;
+    if (sample_engine_stats(engine, &es) == 0)
+    {
+        res->block_cache_bytes = es.block_cache_bytes;
+        res->memtable_bytes = es.memtable_bytes;
+        res->num_keys = es.num_keys;
+    }
+    /* without an engine count, the keys the PUT phase wrote, at most the keyspace */
+    int64_t put_ops = results->put_stats.ops_total;
+    if (res->num_keys <= 0 && put_ops > 0)
+    {
+        int64_t keyspace = results->config.num_operations;
+        res->num_keys = keyspace > 0 && put_ops > keyspace ? keyspace : put_ops;
+    }
+}
+
+/* a worker slab and its key arena, counted as benchtool memory */
+static int64_t slab_footprint(const thread_context_t* ctx, size_t slab_bytes)
+{
+    return (int64_t)(slab_bytes + (size_t)KEYGEN_BLOCK_KEYS * ctx->keygen.key_size);
+}
+
+/* --perf-counters worker entry, counts exactly the phase body on the worker's own counters */
+static void* profiled_worker(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    profile_counters_t pc;
+
+    profile_counters_open(&pc);
+    profile_counters_enable(&pc);
+    ctx->thread_fn(arg);
+    profile_counters_disable(&pc);
+    profile_counters_read(&pc, &ctx->perf);
+    profile_counters_close(&pc);
+    return NULL;
+}
+
+/* --column-families, the worker counts the keys it routed to each family over the phase */
+static void* family_worker(void* arg)
+{
+    thread_context_t* ctx = (thread_context_t*)arg;
+    const uint64_t* routed = cfroute_thread_ops();
+    int num_cfs = ctx->config->num_column_families;
+
+    for (int cf = 0; cf < num_cfs; cf++) ctx->cf_ops[cf] = routed[cf];
+    if (ctx->config->perf_counters)
+        profiled_worker(arg);
+    else
+        ctx->thread_fn(arg);
+    for (int cf = 0; cf < num_cfs; cf++) ctx->cf_ops[cf] = routed[cf] - ctx->cf_ops[cf];
+    return NULL;
+}
+
+/* a family's gauges at the end of a phase, the counters are shared by the whole engine */
+static void sample_family_stats(storage_engine_t* engine, int cf, engine_stats_t* stats)
+{
+    if (sample_engine_stats(cfroute_family(engine, cf), stats) != 0) return;
+    for (size_t i = 0; i < ENGINE_STAT_FIELDS; i++)
+    {
+        if (engine_stat_fields[i].counter) *engine_stat_at(stats, i) = -1;
+    }
+}
+
+/**
+ * run_phase
+ * runs thread_fn on config->num_threads workers, each recording into its own histogram, then
+ * merges the histograms (a handful of bucket additions per thread) into stats.
+ * @param phase operation name of the phase, used by the interval reporter
+ * @param trace_threads print thread start/done markers on stderr
+ * @param paced a measured phase, ops follow the --target-rate schedule and --duration and
+ * --warmup apply (preloads always run closed-loop over their op count)
+ * @param base resource baseline, captured on the first phase once worker state is allocated
+ * @param results mixed phase per-op stats and counts are accumulated here, a measured phase on
+ * column families adds its per-family split
+ * @param stats phase stats to fill
+ * @return 0 on success, -1 on allocation failure
+ */
+static int run_phase(benchmark_config_t* config, storage_engine_t* engine, const char* phase,
+                     void* (*thread_fn)(void*), int trace_threads, int paced,
+                     resource_baseline_t* base, benchmark_results_t* results,
+                     operation_stats_t* stats)
+{
+    int num_threads = config->num_threads;
+    int per_op = thread_fn == benchmark_mix_thread || thread_fn == benchmark_replay_thread;
+    /* a timed replay schedules its ops like an open-loop run, only from the trace's stamps */
+    int timed_replay = thread_fn == benchmark_replay_thread && config->replay_speed > 0.0;
+    int open_loop = paced && (config->target_rate > 0.0 || timed_replay);
+    double warmup_us = paced ? config->warmup_sec * 1000000.0 : 0.0;
+    double duration_us = paced ? config->duration_sec * 1000000.0 : 0.0;
+    /* the main GET phase of an object store run splits its latency by local cache hit or miss */
+    int split_reads = thread_fn == benchmark_get_thread && stats == &results->get_stats &&
+                      results->has_remote && engine->ops->thread_fetches;
+    /* a measured phase on column families also splits its latency by the family of the key */
+    int split_cfs = paced && cfroute_is_router(engine) &&
+                    results->cf_phase_count < BENCHMARK_MAX_CF_PHASES;
+    int num_cfs = split_cfs ? config->num_column_families : 0;
+    size_t cf_hists = 1 + (per_op ? MIX_OP_COUNT : 0) + (split_reads ? 2 : 0);
+    size_t hists_per_thread = cf_hists + (size_t)num_cfs + (open_loop ? 1 : 0);
+
+    /* every worker gets its own slab, the context on its own page(s) and the histograms after it.
+     * no two workers share a cache line and the histogram pages are first written by the worker,
+     * so a pinned worker's hot state lands on its own NUMA node */
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t ctx_bytes = (sizeof(thread_context_t) + page - 1) / page * page;
+    size_t slab_bytes = ctx_bytes + hists_per_thread * sizeof(histogram_t);
+
+    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
+    thread_context_t** contexts = calloc(num_threads, sizeof(thread_context_t*));
+    histogram_t** live = malloc(num_threads * sizeof(histogram_t*));
+    atomic_int_fast64_t next_insert = config->num_operations;
+    reporter_t reporter;
+    affinity_plan_t plan;
+    int slabs = 0;
+
+    if (affinity_plan_init(&plan, config) != 0)
+    {
+        fprintf(stderr, "Warning: could not read the cpu topology, threads are not pinned\n");
+    }
+
+    if (threads && contexts)
+    {
+        for (; slabs < num_threads; slabs++)
+        {
+            thread_context_t* ctx = affinity_alloc_local(slab_bytes);
+            if (!ctx) break;
+            if (keygen_init(&ctx->keygen, config, (uint64_t)slabs + 1) != 0)
+            {
+                affinity_free_local(ctx, slab_bytes);
+                break;
+            }
+            ctx->keygen.frontier = per_op ? &next_insert : NULL;
+            contexts[slabs] = ctx;
+            memstat_track(slab_footprint(ctx, slab_bytes));
+        }
+    }
+
+    if (!threads || !contexts || !live || slabs < num_threads)
+    {
+        for (int i = 0; i < slabs; i++)
+        {
+            memstat_track(-slab_footprint(contexts[i], slab_bytes));
+            keygen_free(&contexts[i]->keygen);
+            affinity_free_local(contexts[i], slab_bytes);
+        }
+        affinity_plan_free(&plan);
+        free(threads);
+        free(contexts);
+        free(live);
+        return -1;
+    }
+
+    /* workers claim the op index space in chunks from one cursor. a chunk holds whole batches
+     * and at least one key stream block, small enough that the tail of a phase still balances */
+    atomic_int_fast64_t next_op = 0;
+    int64_t batch = config->batch_size > 1 ? config->batch_size : 1;
+    int64_t chunk_ops = (KEYGEN_BLOCK_KEYS + batch - 1) / batch * batch;
+
+    if (!base->captured)
+    {
+        get_memory_usage(&base->rss, &base->vms);
+        get_io_stats(&base->io_read, &base->io_write);
+        get_cpu_stats(&base->cpu_user, &base->cpu_system);
+        capture_io_baseline(config->db_path, base);
+        memstat_start(&base->mem, config);
+        base->captured = 1;
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        histogram_t* slab_hists = (histogram_t*)((char*)contexts[i] + ctx_bytes);
+        contexts[i]->hist = &slab_hists[0];
+        if (per_op) contexts[i]->op_hists = &slab_hists[1];
+        if (split_reads)
+        {
+            contexts[i]->hit_hist = &slab_hists[1];
+            contexts[i]->miss_hist = &slab_hists[2];
+        }
+        if (split_cfs) contexts[i]->cf_hists = &slab_hists[cf_hists];
+        if (open_loop) contexts[i]->raw_hist = &slab_hists[hists_per_thread - 1];
+        live[i] = contexts[i]->hist;
+    }
+    engine_stats_t engine_start;
+    sample_engine_stats(engine, &engine_start);
+    reporter_start(&reporter, config, phase, engine, live, num_threads);
+    memstat_phase_begin(&base->mem, phase);
+
+    pid_t hook = -1;
+    if (config->profile_cmd &&
+        (!config->profile_phase || strcasecmp(config->profile_phase, phase) == 0))
+    {
+        hook = profile_hook_start(config->profile_cmd, phase);
+    }
+    void* (*entry)(void*) = config->perf_counters ? profiled_worker : thread_fn;
+    if (split_cfs) entry = family_worker;
+
+    double start_time = get_time_microseconds();
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        contexts[i]->config = config;
+        contexts[i]->engine = engine;
+        contexts[i]->thread_id = i;
+        contexts[i]->next_op = &next_op;
+        contexts[i]->chunk_ops = chunk_ops;
+        /* the pacer reads the clock for every op anyway, open-loop runs time them all */
+        contexts[i]->sample_every = config->latency_sample > 1 && !open_loop
+                                        ? config->latency_sample
+                                        : 1;
+        contexts[i]->sample_left = 1;
+        contexts[i]->warmup_end_us = start_time + warmup_us;
+        contexts[i]->deadline_us = duration_us > 0.0 ? start_time + warmup_us + duration_us : 0.0;
+        contexts[i]->measuring = warmup_us <= 0.0;
+        contexts[i]->clock_check_left = 1;
+        contexts[i]->next_insert = &next_insert;
+        contexts[i]->thread_fn = thread_fn;
+        contexts[i]->phase_start_us = start_time;
+        if (open_loop) pacer_init(&contexts[i]->pacer, config, i, start_time);
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        int pinned = affinity_set_attr(&plan, i, &attr) >= 0;
+        int rc = pthread_create(&threads[i], &attr, entry, contexts[i]);
+        if (rc != 0 && pinned)
+        {
+            /* a listed cpu can be offline or outside our cpuset, the worker then runs unpinned */
+            fprintf(stderr, "Warning: could not pin thread %d, running it unpinned\n", i);
+            rc = pthread_create(&threads[i], NULL, entry, contexts[i]);
+        }
+        pthread_attr_destroy(&attr);
+        if (rc != 0)
+        {
+            fprintf(stderr, "Failed to create thread %d\n", i);
+        }
+    }
+
+    if (trace_threads)
+    {
+        fprintf(stderr, "[%d threads started] ", num_threads);
+        fflush(stderr);
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        if (trace_threads)
+        {
+            fprintf(stderr, "[T%d done, %" PRId64 " ops] ", i, contexts[i]->ops_done);
+            fflush(stderr);
+        }
+    }
+
+    double end_time = get_time_microseconds();
+    profile_hook_stop(hook);
+    reporter_stop(&reporter);
+    stats->peak_rss_bytes = memstat_phase_end(&base->mem);
+
+    /* the stats cover the window after the warmup */
+    double measure_start = start_time + warmup_us;
+    if (measure_start >= end_time)
+    {
+        fprintf(stderr, "Warning: %s ended inside the warmup, nothing was measured\n", phase);
+        measure_start = start_time;
+    }
+    stats->duration_seconds = (end_time - measure_start) / 1000000.0;
+    stats->warmup_seconds = (measure_start - start_time) / 1000000.0;
+    stats->steady_windows = reporter.steady_windows;
+    stats->steady_state_sec = reporter.steady_sec;
+    stats->steady_cv_percent = reporter.steady_cv;
+
+    memset(&stats->perf, 0, sizeof(stats->perf));
+    if (config->perf_counters)
+    {
+        for (int i = 0; i < num_threads; i++)
+        {
+            profile_counts_add(&stats->perf, &contexts[i]->perf);
+        }
+    }
+    sample_engine_stats(engine, &stats->engine_stats);
+    engine_stats_delta(&stats->engine_stats, &engine_start);
+
+    /* idle is how long a worker sat out of work between running dry and the phase end */
+    double idle_total_us = 0.0;
+    int64_t ops_measured = 0;
+    uint64_t items = 0;
+    stats->thread_ops_min = INT64_MAX;
+    stats->ops_total = 0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        stats->ops_total += contexts[i]->ops_done;
+        items += contexts[i]->items;
+        ops_measured += contexts[i]->ops_measured;
+        /* trace workers count the bytes of the records they ran, other phases are sized from
+         * their op counts by the caller */
+        results->total_bytes_written += contexts[i]->bytes_written;
+        results->total_bytes_read += contexts[i]->bytes_read;
+        double finish = contexts[i]->finish_us > 0.0 ? contexts[i]->finish_us : start_time;
+        double idle_us = end_time > finish ? end_time - finish : 0.0;
+        idle_total_us += idle_us;
+        if (idle_us > stats->thread_idle_max_ms * 1000.0)
+        {
+            stats->thread_idle_max_ms = idle_us / 1000.0;
+        }
+        if (contexts[i]->ops_done < stats->thread_ops_min)
+        {
+            stats->thread_ops_min = contexts[i]->ops_done;
+        }
+        if (contexts[i]->ops_done > stats->thread_ops_max)
+        {
+            stats->thread_ops_max = contexts[i]->ops_done;
+        }
+    }
+    stats->thread_idle_avg_ms = idle_total_us / num_threads / 1000.0;
+    if (stats->ops_total > 0) stats->items_per_op = (double)items / stats->ops_total;
+
+    /* we merge into the first thread's histogram, no copies and no sort */
+    histogram_t* merged = contexts[0]->hist;
+    for (int i = 1; i < num_threads; i++)
+    {
+        histogram_merge(merged, contexts[i]->hist);
+    }
+
+    /* the mixed phase and time-bounded phases report what actually ran, the others their
+     * nominal op count. the counts come from the workers, under --latency-sample the histogram
+     * only estimates them */
+    double ops_run = (double)config->num_operations;
+    if (warmup_us > 0.0 || duration_us > 0.0) ops_run = (double)ops_measured;
+    if (per_op)
+    {
+        ops_run = 0.0;
+        for (int i = 0; i < num_threads; i++)
+        {
+            for (int op = 0; op < MIX_OP_COUNT; op++) ops_run += contexts[i]->op_counts[op];
+        }
+    }
+    stats->ops_per_second = ops_run / stats->duration_seconds;
+    calculate_stats(merged, stats);
+    keep_histogram(config, results, stats, merged);
+
+    uint64_t gen_ns = 0, gen_keys = 0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        gen_ns += contexts[i]->keygen.gen_ns;
+        gen_keys += contexts[i]->keygen.gen_keys;
+        memstat_track(-slab_footprint(contexts[i], slab_bytes));
+        keygen_free(&contexts[i]->keygen);
+    }
+    if (gen_keys > 0)
+    {
+        stats->keygen_ns_per_key = (double)gen_ns / (double)gen_keys;
+        stats->keygen_percent =
+            100.0 * gen_ns / ((end_time - start_time) * 1000.0 * num_threads);
+    }
+
+    if (open_loop)
+    {
+        for (int i = 1; i < num_threads; i++)
+        {
+            histogram_merge(contexts[0]->raw_hist, contexts[i]->raw_hist);
+        }
+        calculate_uncorrected_stats(contexts[0]->raw_hist, stats);
+    }
+
+    if (per_op)
+    {
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            histogram_t* op_hist = &contexts[0]->op_hists[op];
+            for (int i = 0; i < num_threads; i++)
+            {
+                results->mix_op_counts[op] += contexts[i]->op_counts[op];
+                if (i > 0) histogram_merge(op_hist, &contexts[i]->op_hists[op]);
+            }
+            if (op_hist->count == 0) continue;
+
+            operation_stats_t* op_stats = &results->mix_op_stats[op];
+            op_stats->duration_seconds = stats->duration_seconds;
+            op_stats->engine_stats = stats->engine_stats;
+            op_stats->ops_per_second = results->mix_op_counts[op] / stats->duration_seconds;
+            calculate_stats(op_hist, op_stats);
+            keep_histogram(config, results, op_stats, op_hist);
+        }
+    }
+
+    if (split_cfs)
+    {
+        /* a family's ops are its share of the keys routed during the phase */
+        int p = results->cf_phase_count++;
+        results->cf_phases[p] = phase;
+        uint64_t routed_total = 0;
+        for (int i = 0; i < num_threads; i++)
+        {
+            for (int cf = 0; cf < num_cfs; cf++) routed_total += contexts[i]->cf_ops[cf];
+        }
+        for (int cf = 0; cf < num_cfs; cf++)
+        {
+            operation_stats_t* cf_stats = &results->cf_stats[p][cf];
+            histogram_t* cf_hist = &contexts[0]->cf_hists[cf];
+            cf_stats->ops_total = 0;
+            for (int i = 0; i < num_threads; i++)
+            {
+                cf_stats->ops_total += (int64_t)contexts[i]->cf_ops[cf];
+                if (i > 0) histogram_merge(cf_hist, &contexts[i]->cf_hists[cf]);
+            }
+            double share = routed_total ? (double)cf_stats->ops_total / routed_total : 0.0;
+            cf_stats->duration_seconds = stats->duration_seconds;
+            cf_stats->ops_per_second = stats->ops_per_second * share;
+            if (cf_hist->count > 0) calculate_stats(cf_hist, cf_stats);
+            sample_family_stats(engine, cf, &cf_stats->engine_stats);
+        }
+    }
+
+    if (split_reads)
+    {
+        histogram_t* hit = contexts[0]->hit_hist;
+        histogram_t* miss = contexts[0]->miss_hist;
+        for (int i = 1; i < num_threads; i++)
+        {
+            histogram_merge(hit, contexts[i]->hit_hist);
+            histogram_merge(miss, contexts[i]->miss_hist);
+        }
+        results->get_hit_stats.duration_seconds = stats->duration_seconds;
+        results->get_hit_stats.engine_stats = stats->engine_stats;
+        results->get_hit_stats.ops_per_second = hit->count / stats->duration_seconds;
+        calculate_stats(hit, &results->get_hit_stats);
+        keep_histogram(config, results, &results->get_hit_stats, hit);
+        results->get_miss_stats.duration_seconds = stats->duration_seconds;
+        results->get_miss_stats.engine_stats = stats->engine_stats;
+        results->get_miss_stats.ops_per_second = miss->count / stats->duration_seconds;
+        calculate_stats(miss, &results->get_miss_stats);
+        keep_histogram(config, results, &results->get_miss_stats, miss);
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        affinity_free_local(contexts[i], slab_bytes);
+    }
+    affinity_plan_free(&plan);
+    free(live);
+    free(threads);
+    free(contexts);
+    return 0;
+}
+
+/* the scan phases format their bounds in the sequential layout the dataset was loaded with, a
+ * sequential pattern keeps consecutive scan starts and every other one draws them uniformly */
+static benchmark_config_t scan_phase_config(const benchmark_config_t* config)
+{
+    benchmark_config_t scan = *config;
+    if (scan.key_pattern != KEY_PATTERN_SEQUENTIAL) scan.key_pattern = KEY_PATTERN_UNIFORM;
+    return scan;
+}
+
+/* a reverse scan needs iter_prev, and seek_for_prev unless the engine takes bounds */
+static int scan_reverse_supported(const benchmark_config_t* config, const storage_engine_t* engine)
+{
+    const storage_engine_ops_t* ops = engine->ops;
+    if (!ops->iter_prev) return 0;
+    if (ops->iter_seek_bounded && !config->scan_unbounded) return 1;
+    return ops->iter_seek_for_prev != NULL;
+}
+
+/**
+ * run_thread_sweep
+ * reruns the measured phase of the workload once per --thread-sweep count on the database the
+ * main run just loaded, so every point of the scaling curve sees the same dataset
+ * @param mix_enabled the mixed workload runs the concurrent mix phase
+ * @param base resource baseline of the run
+ * @param results sweep_phase, sweep_stats and sweep_count are filled
+ */
+static void run_thread_sweep(benchmark_config_t* config, storage_engine_t* engine, int mix_enabled,
+                             resource_baseline_t* base, benchmark_results_t* results)
+{
+    void* (*thread_fn)(void*) = NULL;
+    const char* phase = NULL;
+    switch (config->workload_type)
+    {
+        case WORKLOAD_WRITE:
+        case WORKLOAD_INGEST:
+            thread_fn = benchmark_put_thread;
+            phase = "PUT";
+            break;
+        case WORKLOAD_READ:
+            thread_fn = benchmark_get_thread;
+            phase = "GET";
+            break;
+        case WORKLOAD_MIXED:
+            thread_fn = mix_enabled ? benchmark_mix_thread : benchmark_get_thread;
+            phase = mix_enabled ? "MIXED" : "GET";
+            break;
+        case WORKLOAD_SEEK:
+            thread_fn = benchmark_seek_thread;
+            phase = "SEEK";
+            break;
+        case WORKLOAD_RANGE:
+            thread_fn = benchmark_range_thread;
+            phase = "RANGE";
+            break;
+        case WORKLOAD_MULTIGET:
+            thread_fn = benchmark_multiget_thread;
+            phase = "MULTIGET";
+            break;
+        case WORKLOAD_SCAN:
+            /* the forward direction unless only reverse scans were asked for */
+            if (!(config->scan_direction & SCAN_FORWARD) && !scan_reverse_supported(config, engine))
+            {
+                return;
+            }
+            thread_fn = config->scan_direction & SCAN_FORWARD ? benchmark_scan_thread
+                                                              : benchmark_reverse_scan_thread;
+            phase = config->scan_direction & SCAN_FORWARD ? "SCAN" : "SCAN_REV";
+            break;
+        case WORKLOAD_REPLAY:
+            thread_fn = benchmark_replay_thread;
+            phase = "REPLAY";
+            break;
+        default:
+            return; /* deletes would only find tombstones the second time round */
+    }
+
+    /* the mix phase adds its per-op counts to the results it is given, the sweep keeps its own */
+    benchmark_results_t* scratch = calloc(1, sizeof(benchmark_results_t));
+    if (!scratch) return;
+
+    results->sweep_phase = phase;
+    for (int i = 0; i < config->thread_sweep_count; i++)
+    {
+        benchmark_config_t point =
+            config->workload_type == WORKLOAD_SCAN ? scan_phase_config(config) : *config;
+        point.num_threads = config->thread_sweep[i];
+
+        printf("  SWEEP %s x%d: ", phase, point.num_threads);
+        fflush(stdout);
+
+        if (run_phase(&point, engine, phase, thread_fn, 0, 1, base, scratch,
+                      &results->sweep_stats[i]) != 0)
+        {
+            printf("failed\n");
+            break;
+        }
+        results->sweep_count++;
+
+        printf("%.2f ops/sec\n", results->sweep_stats[i].ops_per_second);
+    }
+    free_results(scratch);
+}
+
+/* --object-cold-cache, we drop every cached object so the next open has to fetch from the store */
+static int evict_object_cache(const benchmark_config_t* config)
+{
+    const char* cache = config->object_local_cache_path;
+    if (dataset_remove(cache) != 0 || mkdir(cache, 0755) != 0)
+    {
+        fprintf(stderr, "Failed to evict object store cache %s\n", cache);
+        return -1;
+    }
+    printf("  Evicted object store cache %s\n", cache);
+    return 0;
+}
+
+/**
+ * open_engine
+ * opens config->db_path and applies the sync mode
+ * @param cold the measured phases run on this open, a cold-cache run evicts the cache first
+ * @return 0 on success, -1 on failure
+ */
+static int open_engine(const benchmark_config_t* config, const storage_engine_ops_t* ops,
+                       int cold, storage_engine_t** engine)
+{
+    if (cold && config->object_cold_cache && evict_object_cache(config) != 0) return -1;
+
+    if (ops->open(engine, config->db_path, config) != 0)
+    {
+        fprintf(stderr, "Failed to open engine\n");
+        return -1;
+    }
+
+    /* the workload runs against the router, which spreads the keys over the families */
+    if (config->num_column_families > 1)
+    {
+        storage_engine_t* base = *engine;
+        if (cfroute_open(base, config, engine) != 0)
+        {
+            base->ops->close(base);
+            return -1;
+        }
+    }
+
+    /* we apply sync mode if supported */
+    if ((*engine)->ops->set_sync)
+    {
+        (*engine)->ops->set_sync(*engine, config->sync_enabled);
+    }
+    return 0;
+}
+
+static void compact_engine(storage_engine_t* engine, benchmark_results_t* results)
+{
+    printf("  COMPACT: ");
+    fflush(stdout);
+
+    if (!engine->ops->compact)
+    {
+        printf("not supported\n");
+        return;
+    }
+
+    double start_time = get_time_microseconds();
+    if (engine->ops->compact(engine) != 0)
+    {
+        printf("failed\n");
+        return;
+    }
+    results->compact_seconds = (get_time_microseconds() - start_time) / 1000000.0;
+    printf("%.2f seconds\n", results->compact_seconds);
+}
+
+/* we add the connector traffic of an engine about to be closed, the counters restart per open */
+static void collect_remote(storage_engine_t* engine, benchmark_results_t* results)
+{
+    remote_stats_t st;
+    if (!results->has_remote || engine->ops->remote_stats(engine, &st) != 0) return;
+
+    remote_stats_t* total = &results->remote;
+    total->gets += st.gets;
+    total->range_gets += st.range_gets;
+    total->bytes_fetched += st.bytes_fetched;
+    total->puts += st.puts;
+    total->bytes_uploaded += st.bytes_uploaded;
+    total->uploads_in_flight = st.uploads_in_flight;
+    if (st.max_uploads_in_flight > total->max_uploads_in_flight)
+    {
+        total->max_uploads_in_flight = st.max_uploads_in_flight;
+    }
+}
+
+/* block cache hits over lookups of a phase, -1 when the engine does not count them */
+static double engine_hit_rate(const engine_stats_t* es)
+{
+    int64_t lookups = es->block_cache_hits + es->block_cache_misses;
+    if (!es->valid || es->block_cache_hits < 0 || es->block_cache_misses < 0 || lookups <= 0)
+    {
+        return -1.0;
+    }
+    return (double)es->block_cache_hits / (double)lookups;
+}
+
+/* one phase of a cache sweep point, the disk reads are the process's over the phase */
+static void run_cache_phase(benchmark_config_t* point, storage_engine_t* engine, const char* phase,
+                            void* (*thread_fn)(void*), resource_baseline_t* base,
+                            benchmark_results_t* scratch, cache_sweep_phase_t* out)
+{
+    size_t read_start, read_end, written;
+    get_io_stats(&read_start, &written);
+    run_phase(point, engine, phase, thread_fn, 0, 1, base, scratch, &out->stats);
+    get_io_stats(&read_end, &written);
+    out->bytes_read = read_end - read_start;
+
+    out->hit_rate = engine_hit_rate(&out->stats.engine_stats);
+}
+
+/**
+ * run_cache_sweep
+ * reopens the loaded database once per --cache-sweep fraction with a block cache of that share
+ * of its size on disk, its pages dropped from the page cache first, and runs a GET and a RANGE
+ * phase on each. with --cgroup-headroom the process's cgroup is capped at the cache plus the
+ * headroom while a point runs, so the page cache cannot serve what the block cache misses
+ * @param engine_io the open engine, reopened as configured once the sweep is done
+ * @param base resource baseline of the run
+ * @param results cache_sweep and cache_sweep_count are filled in
+ * @return 0 on success, -1 when the database cannot be reopened
+ */
+static int run_cache_sweep(benchmark_config_t* config, storage_engine_t** engine_io,
+                           resource_baseline_t* base, benchmark_results_t* results)
+{
+    const storage_engine_ops_t* ops = get_engine_ops(config->engine_name);
+    storage_engine_t* engine = *engine_io;
+
+    memlimit_t limit;
+    int capped = config->cgroup_headroom > 0 && memlimit_open(&limit) == 0;
+    if (config->cgroup_headroom > 0 && !capped)
+    {
+        fflush(stdout);
+        fprintf(stderr, "Warning: the cgroup memory.max of this process is not writable, the "
+                        "cache sweep runs uncapped\n");
+    }
+
+    /* scratch takes the mix and per-family counts the phases would add to the results */
+    benchmark_results_t* scratch = calloc(1, sizeof(benchmark_results_t));
+    if (!scratch) return 0;
+
+    collect_remote(engine, results);
+    engine->ops->close(engine);
+    *engine_io = NULL;
+    results->cache_sweep_dataset_bytes = get_directory_size(config->db_path);
+
+    for (int i = 0; i < config->cache_sweep_count; i++)
+    {
+        cache_sweep_point_t* pt = &results->cache_sweep[i];
+        benchmark_config_t point = *config;
+        pt->fraction = config->cache_sweep[i];
+        pt->cache_bytes = (size_t)(pt->fraction * (double)results->cache_sweep_dataset_bytes);
+        if (pt->cache_bytes == 0) pt->cache_bytes = 1; /* 0 would be the engine default */
+        point.block_cache_size = pt->cache_bytes;
+
+        printf("  CACHE %.3gx (%.2f MB): ", pt->fraction, pt->cache_bytes / (1024.0 * 1024.0));
+        fflush(stdout);
+
+        if (dataset_drop_cache(config->db_path) != 0)
+        {
+            fprintf(stderr, "Warning: could not drop the page cache of %s\n", config->db_path);
+        }
+        if (capped && memlimit_set(&limit, pt->cache_bytes + config->cgroup_headroom) == 0)
+        {
+            pt->memory_limit_bytes = pt->cache_bytes + config->cgroup_headroom;
+        }
+        if (open_engine(&point, ops, 0, &engine) != 0)
+        {
+            printf("failed\n");
+            if (capped) memlimit_restore(&limit);
+            break;
+        }
+
+        run_cache_phase(&point, engine, "GET", benchmark_get_thread, base, scratch, &pt->get);
+        run_cache_phase(&point, engine, "RANGE", benchmark_range_thread, base, scratch,
+                        &pt->range);
+
+        collect_remote(engine, results);
+        engine->ops->close(engine);
+        if (capped) memlimit_restore(&limit);
+        results->cache_sweep_count++;
+
+        printf("GET %.2f ops/sec", pt->get.stats.ops_per_second);
+        if (pt->get.hit_rate >= 0.0) printf(" (hit rate %.1f%%)", pt->get.hit_rate * 100.0);
+        printf(", RANGE %.2f ops/sec\n", pt->range.stats.ops_per_second);
+    }
+    free_results(scratch);
+
+    return open_engine(config, ops, 0, engine_io);
+}
+
+int config_validate(const benchmark_config_t* config)
+{
+    if (config->num_operations <= 0LL || config->key_size <= 0 || config->value_size <= 0 ||
+        config->num_threads <= 0 || config->batch_size <= 0 || config->report_interval_ms < 0 ||
+        config->target_rate < 0.0 || config->queue_depth <= 0 || config->mem_interval_ms < 0)
+    {
+        fprintf(stderr, "Error: All numeric parameters must be positive\n");
+        return -1;
+    }
+
+    if (config->zipf_theta <= 0.0 || config->zipf_theta >= 1.0)
+    {
+        fprintf(stderr, "Error: --zipf-theta must be between 0 and 1 (exclusive)\n");
+        return -1;
+    }
+
+    if (config->hotspot_key_fraction <= 0.0 || config->hotspot_key_fraction > 1.0 ||
+        config->hotspot_op_fraction < 0.0 || config->hotspot_op_fraction > 1.0)
+    {
+        fprintf(stderr, "Error: --hotspot-keys must be in (0, 1] and --hotspot-ops in [0, 1]\n");
+        return -1;
+    }
+
+    if (config->thread_sweep_count > 0 && config->workload_type == WORKLOAD_DELETE)
+    {
+        fprintf(stderr, "Error: --thread-sweep needs a workload that can rerun, not -w delete\n");
+        return -1;
+    }
+
+    /* the cache sweep reads the keyspace the run loaded */
+    if (config->cache_sweep_count > 0 &&
+        (config->workload_type == WORKLOAD_DELETE || config->workload_type == WORKLOAD_REPLAY ||
+         config->workload_type == WORKLOAD_RECOVERY || config->phase == BENCH_PHASE_LOAD))
+    {
+        fprintf(stderr, "Error: --cache-sweep needs the loaded keyspace, not -w delete, replay, "
+                        "recovery or --phase load\n");
+        return -1;
+    }
+
+    if (config->cgroup_headroom > 0 && config->cache_sweep_count == 0)
+    {
+        fprintf(stderr, "Error: --cgroup-headroom caps the --cache-sweep points\n");
+        return -1;
+    }
+
+    if (config->queue_depth > 1 && (config->target_rate > 0.0 || config->batch_size > 1))
+    {
+        fprintf(stderr, "Error: --queue-depth issues single requests, drop -b and --target-rate\n");
+        return -1;
+    }
+
+    /* LMDB rewrites its data file in place, through a hard link it would write the snapshot */
+    if (config->snapshot_dir && config->snapshot_mode == SNAPSHOT_HARDLINK &&
+        strcmp(config->engine_name, "lmdb") == 0)
+    {
+        fprintf(stderr,
+                "Error: --snapshot-mode hardlink is unsafe for lmdb, use reflink or copy\n");
+        return -1;
+    }
+
+    /* the cache is wiped wholesale, it must not be the db directory itself */
+    if (config->object_cold_cache &&
+        (!config->object_store_backend || strcmp(config->object_store_backend, "none") == 0 ||
+         !config->object_local_cache_path ||
+         strcmp(config->object_local_cache_path, config->db_path) == 0))
+    {
+        fprintf(stderr,
+                "Error: --object-cold-cache needs --object-store and an "
+                "--object-local-cache-path other than the db path\n");
+        return -1;
+    }
+
+    if (config->profile_phase && !config->profile_cmd)
+    {
+        fprintf(stderr, "Error: --profile-phase needs --profile-cmd\n");
+        return -1;
+    }
+
+    if (config->compression_ratio <= 0.0 || config->compression_ratio > 1.0)
+    {
+        fprintf(stderr, "Error: --compression-ratio must be in (0, 1]\n");
+        return -1;
+    }
+
+    if (config->value_size_min < 0 || config->value_size_max < 0 || config->value_size_stddev < 0 ||
+        (config->value_size_min > 0 && config->value_size_max > 0 &&
+         config->value_size_min > config->value_size_max))
+    {
+        fprintf(stderr, "Error: --value-size-min must not exceed --value-size-max\n");
+        return -1;
+    }
+
+    if (config->latency_sample <= 0)
+    {
+        fprintf(stderr, "Error: --latency-sample must be positive\n");
+        return -1;
+    }
+
+    if (config->latency_sample > 1 && config->target_rate > 0.0)
+    {
+        fprintf(stderr, "Error: --latency-sample cannot be combined with --target-rate\n");
+        return -1;
+    }
+
+    if (config->workload_type == WORKLOAD_REPLAY &&
+        (!config->trace_file || config->replay_speed < 0.0))
+    {
+        fprintf(stderr, "Error: -w replay needs --trace and a --replay-speed of at least 0\n");
+        return -1;
+    }
+
+    if (config->workload_type == WORKLOAD_REPLAY &&
+        (config->queue_depth > 1 || config->batch_size > 1))
+    {
+        fprintf(stderr, "Error: -w replay issues the trace's ops one by one, drop -b and "
+                        "--queue-depth\n");
+        return -1;
+    }
+
+    if (config->replay_speed > 0.0 && (config->target_rate > 0.0 || config->latency_sample > 1))
+    {
+        fprintf(stderr, "Error: --replay-speed paces the ops, drop --target-rate and "
+                        "--latency-sample\n");
+        return -1;
+    }
+
+    /* the recovery workload forks its own writer into a fresh database, one load per run */
+    if (config->workload_type == WORKLOAD_RECOVERY &&
+        (config->phase != BENCH_PHASE_ALL || config->reuse_db || config->duration_sec > 0.0 ||
+         config->warmup_sec > 0.0 || config->thread_sweep_count > 0 || config->queue_depth > 1))
+    {
+        fprintf(stderr, "Error: -w recovery runs its own load, drop --phase, --reuse-db, "
+                        "--duration, --warmup, --thread-sweep and --queue-depth\n");
+        return -1;
+    }
+
+    if (config->recovery_unflushed > config->num_operations)
+    {
+        fprintf(stderr, "Error: --recovery-unflushed cannot exceed -o\n");
+        return -1;
+    }
+
+    if (config->workload_type == WORKLOAD_SCAN && config->scan_min < 1)
+    {
+        fprintf(stderr, "Error: -w scan needs a --range-size or --scan-length of at least 1\n");
+        return -1;
+    }
+    if (config->workload_type == WORKLOAD_SCAN && config->num_column_families > 1 &&
+        config->scan_unbounded)
+    {
+        fprintf(stderr, "Error: --scan-unbounded stays in one column family, drop it or "
+                        "--column-families\n");
+        return -1;
+    }
+
+    if (config->mem_timeline_file && config->mem_interval_ms == 0)
+    {
+        fprintf(stderr, "Error: --mem-timeline needs a --mem-interval above 0\n");
+        return -1;
+    }
+
+    if (config->num_column_families > 1 && config->queue_depth > 1)
+    {
+        fprintf(stderr, "Error: --column-families attributes every op in the worker thread, "
+                        "drop --queue-depth\n");
+        return -1;
+    }
+
+    /* LMDB has one writer per environment, a family's batch or bulk txn would wait on another's */
+    if (config->num_column_families > 1 && strcmp(config->engine_name, "lmdb") == 0 &&
+        (config->batch_size > 1 || config->workload_type == WORKLOAD_INGEST))
+    {
+        fprintf(stderr, "Error: -e lmdb with --column-families writes one key at a time, drop -b "
+                        "and -w ingest\n");
+        return -1;
+    }
+
+    if (config->steady_window < 2 || config->steady_window > REPORTER_MAX_STEADY_WINDOW ||
+        config->steady_cv <= 0.0)
+    {
+        fprintf(stderr, "Error: --steady-window must be in [2, %d] and --steady-cv positive\n",
+                REPORTER_MAX_STEADY_WINDOW);
+        return -1;
+    }
+    return 0;
+}
+
+int workload_needs_dataset(const benchmark_config_t* config)
+{
+    int mix_enabled = 0;
+    if (config->workload_type == WORKLOAD_MIXED)
+    {
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if (config->mix_weights[op] > 0) mix_enabled = 1;
+        }
+    }
+    return config->workload_type == WORKLOAD_READ || config->workload_type == WORKLOAD_DELETE ||
+           config->workload_type == WORKLOAD_SEEK || config->workload_type == WORKLOAD_RANGE ||
+           config->workload_type == WORKLOAD_MULTIGET || config->workload_type == WORKLOAD_SCAN ||
+           mix_enabled;
+}
+
+/**
+ * load_dataset
+ * loads every key the run phases can ask for exactly once, closed-loop, and optionally compacts
+ * @param base resource baseline of the run
+ * @param results put_stats and the logical byte counts are filled in
+ */
+static void load_dataset(benchmark_config_t* config, storage_engine_t* engine,
+                         resource_baseline_t* base, benchmark_results_t* results)
+{
+    printf("  LOAD: ");
+    fflush(stdout);
+
+    benchmark_config_t load_config = *config;
+    load_config.key_pattern = dataset_load_pattern(config);
+
+    run_phase(&load_config, engine, "LOAD", benchmark_put_thread, 0, 0, base, results,
+              &results->put_stats);
+
+    size_t data_size = (size_t)config->num_operations * entry_bytes(config);
+    results->total_bytes_written += data_size;
+    results->net_logical_data_size += data_size;
+
+    printf("%.2f ops/sec\n", results->put_stats.ops_per_second);
+
+    if (config->compact_after_load) compact_engine(engine, results);
+}
+
+/* we mark the closed database as loaded and snapshot it when asked */
+static int finish_load(const benchmark_config_t* config)
+{
+    if (dataset_mark_loaded(config) != 0)
+    {
+        fprintf(stderr, "Warning: could not write the load marker for %s\n", config->db_path);
+    }
+    if (!config->snapshot_dir) return 0;
+
+    printf("  SNAPSHOT: ");
+    fflush(stdout);
+    double start_time = get_time_microseconds();
+    if (dataset_snapshot(config) != 0)
+    {
+        printf("failed\n");
+        fprintf(stderr, "Failed to snapshot %s to %s\n", config->db_path, config->snapshot_dir);
+        return -1;
+    }
+    printf("%s in %.2f seconds\n", config->snapshot_dir,
+           (get_time_microseconds() - start_time) / 1000000.0);
+    return 0;
+}
+
+/**
+ * run_ingest
+ * bulk loads the sorted keyspace into a sibling database <db_path>_ingest, then measures the io
+ * and on-disk size of that database alone, so it compares with the PUT path of the main run
+ * @param ops engine ops
+ * @param results ingest_stats and ingest_resources are filled in
+ */
+static void run_ingest(const benchmark_config_t* config, const storage_engine_ops_t* ops,
+                       benchmark_results_t* results)
+{
+    printf("  INGEST: ");
+    fflush(stdout);
+
+    if (!ops->bulk_begin || !ops->bulk_add || !ops->bulk_finish)
+    {
+        printf("not supported by engine\n");
+        return;
+    }
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s_ingest", config->db_path);
+    dataset_remove(path);
+
+    /* bulk loads are single writer, sorted input */
+    benchmark_config_t ingest_config = *config;
+    ingest_config.mem_interval_ms = 0; /* the main run's sampler already covered the peak */
+    ingest_config.db_path = path;
+    ingest_config.num_threads = 1;
+    ingest_config.key_pattern = KEY_PATTERN_SEQUENTIAL;
+    ingest_config.cpu_affinity = AFFINITY_NONE;
+
+    storage_engine_t* engine = NULL;
+    if (open_engine(&ingest_config, ops, 0, &engine) != 0)
+    {
+        printf("failed\n");
+        return;
+    }
+
+    resource_baseline_t base = {0};
+    operation_stats_t* st = &results->ingest_stats;
+    int rc = run_phase(&ingest_config, engine, "INGEST", benchmark_ingest_thread, 0, 0, &base,
+                       results, st);
+
+    /* io is counted before the close and the size after it, as for the main run */
+    size_t final_io_read, final_io_write;
+    double final_cpu_user, final_cpu_system;
+    io_end_t io_end;
+    get_io_stats(&final_io_read, &final_io_write);
+    get_cpu_stats(&final_cpu_user, &final_cpu_system);
+    capture_io_end(path, &io_end);
+    engine->ops->close(engine);
+
+    if (rc != 0 || st->thread_ops_max < config->num_operations)
+    {
+        printf("failed\n");
+        memset(st, 0, sizeof(*st));
+        dataset_remove(path);
+        return;
+    }
+
+    resource_stats_t* res = &results->ingest_resources;
+    size_t logical = (size_t)config->num_operations * entry_bytes(config);
+    res->peak_rss_bytes = results->resources.peak_rss_bytes;
+    res->peak_vms_bytes = results->resources.peak_vms_bytes;
+    res->bytes_read = final_io_read - base.io_read;
+    res->bytes_written = final_io_write - base.io_write;
+    res->cpu_user_time = final_cpu_user - base.cpu_user;
+    res->cpu_system_time = final_cpu_system - base.cpu_system;
+    res->cpu_percent = (res->cpu_user_time + res->cpu_system_time) / st->duration_seconds * 100.0;
+    res->storage_size_bytes = get_directory_size(path);
+    if (res->bytes_written > 0)
+    {
+        res->write_amplification = (double)res->bytes_written / (double)logical;
+    }
+    if (res->storage_size_bytes > 0)
+    {
+        res->space_amplification = (double)res->storage_size_bytes / (double)logical;
+    }
+    finish_device_io(&base, &io_end, res, logical, 0);
+    dataset_remove(path);
+
+    /* the single worker runs dry once the stream is added, the rest of the phase is the ingest */
+    printf("%.2f ops/sec (ingest step %.2f ms)\n", st->ops_per_second, st->thread_idle_max_ms);
+}
+
+/* -w recovery, state the forked writer shares with the parent through an anonymous mapping */
+enum
+{
+    RECOVERY_WRITING,
+    RECOVERY_READY, /* num_operations keys are acknowledged, the parent may kill the writer */
+    RECOVERY_FAILED
+};
+
+typedef struct
+{
+    atomic_int state;
+    atomic_int_fast64_t acked;      /* keys whose put or batch commit returned */
+    atomic_int_fast64_t flushed_at; /* keys written before the flush, -1 when none ran */
+    double start_us;                /* written before the writer publishes READY */
+} recovery_shared_t;
+
+/**
+ * recovery_writer
+ * writes keys 0.. in order from the forked child and publishes every acknowledgement. past
+ * num_operations it keeps writing until the parent kills it, so the kill lands mid-write
+ * @param shared the mapping, the writer never returns
+ */
+static void recovery_writer(const benchmark_config_t* config, const storage_engine_ops_t* ops,
+                            recovery_shared_t* shared)
+{
+    storage_engine_t* engine = NULL;
+    keygen_t kg;
+    int64_t n = config->num_operations;
+    int64_t flush_at = config->recovery_unflushed >= 0 && config->recovery_unflushed < n
+                           ? n - config->recovery_unflushed
+                           : -1;
+
+    if (open_engine(config, ops, 0, &engine) != 0 || keygen_init(&kg, config, 1) != 0)
+    {
+        atomic_store(&shared->state, RECOVERY_FAILED);
+        _exit(1);
+    }
+    int batch = config->batch_size > 1 && engine->ops->batch_begin ? config->batch_size : 1;
+    uint8_t* keys = malloc((size_t)batch * config->key_size);
+    if (!keys)
+    {
+        atomic_store(&shared->state, RECOVERY_FAILED);
+        _exit(1);
+    }
+
+    shared->start_us = get_time_microseconds();
+    for (int64_t i = 0; i < 2 * n; i += batch)
+    {
+        int64_t count = 2 * n - i < batch ? 2 * n - i : batch;
+        int rc = 0;
+        if (batch > 1)
+        {
+            void* batch_ctx = NULL;
+            rc = engine->ops->batch_begin(engine, &batch_ctx);
+            for (int64_t j = 0; rc == 0 && j < count; j++)
+            {
+                uint8_t* key = keys + j * config->key_size;
+                size_t value_size;
+                const uint8_t* value = value_pool_get(config->value_pool, i + j, &value_size);
+                keygen_format_index(&kg, key, i + j);
+                rc = engine->ops->batch_put(batch_ctx, engine, key, config->key_size, value,
+                                            value_size);
+            }
+            if (batch_ctx && engine->ops->batch_commit(batch_ctx) != 0) rc = -1;
+        }
+        else
+        {
+            size_t value_size;
+            const uint8_t* value = value_pool_get(config->value_pool, i, &value_size);
+            keygen_format_index(&kg, keys, i);
+            rc = engine->ops->put(engine, keys, config->key_size, value, value_size);
+        }
+        if (rc != 0)
+        {
+            fprintf(stderr, "Recovery writer failed at key %" PRId64 "\n", i);
+            atomic_store(&shared->state, RECOVERY_FAILED);
+            _exit(1);
+        }
+
+        atomic_store(&shared->acked, i + count);
+
+        /* we flush once so the tail of the load is all that lives in the log alone */
+        if (flush_at >= 0 && i + count >= flush_at)
+        {
+            if (engine->ops->compact && engine->ops->compact(engine) == 0)
+            {
+                atomic_store(&shared->flushed_at, i + count);
+            }
+            flush_at = -1;
+        }
+        if (i + count >= n && atomic_load(&shared->state) == RECOVERY_WRITING)
+        {
+            atomic_store(&shared->state, RECOVERY_READY);
+        }
+    }
+
+    /* the writer only stops on the kill */
+    for (;;) pause();
+}
+
+/* we time an open of db_path with the sync mode applied */
+static int timed_open(const benchmark_config_t* config, const storage_engine_ops_t* ops,
+                      storage_engine_t** engine, double* open_ms)
+{
+    double start_time = get_time_microseconds();
+    if (open_engine(config, ops, 0, engine) != 0) return -1;
+    *open_ms = (get_time_microseconds() - start_time) / 1000.0;
+    return 0;
+}
+
+/**
+ * verify_recovered
+ * reads every acknowledged key and the in-flight batch after it, the lookups are timed into
+ * results->get_stats
+ * @param engine the reopened database
+ * @param rec found, lost, corrupt and unacked_found are filled in
+ * @return 0 on success, -1 on allocation failure
+ */
+static int verify_recovered(const benchmark_config_t* config, storage_engine_t* engine,
+                            benchmark_results_t* results, recovery_stats_t* rec)
+{
+    keygen_t kg;
+    histogram_t* hist = calloc(1, sizeof(histogram_t));
+    uint8_t* key = malloc(config->key_size);
+    if (!hist || !key || keygen_init(&kg, config, 1) != 0)
+    {
+        free(hist);
+        free(key);
+        return -1;
+    }
+
+    int64_t in_flight = config->batch_size > 1 ? config->batch_size : 1;
+    int64_t span = rec->acked + in_flight;
+    double start_time = get_time_microseconds();
+
+    /* the first lookup is the one a restarted application waits on */
+    keygen_format_index(&kg, key, rec->acked - 1);
+    uint8_t* value = NULL;
+    size_t value_size = 0;
+    engine->ops->get(engine, key, config->key_size, &value, &value_size);
+    rec->first_get_us = get_time_microseconds() - start_time;
+    free(value);
+
+    start_time = get_time_microseconds();
+    for (int64_t i = 0; i < span; i++)
+    {
+        keygen_format_index(&kg, key, i);
+        value = NULL;
+        value_size = 0;
+        double op_start = get_time_microseconds();
+        int rc = engine->ops->get(engine, key, config->key_size, &value, &value_size);
+        double elapsed_ns = (get_time_microseconds() - op_start) * 1000.0;
+        histogram_record_n(hist, elapsed_ns > 0.0 ? (uint64_t)elapsed_ns : 0, 1);
+
+        int present = rc == 0 && value != NULL;
+        if (i >= rec->acked)
+        {
+            if (present) rec->unacked_found++;
+        }
+        else if (!present)
+        {
+            rec->lost++;
+        }
+        else
+        {
+            /* a family value size truncates the drawn value, so we compare the common prefix */
+            size_t expect_size;
+            const uint8_t* expect = value_pool_get(config->value_pool, i, &expect_size);
+            size_t n = value_size < expect_size ? value_size : expect_size;
+            if (n == 0 || memcmp(value, expect, n) != 0)
+            {
+                rec->corrupt++;
+            }
+            else
+            {
+                rec->found++;
+            }
+        }
+        free(value);
+    }
+
+    operation_stats_t* st = &results->get_stats;
+    memset(st, 0, sizeof(*st));
+    calculate_stats(hist, st);
+    keep_histogram(config, results, st, hist);
+    st->duration_seconds = (get_time_microseconds() - start_time) / 1000000.0;
+    st->ops_per_second = st->duration_seconds > 0 ? span / st->duration_seconds : 0;
+
+    keygen_free(&kg);
+    free(key);
+    free(hist);
+    return 0;
+}
+
+/**
+ * run_recovery
+ * -w recovery. a forked writer loads db_path until num_operations puts are acknowledged and is
+ * killed with SIGKILL mid-write, then the parent times the reopen and the first lookup, checks
+ * every acknowledged key and times a clean close and reopen of the recovered database
+ * @param ops engine ops
+ * @param results recovery and get_stats are filled in
+ * @return 0 on success, -1 on failure
+ */
+static int run_recovery(benchmark_config_t* config, const storage_engine_ops_t* ops,
+                        benchmark_results_t* results)
+{
+    recovery_stats_t* rec = &results->recovery;
+
+    dataset_forget(config);
+    dataset_remove(config->db_path);
+
+    recovery_shared_t* shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map the recovery writer state\n");
+        return -1;
+    }
+    atomic_init(&shared->state, RECOVERY_WRITING);
+    atomic_init(&shared->acked, 0);
+    atomic_init(&shared->flushed_at, -1);
+
+    printf("  LOAD (writer process): ");
+    fflush(stdout);
+    fflush(stderr);
+
+    double start_time = get_time_microseconds();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        printf("failed\n");
+        fprintf(stderr, "Failed to fork the recovery writer\n");
+        munmap(shared, sizeof(*shared));
+        return -1;
+    }
+    if (pid == 0) recovery_writer(config, ops, shared);
+
+    /* we kill the writer as soon as the load is acknowledged, it is writing the next keys */
+    int status = 0;
+    int exited = 0;
+    while (atomic_load(&shared->state) == RECOVERY_WRITING)
+    {
+        if (waitpid(pid, &status, WNOHANG) == pid)
+        {
+            exited = 1;
+            break;
+        }
+        usleep(100);
+    }
+    if (!exited)
+    {
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+    }
+    double kill_us = get_time_microseconds();
+
+    int ready = atomic_load(&shared->state) == RECOVERY_READY;
+    int64_t flushed_at = atomic_load(&shared->flushed_at);
+    if (shared->start_us > start_time) start_time = shared->start_us;
+    rec->acked = atomic_load(&shared->acked);
+    munmap(shared, sizeof(*shared));
+    if (!ready)
+    {
+        printf("failed\n");
+        fprintf(stderr, "The recovery writer died after %" PRId64 " of %" PRId64 " keys\n",
+                rec->acked, config->num_operations);
+        return -1;
+    }
+
+    rec->unflushed_keys = flushed_at >= 0 ? rec->acked - flushed_at : rec->acked;
+    rec->load_ops_per_sec = rec->acked / ((kill_us - start_time) / 1000000.0);
+    size_t data_size = (size_t)rec->acked * entry_bytes(config);
+    results->total_bytes_written = data_size;
+    results->net_logical_data_size = data_size;
+    printf("%.2f ops/sec, killed after %" PRId64 " acknowledged keys\n", rec->load_ops_per_sec,
+           rec->acked);
+
+    printf("  REOPEN: ");
+    fflush(stdout);
+    storage_engine_t* engine = NULL;
+    if (timed_open(config, ops, &engine, &rec->open_ms) != 0)
+    {
+        printf("failed\n");
+        return -1;
+    }
+    if (verify_recovered(config, engine, results, rec) != 0)
+    {
+        printf("failed\n");
+        engine->ops->close(engine);
+        return -1;
+    }
+    printf("%.2f ms, first GET %.2f μs, %" PRId64 " lost, %" PRId64 " corrupt\n", rec->open_ms,
+           rec->first_get_us, rec->lost, rec->corrupt);
+
+    printf("  CLEAN REOPEN: ");
+    fflush(stdout);
+    double close_start = get_time_microseconds();
+    engine->ops->close(engine);
+    rec->close_ms = (get_time_microseconds() - close_start) / 1000.0;
+    if (timed_open(config, ops, &engine, &rec->clean_open_ms) != 0)
+    {
+        printf("failed\n");
+        return -1;
+    }
+    engine->ops->close(engine);
+    printf("close %.2f ms, open %.2f ms\n", rec->close_ms, rec->clean_open_ms);
+
+    resource_stats_t* res = &results->resources;
+    res->storage_size_bytes = get_directory_size(config->db_path);
+    if (res->storage_size_bytes > 0)
+    {
+        res->space_amplification = (double)res->storage_size_bytes / (double)data_size;
+    }
+    rec->valid = 1;
+    return 0;
+}
+
+/* the order of the engines' default comparators, memcmp with the shorter key first on a tie */
+static int key_order(const uint8_t* a, size_t a_size, const uint8_t* b, size_t b_size)
+{
+    size_t n = a_size < b_size ? a_size : b_size;
+    int c = n > 0 ? memcmp(a, b, n) : 0;
+    if (c != 0) return c;
+    return a_size < b_size ? -1 : (a_size > b_size ? 1 : 0);
+}
+
+typedef struct
+{
+    uint8_t* key;
+    size_t size;
+} split_key_t;
+
+static int split_key_cmp(const void* a, const void* b)
+{
+    const split_key_t* x = (const split_key_t*)a;
+    const split_key_t* y = (const split_key_t*)b;
+    return key_order(x->key, x->size, y->key, y->size);
+}
+
+/* samples per range the sampled split keys are picked from */
+#define ITER_SAMPLES_PER_RANGE 64
+
+/**
+ * sample_split_keys
+ * draws keys uniformly from the keyspace in the layout the run loaded it with, sorts them and
+ * keeps every ITER_SAMPLES_PER_RANGE-th as a boundary
+ * @param splits receives up to ranges - 1 ascending keys, malloc'd
+ * @return number of keys filled, -1 on allocation failure
+ */
+static int sample_split_keys(const benchmark_config_t* config, int ranges, split_key_t* splits)
+{
+    /* skewed patterns and scans load the sequential layout, keygen_format_index follows it */
+    benchmark_config_t layout =
+        config->workload_type == WORKLOAD_SCAN ? scan_phase_config(config) : *config;
+    keygen_t kg;
+    if (keygen_init(&kg, &layout, 0x5eed) != 0) return -1;
+
+    int samples = ranges * ITER_SAMPLES_PER_RANGE;
+    size_t key_size = (size_t)config->key_size;
+    split_key_t* drawn = malloc((size_t)samples * sizeof(split_key_t));
+    uint8_t* keys = malloc((size_t)samples * key_size);
+    if (!drawn || !keys)
+    {
+        free(drawn);
+        free(keys);
+        keygen_free(&kg);
+        return -1;
+    }
+    for (int i = 0; i < samples; i++)
+    {
+        drawn[i].key = keys + (size_t)i * key_size;
+        drawn[i].size = key_size;
+        keygen_format_index(&kg, drawn[i].key,
+                            (int64_t)(keygen_rand(&kg) % (uint64_t)config->num_operations));
+    }
+    qsort(drawn, (size_t)samples, sizeof(split_key_t), split_key_cmp);
+
+    int count = 0;
+    for (int r = 1; r < ranges; r++)
+    {
+        const split_key_t* s = &drawn[r * ITER_SAMPLES_PER_RANGE];
+        if (count > 0 && split_key_cmp(s, &splits[count - 1]) == 0) continue;
+        splits[count].key = malloc(key_size);
+        if (!splits[count].key) break;
+        memcpy(splits[count].key, s->key, key_size);
+        splits[count++].size = key_size;
+    }
+
+    free(keys);
+    free(drawn);
+    keygen_free(&kg);
+    return count;
+}
+
+typedef struct
+{
+    storage_engine_t* engine;
+    size_t readahead;
+    const split_key_t* splits; /* ranges + 1 keys, range r is [splits[r], splits[r + 1]) */
+    int ranges;
+    atomic_int next_range;
+    uint64_t* range_keys;
+    uint64_t* range_bytes;
+    double* range_sec;
+} iter_scan_t;
+
+/* we walk the ranges claimed from next_range, one iterator per worker */
+static void* iter_scan_worker(void* arg)
+{
+    iter_scan_t* scan = (iter_scan_t*)arg;
+    const storage_engine_ops_t* ops = scan->engine->ops;
+
+    void* iter = NULL;
+    int rc = scan->readahead > 0 && ops->iter_new_opts
+                 ? ops->iter_new_opts(scan->engine, scan->readahead, &iter)
+                 : ops->iter_new(scan->engine, &iter);
+    if (rc != 0) return NULL;
+
+    int r;
+    while ((r = atomic_fetch_add(&scan->next_range, 1)) < scan->ranges)
+    {
+        const split_key_t* lower = &scan->splits[r];
+        const split_key_t* upper = &scan->splits[r + 1];
+        /* with bounds the engine stops at the end of the range, the column-family router only
+         * covers a range of every family this way. without them we seek and compare each key,
+         * the first range starts at the first key and the last one runs to the end */
+        int bounded = ops->iter_seek_bounded != NULL;
+        int last = r == scan->ranges - 1;
+        double start = get_time_microseconds();
+
+        if (bounded)
+        {
+            ops->iter_seek_bounded(iter, lower->key, lower->size, upper->key, upper->size, 0);
+        }
+        else if (r > 0)
+        {
+            ops->iter_seek(iter, lower->key, lower->size);
+        }
+        else
+        {
+            ops->iter_seek_to_first(iter);
+        }
+
+        uint64_t keys = 0;
+        uint64_t bytes = 0;
+        while (ops->iter_valid(iter))
+        {
+            uint8_t *key = NULL, *value = NULL;
+            size_t key_size = 0, value_size = 0;
+            if (iter_entry_of(ops, iter, &key, &key_size, &value, &value_size) != 0) break;
+            if (!bounded && !last && key_order(key, key_size, upper->key, upper->size) >= 0)
+            {
+                break;
+            }
+            keys++;
+            bytes += key_size + value_size;
+            ops->iter_next(iter);
+        }
+
+        scan->range_sec[r] = (get_time_microseconds() - start) / 1000000.0;
+        scan->range_keys[r] = keys;
+        scan->range_bytes[r] = bytes;
+    }
+
+    ops->iter_free(iter);
+    return NULL;
+}
+
+/**
+ * run_parallel_iteration
+ * splits the keyspace into config->iter_ranges ranges and scans them on up to -t threads
+ * @param out keys, bytes and the per-range skew, the duration is returned
+ * @return wall time of the scan in seconds, -1 on failure
+ */
+static double run_parallel_iteration(const benchmark_config_t* config, storage_engine_t* engine,
+                                     iter_scan_stats_t* out)
+{
+    int ranges = config->iter_ranges;
+    /* an upper bound past every key, as long as the column-family router never pads it */
+    uint8_t end_key[CFROUTE_MAX_KEY_SIZE];
+    memset(end_key, 0xff, sizeof(end_key));
+
+    /* splits[0] is the empty key and the last entry end_key, the boundaries go in between */
+    split_key_t* splits = calloc((size_t)ranges + 1, sizeof(split_key_t));
+    uint8_t** engine_keys = calloc((size_t)ranges, sizeof(uint8_t*));
+    size_t* engine_sizes = calloc((size_t)ranges, sizeof(size_t));
+    if (!splits || !engine_keys || !engine_sizes)
+    {
+        free(splits);
+        free(engine_keys);
+        free(engine_sizes);
+        return -1.0;
+    }
+
+    int count = -1;
+    if (config->iter_splits != ITER_SPLITS_SAMPLE && engine->ops->split_keys)
+    {
+        count = engine->ops->split_keys(engine, ranges, engine_keys, engine_sizes);
+        for (int i = 0; i < count; i++)
+        {
+            splits[i + 1].key = engine_keys[i];
+            splits[i + 1].size = engine_sizes[i];
+        }
+        if (count > 0) out->splits = "engine";
+    }
+    if (count <= 0)
+    {
+        count = sample_split_keys(config, ranges, splits + 1);
+        out->splits = "sampled";
+    }
+    free(engine_keys);
+    free(engine_sizes);
+    if (count < 0)
+    {
+        free(splits);
+        return -1.0;
+    }
+    splits[0].key = end_key; /* size 0, the key itself is never read */
+    splits[count + 1].key = end_key;
+    splits[count + 1].size = sizeof(end_key);
+
+    iter_scan_t scan = {.engine = engine,
+                        .readahead = config->scan_readahead,
+                        .splits = splits,
+                        .ranges = count + 1};
+    atomic_init(&scan.next_range, 0);
+    scan.range_keys = calloc((size_t)scan.ranges, sizeof(uint64_t));
+    scan.range_bytes = calloc((size_t)scan.ranges, sizeof(uint64_t));
+    scan.range_sec = calloc((size_t)scan.ranges, sizeof(double));
+    int threads = config->num_threads < scan.ranges ? config->num_threads : scan.ranges;
+    pthread_t* workers = calloc((size_t)threads, sizeof(pthread_t));
+
+    double elapsed = -1.0;
+    if (scan.range_keys && scan.range_bytes && scan.range_sec && workers)
+    {
+        double start = get_time_microseconds();
+        int started = 0;
+        while (started < threads &&
+               pthread_create(&workers[started], NULL, iter_scan_worker, &scan) == 0)
+        {
+            started++;
+        }
+        for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+        elapsed = started > 0 ? (get_time_microseconds() - start) / 1000000.0 : -1.0;
+
+        out->ranges = scan.ranges;
+        out->threads = started;
+        out->range_keys_min = UINT64_MAX;
+        for (int r = 0; r < scan.ranges; r++)
+        {
+            out->keys += scan.range_keys[r];
+            out->bytes += scan.range_bytes[r];
+            if (scan.range_keys[r] < out->range_keys_min) out->range_keys_min = scan.range_keys[r];
+            if (scan.range_keys[r] > out->range_keys_max) out->range_keys_max = scan.range_keys[r];
+            out->range_sec_mean += scan.range_sec[r] / scan.ranges;
+            if (scan.range_sec[r] > out->range_sec_max) out->range_sec_max = scan.range_sec[r];
+        }
+    }
+
+    for (int i = 1; i <= count; i++) free(splits[i].key);
+    free(splits);
+    free(scan.range_keys);
+    free(scan.range_bytes);
+    free(scan.range_sec);
+    free(workers);
+    return elapsed;
+}
+
+/**
+ * run_iteration
+ * the final ITER pass over everything the run left, a single walk from the first key, or the
+ * parallel range scan of --iter-ranges
+ * @param results iteration_stats and iter_scan are filled
+ */
+static void run_iteration(const benchmark_config_t* config, storage_engine_t* engine,
+                          benchmark_results_t* results)
+{
+    iter_scan_stats_t* out = &results->iter_scan;
+    printf("  ITER: ");
+    fflush(stdout);
+
+    engine_stats_t engine_start;
+    sample_engine_stats(engine, &engine_start);
+    double elapsed = -1.0;
+
+    if (config->iter_ranges > 1)
+    {
+        elapsed = run_parallel_iteration(config, engine, out);
+    }
+    else
+    {
+        void* iter = NULL;
+        int rc = config->scan_readahead > 0 && engine->ops->iter_new_opts
+                     ? engine->ops->iter_new_opts(engine, config->scan_readahead, &iter)
+                     : engine->ops->iter_new(engine, &iter);
+        if (rc == 0)
+        {
+            double start_time = get_time_microseconds();
+            engine->ops->iter_seek_to_first(iter);
+            while (engine->ops->iter_valid(iter))
+            {
+                out->bytes += read_iter_entry(engine->ops, iter);
+                engine->ops->iter_next(iter);
+                out->keys++;
+            }
+            elapsed = (get_time_microseconds() - start_time) / 1000000.0;
+            engine->ops->iter_free(iter);
+            out->ranges = 1;
+            out->threads = 1;
+        }
+    }
+
+    if (elapsed < 0.0)
+    {
+        printf("not supported\n");
+        return;
+    }
+
+    operation_stats_t* st = &results->iteration_stats;
+    st->duration_seconds = elapsed;
+    if (out->keys > 0 && elapsed > 0.0) st->ops_per_second = out->keys / elapsed;
+    sample_engine_stats(engine, &st->engine_stats);
+    engine_stats_delta(&st->engine_stats, &engine_start);
+
+    printf("%.2f ops/sec (%" PRIu64 " keys", st->ops_per_second, out->keys);
+    if (out->ranges > 1)
+    {
+        printf(" in %d %s ranges on %d threads", out->ranges, out->splits, out->threads);
+    }
+    printf(")\n");
+}
+
+/**
+ * run_workload
+ * runs the measured phases of the configured workload, then the full iteration pass
+ * @param mix_enabled the mixed workload runs the concurrent mix phase
+ * @param preloaded db_path already holds the dataset, the mix preload is skipped
+ * @param base resource baseline of the run
+ * @param results phase stats are filled in
+ * @param engine_io the open engine, a cold-cache run reopens it between the PUT and read phases
+ * @return 0 on success, -1 when the engine could not be reopened (*engine_io is then NULL)
+ */
+static int run_workload(benchmark_config_t* config, storage_engine_t** engine_io, int mix_enabled,
+                        int preloaded, resource_baseline_t* base, benchmark_results_t** results)
+{
+    storage_engine_t* engine = *engine_io;
+
+    if (config->workload_type == WORKLOAD_WRITE || config->workload_type == WORKLOAD_INGEST ||
+        (config->workload_type == WORKLOAD_MIXED && !(mix_enabled && preloaded)))
+    {
+        printf("  PUT: ");
+        fflush(stdout);
+
+        /* a mix preload fills the whole keyspace, skewed patterns only shape the mixed phase */
+        benchmark_config_t load_config = *config;
+        if (mix_enabled && keygen_pattern_is_skewed(config->key_pattern))
+        {
+            load_config.key_pattern = KEY_PATTERN_SEQUENTIAL;
+        }
+
+        /* the PUT path of -w ingest writes the sorted stream the bulk load gets */
+        if (config->workload_type == WORKLOAD_INGEST)
+        {
+            load_config.key_pattern = KEY_PATTERN_SEQUENTIAL;
+        }
+
+        run_phase(&load_config, engine, "PUT", benchmark_put_thread, 0, !mix_enabled, base,
+                  *results, &(*results)->put_stats);
+
+        /* a --duration phase wraps over the keyspace, the rewrites add no new data */
+        int64_t put_ops = (*results)->put_stats.ops_total;
+        int64_t put_keys = put_ops < config->num_operations ? put_ops : config->num_operations;
+        (*results)->total_bytes_written += (size_t)put_ops * entry_bytes(config);
+        (*results)->net_logical_data_size += (size_t)put_keys * entry_bytes(config);
+
+        printf("%.2f ops/sec\n", (*results)->put_stats.ops_per_second);
+    }
+
+    if (mix_enabled && !preloaded && config->compact_after_load)
+    {
+        compact_engine(engine, *results);
+    }
+
+    /* the reads of -w mixed run on what the PUT phase just wrote, cold means through the store */
+    if (config->object_cold_cache && config->workload_type == WORKLOAD_MIXED &&
+        !(mix_enabled && preloaded))
+    {
+        const storage_engine_ops_t* ops = get_engine_ops(config->engine_name);
+        collect_remote(engine, *results);
+        engine->ops->close(engine);
+        *engine_io = NULL;
+        if (open_engine(config, ops, 1, engine_io) != 0) return -1;
+        engine = *engine_io;
+    }
+
+    if (config->workload_type == WORKLOAD_READ ||
+        (config->workload_type == WORKLOAD_MIXED && !mix_enabled))
+    {
+        printf("  GET: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "GET", benchmark_get_thread, 0, 1, base, *results,
+                  &(*results)->get_stats);
+
+        (*results)->total_bytes_read =
+            (size_t)(*results)->get_stats.ops_total * entry_bytes(config);
+
+        printf("%.2f ops/sec\n", (*results)->get_stats.ops_per_second);
+    }
+
+    if (mix_enabled)
+    {
+        printf("  MIXED: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "MIXED", benchmark_mix_thread, 0, 1, base, *results,
+                  &(*results)->mix_stats);
+
+        /* the op counts cover the measured window, we scale them up to the warmup included */
+        const int64_t* counts = (*results)->mix_op_counts;
+        int64_t measured = 0;
+        for (int op = 0; op < MIX_OP_COUNT; op++) measured += counts[op];
+        double share = measured > 0 ? (double)(*results)->mix_stats.ops_total / measured : 1.0;
+        size_t entry_size = (size_t)(entry_bytes(config) * share);
+        size_t written = (size_t)(counts[MIX_OP_PUT] + counts[MIX_OP_RMW] + counts[MIX_OP_INSERT] +
+                                  counts[MIX_OP_DELETE]) *
+                         entry_size;
+        size_t removed = (size_t)counts[MIX_OP_DELETE] * entry_size;
+        (*results)->total_bytes_written += written;
+        (*results)->total_bytes_read +=
+            (size_t)(counts[MIX_OP_GET] + counts[MIX_OP_RMW]) * entry_size +
+            (size_t)counts[MIX_OP_RANGE] * config->range_size * entry_size;
+        (*results)->net_logical_data_size += (size_t)counts[MIX_OP_INSERT] * entry_size;
+        if ((*results)->net_logical_data_size >= removed)
+        {
+            (*results)->net_logical_data_size -= removed;
+        }
+        else
+        {
+            (*results)->net_logical_data_size = 0;
+        }
+
+        printf("%.2f ops/sec\n", (*results)->mix_stats.ops_per_second);
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if ((*results)->mix_op_counts[op] == 0) continue;
+            printf("    %-6s %" PRId64 " ops, p99 %.2f μs\n", mix_op_names[op],
+                   (*results)->mix_op_counts[op], (*results)->mix_op_stats[op].p99_latency_us);
+        }
+    }
+
+    if (config->workload_type == WORKLOAD_REPLAY)
+    {
+        if (config->trace_preload)
+        {
+            printf("  PRELOAD: ");
+            fflush(stdout);
+
+            run_phase(config, engine, "PRELOAD", benchmark_trace_load_thread, 0, 0, base,
+                      *results, &(*results)->put_stats);
+
+            printf("%.2f ops/sec\n", (*results)->put_stats.ops_per_second);
+        }
+
+        printf("  REPLAY: ");
+        fflush(stdout);
+
+        /* the replay reports like the mixed phase, one row per trace op type */
+        run_phase(config, engine, "REPLAY", benchmark_replay_thread, 0, 1, base, *results,
+                  &(*results)->mix_stats);
+
+        printf("%.2f ops/sec\n", (*results)->mix_stats.ops_per_second);
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if ((*results)->mix_op_counts[op] == 0) continue;
+            printf("    %-6s %" PRId64 " ops, p99 %.2f μs\n", mix_op_names[op],
+                   (*results)->mix_op_counts[op], (*results)->mix_op_stats[op].p99_latency_us);
+        }
+    }
+
+    if (config->workload_type == WORKLOAD_DELETE)
+    {
+        printf("  DELETE: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "DELETE", benchmark_delete_thread, 1, 1, base, *results,
+                  &(*results)->delete_stats);
+
+        size_t data_size = (size_t)(*results)->delete_stats.ops_total * entry_bytes(config);
+        (*results)->total_bytes_written += data_size;
+        if ((*results)->net_logical_data_size >= data_size)
+        {
+            (*results)->net_logical_data_size -= data_size;
+        }
+        else
+        {
+            (*results)->net_logical_data_size = 0;
+        }
+
+        printf("%.2f ops/sec\n", (*results)->delete_stats.ops_per_second);
+    }
+
+    if (config->workload_type == WORKLOAD_SEEK)
+    {
+        printf("  SEEK: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "SEEK", benchmark_seek_thread, 1, 1, base, *results,
+                  &(*results)->seek_stats);
+        fprintf(stderr, "\n");
+
+        (*results)->total_bytes_read +=
+            (size_t)(*results)->seek_stats.ops_total * entry_bytes(config);
+
+        printf("%.2f ops/sec\n", (*results)->seek_stats.ops_per_second);
+    }
+
+    if (config->workload_type == WORKLOAD_RANGE)
+    {
+        printf("  RANGE: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "RANGE", benchmark_range_thread, 1, 1, base, *results,
+                  &(*results)->range_stats);
+        fprintf(stderr, "\n");
+
+        /* we range queries read range_size keys per operation */
+        (*results)->total_bytes_read += (size_t)(*results)->range_stats.ops_total *
+                                        config->range_size * entry_bytes(config);
+
+        printf("%.2f ops/sec\n", (*results)->range_stats.ops_per_second);
+    }
+
+    if (config->workload_type == WORKLOAD_SCAN)
+    {
+        benchmark_config_t scan = scan_phase_config(config);
+        if (config->scan_direction & SCAN_FORWARD)
+        {
+            printf("  SCAN: ");
+            fflush(stdout);
+
+            run_phase(&scan, engine, "SCAN", benchmark_scan_thread, 1, 1, base, *results,
+                      &(*results)->scan_stats);
+            fprintf(stderr, "\n");
+
+            printf("%.2f ops/sec, %.1f keys/scan\n", (*results)->scan_stats.ops_per_second,
+                   (*results)->scan_stats.items_per_op);
+        }
+        if ((config->scan_direction & SCAN_REVERSE) && !scan_reverse_supported(config, engine))
+        {
+            printf("  SCAN_REV: skipped, %s cannot iterate backwards\n", engine->ops->name);
+        }
+        else if (config->scan_direction & SCAN_REVERSE)
+        {
+            printf("  SCAN_REV: ");
+            fflush(stdout);
+
+            run_phase(&scan, engine, "SCAN_REV", benchmark_reverse_scan_thread, 1, 1, base,
+                      *results, &(*results)->reverse_scan_stats);
+            fprintf(stderr, "\n");
+
+            printf("%.2f ops/sec, %.1f keys/scan\n",
+                   (*results)->reverse_scan_stats.ops_per_second,
+                   (*results)->reverse_scan_stats.items_per_op);
+        }
+    }
+
+    if (config->workload_type == WORKLOAD_MULTIGET)
+    {
+        printf("  MULTIGET: ");
+        fflush(stdout);
+
+        run_phase(config, engine, "MULTIGET", benchmark_multiget_thread, 0, 1, base, *results,
+                  &(*results)->multiget_stats);
+
+        (*results)->total_bytes_read +=
+            (size_t)(*results)->multiget_stats.ops_total * entry_bytes(config);
+
+        printf("%.2f ops/sec\n", (*results)->multiget_stats.ops_per_second);
+    }
+
+    if (config->thread_sweep_count > 0)
+    {
+        run_thread_sweep(config, engine, mix_enabled, base, *results);
+    }
+
+    if (config->cache_sweep_count > 0)
+    {
+        if (run_cache_sweep(config, engine_io, base, *results) != 0) return -1;
+        engine = *engine_io;
+    }
+
+    run_iteration(config, engine, *results);
+    return 0;
+}
+
+static int run_benchmark_body(benchmark_config_t* config, benchmark_results_t** results)
+{
+    *results = calloc(1, sizeof(benchmark_results_t));
+    if (!*results) return -1;
+
+    (*results)->engine_name = config->engine_name;
+    (*results)->config = *config;
+
+    const storage_engine_ops_t* ops = get_engine_ops(config->engine_name);
+    if (!ops)
+    {
+        fprintf(stderr, "Unknown engine: %s\n", config->engine_name);
+        free_results(*results);
+        return -1;
+    }
+
+    /* the recovery workload owns its database from the writer's fork to the clean reopen */
+    if (config->workload_type == WORKLOAD_RECOVERY)
+    {
+        if (run_recovery(config, ops, *results) != 0)
+        {
+            free_results(*results);
+            return -1;
+        }
+        return 0;
+    }
+
+    /* a --mix spec turns the mixed workload into preload + concurrent weighted phase */
+    int mix_enabled = 0;
+    if (config->workload_type == WORKLOAD_MIXED)
+    {
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if (config->mix_weights[op] > 0) mix_enabled = 1;
+        }
+    }
+
+    /* a run phase starts from the snapshot when there is one, every trial sees the same files */
+    if (config->phase == BENCH_PHASE_RUN && config->snapshot_dir)
+    {
+        if (dataset_restore(config) != 0)
+        {
+            fprintf(stderr, "Failed to restore snapshot %s to %s\n", config->snapshot_dir,
+                    config->db_path);
+            free_results(*results);
+            return -1;
+        }
+        printf("Restored %s from snapshot %s\n", config->db_path, config->snapshot_dir);
+    }
+
+    int loaded = dataset_is_loaded(config);
+    int do_load = config->phase == BENCH_PHASE_LOAD ||
+                  (config->phase == BENCH_PHASE_ALL && config->reuse_db && !loaded &&
+                   workload_needs_dataset(config));
+    int preloaded = config->phase == BENCH_PHASE_RUN || do_load || (config->reuse_db && loaded);
+
+    /* only an open that goes straight to the measured phases runs cold, a load writes first */
+    storage_engine_t* engine = NULL;
+    if (open_engine(config, ops, preloaded && !do_load, &engine) != 0)
+    {
+        free_results(*results);
+        return -1;
+    }
+
+    remote_stats_t remote;
+    (*results)->has_remote = ops->remote_stats && ops->remote_stats(engine, &remote) == 0;
+
+    printf("Running %s benchmark...\n", ops->name);
+    if (config->reuse_db && loaded && config->phase == BENCH_PHASE_ALL)
+    {
+        printf("  Reusing the dataset loaded in %s\n", config->db_path);
+    }
+
+    /* baseline captured after first thread allocation to exclude benchmark infrastructure */
+    resource_baseline_t base = {0};
+    double benchmark_start_time = get_time_microseconds();
+
+    if (do_load)
+    {
+        load_dataset(config, engine, &base, *results);
+
+        if (config->phase != BENCH_PHASE_LOAD)
+        {
+            /* the marker and snapshot are taken closed, the measured phases get a fresh open */
+            collect_remote(engine, *results);
+            engine->ops->close(engine);
+            engine = NULL;
+            if (finish_load(config) != 0 || open_engine(config, ops, 1, &engine) != 0)
+            {
+                memstat_stop(&base.mem);
+                free_results(*results);
+                return -1;
+            }
+        }
+    }
+
+    if (config->phase != BENCH_PHASE_LOAD &&
+        run_workload(config, &engine, mix_enabled, preloaded, &base, results) != 0)
+    {
+        /* the sampler started with the first phase writes into base */
+        memstat_stop(&base.mem);
+        free_results(*results);
+        return -1;
+    }
+
+    /* we capture final resource metrics */
+    size_t final_rss, final_vms, final_io_read, final_io_write;
+    double final_cpu_user, final_cpu_system;
+    double benchmark_end_time = get_time_microseconds();
+
+    io_end_t io_end;
+    get_memory_usage(&final_rss, &final_vms);
+    get_io_stats(&final_io_read, &final_io_write);
+    get_cpu_stats(&final_cpu_user, &final_cpu_system);
+    capture_io_end(config->db_path, &io_end);
+
+    /* we calc resource deltas */
+    (*results)->resources.peak_rss_bytes = final_rss > base.rss ? final_rss : base.rss;
+    (*results)->resources.peak_vms_bytes = final_vms > base.vms ? final_vms : base.vms;
+    finish_memory(engine, &base.mem, *results);
+    (*results)->resources.bytes_read = final_io_read - base.io_read;
+    (*results)->resources.bytes_written = final_io_write - base.io_write;
+    (*results)->resources.cpu_user_time = final_cpu_user - base.cpu_user;
+    (*results)->resources.cpu_system_time = final_cpu_system - base.cpu_system;
+
+    /* we calc CPU percentage */
+    double total_wall_time = (benchmark_end_time - benchmark_start_time) / 1000000.0;
+    double total_cpu_time =
+        (*results)->resources.cpu_user_time + (*results)->resources.cpu_system_time;
+    (*results)->resources.cpu_percent = (total_cpu_time / total_wall_time) * 100.0;
+
+    /* we calc write and read amplification factors (before close) */
+    size_t logical_data_written = (*results)->total_bytes_written;
+    size_t logical_data_read = (*results)->total_bytes_read;
+
+    if (logical_data_written > 0 && (*results)->resources.bytes_written > 0)
+    {
+        (*results)->resources.write_amplification =
+            (double)(*results)->resources.bytes_written / (double)logical_data_written;
+    }
+
+    if (logical_data_read > 0 && (*results)->resources.bytes_read > 0)
+    {
+        (*results)->resources.read_amplification =
+            (double)(*results)->resources.bytes_read / (double)logical_data_read;
+    }
+    finish_device_io(&base, &io_end, &(*results)->resources, logical_data_written,
+                     logical_data_read);
+
+    /* we close database to ensure all data is flushed and compacted */
+    collect_remote(engine, *results);
+    engine->ops->close(engine);
+
+    /* we append debug logs before database directory is cleaned up */
+    if (config->debug_logging)
+    {
+        append_debug_log(config->db_path, config->engine_name);
+    }
+
+    /* we get storage size after close for accurate space amplification */
+    (*results)->resources.storage_size_bytes = get_directory_size(config->db_path);
+
+    /* we calc space amplification after close */
+    if ((*results)->net_logical_data_size > 0 && (*results)->resources.storage_size_bytes > 0)
+    {
+        (*results)->resources.space_amplification =
+            (double)(*results)->resources.storage_size_bytes /
+            (double)(*results)->net_logical_data_size;
+    }
+
+    /* after the main accounting, the PUT path numbers above do not include the bulk load */
+    if (config->workload_type == WORKLOAD_INGEST && config->phase != BENCH_PHASE_LOAD)
+    {
+        run_ingest(config, ops, *results);
+    }
+
+    if (do_load && config->phase == BENCH_PHASE_LOAD && finish_load(config) != 0)
+    {
+        free_results(*results);
+        return -1;
+    }
+
+    /* the loaded dataset is gone once a run deleted from it or replayed a trace over it */
+    if (config->phase != BENCH_PHASE_LOAD &&
+        (config->workload_type == WORKLOAD_DELETE || config->workload_type == WORKLOAD_REPLAY ||
+         (mix_enabled && config->mix_weights[MIX_OP_DELETE] > 0)))
+    {
+        dataset_forget(config);
+    }
+    return 0;
+}
+
+int run_benchmark(benchmark_config_t* config, benchmark_results_t** results)
+{
+    /* a replay runs the trace once per pass, its op count is the trace length */
+    trace_t trace;
+    int64_t num_operations = config->num_operations;
+    benchmark_config_t pool_config = *config;
+    if (config->workload_type == WORKLOAD_REPLAY)
+    {
+        if (trace_open(&trace, config->trace_file) != 0) return -1;
+        config->trace = &trace;
+        config->num_operations = (int64_t)trace.num_records;
+        if ((uint32_t)pool_config.value_size < trace.max_value_size)
+        {
+            pool_config.value_size = (int)trace.max_value_size;
+        }
+    }
+
+    /* one value pool per run, every worker and every phase slices the same buffer */
+    value_pool_t pool;
+    int rc = -1;
+    if (value_pool_init(&pool, &pool_config) != 0)
+    {
+        fprintf(stderr, "Failed to allocate the value pool\n");
+    }
+    else
+    {
+        config->value_pool = &pool;
+        memstat_track((int64_t)pool.size);
+        rc = run_benchmark_body(config, results);
+        if (rc == 0)
+        {
+            (*results)->mean_value_size = pool.mean_size;
+            (*results)->config.value_pool = NULL;
+            (*results)->config.trace = NULL;
+        }
+        config->value_pool = NULL;
+        memstat_track(-(int64_t)pool.size);
+        value_pool_free(&pool);
+    }
+
+    if (config->trace)
+    {
+        trace_close(&trace);
+        config->trace = NULL;
+        config->num_operations = num_operations;
+    }
+    return rc;
+}
+
+/* open-loop runs also print the plain service time, the gap to the corrected numbers above is
+ * the queueing a closed-loop client would have hidden */
+static void print_uncorrected(FILE* fp, const operation_stats_t* st)
+{
+    if (st->uncorrected_max_us <= 0.0) return;
+
+    fprintf(fp, "  Uncorrected (avg/p50/p99/p99.9/max): %.2f / %.2f / %.2f / %.2f / %.2f μs\n",
+            st->uncorrected_avg_us, st->uncorrected_p50_us, st->uncorrected_p99_us,
+            st->uncorrected_p999_us, st->uncorrected_max_us);
+}
+
+static void print_keygen(FILE* fp, const operation_stats_t* st)
+{
+    if (st->keygen_ns_per_key <= 0.0) return;
+
+    fprintf(fp, "  Key generation: %.1f ns/key (%.2f%% of worker time)\n", st->keygen_ns_per_key,
+            st->keygen_percent);
+}
+
+/* a wide ops spread or a long idle tail means one worker held the others up */
+static void print_balance(FILE* fp, const operation_stats_t* st)
+{
+    if (st->thread_ops_max <= 0) return;
+
+    fprintf(fp,
+            "  Worker balance: %" PRId64 "-%" PRId64
+            " ops/thread, idle avg %.2f ms, max %.2f ms\n",
+            st->thread_ops_min, st->thread_ops_max, st->thread_idle_avg_ms,
+            st->thread_idle_max_ms);
+}
+
+/* the --warmup / --duration window and the steady-state verdict of the interval reporter */
+static void print_window(FILE* fp, const operation_stats_t* st)
+{
+    if (st->warmup_seconds > 0.0)
+    {
+        fprintf(fp, "  Measured window: %.1f s after a %.1f s warmup, %" PRId64 " ops in total\n",
+                st->duration_seconds, st->warmup_seconds, st->ops_total);
+    }
+    if (st->steady_state_sec > 0.0)
+    {
+        fprintf(fp, "  Steady state: reached %.1f s into the phase (throughput cv %.1f%%)\n",
+                st->steady_state_sec, st->steady_cv_percent);
+    }
+    else if (st->steady_windows > 0)
+    {
+        fprintf(fp, "  Steady state: not reached (throughput cv %.1f%% over the last window)\n",
+                st->steady_cv_percent);
+    }
+}
+
+/* perf counter ratios of a phase, -1 when either side was not counted */
+static double perf_ratio(const perf_counts_t* pc, int64_t num, double den)
+{
+    return pc->valid && num >= 0 && den > 0 ? (double)num / den : -1.0;
+}
+
+static double perf_ipc(const operation_stats_t* st)
+{
+    return perf_ratio(&st->perf, st->perf.instructions, (double)st->perf.cycles);
+}
+
+static double perf_per_op(const operation_stats_t* st, int64_t count)
+{
+    /* the counters run over the whole phase, a warmup included */
+    double ops = st->ops_total > 0 ? (double)st->ops_total
+                                   : st->ops_per_second * st->duration_seconds;
+    return perf_ratio(&st->perf, count, ops);
+}
+
+static void print_perf_value(FILE* fp, const char* sep, const char* fmt, double v,
+                             const char* label)
+{
+    fprintf(fp, "%s", sep);
+    if (v < 0)
+    {
+        fprintf(fp, "n/a %s", label);
+        return;
+    }
+    fprintf(fp, fmt, v);
+    fprintf(fp, " %s", label);
+}
+
+static void print_perf(FILE* fp, const operation_stats_t* st)
+{
+    const perf_counts_t* pc = &st->perf;
+    if (!pc->valid) return;
+
+    fprintf(fp, "  CPU counters:");
+    print_perf_value(fp, " ", "%.2f", perf_ipc(st), "IPC");
+    print_perf_value(fp, ", ", "%.0f", perf_per_op(st, pc->cycles), "cycles/op");
+    print_perf_value(fp, ", ", "%.0f", perf_per_op(st, pc->instructions), "instructions/op");
+    print_perf_value(fp, ", ", "%.2f", perf_per_op(st, pc->llc_misses), "LLC misses/op");
+    print_perf_value(fp, ", ", "%.2f", perf_per_op(st, pc->branch_misses), "branch misses/op");
+    print_perf_value(fp, ", ", "%.0f", (double)pc->context_switches, "context switches");
+    fprintf(fp, "\n");
+}
+
+static void print_mix_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (r->mix_stats.ops_per_second <= 0) return;
+
+    if (r->config.workload_type == WORKLOAD_REPLAY)
+    {
+        fprintf(fp, "REPLAY Operations (trace):\n");
+        fprintf(fp, "  Trace: %s (%" PRId64 " records)\n", r->config.trace_file,
+                r->config.num_operations);
+        if (r->config.replay_speed > 0.0)
+            fprintf(fp, "  Timing: %.2fx the original\n", r->config.replay_speed);
+        else
+            fprintf(fp, "  Timing: as fast as possible\n");
+    }
+    else
+    {
+        fprintf(fp, "MIXED Operations (concurrent):\n");
+        fprintf(fp, "  Mix: %s\n", r->config.mix_spec ? r->config.mix_spec : "custom");
+    }
+    fprintf(fp, "  Throughput: %.2f ops/sec\n", r->mix_stats.ops_per_second);
+    fprintf(fp, "  Duration: %.3f seconds\n", r->mix_stats.duration_seconds);
+    fprintf(fp, "  Latency (avg): %.2f μs\n", r->mix_stats.avg_latency_us);
+    fprintf(fp, "  Latency (p99): %.2f μs\n", r->mix_stats.p99_latency_us);
+    fprintf(fp, "  Latency (p99.9): %.2f μs\n", r->mix_stats.p999_latency_us);
+    fprintf(fp, "  Latency (p99.99): %.2f μs\n", r->mix_stats.p9999_latency_us);
+    print_uncorrected(fp, &r->mix_stats);
+    print_keygen(fp, &r->mix_stats);
+    print_balance(fp, &r->mix_stats);
+    print_perf(fp, &r->mix_stats);
+    print_window(fp, &r->mix_stats);
+    for (int op = 0; op < MIX_OP_COUNT; op++)
+    {
+        const operation_stats_t* st = &r->mix_op_stats[op];
+        if (r->mix_op_counts[op] == 0) continue;
+        fprintf(fp,
+                "  %-6s %10" PRId64
+                " ops  %10.2f ops/sec  avg %.2f μs  p50 %.2f μs  p95 %.2f μs  p99 %.2f μs  "
+                "max %.2f μs\n",
+                mix_op_names[op], r->mix_op_counts[op], st->ops_per_second, st->avg_latency_us,
+                st->p50_latency_us, st->p95_latency_us, st->p99_latency_us, st->max_latency_us);
+    }
+    fprintf(fp, "\n");
+}
+
+/* efficiency is the speedup over the first sweep point divided by the growth in threads, 100%
+ * means the extra threads scaled linearly */
+static void print_sweep_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (r->sweep_count == 0) return;
+
+    const int* threads = r->config.thread_sweep;
+    double base_ops = r->sweep_stats[0].ops_per_second;
+
+    fprintf(fp, "Thread Scaling (%s on one loaded database, affinity %s):\n", r->sweep_phase,
+            affinity_to_string(r->config.cpu_affinity));
+    fprintf(fp, "  Threads         Ops/sec   Speedup  Efficiency     p50 (μs)     p99 (μs)\n");
+    for (int i = 0; i < r->sweep_count; i++)
+    {
+        const operation_stats_t* st = &r->sweep_stats[i];
+        double speedup = base_ops > 0 ? st->ops_per_second / base_ops : 0.0;
+        double efficiency = 100.0 * speedup * threads[0] / threads[i];
+        fprintf(fp, "  %7d  %14.2f  %7.2fx  %9.1f%%  %11.2f  %11.2f\n", threads[i],
+                st->ops_per_second, speedup, efficiency, st->p50_latency_us, st->p99_latency_us);
+    }
+    fprintf(fp, "\n");
+}
+
+/* a hit rate column, "-" when the engine did not count the lookups */
+static const char* hit_rate_text(double hit_rate, char* buf, size_t size)
+{
+    if (hit_rate < 0.0) return "-";
+    snprintf(buf, size, "%.1f%%", hit_rate * 100.0);
+    return buf;
+}
+
+/* the curve to size a machine by, throughput and hit rate against the block cache size */
+static void print_cache_sweep_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (r->cache_sweep_count == 0) return;
+
+    const double mb = 1024.0 * 1024.0;
+    fprintf(fp, "Block Cache Sweep (%.2f MB on disk, page cache dropped before each point):\n",
+            r->cache_sweep_dataset_bytes / mb);
+    fprintf(fp, "  Cache   Cache MB   Limit MB     GET ops/sec  GET p99 (μs)  GET hit   "
+                "RANGE ops/sec  RANGE hit   Read MB\n");
+    for (int i = 0; i < r->cache_sweep_count; i++)
+    {
+        const cache_sweep_point_t* pt = &r->cache_sweep[i];
+        char get_hit[16], range_hit[16], limit[16];
+        if (pt->memory_limit_bytes > 0)
+            snprintf(limit, sizeof(limit), "%.1f", pt->memory_limit_bytes / mb);
+        else
+            snprintf(limit, sizeof(limit), "-");
+        fprintf(fp, "  %5.3g %10.1f %10s  %14.2f  %12.2f  %7s  %14.2f  %9s  %8.1f\n",
+                pt->fraction, pt->cache_bytes / mb, limit, pt->get.stats.ops_per_second,
+                pt->get.stats.p99_latency_us, hit_rate_text(pt->get.hit_rate, get_hit, 16),
+                pt->range.stats.ops_per_second,
+                hit_rate_text(pt->range.hit_rate, range_hit, 16),
+                (pt->get.bytes_read + pt->range.bytes_read) / mb);
+    }
+    fprintf(fp, "\n");
+}
+
+/* a gauge of a family snapshot in MB, "-" when the engine does not report it */
+static void print_family_gauge(FILE* fp, int64_t v, int width, int bytes)
+{
+    if (v < 0)
+        fprintf(fp, "  %*s", width, "-");
+    else if (bytes)
+        fprintf(fp, "  %*.2f", width, v / (1024.0 * 1024.0));
+    else
+        fprintf(fp, "  %*" PRId64, width, v);
+}
+
+/* every measured phase split by family, with each family's own layout at the phase end */
+static void print_cf_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (r->cf_phase_count == 0) return;
+
+    const benchmark_config_t* cfg = &r->config;
+    fprintf(fp, "Column Families (%d, profile %s):\n", cfg->num_column_families,
+            cfg->cf_profile ? cfg->cf_profile : "uniform");
+    for (int p = 0; p < r->cf_phase_count; p++)
+    {
+        fprintf(fp, "  %s\n", r->cf_phases[p]);
+        fprintf(fp,
+                "    CF  Weight   Key   Value          Keys       Ops/sec   avg (μs)   p50 (μs)"
+                "   p99 (μs)  Memtable (MB)     L0  Tables  Live (MB)\n");
+        for (int cf = 0; cf < cfg->num_column_families; cf++)
+        {
+            const operation_stats_t* st = &r->cf_stats[p][cf];
+            const engine_stats_t* es = &st->engine_stats;
+            int key = cfg->cf_key_sizes[cf] > cfg->key_size ? cfg->cf_key_sizes[cf]
+                                                            : cfg->key_size;
+            fprintf(fp, "  %4d  %6d  %4d", cf, cfg->cf_weights[cf], key);
+            if (cfg->cf_value_sizes[cf] > 0)
+                fprintf(fp, "  %6d", cfg->cf_value_sizes[cf]);
+            else
+                fprintf(fp, "  %6s", "pool");
+            fprintf(fp, "  %12" PRId64 "  %12.2f  %9.2f  %9.2f  %9.2f", st->ops_total,
+                    st->ops_per_second, st->avg_latency_us, st->p50_latency_us,
+                    st->p99_latency_us);
+            print_family_gauge(fp, es->valid ? es->memtable_bytes : -1, 13, 1);
+            print_family_gauge(fp, es->valid ? es->l0_files : -1, 5, 0);
+            print_family_gauge(fp, es->valid ? es->table_files : -1, 6, 0);
+            print_family_gauge(fp, es->valid ? es->live_data_bytes : -1, 9, 1);
+            fprintf(fp, "\n");
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+/* one row of the scan table, a direction that did not run shows a dash */
+static void print_scan_row(FILE* fp, const char* label, const operation_stats_t* fwd,
+                           const operation_stats_t* rev, size_t offset)
+{
+    fprintf(fp, "  %-20s", label);
+    const operation_stats_t* cols[2] = {fwd, rev};
+    for (int i = 0; i < 2; i++)
+    {
+        if (cols[i]->ops_per_second > 0)
+        {
+            fprintf(fp, " %13.2f", *(const double*)((const char*)cols[i] + offset));
+        }
+        else
+        {
+            fprintf(fp, " %13s", "-");
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+/* -w scan, forward and reverse bounded scans side by side */
+static void print_scan_report(FILE* fp, const benchmark_results_t* r)
+{
+    const operation_stats_t* fwd = &r->scan_stats;
+    const operation_stats_t* rev = &r->reverse_scan_stats;
+    if (fwd->ops_per_second <= 0 && rev->ops_per_second <= 0) return;
+
+    const benchmark_config_t* c = &r->config;
+    fprintf(fp, "Range Scans (");
+    if (c->scan_prefix_keys > 0)
+    {
+        fprintf(fp, "prefixes of %lld keys", (long long)scan_prefix_block(c->scan_prefix_keys));
+    }
+    else if (c->scan_min == c->scan_max)
+    {
+        fprintf(fp, "%d keys", c->scan_min);
+    }
+    else
+    {
+        fprintf(fp, "%d-%d keys", c->scan_min, c->scan_max);
     }
+    fprintf(fp, ", %s", c->scan_unbounded ? "unbounded seek and count" : "iterator bounds");
+    if (c->scan_readahead > 0) fprintf(fp, ", readahead %zu KB", c->scan_readahead / 1024);
+    fprintf(fp, "):\n");
+    fprintf(fp, "                             Forward       Reverse\n");
+    print_scan_row(fp, "Throughput (ops/sec)", fwd, rev,
+                   offsetof(operation_stats_t, ops_per_second));
+    print_scan_row(fp, "Keys per Scan", fwd, rev, offsetof(operation_stats_t, items_per_op));
+    print_scan_row(fp, "Latency avg (μs)", fwd, rev, offsetof(operation_stats_t, avg_latency_us));
+    print_scan_row(fp, "Latency p50 (μs)", fwd, rev, offsetof(operation_stats_t, p50_latency_us));
+    print_scan_row(fp, "Latency p99 (μs)", fwd, rev, offsetof(operation_stats_t, p99_latency_us));
+    print_scan_row(fp, "Latency p99.9 (μs)", fwd, rev,
+                   offsetof(operation_stats_t, p999_latency_us));
+    print_scan_row(fp, "Latency max (μs)", fwd, rev, offsetof(operation_stats_t, max_latency_us));
+    if (fwd->ops_per_second > 0 && rev->ops_per_second > 0)
+    {
+        fprintf(fp, "  Reverse vs Forward: %.2fx\n", rev->ops_per_second / fwd->ops_per_second);
+    }
+    fprintf(fp, "\n");
+}
 
-    printf("  ITER: ");
-    fflush(stdout);
+/* keys and scan rate of the ITER pass, and how evenly an --iter-ranges scan split the keys */
+static void print_iter_scan(FILE* fp, const benchmark_results_t* r)
+{
+    const iter_scan_stats_t* it = &r->iter_scan;
+    double sec = r->iteration_stats.duration_seconds;
+    fprintf(fp, "  Keys: %" PRIu64 " (%.2f MB, %.3f GB/s)\n", it->keys,
+            it->bytes / (1024.0 * 1024.0),
+            sec > 0.0 ? it->bytes / (1024.0 * 1024.0 * 1024.0) / sec : 0.0);
+    if (it->ranges > 1)
+    {
+        double mean = (double)it->keys / it->ranges;
+        fprintf(fp, "  Parallel Scan: %d ranges on %d threads, %s split keys\n", it->ranges,
+                it->threads, it->splits);
+        fprintf(fp, "  Keys per Range: min %" PRIu64 ", mean %.0f, max %" PRIu64 " (skew %.2fx)\n",
+                it->range_keys_min, mean, it->range_keys_max,
+                mean > 0.0 ? it->range_keys_max / mean : 0.0);
+        fprintf(fp, "  Range Time: mean %.3f s, slowest %.3f s\n", it->range_sec_mean,
+                it->range_sec_max);
+    }
+    fprintf(fp, "\n");
+}
 
-    void* iter = NULL;
-    if (engine->ops->iter_new(engine, &iter) == 0)
+/* -w ingest, the bulk load next to the PUT path of the same sorted keys */
+static void print_ingest_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (r->ingest_stats.ops_per_second <= 0) return;
+
+    const operation_stats_t* put = &r->put_stats;
+    const operation_stats_t* ingest = &r->ingest_stats;
+    const resource_stats_t* put_res = &r->resources;
+    const resource_stats_t* ingest_res = &r->ingest_resources;
+    const double mb = 1024.0 * 1024.0;
+
+    fprintf(fp, "Bulk Ingest vs PUT Path (same sorted keys, ingest by one writer):\n");
+    fprintf(fp, "                           PUT path        Ingest\n");
+    fprintf(fp, "  Throughput (ops/sec) %14.2f %13.2f\n", put->ops_per_second,
+            ingest->ops_per_second);
+    fprintf(fp, "  Duration (s)         %14.3f %13.3f\n", put->duration_seconds,
+            ingest->duration_seconds);
+    fprintf(fp, "  Disk Writes (MB)     %14.2f %13.2f\n", put_res->bytes_written / mb,
+            ingest_res->bytes_written / mb);
+    if (put_res->device[0] && ingest_res->device[0])
     {
-        double start_time = get_time_microseconds();
-        int count = 0;
+        fprintf(fp, "  Device Writes (MB)   %14.2f %13.2f\n", put_res->device_bytes_written / mb,
+                ingest_res->device_bytes_written / mb);
+    }
+    fprintf(fp, "  Write Amplification  %13.2fx %12.2fx\n", put_res->write_amplification,
+            ingest_res->write_amplification);
+    fprintf(fp, "  Database Size (MB)   %14.2f %13.2f\n", put_res->storage_size_bytes / mb,
+            ingest_res->storage_size_bytes / mb);
+    fprintf(fp, "  Space Amplification  %13.2fx %12.2fx\n", put_res->space_amplification,
+            ingest_res->space_amplification);
+    if (put->ops_per_second > 0)
+    {
+        fprintf(fp, "  Ingest Speedup: %.2fx\n", ingest->ops_per_second / put->ops_per_second);
+    }
+    /* the single worker ran dry when the stream was added, the rest was the ingest step */
+    fprintf(fp, "  Ingest Step: %.2f ms, add latency (avg/p99): %.2f / %.2f μs\n\n",
+            ingest->thread_idle_max_ms, ingest->avg_latency_us, ingest->p99_latency_us);
+}
 
-        engine->ops->iter_seek_to_first(iter);
-        while (engine->ops->iter_valid(iter))
-        {
-            uint8_t *key = NULL, *value = NULL;
-            size_t key_size = 0, value_size = 0;
-            engine->ops->iter_key(iter, &key, &key_size);
-            engine->ops->iter_value(iter, &value, &value_size);
-            engine->ops->iter_next(iter);
-            count++;
-        }
+/* -w recovery, the reopen of the killed writer's database and what it kept */
+static void print_recovery_report(FILE* fp, const benchmark_results_t* r)
+{
+    const recovery_stats_t* rec = &r->recovery;
+    if (!rec->valid) return;
+
+    const char* sync = r->config.sync_mode ? r->config.sync_mode
+                                           : (r->config.sync_enabled ? "full" : "none");
+    double kept = rec->acked > 0 ? (double)rec->found / (double)rec->acked * 100.0 : 0.0;
+    int64_t in_flight = r->config.batch_size > 1 ? r->config.batch_size : 1;
+
+    fprintf(fp, "Crash Recovery (writer killed with SIGKILL, sync %s):\n", sync);
+    fprintf(fp, "  Writer: %" PRId64 " keys acknowledged at %.2f ops/sec, %" PRId64
+            " after the last flush\n", rec->acked, rec->load_ops_per_sec, rec->unflushed_keys);
+    fprintf(fp, "  Reopen After Kill: %.2f ms\n", rec->open_ms);
+    fprintf(fp, "  First GET: %.2f μs\n", rec->first_get_us);
+    fprintf(fp, "  Recovered: %" PRId64 " of %" PRId64 " acknowledged keys (%.3f%%)\n", rec->found,
+            rec->acked, kept);
+    fprintf(fp, "  Lost: %" PRId64 ", Corrupt: %" PRId64 "\n", rec->lost, rec->corrupt);
+    fprintf(fp, "  In-flight Write Survived: %" PRId64 " of %" PRId64 " keys\n",
+            rec->unacked_found, in_flight);
+    fprintf(fp, "  Clean Close: %.2f ms, Clean Reopen: %.2f ms\n\n", rec->close_ms,
+            rec->clean_open_ms);
+}
 
-        double end_time = get_time_microseconds();
-        (*results)->iteration_stats.duration_seconds = (end_time - start_time) / 1000000.0;
-        if (count > 0)
-        {
-            (*results)->iteration_stats.ops_per_second =
-                count / (*results)->iteration_stats.duration_seconds;
-        }
+/* one row of the hit/miss table, the lookup count is recovered from the phase rate */
+static void print_remote_latency(FILE* fp, const char* label, const operation_stats_t* st)
+{
+    fprintf(fp, "  %-14s %10.0f %12.2f %12.2f %12.2f\n", label,
+            st->ops_per_second * st->duration_seconds, st->avg_latency_us, st->p50_latency_us,
+            st->p99_latency_us);
+}
 
-        engine->ops->iter_free(iter);
-        printf("%.2f ops/sec (%d keys)\n", (*results)->iteration_stats.ops_per_second, count);
-    }
-    else
+static void print_remote_report(FILE* fp, const benchmark_results_t* r)
+{
+    if (!r->has_remote) return;
+
+    const remote_stats_t* rs = &r->remote;
+    const double mb = 1024.0 * 1024.0;
+
+    fprintf(fp, "Remote Object Store (%s, local cache %s):\n", r->config.object_store_backend,
+            r->config.object_cold_cache ? "evicted before the reads" : "kept warm");
+    fprintf(fp, "  GETs: %" PRIu64 " whole objects, %" PRIu64 " ranges, %.2f MB fetched\n",
+            rs->gets, rs->range_gets, rs->bytes_fetched / mb);
+    fprintf(fp, "  Uploads: %" PRIu64 " objects, %.2f MB, max in flight %" PRId64 "\n", rs->puts,
+            rs->bytes_uploaded / mb, rs->max_uploads_in_flight);
+    if (r->config.object_latency_us > 0)
     {
-        printf("not supported\n");
+        fprintf(fp, "  Injected latency: %" PRIu64 " μs per request\n",
+                r->config.object_latency_us);
     }
 
-    /* we capture final resource metrics */
-    size_t final_rss, final_vms, final_io_read, final_io_write;
-    double final_cpu_user, final_cpu_system;
-    double benchmark_end_time = get_time_microseconds();
+    const operation_stats_t* hit = &r->get_hit_stats;
+    const operation_stats_t* miss = &r->get_miss_stats;
+    if (hit->duration_seconds > 0.0)
+    {
+        fprintf(fp, "  GET               Lookups     avg (μs)     p50 (μs)     p99 (μs)\n");
+        print_remote_latency(fp, "local hit", hit);
+        print_remote_latency(fp, "remote fetch", miss);
+    }
+    fprintf(fp, "\n");
+}
 
-    get_memory_usage(&final_rss, &final_vms);
-    get_io_stats(&final_io_read, &final_io_write);
-    get_cpu_stats(&final_cpu_user, &final_cpu_system);
+/* device and fsync lines of a Resource Usage section, nothing when neither was measured */
+static void print_device_io(FILE* fp, const resource_stats_t* res)
+{
+    const double mb = 1024.0 * 1024.0;
+    if (res->device[0])
+    {
+        fprintf(fp, "  Device: %s\n", res->device);
+        fprintf(fp, "  Device Reads: %.2f MB (%.0f IOPS)\n", res->device_bytes_read / mb,
+                res->device_read_iops);
+        fprintf(fp, "  Device Writes: %.2f MB (%.0f IOPS)\n", res->device_bytes_written / mb,
+                res->device_write_iops);
+        fprintf(fp, "  Device Flushes: %" PRIu64 "\n", res->device_flushes);
+        fprintf(fp, "  Device Utilization: %.1f%%\n", res->device_util_percent);
+        fprintf(fp, "  Device Queue Depth: %.2f\n", res->device_queue_depth);
+    }
+    if (res->has_fsync)
+    {
+        fprintf(fp, "  Syncs: %" PRIu64 " (avg %.2f μs, p50 %.2f μs, p99 %.2f μs, max %.2f μs)\n",
+                res->fsync_count, res->fsync_avg_us, res->fsync_p50_us, res->fsync_p99_us,
+                res->fsync_max_us);
+    }
+}
 
-    /* we calc resource deltas */
-    (*results)->resources.peak_rss_bytes = final_rss > baseline_rss ? final_rss : baseline_rss;
-    (*results)->resources.peak_vms_bytes = final_vms > baseline_vms ? final_vms : baseline_vms;
-    (*results)->resources.bytes_read = final_io_read - baseline_io_read;
-    (*results)->resources.bytes_written = final_io_write - baseline_io_write;
-    (*results)->resources.cpu_user_time = final_cpu_user - baseline_cpu_user;
-    (*results)->resources.cpu_system_time = final_cpu_system - baseline_cpu_system;
+/* share of the allocator's footprint (resident, else active, else mapped) that holds no live
+ * allocation, -1 when the allocator does not report enough to tell */
+static double alloc_fragmentation(const resource_stats_t* res)
+{
+    int64_t footprint = res->alloc_resident_bytes >= 0 ? res->alloc_resident_bytes
+                        : res->alloc_active_bytes >= 0 ? res->alloc_active_bytes
+                                                        : res->alloc_mapped_bytes;
+    if (!res->allocator[0] || res->alloc_allocated_bytes < 0 || footprint <= 0) return -1.0;
+    double frag = 100.0 * (footprint - res->alloc_allocated_bytes) / footprint;
+    return frag > 0.0 ? frag : 0.0;
+}
 
-    /* we calc CPU percentage */
-    double total_wall_time = (benchmark_end_time - benchmark_start_time) / 1000000.0;
-    double total_cpu_time =
-        (*results)->resources.cpu_user_time + (*results)->resources.cpu_system_time;
-    (*results)->resources.cpu_percent = (total_cpu_time / total_wall_time) * 100.0;
+/* an allocator counter in MB for the CSV, -1 when the allocator did not report it */
+static double alloc_mb(const resource_stats_t* res, int64_t bytes)
+{
+    return res->allocator[0] && bytes >= 0 ? bytes / (1024.0 * 1024.0) : -1.0;
+}
 
-    /* we calc write and read amplification factors (before close) */
-    size_t logical_data_written = (*results)->total_bytes_written;
-    size_t logical_data_read = (*results)->total_bytes_read;
+/* the sampled peaks, the end resident set split into what benchtool, the block cache and the
+ * memtables hold, and the allocator's own view of it */
+static void print_memory_report(FILE* fp, const benchmark_results_t* r)
+{
+    const resource_stats_t* res = &r->resources;
+    const double mb = 1024.0 * 1024.0;
+    if (res->mem_samples == 0 && !res->allocator[0]) return;
 
-    if (logical_data_written > 0 && (*results)->resources.bytes_written > 0)
+    fprintf(fp, "Memory:\n");
+    if (res->mem_samples > 0)
     {
-        (*results)->resources.write_amplification =
-            (double)(*results)->resources.bytes_written / (double)logical_data_written;
+        fprintf(fp, "  Sampled Peak RSS: %.2f MB (%s, %llu samples every %d ms)\n",
+                res->sampled_peak_rss_bytes / mb,
+                res->sampled_peak_phase[0] ? res->sampled_peak_phase : "between phases",
+                (unsigned long long)res->mem_samples, r->config.mem_interval_ms);
+
+        const char* names[] = {"PUT",      "GET",  "DELETE", "SEEK", "RANGE",
+                               "SCAN",     "SCAN_REV", "MGET", "MIXED", "ITER"};
+        const operation_stats_t* phases[] = {
+            &r->put_stats,   &r->get_stats,  &r->delete_stats,       &r->seek_stats,
+            &r->range_stats, &r->scan_stats, &r->reverse_scan_stats, &r->multiget_stats,
+            &r->mix_stats,   &r->iteration_stats};
+        int listed = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            if (phases[i]->peak_rss_bytes == 0) continue;
+            fprintf(fp, "%s %s %.2f MB", listed++ ? "," : "  Phase Peak RSS:", names[i],
+                    phases[i]->peak_rss_bytes / mb);
+        }
+        if (listed) fprintf(fp, "\n");
+    }
+    fprintf(fp, "  RSS at End: %.2f MB anonymous, %.2f MB file-backed\n",
+            res->rss_anon_bytes / mb, res->rss_file_bytes / mb);
+
+    /* what of the anonymous set is not benchtool's buffers, cache or memtables is the rest of
+     * the engine: indexes, filters, compaction buffers and allocator slack */
+    int64_t other = (int64_t)res->rss_anon_bytes - res->benchtool_bytes;
+    fprintf(fp, "  Benchtool Buffers: %.2f MB (peak %.2f MB)\n", res->benchtool_bytes / mb,
+            res->benchtool_peak_bytes / mb);
+    if (res->block_cache_bytes >= 0)
+    {
+        fprintf(fp, "  Block Cache: %.2f MB\n", res->block_cache_bytes / mb);
+        other -= res->block_cache_bytes;
+    }
+    if (res->memtable_bytes >= 0)
+    {
+        fprintf(fp, "  Memtables: %.2f MB\n", res->memtable_bytes / mb);
+        other -= res->memtable_bytes;
     }
+    fprintf(fp, "  Engine Other (anonymous): %.2f MB\n", (other > 0 ? other : 0) / mb);
 
-    if (logical_data_read > 0 && (*results)->resources.bytes_read > 0)
+    if (res->allocator[0])
     {
-        (*results)->resources.read_amplification =
-            (double)(*results)->resources.bytes_read / (double)logical_data_read;
+        fprintf(fp, "  Allocator (%s):", res->allocator);
+        const char* labels[] = {"allocated", "active", "resident", "mapped", "retained"};
+        const int64_t values[] = {res->alloc_allocated_bytes, res->alloc_active_bytes,
+                                  res->alloc_resident_bytes, res->alloc_mapped_bytes,
+                                  res->alloc_retained_bytes};
+        int listed = 0;
+        for (int i = 0; i < 5; i++)
+        {
+            if (values[i] < 0) continue;
+            fprintf(fp, "%s %s %.2f MB", listed++ ? "," : "", labels[i], values[i] / mb);
+        }
+        fprintf(fp, "\n");
+        if (res->alloc_peak_allocated_bytes > res->alloc_allocated_bytes)
+        {
+            fprintf(fp, "  Peak Allocated: %.2f MB\n", res->alloc_peak_allocated_bytes / mb);
+        }
+
+        double frag = alloc_fragmentation(res);
+        if (frag >= 0.0) fprintf(fp, "  Fragmentation: %.1f%%\n", frag);
     }
 
-    /* we close database to ensure all data is flushed and compacted */
-    ops->close(engine);
+    if (res->num_keys > 0)
+    {
+        fprintf(fp, "  Bytes per Key: %.1f peak RSS", (double)res->peak_rss_bytes / res->num_keys);
+        if (res->alloc_allocated_bytes >= 0)
+        {
+            fprintf(fp, ", %.1f allocated",
+                    (double)(res->alloc_allocated_bytes - res->benchtool_bytes) / res->num_keys);
+        }
+        fprintf(fp, " (%lld keys)\n", (long long)res->num_keys);
+    }
+    fprintf(fp, "\n");
+}
 
-    /* we append debug logs before database directory is cleaned up */
-    if (config->debug_logging)
+/* one column per measured phase that has a snapshot, rows the engine does not report are left
+ * out */
+static void print_engine_stats_report(FILE* fp, const benchmark_results_t* r)
+{
+    const char* names[] = {"PUT",  "GET",      "DELETE", "SEEK",  "RANGE",  "SCAN",
+                           "SCAN_REV", "MGET", "MIXED",  "INGEST", "ITER"};
+    const operation_stats_t* phases[] = {
+        &r->put_stats,      &r->get_stats,  &r->delete_stats,       &r->seek_stats,
+        &r->range_stats,    &r->scan_stats, &r->reverse_scan_stats, &r->multiget_stats,
+        &r->mix_stats,      &r->ingest_stats, &r->iteration_stats};
+    const engine_stats_t* cols[11];
+    const char* col_names[11];
+    int num_cols = 0;
+    for (int i = 0; i < 11; i++)
     {
-        append_debug_log(config->db_path, config->engine_name);
+        if (!phases[i]->engine_stats.valid || phases[i]->ops_per_second <= 0) continue;
+        cols[num_cols] = &phases[i]->engine_stats;
+        col_names[num_cols++] =
+            phases[i] == &r->mix_stats && r->config.workload_type == WORKLOAD_REPLAY ? "REPLAY"
+                                                                                      : names[i];
     }
+    if (num_cols == 0) return;
 
-    /* we get storage size after close for accurate space amplification */
-    (*results)->resources.storage_size_bytes = get_directory_size(config->db_path);
+    fprintf(fp, "Engine Statistics (counters over the phase, gauges at its end):\n");
+    fprintf(fp, "  %-24s", "");
+    for (int c = 0; c < num_cols; c++) fprintf(fp, " %12s", col_names[c]);
+    fprintf(fp, "\n");
 
-    /* we calc space amplification after close */
-    if ((*results)->net_logical_data_size > 0 && (*results)->resources.storage_size_bytes > 0)
+    for (size_t i = 0; i < ENGINE_STAT_FIELDS; i++)
     {
-        (*results)->resources.space_amplification =
-            (double)(*results)->resources.storage_size_bytes /
-            (double)(*results)->net_logical_data_size;
+        int reported = 0;
+        for (int c = 0; c < num_cols; c++)
+        {
+            if (engine_stat_value(cols[c], i) >= 0) reported = 1;
+        }
+        if (!reported) continue;
+
+        fprintf(fp, "  %-24s", engine_stat_fields[i].label);
+        for (int c = 0; c < num_cols; c++)
+        {
+            int64_t v = engine_stat_value(cols[c], i);
+            if (v < 0)
+                fprintf(fp, " %12s", "-");
+            else if (engine_stat_fields[i].unit == STAT_BYTES)
+                fprintf(fp, " %12.2f", v / (1024.0 * 1024.0));
+            else if (engine_stat_fields[i].unit == STAT_MICROS)
+                fprintf(fp, " %12.2f", v / 1000.0);
+            else
+                fprintf(fp, " %12" PRId64, v);
+        }
+        fprintf(fp, "\n");
     }
-    return 0;
+    fprintf(fp, "\n");
 }
 
 void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t* baseline)
@@ -1317,7 +4739,54 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
     fprintf(fp, "Operations: %" PRId64 "\n", results->config.num_operations);
     fprintf(fp, "Threads: %d\n", results->config.num_threads);
     fprintf(fp, "Key Size: %d bytes\n", results->config.key_size);
-    fprintf(fp, "Value Size: %d bytes\n\n", results->config.value_size);
+    fprintf(fp, "Value Size: %d bytes\n", results->config.value_size);
+    if (results->config.value_dist != VALUE_DIST_FIXED)
+    {
+        size_t min_size, max_size;
+        value_pool_bounds(&results->config, &min_size, &max_size);
+        fprintf(fp, "Value Sizes: %s, %zu-%zu bytes, mean %.1f bytes\n",
+                value_dist_name(results->config.value_dist), min_size, max_size,
+                results->mean_value_size);
+    }
+    fprintf(fp, "Compression Ratio: %.2f\n", results->config.compression_ratio);
+    fprintf(fp, "Timer: %s\n", timing_source_name(results->config.timer));
+    if (results->config.latency_sample > 1)
+    {
+        fprintf(fp, "Latency Sampling: 1 in %d ops (latency percentiles are estimates)\n",
+                results->config.latency_sample);
+    }
+    if (results->config.target_rate > 0.0)
+    {
+        fprintf(fp, "Target Rate: %.0f ops/sec (%s arrivals, latency from intended start)\n",
+                results->config.target_rate,
+                results->config.arrival == ARRIVAL_POISSON ? "poisson" : "fixed");
+    }
+    if (results->config.zero_copy_reads)
+    {
+        const storage_engine_ops_t* ops = get_engine_ops(results->engine_name);
+        fprintf(fp, "Reads: %s\n",
+                ops && ops->get_pinned ? "zero-copy (pinned)" : "copying get (no pinned reads)");
+    }
+    if (results->config.queue_depth > 1)
+    {
+        const storage_engine_ops_t* ops = get_engine_ops(results->engine_name);
+        fprintf(fp, "Queue Depth: %d outstanding requests per thread (GET: %s)\n",
+                results->config.queue_depth, ops ? asyncq_mode(ops, ASYNCQ_GET) : "helper threads");
+    }
+    if (results->config.num_column_families > 1)
+    {
+        fprintf(fp, "Column Families: %d (profile %s)\n", results->config.num_column_families,
+                results->config.cf_profile ? results->config.cf_profile : "uniform");
+    }
+    if (results->config.phase != BENCH_PHASE_ALL)
+    {
+        fprintf(fp, "Phase: %s\n", results->config.phase == BENCH_PHASE_LOAD ? "load" : "run");
+    }
+    if (results->compact_seconds > 0.0)
+    {
+        fprintf(fp, "Compaction after load: %.2f seconds\n", results->compact_seconds);
+    }
+    fprintf(fp, "\n");
 
     if (results->put_stats.ops_per_second > 0)
     {
@@ -1330,6 +4799,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Latency (p50): %.2f μs\n", results->put_stats.p50_latency_us);
         fprintf(fp, "  Latency (p95): %.2f μs\n", results->put_stats.p95_latency_us);
         fprintf(fp, "  Latency (p99): %.2f μs\n", results->put_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->put_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->put_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->put_stats);
+        print_keygen(fp, &results->put_stats);
+        print_balance(fp, &results->put_stats);
+        print_perf(fp, &results->put_stats);
+        print_window(fp, &results->put_stats);
         fprintf(fp, "  Latency (min): %.2f μs\n", results->put_stats.min_latency_us);
         fprintf(fp, "  Latency (max): %.2f μs\n\n", results->put_stats.max_latency_us);
     }
@@ -1345,6 +4821,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Latency (p50): %.2f μs\n", results->get_stats.p50_latency_us);
         fprintf(fp, "  Latency (p95): %.2f μs\n", results->get_stats.p95_latency_us);
         fprintf(fp, "  Latency (p99): %.2f μs\n", results->get_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->get_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->get_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->get_stats);
+        print_keygen(fp, &results->get_stats);
+        print_balance(fp, &results->get_stats);
+        print_perf(fp, &results->get_stats);
+        print_window(fp, &results->get_stats);
         fprintf(fp, "  Latency (min): %.2f μs\n", results->get_stats.min_latency_us);
         fprintf(fp, "  Latency (max): %.2f μs\n\n", results->get_stats.max_latency_us);
     }
@@ -1360,6 +4843,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Latency (p50): %.2f μs\n", results->delete_stats.p50_latency_us);
         fprintf(fp, "  Latency (p95): %.2f μs\n", results->delete_stats.p95_latency_us);
         fprintf(fp, "  Latency (p99): %.2f μs\n", results->delete_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->delete_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->delete_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->delete_stats);
+        print_keygen(fp, &results->delete_stats);
+        print_balance(fp, &results->delete_stats);
+        print_perf(fp, &results->delete_stats);
+        print_window(fp, &results->delete_stats);
         fprintf(fp, "  Latency (min): %.2f μs\n", results->delete_stats.min_latency_us);
         fprintf(fp, "  Latency (max): %.2f μs\n\n", results->delete_stats.max_latency_us);
     }
@@ -1375,6 +4865,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Latency (p50): %.2f μs\n", results->seek_stats.p50_latency_us);
         fprintf(fp, "  Latency (p95): %.2f μs\n", results->seek_stats.p95_latency_us);
         fprintf(fp, "  Latency (p99): %.2f μs\n", results->seek_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->seek_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->seek_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->seek_stats);
+        print_keygen(fp, &results->seek_stats);
+        print_balance(fp, &results->seek_stats);
+        print_perf(fp, &results->seek_stats);
+        print_window(fp, &results->seek_stats);
         fprintf(fp, "  Latency (min): %.2f μs\n", results->seek_stats.min_latency_us);
         fprintf(fp, "  Latency (max): %.2f μs\n\n", results->seek_stats.max_latency_us);
     }
@@ -1390,16 +4887,57 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Latency (p50): %.2f μs\n", results->range_stats.p50_latency_us);
         fprintf(fp, "  Latency (p95): %.2f μs\n", results->range_stats.p95_latency_us);
         fprintf(fp, "  Latency (p99): %.2f μs\n", results->range_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->range_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->range_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->range_stats);
+        print_keygen(fp, &results->range_stats);
+        print_balance(fp, &results->range_stats);
+        print_perf(fp, &results->range_stats);
+        print_window(fp, &results->range_stats);
         fprintf(fp, "  Latency (min): %.2f μs\n", results->range_stats.min_latency_us);
         fprintf(fp, "  Latency (max): %.2f μs\n", results->range_stats.max_latency_us);
         fprintf(fp, "  Keys per range: %d\n\n", results->config.range_size);
     }
 
+    if (results->multiget_stats.ops_per_second > 0)
+    {
+        fprintf(fp, "MULTIGET Operations (batched):\n");
+        fprintf(fp, "  Throughput: %.2f ops/sec\n", results->multiget_stats.ops_per_second);
+        fprintf(fp, "  Duration: %.3f seconds\n", results->multiget_stats.duration_seconds);
+        fprintf(fp, "  Latency (avg): %.2f μs\n", results->multiget_stats.avg_latency_us);
+        fprintf(fp, "  Latency (stddev): %.2f μs\n", results->multiget_stats.std_dev_us);
+        fprintf(fp, "  Latency (CV): %.2f%%\n", results->multiget_stats.cv_percent);
+        fprintf(fp, "  Latency (p50): %.2f μs\n", results->multiget_stats.p50_latency_us);
+        fprintf(fp, "  Latency (p95): %.2f μs\n", results->multiget_stats.p95_latency_us);
+        fprintf(fp, "  Latency (p99): %.2f μs\n", results->multiget_stats.p99_latency_us);
+        fprintf(fp, "  Latency (p99.9): %.2f μs\n", results->multiget_stats.p999_latency_us);
+        fprintf(fp, "  Latency (p99.99): %.2f μs\n", results->multiget_stats.p9999_latency_us);
+        print_uncorrected(fp, &results->multiget_stats);
+        print_keygen(fp, &results->multiget_stats);
+        print_balance(fp, &results->multiget_stats);
+        print_perf(fp, &results->multiget_stats);
+        print_window(fp, &results->multiget_stats);
+        fprintf(fp, "  Latency (min): %.2f μs\n", results->multiget_stats.min_latency_us);
+        fprintf(fp, "  Latency (max): %.2f μs\n", results->multiget_stats.max_latency_us);
+        fprintf(fp, "  Keys per batch: %d\n\n", results->config.batch_size);
+    }
+
+    print_mix_report(fp, results);
+    print_sweep_report(fp, results);
+    print_cache_sweep_report(fp, results);
+    print_cf_report(fp, results);
+    print_ingest_report(fp, results);
+    print_recovery_report(fp, results);
+    print_scan_report(fp, results);
+    print_remote_report(fp, results);
+    print_engine_stats_report(fp, results);
+
     if (results->iteration_stats.ops_per_second > 0)
     {
         fprintf(fp, "ITERATION:\n");
         fprintf(fp, "  Throughput: %.2f ops/sec\n", results->iteration_stats.ops_per_second);
-        fprintf(fp, "  Duration: %.3f seconds\n\n", results->iteration_stats.duration_seconds);
+        fprintf(fp, "  Duration: %.3f seconds\n", results->iteration_stats.duration_seconds);
+        print_iter_scan(fp, results);
     }
 
     /* resource usage section */
@@ -1408,11 +4946,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
     fprintf(fp, "  Peak VMS: %.2f MB\n", results->resources.peak_vms_bytes / (1024.0 * 1024.0));
     fprintf(fp, "  Disk Reads: %.2f MB\n", results->resources.bytes_read / (1024.0 * 1024.0));
     fprintf(fp, "  Disk Writes: %.2f MB\n", results->resources.bytes_written / (1024.0 * 1024.0));
+    print_device_io(fp, &results->resources);
     fprintf(fp, "  CPU User Time: %.3f seconds\n", results->resources.cpu_user_time);
     fprintf(fp, "  CPU System Time: %.3f seconds\n", results->resources.cpu_system_time);
     fprintf(fp, "  CPU Utilization: %.1f%%\n", results->resources.cpu_percent);
     fprintf(fp, "  Database Size: %.2f MB\n\n",
             results->resources.storage_size_bytes / (1024.0 * 1024.0));
+    print_memory_report(fp, results);
 
     /* amplification factors section */
     fprintf(fp, "Amplification Factors:\n");
@@ -1447,6 +4987,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
             fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->put_stats.p50_latency_us);
             fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->put_stats.p95_latency_us);
             fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->put_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->put_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->put_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->put_stats);
+            print_keygen(fp, &baseline->put_stats);
+            print_balance(fp, &baseline->put_stats);
+            print_perf(fp, &baseline->put_stats);
+            print_window(fp, &baseline->put_stats);
             fprintf(fp, "  Latency (min): %.2f μs\n", baseline->put_stats.min_latency_us);
             fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->put_stats.max_latency_us);
         }
@@ -1462,6 +5009,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
             fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->get_stats.p50_latency_us);
             fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->get_stats.p95_latency_us);
             fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->get_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->get_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->get_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->get_stats);
+            print_keygen(fp, &baseline->get_stats);
+            print_balance(fp, &baseline->get_stats);
+            print_perf(fp, &baseline->get_stats);
+            print_window(fp, &baseline->get_stats);
             fprintf(fp, "  Latency (min): %.2f μs\n", baseline->get_stats.min_latency_us);
             fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->get_stats.max_latency_us);
         }
@@ -1477,6 +5031,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
             fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->delete_stats.p50_latency_us);
             fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->delete_stats.p95_latency_us);
             fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->delete_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->delete_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->delete_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->delete_stats);
+            print_keygen(fp, &baseline->delete_stats);
+            print_balance(fp, &baseline->delete_stats);
+            print_perf(fp, &baseline->delete_stats);
+            print_window(fp, &baseline->delete_stats);
             fprintf(fp, "  Latency (min): %.2f μs\n", baseline->delete_stats.min_latency_us);
             fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->delete_stats.max_latency_us);
         }
@@ -1492,6 +5053,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
             fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->seek_stats.p50_latency_us);
             fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->seek_stats.p95_latency_us);
             fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->seek_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->seek_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->seek_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->seek_stats);
+            print_keygen(fp, &baseline->seek_stats);
+            print_balance(fp, &baseline->seek_stats);
+            print_perf(fp, &baseline->seek_stats);
+            print_window(fp, &baseline->seek_stats);
             fprintf(fp, "  Latency (min): %.2f μs\n", baseline->seek_stats.min_latency_us);
             fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->seek_stats.max_latency_us);
         }
@@ -1507,15 +5075,55 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
             fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->range_stats.p50_latency_us);
             fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->range_stats.p95_latency_us);
             fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->range_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->range_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->range_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->range_stats);
+            print_keygen(fp, &baseline->range_stats);
+            print_balance(fp, &baseline->range_stats);
+            print_perf(fp, &baseline->range_stats);
+            print_window(fp, &baseline->range_stats);
             fprintf(fp, "  Latency (min): %.2f μs\n", baseline->range_stats.min_latency_us);
             fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->range_stats.max_latency_us);
         }
 
+        if (baseline->multiget_stats.ops_per_second > 0)
+        {
+            fprintf(fp, "MULTIGET Operations:\n");
+            fprintf(fp, "  Throughput: %.2f ops/sec\n", baseline->multiget_stats.ops_per_second);
+            fprintf(fp, "  Duration: %.3f seconds\n", baseline->multiget_stats.duration_seconds);
+            fprintf(fp, "  Latency (avg): %.2f μs\n", baseline->multiget_stats.avg_latency_us);
+            fprintf(fp, "  Latency (stddev): %.2f μs\n", baseline->multiget_stats.std_dev_us);
+            fprintf(fp, "  Latency (CV): %.2f%%\n", baseline->multiget_stats.cv_percent);
+            fprintf(fp, "  Latency (p50): %.2f μs\n", baseline->multiget_stats.p50_latency_us);
+            fprintf(fp, "  Latency (p95): %.2f μs\n", baseline->multiget_stats.p95_latency_us);
+            fprintf(fp, "  Latency (p99): %.2f μs\n", baseline->multiget_stats.p99_latency_us);
+            fprintf(fp, "  Latency (p99.9): %.2f μs\n", baseline->multiget_stats.p999_latency_us);
+            fprintf(fp, "  Latency (p99.99): %.2f μs\n", baseline->multiget_stats.p9999_latency_us);
+            print_uncorrected(fp, &baseline->multiget_stats);
+            print_keygen(fp, &baseline->multiget_stats);
+            print_balance(fp, &baseline->multiget_stats);
+            print_perf(fp, &baseline->multiget_stats);
+            print_window(fp, &baseline->multiget_stats);
+            fprintf(fp, "  Latency (min): %.2f μs\n", baseline->multiget_stats.min_latency_us);
+            fprintf(fp, "  Latency (max): %.2f μs\n\n", baseline->multiget_stats.max_latency_us);
+        }
+
+        print_mix_report(fp, baseline);
+        print_sweep_report(fp, baseline);
+        print_cache_sweep_report(fp, baseline);
+        print_cf_report(fp, baseline);
+        print_ingest_report(fp, baseline);
+        print_recovery_report(fp, baseline);
+        print_scan_report(fp, baseline);
+        print_remote_report(fp, baseline);
+        print_engine_stats_report(fp, baseline);
+
         if (baseline->iteration_stats.ops_per_second > 0)
         {
             fprintf(fp, "ITER Operations:\n");
             fprintf(fp, "  Throughput: %.2f ops/sec\n", baseline->iteration_stats.ops_per_second);
-            fprintf(fp, "  Duration: %.3f seconds\n\n", baseline->iteration_stats.duration_seconds);
+            fprintf(fp, "  Duration: %.3f seconds\n", baseline->iteration_stats.duration_seconds);
+            print_iter_scan(fp, baseline);
         }
 
         /* baseline resource usage */
@@ -1527,11 +5135,13 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Disk Reads: %.2f MB\n", baseline->resources.bytes_read / (1024.0 * 1024.0));
         fprintf(fp, "  Disk Writes: %.2f MB\n",
                 baseline->resources.bytes_written / (1024.0 * 1024.0));
+        print_device_io(fp, &baseline->resources);
         fprintf(fp, "  CPU User Time: %.3f seconds\n", baseline->resources.cpu_user_time);
         fprintf(fp, "  CPU System Time: %.3f seconds\n", baseline->resources.cpu_system_time);
         fprintf(fp, "  CPU Utilization: %.1f%%\n", baseline->resources.cpu_percent);
         fprintf(fp, "  Database Size: %.2f MB\n\n",
                 baseline->resources.storage_size_bytes / (1024.0 * 1024.0));
+        print_memory_report(fp, baseline);
 
         /* baseline amplification factors */
         fprintf(fp, "Amplification Factors:\n");
@@ -1596,6 +5206,25 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     results->range_stats.ops_per_second, baseline->range_stats.ops_per_second);
         }
 
+        if (results->multiget_stats.ops_per_second > 0 &&
+            baseline->multiget_stats.ops_per_second > 0)
+        {
+            double speedup =
+                results->multiget_stats.ops_per_second / baseline->multiget_stats.ops_per_second;
+            fprintf(fp, "  MULTIGET: %.2fx %s (%.0f vs %.0f ops/sec)\n",
+                    speedup > 1.0 ? speedup : 1.0 / speedup, speedup > 1.0 ? "faster" : "slower",
+                    results->multiget_stats.ops_per_second,
+                    baseline->multiget_stats.ops_per_second);
+        }
+
+        if (results->mix_stats.ops_per_second > 0 && baseline->mix_stats.ops_per_second > 0)
+        {
+            double speedup = results->mix_stats.ops_per_second / baseline->mix_stats.ops_per_second;
+            fprintf(fp, "  MIXED: %.2fx %s (%.0f vs %.0f ops/sec)\n",
+                    speedup > 1.0 ? speedup : 1.0 / speedup, speedup > 1.0 ? "faster" : "slower",
+                    results->mix_stats.ops_per_second, baseline->mix_stats.ops_per_second);
+        }
+
         if (results->iteration_stats.ops_per_second > 0 &&
             baseline->iteration_stats.ops_per_second > 0)
         {
@@ -1615,6 +5244,8 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     baseline->put_stats.avg_latency_us);
             fprintf(fp, "  PUT p99: %.2f μs vs %.2f μs\n", results->put_stats.p99_latency_us,
                     baseline->put_stats.p99_latency_us);
+            fprintf(fp, "  PUT p99.9: %.2f μs vs %.2f μs\n", results->put_stats.p999_latency_us,
+                    baseline->put_stats.p999_latency_us);
             fprintf(fp, "  PUT max: %.2f μs vs %.2f μs\n", results->put_stats.max_latency_us,
                     baseline->put_stats.max_latency_us);
             fprintf(fp, "  PUT CV: %.2f%% vs %.2f%%\n", results->put_stats.cv_percent,
@@ -1626,6 +5257,8 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     baseline->get_stats.avg_latency_us);
             fprintf(fp, "  GET p99: %.2f μs vs %.2f μs\n", results->get_stats.p99_latency_us,
                     baseline->get_stats.p99_latency_us);
+            fprintf(fp, "  GET p99.9: %.2f μs vs %.2f μs\n", results->get_stats.p999_latency_us,
+                    baseline->get_stats.p999_latency_us);
             fprintf(fp, "  GET max: %.2f μs vs %.2f μs\n", results->get_stats.max_latency_us,
                     baseline->get_stats.max_latency_us);
             fprintf(fp, "  GET CV: %.2f%% vs %.2f%%\n", results->get_stats.cv_percent,
@@ -1637,6 +5270,9 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     baseline->delete_stats.avg_latency_us);
             fprintf(fp, "  DELETE p99: %.2f μs vs %.2f μs\n", results->delete_stats.p99_latency_us,
                     baseline->delete_stats.p99_latency_us);
+            fprintf(fp, "  DELETE p99.9: %.2f μs vs %.2f μs\n",
+                    results->delete_stats.p999_latency_us,
+                    baseline->delete_stats.p999_latency_us);
             fprintf(fp, "  DELETE max: %.2f μs vs %.2f μs\n", results->delete_stats.max_latency_us,
                     baseline->delete_stats.max_latency_us);
             fprintf(fp, "  DELETE CV: %.2f%% vs %.2f%%\n", results->delete_stats.cv_percent,
@@ -1648,6 +5284,8 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     baseline->seek_stats.avg_latency_us);
             fprintf(fp, "  SEEK p99: %.2f μs vs %.2f μs\n", results->seek_stats.p99_latency_us,
                     baseline->seek_stats.p99_latency_us);
+            fprintf(fp, "  SEEK p99.9: %.2f μs vs %.2f μs\n", results->seek_stats.p999_latency_us,
+                    baseline->seek_stats.p999_latency_us);
             fprintf(fp, "  SEEK max: %.2f μs vs %.2f μs\n", results->seek_stats.max_latency_us,
                     baseline->seek_stats.max_latency_us);
             fprintf(fp, "  SEEK CV: %.2f%% vs %.2f%%\n", results->seek_stats.cv_percent,
@@ -1659,12 +5297,61 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
                     baseline->range_stats.avg_latency_us);
             fprintf(fp, "  RANGE p99: %.2f μs vs %.2f μs\n", results->range_stats.p99_latency_us,
                     baseline->range_stats.p99_latency_us);
+            fprintf(fp, "  RANGE p99.9: %.2f μs vs %.2f μs\n", results->range_stats.p999_latency_us,
+                    baseline->range_stats.p999_latency_us);
             fprintf(fp, "  RANGE max: %.2f μs vs %.2f μs\n", results->range_stats.max_latency_us,
                     baseline->range_stats.max_latency_us);
             fprintf(fp, "  RANGE CV: %.2f%% vs %.2f%%\n", results->range_stats.cv_percent,
                     baseline->range_stats.cv_percent);
         }
 
+        if (results->multiget_stats.avg_latency_us > 0 &&
+            baseline->multiget_stats.avg_latency_us > 0)
+        {
+            fprintf(fp, "  MULTIGET avg: %.2f μs vs %.2f μs\n",
+                    results->multiget_stats.avg_latency_us,
+                    baseline->multiget_stats.avg_latency_us);
+            fprintf(fp, "  MULTIGET p99: %.2f μs vs %.2f μs\n",
+                    results->multiget_stats.p99_latency_us,
+                    baseline->multiget_stats.p99_latency_us);
+            fprintf(fp, "  MULTIGET p99.9: %.2f μs vs %.2f μs\n",
+                    results->multiget_stats.p999_latency_us,
+                    baseline->multiget_stats.p999_latency_us);
+            fprintf(fp, "  MULTIGET max: %.2f μs vs %.2f μs\n",
+                    results->multiget_stats.max_latency_us,
+                    baseline->multiget_stats.max_latency_us);
+            fprintf(fp, "  MULTIGET CV: %.2f%% vs %.2f%%\n", results->multiget_stats.cv_percent,
+                    baseline->multiget_stats.cv_percent);
+        }
+
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if (results->mix_op_counts[op] == 0 || baseline->mix_op_counts[op] == 0) continue;
+            fprintf(fp, "  MIXED %s p99: %.2f μs vs %.2f μs\n", mix_op_names[op],
+                    results->mix_op_stats[op].p99_latency_us,
+                    baseline->mix_op_stats[op].p99_latency_us);
+        }
+
+        /* cpu efficiency, only with --perf-counters and counters both runs could open */
+        const char* perf_names[] = {"PUT", "GET", "DELETE", "SEEK", "RANGE", "MULTIGET", "MIXED"};
+        const operation_stats_t* perf_a[] = {
+            &results->put_stats,  &results->get_stats,      &results->delete_stats,
+            &results->seek_stats, &results->range_stats,    &results->multiget_stats,
+            &results->mix_stats};
+        const operation_stats_t* perf_b[] = {
+            &baseline->put_stats,  &baseline->get_stats,      &baseline->delete_stats,
+            &baseline->seek_stats, &baseline->range_stats,    &baseline->multiget_stats,
+            &baseline->mix_stats};
+        for (int i = 0; i < 7; i++)
+        {
+            if (perf_ipc(perf_a[i]) < 0 || perf_ipc(perf_b[i]) < 0) continue;
+            fprintf(fp, "  %s IPC: %.2f vs %.2f\n", perf_names[i], perf_ipc(perf_a[i]),
+                    perf_ipc(perf_b[i]));
+            fprintf(fp, "  %s cycles/op: %.0f vs %.0f\n", perf_names[i],
+                    perf_per_op(perf_a[i], perf_a[i]->perf.cycles),
+                    perf_per_op(perf_b[i], perf_b[i]->perf.cycles));
+        }
+
         /* resource comparison */
         fprintf(fp, "\nResource Comparison:\n");
         fprintf(fp, "  Peak RSS: %.2f MB vs %.2f MB\n",
@@ -1679,6 +5366,22 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
         fprintf(fp, "  Disk Writes: %.2f MB vs %.2f MB\n",
                 results->resources.bytes_written / (1024.0 * 1024.0),
                 baseline->resources.bytes_written / (1024.0 * 1024.0));
+        if (results->resources.device[0] && baseline->resources.device[0])
+        {
+            fprintf(fp, "  Device Writes: %.2f MB vs %.2f MB\n",
+                    results->resources.device_bytes_written / (1024.0 * 1024.0),
+                    baseline->resources.device_bytes_written / (1024.0 * 1024.0));
+            fprintf(fp, "  Device Utilization: %.1f%% vs %.1f%%\n",
+                    results->resources.device_util_percent,
+                    baseline->resources.device_util_percent);
+        }
+        if (results->resources.has_fsync && baseline->resources.has_fsync)
+        {
+            fprintf(fp, "  Syncs: %" PRIu64 " vs %" PRIu64 "\n", results->resources.fsync_count,
+                    baseline->resources.fsync_count);
+            fprintf(fp, "  Sync p99: %.2f μs vs %.2f μs\n", results->resources.fsync_p99_us,
+                    baseline->resources.fsync_p99_us);
+        }
         fprintf(fp, "  CPU User Time: %.3f s vs %.3f s\n", results->resources.cpu_user_time,
                 baseline->resources.cpu_user_time);
         fprintf(fp, "  CPU System Time: %.3f s vs %.3f s\n", results->resources.cpu_system_time,
@@ -1713,7 +5416,7 @@ void generate_report(FILE* fp, benchmark_results_t* results, benchmark_results_t
     }
 }
 
-static const char* workload_to_string(workload_type_t type)
+const char* workload_to_string(workload_type_t type)
 {
     switch (type)
     {
@@ -1729,12 +5432,22 @@ static const char* workload_to_string(workload_type_t type)
             return "seek";
         case WORKLOAD_RANGE:
             return "range";
+        case WORKLOAD_SCAN:
+            return "scan";
+        case WORKLOAD_MULTIGET:
+            return "multiget";
+        case WORKLOAD_INGEST:
+            return "ingest";
+        case WORKLOAD_REPLAY:
+            return "replay";
+        case WORKLOAD_RECOVERY:
+            return "recovery";
         default:
             return "unknown";
     }
 }
 
-static const char* pattern_to_string(key_pattern_t pattern)
+const char* pattern_to_string(key_pattern_t pattern)
 {
     switch (pattern)
     {
@@ -1750,11 +5463,241 @@ static const char* pattern_to_string(key_pattern_t pattern)
             return "timestamp";
         case KEY_PATTERN_REVERSE:
             return "reverse";
+        case KEY_PATTERN_SCRAMBLED_ZIPFIAN:
+            return "scrambled";
+        case KEY_PATTERN_LATEST:
+            return "latest";
+        case KEY_PATTERN_HOTSPOT:
+            return "hotspot";
         default:
             return "unknown";
     }
 }
 
+/* engine statistics columns, -1 when the engine does not report the field or has no get_stats */
+#define CSV_ENGINE_FMT                                                                  \
+    ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 \
+    ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 \
+    ",%" PRId64
+#define CSV_ENGINE_STAT(es, f) ((es)->valid ? (es)->f : (int64_t)-1)
+#define CSV_ENGINE_ARGS(es)                                                                 \
+    CSV_ENGINE_STAT(es, stall_us), CSV_ENGINE_STAT(es, flush_write_bytes),                  \
+        CSV_ENGINE_STAT(es, compaction_read_bytes),                                         \
+        CSV_ENGINE_STAT(es, compaction_write_bytes), CSV_ENGINE_STAT(es, block_cache_hits), \
+        CSV_ENGINE_STAT(es, block_cache_misses), CSV_ENGINE_STAT(es, bloom_useful),         \
+        CSV_ENGINE_STAT(es, pending_compaction_bytes),                                      \
+        CSV_ENGINE_STAT(es, immutable_memtables), CSV_ENGINE_STAT(es, memtable_bytes),      \
+        CSV_ENGINE_STAT(es, l0_files), CSV_ENGINE_STAT(es, table_files),                    \
+        CSV_ENGINE_STAT(es, live_data_bytes), CSV_ENGINE_STAT(es, num_keys),                \
+        CSV_ENGINE_STAT(es, tree_depth)
+
+/* block device and fsync shim columns of the run, the device is empty and the rest 0 when the
+ * path is not on a block device or the shim is not preloaded */
+#define CSV_DEVICE_FMT ",%s,%.2f,%.2f,%.0f,%.0f,%.1f,%.2f,%" PRIu64 ",%.2f,%.2f,%.2f"
+#define CSV_DEVICE_ARGS(res)                                                                 \
+    (res)->device, (res)->device_bytes_read / (1024.0 * 1024.0),                             \
+        (res)->device_bytes_written / (1024.0 * 1024.0), (res)->device_read_iops,            \
+        (res)->device_write_iops, (res)->device_util_percent, (res)->device_queue_depth,     \
+        (res)->fsync_count, (res)->fsync_avg_us, (res)->fsync_p99_us, (res)->fsync_max_us
+
+/* worker cpu counter columns of the phase, -1 without --perf-counters or when not counted */
+#define CSV_PERF_FMT ",%.3f,%.1f,%.1f,%.3f,%.3f,%" PRId64
+#define CSV_PERF_ARGS(st)                                                                 \
+    perf_ipc(st), perf_per_op(st, (st)->perf.cycles),                                     \
+        perf_per_op(st, (st)->perf.instructions), perf_per_op(st, (st)->perf.llc_misses), \
+        perf_per_op(st, (st)->perf.branch_misses),                                        \
+        (st)->perf.valid ? (st)->perf.context_switches : (int64_t)-1
+#define CSV_WINDOW_FMT ",%.1f,%.1f,%.1f"
+#define CSV_WINDOW_ARGS(st) (st)->warmup_seconds, (st)->steady_state_sec, (st)->steady_cv_percent
+
+/* memory columns, the phase's sampled peak (0 = not sampled), the run's allocator counters at
+ * the end (-1 = not reported), benchtool's buffers, the block cache and peak RSS per key */
+#define CSV_MEMORY_FMT ",%.2f,%s,%.2f,%.2f,%.1f,%.2f,%" PRId64 ",%.1f"
+#define CSV_MEMORY_ARGS(st, res)                                                                 \
+    (st)->peak_rss_bytes / (1024.0 * 1024.0), (res)->allocator,                                  \
+        alloc_mb(res, (res)->alloc_allocated_bytes), alloc_mb(res, (res)->alloc_resident_bytes), \
+        alloc_fragmentation(res), (res)->benchtool_bytes / (1024.0 * 1024.0),                    \
+        CSV_ENGINE_STAT(&(st)->engine_stats, block_cache_bytes),                                 \
+        (res)->num_keys > 0 ? (double)(res)->peak_rss_bytes / (res)->num_keys : -1.0
+
+/* trailing config and per-phase columns shared by every CSV row */
+#define CSV_CONFIG_FMT                                                               \
+    ",%s,%s,%d,%" PRId64 ",%d,%d,%d,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%" PRId64    \
+    ",%" PRId64 ",%.2f,%d" CSV_ENGINE_FMT CSV_DEVICE_FMT CSV_PERF_FMT CSV_WINDOW_FMT \
+        CSV_MEMORY_FMT "\n"
+#define CSV_CONFIG_ARGS(cfg, wl, pat, st, res)                                               \
+    wl, pat, (cfg)->num_threads, (cfg)->num_operations, (cfg)->batch_size, (cfg)->key_size,  \
+        (cfg)->value_size, (cfg)->range_size, (cfg)->sync_enabled, (cfg)->target_rate,       \
+        (st)->uncorrected_p50_us, (st)->uncorrected_p99_us, (st)->uncorrected_p999_us,       \
+        (st)->uncorrected_max_us, (st)->keygen_ns_per_key, (st)->thread_ops_min,             \
+        (st)->thread_ops_max, (st)->thread_idle_max_ms, (cfg)->queue_depth,                  \
+        CSV_ENGINE_ARGS(&(st)->engine_stats), CSV_DEVICE_ARGS(res), CSV_PERF_ARGS(st),        \
+        CSV_WINDOW_ARGS(st), CSV_MEMORY_ARGS(st, res)
+
+/* one CSV row in the generate_csv layout for stats that are not a fixed results field, the mix
+ * op rows, the thread sweep points, the bulk ingest and the cache outcome split. num_threads
+ * overrides the configured thread count, res the resource columns */
+static void write_stats_csv_row(FILE* fp, const benchmark_results_t* r, const char* op_name,
+                                const operation_stats_t* st, const resource_stats_t* res,
+                                const char* workload, const char* pattern, int num_threads)
+{
+    const char* test_name = r->config.test_name ? r->config.test_name : "";
+    benchmark_config_t cfg = r->config;
+    cfg.num_threads = num_threads;
+
+    fprintf(fp,
+            "%s,%s,%s,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+            "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
+            r->engine_name, test_name, op_name, st->ops_per_second, st->duration_seconds,
+            st->avg_latency_us, st->std_dev_us, st->cv_percent, st->p50_latency_us,
+            st->p95_latency_us, st->p99_latency_us, st->p999_latency_us, st->p9999_latency_us,
+            st->min_latency_us, st->max_latency_us, res->peak_rss_bytes / (1024.0 * 1024.0),
+            res->peak_vms_bytes / (1024.0 * 1024.0), res->bytes_read / (1024.0 * 1024.0),
+            res->bytes_written / (1024.0 * 1024.0), res->cpu_user_time, res->cpu_system_time,
+            res->cpu_percent, res->storage_size_bytes / (1024.0 * 1024.0),
+            res->write_amplification, res->read_amplification, res->space_amplification,
+            CSV_CONFIG_ARGS(&cfg, workload, pattern, st, res));
+}
+
+/* writes one CSV row per active op type of the concurrent mixed phase (MIXED, MIX_GET, ...) */
+static void write_mix_csv_rows(FILE* fp, const benchmark_results_t* r, const char* workload,
+                               const char* pattern)
+{
+    if (r->mix_stats.ops_per_second <= 0) return;
+
+    int replay = r->config.workload_type == WORKLOAD_REPLAY;
+    for (int op = -1; op < MIX_OP_COUNT; op++)
+    {
+        const operation_stats_t* st = op < 0 ? &r->mix_stats : &r->mix_op_stats[op];
+        char op_name[32];
+        if (op < 0)
+        {
+            snprintf(op_name, sizeof(op_name), replay ? "REPLAY" : "MIXED");
+        }
+        else
+        {
+            if (r->mix_op_counts[op] == 0) continue;
+            snprintf(op_name, sizeof(op_name), "%s_%s", replay ? "REPLAY" : "MIX",
+                     mix_op_names[op]);
+        }
+
+        write_stats_csv_row(fp, r, op_name, st, &r->resources, workload, pattern,
+                            r->config.num_threads);
+    }
+}
+
+/* sweep points are SWEEP_<phase> rows, num_threads carries the point's thread count */
+static void write_sweep_csv_rows(FILE* fp, const benchmark_results_t* r, const char* workload,
+                                 const char* pattern)
+{
+    char op_name[32];
+    for (int i = 0; i < r->sweep_count; i++)
+    {
+        snprintf(op_name, sizeof(op_name), "SWEEP_%s", r->sweep_phase);
+        write_stats_csv_row(fp, r, op_name, &r->sweep_stats[i], &r->resources, workload,
+                            pattern, r->config.thread_sweep[i]);
+    }
+}
+
+/* families are <phase>_CF<i> rows, the engine columns carry the family's gauges */
+static void write_cf_csv_rows(FILE* fp, const benchmark_results_t* r, const char* workload,
+                              const char* pattern)
+{
+    char op_name[48];
+    for (int p = 0; p < r->cf_phase_count; p++)
+    {
+        for (int cf = 0; cf < r->config.num_column_families; cf++)
+        {
+            snprintf(op_name, sizeof(op_name), "%s_CF%d", r->cf_phases[p], cf);
+            write_stats_csv_row(fp, r, op_name, &r->cf_stats[p][cf], &r->resources, workload,
+                                pattern, r->config.num_threads);
+        }
+    }
+}
+
+/* object store runs split the GET phase into GET_HIT and GET_MISS rows by local cache outcome */
+static void write_remote_csv_rows(FILE* fp, const benchmark_results_t* r, const char* workload,
+                                  const char* pattern)
+{
+    if (!r->has_remote || r->get_hit_stats.duration_seconds <= 0.0) return;
+
+    write_stats_csv_row(fp, r, "GET_HIT", &r->get_hit_stats, &r->resources, workload, pattern,
+                        r->config.num_threads);
+    write_stats_csv_row(fp, r, "GET_MISS", &r->get_miss_stats, &r->resources, workload, pattern,
+                        r->config.num_threads);
+}
+
+/* -w scan writes a SCAN and a SCAN_REV row for the directions that ran */
+static void write_scan_csv_rows(FILE* fp, const benchmark_results_t* r, const char* workload,
+                                const char* pattern)
+{
+    if (r->scan_stats.ops_per_second > 0)
+    {
+        write_stats_csv_row(fp, r, "SCAN", &r->scan_stats, &r->resources, workload, pattern,
+                            r->config.num_threads);
+    }
+    if (r->reverse_scan_stats.ops_per_second > 0)
+    {
+        write_stats_csv_row(fp, r, "SCAN_REV", &r->reverse_scan_stats, &r->resources, workload,
+                            pattern, r->config.num_threads);
+    }
+}
+
+/* the INGEST row carries the resources of the ingested database, not of the main run. the
+ * bulk load always streams sequential keys from one writer */
+static void write_ingest_csv_row(FILE* fp, const benchmark_results_t* r, const char* workload)
+{
+    if (r->ingest_stats.ops_per_second <= 0) return;
+
+    write_stats_csv_row(fp, r, "INGEST", &r->ingest_stats, &r->ingest_resources, workload,
+                        "sequential", 1);
+}
+
+/* appends an op that ran to the results_ops list */
+static void add_result_op(result_op_t* ops, int* n, const char* name,
+                          const operation_stats_t* st)
+{
+    if (st->ops_per_second <= 0 || *n >= BENCHMARK_MAX_RESULT_OPS) return;
+    snprintf(ops[*n].name, sizeof(ops[*n].name), "%s", name);
+    ops[*n].stats = st;
+    (*n)++;
+}
+
+int results_ops(const benchmark_results_t* results, result_op_t* ops)
+{
+    int n = 0;
+    add_result_op(ops, &n, "PUT", &results->put_stats);
+    add_result_op(ops, &n, "GET", &results->get_stats);
+    add_result_op(ops, &n, "DELETE", &results->delete_stats);
+    add_result_op(ops, &n, "SEEK", &results->seek_stats);
+    add_result_op(ops, &n, "RANGE", &results->range_stats);
+    add_result_op(ops, &n, "MULTIGET", &results->multiget_stats);
+
+    int replay = results->config.workload_type == WORKLOAD_REPLAY;
+    if (results->mix_stats.ops_per_second > 0)
+    {
+        add_result_op(ops, &n, replay ? "REPLAY" : "MIXED", &results->mix_stats);
+        for (int op = 0; op < MIX_OP_COUNT; op++)
+        {
+            if (results->mix_op_counts[op] == 0) continue;
+            char name[32];
+            snprintf(name, sizeof(name), "%s_%s", replay ? "REPLAY" : "MIX", mix_op_names[op]);
+            add_result_op(ops, &n, name, &results->mix_op_stats[op]);
+        }
+    }
+
+    add_result_op(ops, &n, "INGEST", &results->ingest_stats);
+    add_result_op(ops, &n, "SCAN", &results->scan_stats);
+    add_result_op(ops, &n, "SCAN_REV", &results->reverse_scan_stats);
+    if (results->has_remote && results->get_hit_stats.duration_seconds > 0.0)
+    {
+        add_result_op(ops, &n, "GET_HIT", &results->get_hit_stats);
+        add_result_op(ops, &n, "GET_MISS", &results->get_miss_stats);
+    }
+    add_result_op(ops, &n, "ITER", &results->iteration_stats);
+    return n;
+}
+
 void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* baseline,
                   int write_header)
 {
@@ -1764,34 +5707,41 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
     const char* pattern = pattern_to_string(results->config.key_pattern);
     const char* test_name = results->config.test_name ? results->config.test_name : "";
 
-#define CSV_CONFIG_FMT ",%s,%s,%d,%" PRId64 ",%d,%d,%d,%d,%d\n"
-#define CSV_CONFIG_ARGS(cfg, wl, pat)                                                       \
-    wl, pat, (cfg)->num_threads, (cfg)->num_operations, (cfg)->batch_size, (cfg)->key_size, \
-        (cfg)->value_size, (cfg)->range_size, (cfg)->sync_enabled
-
     /* we write CSV header only if file is empty/new */
     if (write_header)
     {
         fprintf(fp,
                 "engine,test_name,operation,ops_per_sec,duration_sec,avg_latency_us,stddev_us,"
-                "cv_percent,p50_us,p95_us,p99_us,min_us,max_us,"
+                "cv_percent,p50_us,p95_us,p99_us,p999_us,p9999_us,min_us,max_us,"
                 "peak_rss_mb,peak_vms_mb,disk_read_mb,disk_write_mb,"
                 "cpu_user_sec,cpu_sys_sec,cpu_percent,db_size_mb,"
                 "write_amp,read_amp,space_amp,"
                 "workload,pattern,threads,num_operations,batch_size,key_size,value_size,"
-                "range_size,sync_enabled\n");
+                "range_size,sync_enabled,target_rate,uncorrected_p50_us,uncorrected_p99_us,"
+                "uncorrected_p999_us,uncorrected_max_us,keygen_ns_per_key,thread_ops_min,"
+                "thread_ops_max,thread_idle_max_ms,queue_depth,stall_us,flush_write_bytes,"
+                "compaction_read_bytes,compaction_write_bytes,block_cache_hits,"
+                "block_cache_misses,bloom_useful,pending_compaction_bytes,immutable_memtables,"
+                "memtable_bytes,l0_files,table_files,live_data_bytes,num_keys,tree_depth,device,"
+                "device_read_mb,device_write_mb,device_read_iops,device_write_iops,"
+                "device_util_pct,device_queue_depth,sync_count,sync_avg_us,sync_p99_us,"
+                "sync_max_us,ipc,cycles_per_op,instructions_per_op,llc_misses_per_op,"
+                "branch_misses_per_op,context_switches,warmup_sec,steady_state_sec,"
+                "steady_cv_pct,phase_peak_rss_mb,allocator,allocated_mb,allocator_resident_mb,"
+                "fragmentation_pct,benchtool_mb,block_cache_bytes,rss_bytes_per_key\n");
     }
 
     if (results->put_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,PUT,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%s,%s,PUT,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->put_stats.ops_per_second,
                 results->put_stats.duration_seconds, results->put_stats.avg_latency_us,
                 results->put_stats.std_dev_us, results->put_stats.cv_percent,
                 results->put_stats.p50_latency_us, results->put_stats.p95_latency_us,
-                results->put_stats.p99_latency_us, results->put_stats.min_latency_us,
+                results->put_stats.p99_latency_us, results->put_stats.p999_latency_us,
+                results->put_stats.p9999_latency_us, results->put_stats.min_latency_us,
                 results->put_stats.max_latency_us,
                 results->resources.peak_rss_bytes / (1024.0 * 1024.0),
                 results->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1802,19 +5752,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->put_stats,
+                                &results->resources));
     }
 
     if (results->get_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,GET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%s,%s,GET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->get_stats.ops_per_second,
                 results->get_stats.duration_seconds, results->get_stats.avg_latency_us,
                 results->get_stats.std_dev_us, results->get_stats.cv_percent,
                 results->get_stats.p50_latency_us, results->get_stats.p95_latency_us,
-                results->get_stats.p99_latency_us, results->get_stats.min_latency_us,
+                results->get_stats.p99_latency_us, results->get_stats.p999_latency_us,
+                results->get_stats.p9999_latency_us, results->get_stats.min_latency_us,
                 results->get_stats.max_latency_us,
                 results->resources.peak_rss_bytes / (1024.0 * 1024.0),
                 results->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1825,19 +5777,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->get_stats,
+                                &results->resources));
     }
 
     if (results->delete_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,DELETE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%s,%s,DELETE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->delete_stats.ops_per_second,
                 results->delete_stats.duration_seconds, results->delete_stats.avg_latency_us,
                 results->delete_stats.std_dev_us, results->delete_stats.cv_percent,
                 results->delete_stats.p50_latency_us, results->delete_stats.p95_latency_us,
-                results->delete_stats.p99_latency_us, results->delete_stats.min_latency_us,
+                results->delete_stats.p99_latency_us, results->delete_stats.p999_latency_us,
+                results->delete_stats.p9999_latency_us, results->delete_stats.min_latency_us,
                 results->delete_stats.max_latency_us,
                 results->resources.peak_rss_bytes / (1024.0 * 1024.0),
                 results->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1848,19 +5802,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->delete_stats,
+                                &results->resources));
     }
 
     if (results->seek_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,SEEK,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%s,%s,SEEK,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->seek_stats.ops_per_second,
                 results->seek_stats.duration_seconds, results->seek_stats.avg_latency_us,
                 results->seek_stats.std_dev_us, results->seek_stats.cv_percent,
                 results->seek_stats.p50_latency_us, results->seek_stats.p95_latency_us,
-                results->seek_stats.p99_latency_us, results->seek_stats.min_latency_us,
+                results->seek_stats.p99_latency_us, results->seek_stats.p999_latency_us,
+                results->seek_stats.p9999_latency_us, results->seek_stats.min_latency_us,
                 results->seek_stats.max_latency_us,
                 results->resources.peak_rss_bytes / (1024.0 * 1024.0),
                 results->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1871,19 +5827,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->seek_stats,
+                                &results->resources));
     }
 
     if (results->range_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,RANGE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%s,%s,RANGE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->range_stats.ops_per_second,
                 results->range_stats.duration_seconds, results->range_stats.avg_latency_us,
                 results->range_stats.std_dev_us, results->range_stats.cv_percent,
                 results->range_stats.p50_latency_us, results->range_stats.p95_latency_us,
-                results->range_stats.p99_latency_us, results->range_stats.min_latency_us,
+                results->range_stats.p99_latency_us, results->range_stats.p999_latency_us,
+                results->range_stats.p9999_latency_us, results->range_stats.min_latency_us,
                 results->range_stats.max_latency_us,
                 results->resources.peak_rss_bytes / (1024.0 * 1024.0),
                 results->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1894,13 +5852,46 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->range_stats,
+                                &results->resources));
+    }
+
+    if (results->multiget_stats.ops_per_second > 0)
+    {
+        fprintf(fp,
+                "%s,%s,MULTIGET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
+                engine, test_name, results->multiget_stats.ops_per_second,
+                results->multiget_stats.duration_seconds, results->multiget_stats.avg_latency_us,
+                results->multiget_stats.std_dev_us, results->multiget_stats.cv_percent,
+                results->multiget_stats.p50_latency_us, results->multiget_stats.p95_latency_us,
+                results->multiget_stats.p99_latency_us, results->multiget_stats.p999_latency_us,
+                results->multiget_stats.p9999_latency_us, results->multiget_stats.min_latency_us,
+                results->multiget_stats.max_latency_us,
+                results->resources.peak_rss_bytes / (1024.0 * 1024.0),
+                results->resources.peak_vms_bytes / (1024.0 * 1024.0),
+                results->resources.bytes_read / (1024.0 * 1024.0),
+                results->resources.bytes_written / (1024.0 * 1024.0),
+                results->resources.cpu_user_time, results->resources.cpu_system_time,
+                results->resources.cpu_percent,
+                results->resources.storage_size_bytes / (1024.0 * 1024.0),
+                results->resources.write_amplification, results->resources.read_amplification,
+                results->resources.space_amplification,
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->multiget_stats,
+                                &results->resources));
     }
 
+    write_mix_csv_rows(fp, results, workload, pattern);
+    write_sweep_csv_rows(fp, results, workload, pattern);
+    write_cf_csv_rows(fp, results, workload, pattern);
+    write_ingest_csv_row(fp, results, workload);
+    write_scan_csv_rows(fp, results, workload, pattern);
+    write_remote_csv_rows(fp, results, workload, pattern);
+
     if (results->iteration_stats.ops_per_second > 0)
     {
         fprintf(fp,
-                "%s,%s,ITER,%.2f,%.3f,,,,,,,,"
+                "%s,%s,ITER,%.2f,%.3f,,,,,,,,,,,"
                 "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                 engine, test_name, results->iteration_stats.ops_per_second,
                 results->iteration_stats.duration_seconds,
@@ -1913,7 +5904,8 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                 results->resources.storage_size_bytes / (1024.0 * 1024.0),
                 results->resources.write_amplification, results->resources.read_amplification,
                 results->resources.space_amplification,
-                CSV_CONFIG_ARGS(&results->config, workload, pattern));
+                CSV_CONFIG_ARGS(&results->config, workload, pattern, &results->iteration_stats,
+                                &results->resources));
     }
 
     if (baseline)
@@ -1926,13 +5918,14 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
         if (baseline->put_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,PUT,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%s,%s,PUT,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->put_stats.ops_per_second,
                     baseline->put_stats.duration_seconds, baseline->put_stats.avg_latency_us,
                     baseline->put_stats.std_dev_us, baseline->put_stats.cv_percent,
                     baseline->put_stats.p50_latency_us, baseline->put_stats.p95_latency_us,
-                    baseline->put_stats.p99_latency_us, baseline->put_stats.min_latency_us,
+                    baseline->put_stats.p99_latency_us, baseline->put_stats.p999_latency_us,
+                    baseline->put_stats.p9999_latency_us, baseline->put_stats.min_latency_us,
                     baseline->put_stats.max_latency_us,
                     baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
                     baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1943,19 +5936,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->put_stats, &baseline->resources));
         }
 
         if (baseline->get_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,GET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%s,%s,GET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->get_stats.ops_per_second,
                     baseline->get_stats.duration_seconds, baseline->get_stats.avg_latency_us,
                     baseline->get_stats.std_dev_us, baseline->get_stats.cv_percent,
                     baseline->get_stats.p50_latency_us, baseline->get_stats.p95_latency_us,
-                    baseline->get_stats.p99_latency_us, baseline->get_stats.min_latency_us,
+                    baseline->get_stats.p99_latency_us, baseline->get_stats.p999_latency_us,
+                    baseline->get_stats.p9999_latency_us, baseline->get_stats.min_latency_us,
                     baseline->get_stats.max_latency_us,
                     baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
                     baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1966,19 +5961,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->get_stats, &baseline->resources));
         }
 
         if (baseline->delete_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,DELETE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%s,%s,DELETE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->delete_stats.ops_per_second,
                     baseline->delete_stats.duration_seconds, baseline->delete_stats.avg_latency_us,
                     baseline->delete_stats.std_dev_us, baseline->delete_stats.cv_percent,
                     baseline->delete_stats.p50_latency_us, baseline->delete_stats.p95_latency_us,
-                    baseline->delete_stats.p99_latency_us, baseline->delete_stats.min_latency_us,
+                    baseline->delete_stats.p99_latency_us, baseline->delete_stats.p999_latency_us,
+                    baseline->delete_stats.p9999_latency_us, baseline->delete_stats.min_latency_us,
                     baseline->delete_stats.max_latency_us,
                     baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
                     baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -1989,19 +5986,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->delete_stats, &baseline->resources));
         }
 
         if (baseline->seek_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,SEEK,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%s,%s,SEEK,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->seek_stats.ops_per_second,
                     baseline->seek_stats.duration_seconds, baseline->seek_stats.avg_latency_us,
                     baseline->seek_stats.std_dev_us, baseline->seek_stats.cv_percent,
                     baseline->seek_stats.p50_latency_us, baseline->seek_stats.p95_latency_us,
-                    baseline->seek_stats.p99_latency_us, baseline->seek_stats.min_latency_us,
+                    baseline->seek_stats.p99_latency_us, baseline->seek_stats.p999_latency_us,
+                    baseline->seek_stats.p9999_latency_us, baseline->seek_stats.min_latency_us,
                     baseline->seek_stats.max_latency_us,
                     baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
                     baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -2012,19 +6011,21 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->seek_stats, &baseline->resources));
         }
 
         if (baseline->range_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,RANGE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%s,%s,RANGE,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->range_stats.ops_per_second,
                     baseline->range_stats.duration_seconds, baseline->range_stats.avg_latency_us,
                     baseline->range_stats.std_dev_us, baseline->range_stats.cv_percent,
                     baseline->range_stats.p50_latency_us, baseline->range_stats.p95_latency_us,
-                    baseline->range_stats.p99_latency_us, baseline->range_stats.min_latency_us,
+                    baseline->range_stats.p99_latency_us, baseline->range_stats.p999_latency_us,
+                    baseline->range_stats.p9999_latency_us, baseline->range_stats.min_latency_us,
                     baseline->range_stats.max_latency_us,
                     baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
                     baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
@@ -2035,13 +6036,49 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->range_stats, &baseline->resources));
+        }
+
+        if (baseline->multiget_stats.ops_per_second > 0)
+        {
+            fprintf(fp,
+                    "%s,%s,MULTIGET,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
+                    baseline_engine, baseline_test_name, baseline->multiget_stats.ops_per_second,
+                    baseline->multiget_stats.duration_seconds,
+                    baseline->multiget_stats.avg_latency_us, baseline->multiget_stats.std_dev_us,
+                    baseline->multiget_stats.cv_percent, baseline->multiget_stats.p50_latency_us,
+                    baseline->multiget_stats.p95_latency_us,
+                    baseline->multiget_stats.p99_latency_us,
+                    baseline->multiget_stats.p999_latency_us,
+                    baseline->multiget_stats.p9999_latency_us,
+                    baseline->multiget_stats.min_latency_us,
+                    baseline->multiget_stats.max_latency_us,
+                    baseline->resources.peak_rss_bytes / (1024.0 * 1024.0),
+                    baseline->resources.peak_vms_bytes / (1024.0 * 1024.0),
+                    baseline->resources.bytes_read / (1024.0 * 1024.0),
+                    baseline->resources.bytes_written / (1024.0 * 1024.0),
+                    baseline->resources.cpu_user_time, baseline->resources.cpu_system_time,
+                    baseline->resources.cpu_percent,
+                    baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
+                    baseline->resources.write_amplification, baseline->resources.read_amplification,
+                    baseline->resources.space_amplification,
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->multiget_stats, &baseline->resources));
         }
 
+        write_mix_csv_rows(fp, baseline, baseline_workload, baseline_pattern);
+        write_sweep_csv_rows(fp, baseline, baseline_workload, baseline_pattern);
+        write_cf_csv_rows(fp, baseline, baseline_workload, baseline_pattern);
+        write_ingest_csv_row(fp, baseline, baseline_workload);
+        write_scan_csv_rows(fp, baseline, baseline_workload, baseline_pattern);
+        write_remote_csv_rows(fp, baseline, baseline_workload, baseline_pattern);
+
         if (baseline->iteration_stats.ops_per_second > 0)
         {
             fprintf(fp,
-                    "%s,%s,ITER,%.2f,%.3f,,,,,,,,"
+                    "%s,%s,ITER,%.2f,%.3f,,,,,,,,,,,"
                     "%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f" CSV_CONFIG_FMT,
                     baseline_engine, baseline_test_name, baseline->iteration_stats.ops_per_second,
                     baseline->iteration_stats.duration_seconds,
@@ -2054,7 +6091,8 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
                     baseline->resources.storage_size_bytes / (1024.0 * 1024.0),
                     baseline->resources.write_amplification, baseline->resources.read_amplification,
                     baseline->resources.space_amplification,
-                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern));
+                    CSV_CONFIG_ARGS(&baseline->config, baseline_workload, baseline_pattern,
+                                    &baseline->iteration_stats, &baseline->resources));
         }
     }
 
@@ -2062,7 +6100,55 @@ void generate_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* b
 #undef CSV_CONFIG_ARGS
 }
 
+/* sweep rows of one run, a field the point does not have stays empty */
+static void write_sweep_points(FILE* fp, const benchmark_results_t* r)
+{
+    const char* test_name = r->config.test_name ? r->config.test_name : "";
+    for (int i = 0; i < r->sweep_count; i++)
+    {
+        const operation_stats_t* st = &r->sweep_stats[i];
+        double hit_rate = engine_hit_rate(&st->engine_stats);
+        fprintf(fp, "%s,%s,threads,%s,%d,,%zu,,%.2f,%.2f,%.2f,%.2f,", r->engine_name, test_name,
+                r->sweep_phase, r->config.thread_sweep[i], r->config.block_cache_size,
+                st->ops_per_second, st->avg_latency_us, st->p50_latency_us, st->p99_latency_us);
+        if (hit_rate >= 0.0) fprintf(fp, "%.4f", hit_rate);
+        fprintf(fp, ",\n");
+    }
+    for (int i = 0; i < r->cache_sweep_count; i++)
+    {
+        const cache_sweep_point_t* pt = &r->cache_sweep[i];
+        const cache_sweep_phase_t* phases[2] = {&pt->get, &pt->range};
+        const char* names[2] = {"GET", "RANGE"};
+        for (int p = 0; p < 2; p++)
+        {
+            const operation_stats_t* st = &phases[p]->stats;
+            fprintf(fp, "%s,%s,cache,%s,%d,%.4f,%zu,%zu,%.2f,%.2f,%.2f,%.2f,", r->engine_name,
+                    test_name, names[p], r->config.num_threads, pt->fraction, pt->cache_bytes,
+                    pt->memory_limit_bytes, st->ops_per_second, st->avg_latency_us,
+                    st->p50_latency_us, st->p99_latency_us);
+            if (phases[p]->hit_rate >= 0.0) fprintf(fp, "%.4f", phases[p]->hit_rate);
+            fprintf(fp, ",%.2f\n", phases[p]->bytes_read / (1024.0 * 1024.0));
+        }
+    }
+}
+
+void generate_sweep_csv(FILE* fp, benchmark_results_t* results, benchmark_results_t* baseline,
+                        int write_header)
+{
+    if (write_header)
+    {
+        fprintf(fp,
+                "engine,test_name,sweep,operation,threads,cache_fraction,cache_bytes,"
+                "memory_limit_bytes,ops_per_sec,avg_latency_us,p50_us,p99_us,cache_hit_rate,"
+                "disk_read_mb\n");
+    }
+    write_sweep_points(fp, results);
+    if (baseline) write_sweep_points(fp, baseline);
+}
+
 void free_results(benchmark_results_t* results)
 {
-    if (results) free(results);
+    if (!results) return;
+    for (int i = 0; i < results->hist_count; i++) free(results->hists[i].hist);
+    free(results);
 }
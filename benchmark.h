@@ -27,26 +27,122 @@ const char *get_engine_version(const char *engine_name);
 #include <stddef.h>
 #include <stdio.h>
 
+#include "histogram.h"
+
 typedef enum
 {
     WORKLOAD_WRITE,
     WORKLOAD_READ,
     WORKLOAD_MIXED,
     WORKLOAD_DELETE,
-    WORKLOAD_SEEK, /* seek to specific keys */
-    WORKLOAD_RANGE /* range queries (seek + iterate N keys) */
+    WORKLOAD_SEEK,     /* seek to specific keys */
+    WORKLOAD_RANGE,    /* range queries (seek + iterate N keys) */
+    WORKLOAD_MULTIGET, /* batched point lookups of batch_size keys */
+    WORKLOAD_INGEST,   /* sorted PUT path, then a bulk ingest of the same keys for comparison */
+    WORKLOAD_REPLAY,   /* the ops of a --trace file, optionally at their original timing */
+    WORKLOAD_RECOVERY, /* a writer killed with SIGKILL, then the reopen and the recovered keys */
+    WORKLOAD_SCAN      /* bounded range scans of variable length, forward and reverse */
 } workload_type_t;
 
+/* -w scan, the directions the scan phases run in */
+#define SCAN_FORWARD 0x1
+#define SCAN_REVERSE 0x2
+
+/* --iter-splits, the boundaries of the parallel ITER ranges */
+typedef enum
+{
+    ITER_SPLITS_AUTO,  /* the engine's split keys when it has them, sampled ones otherwise */
+    ITER_SPLITS_SAMPLE /* keys sampled from the run's key layout */
+} iter_splits_t;
+
 typedef enum
 {
     KEY_PATTERN_SEQUENTIAL,
     KEY_PATTERN_RANDOM,
-    KEY_PATTERN_ZIPFIAN,   /* hot keys (80/20 distribution) */
-    KEY_PATTERN_UNIFORM,   /* true uniform random */
-    KEY_PATTERN_TIMESTAMP, /* monotonically increasing timestamp-like */
-    KEY_PATTERN_REVERSE    /* reverse sequential */
+    KEY_PATTERN_ZIPFIAN,           /* zipfian hot keys at the lowest indexes (zipf_theta) */
+    KEY_PATTERN_UNIFORM,           /* true uniform random */
+    KEY_PATTERN_TIMESTAMP,         /* monotonically increasing timestamp-like */
+    KEY_PATTERN_REVERSE,           /* reverse sequential */
+    KEY_PATTERN_SCRAMBLED_ZIPFIAN, /* zipfian with the hot keys scattered over the keyspace */
+    KEY_PATTERN_LATEST,            /* zipfian skewed toward the most recently inserted keys */
+    KEY_PATTERN_HOTSPOT            /* hotspot_op_fraction of ops on hotspot_key_fraction of keys */
 } key_pattern_t;
 
+typedef enum
+{
+    VALUE_DIST_FIXED,   /* every value is value_size bytes */
+    VALUE_DIST_UNIFORM, /* uniform in [value_size_min, value_size_max] */
+    VALUE_DIST_NORMAL,  /* mean value_size, value_size_stddev, clamped to [min, max] */
+    VALUE_DIST_PARETO   /* scale value_size_min, shape for a mean of value_size, capped at max */
+} value_dist_t;
+
+typedef enum
+{
+    TIMER_MONOTONIC, /* clock_gettime(CLOCK_MONOTONIC) */
+    TIMER_TSC        /* calibrated rdtsc, needs an invariant tsc */
+} timer_source_t;
+
+struct value_pool_t;
+struct trace_t;
+
+/* operation types a mixed-workload worker can pick from */
+typedef enum
+{
+    MIX_OP_PUT,    /* overwrite a preloaded key */
+    MIX_OP_GET,    /* point lookup of a preloaded key */
+    MIX_OP_DELETE, /* delete a preloaded key */
+    MIX_OP_RANGE,  /* seek + iterate range_size keys */
+    MIX_OP_RMW,    /* read-modify-write (get then put the same key) */
+    MIX_OP_INSERT, /* put a fresh key beyond the preloaded keyspace */
+    MIX_OP_COUNT
+} mix_op_t;
+
+/* placement of the worker threads on the host cpus */
+typedef enum
+{
+    AFFINITY_NONE,    /* leave placement to the scheduler */
+    AFFINITY_COMPACT, /* fill one NUMA node before moving to the next */
+    AFFINITY_SCATTER, /* deal threads round-robin across NUMA nodes */
+    AFFINITY_LIST     /* explicit cpu list, thread i on the i-th listed cpu */
+} cpu_affinity_t;
+
+/* which part of the benchmark one invocation runs */
+typedef enum
+{
+    BENCH_PHASE_ALL,  /* load where the workload needs it, then measure (default) */
+    BENCH_PHASE_LOAD, /* only load db_path, compact and snapshot it, nothing is measured */
+    BENCH_PHASE_RUN   /* only the measured phases, against an already loaded db_path */
+} bench_phase_t;
+
+/* how a loaded database is copied to and from its snapshot */
+typedef enum
+{
+    SNAPSHOT_REFLINK,  /* copy-on-write clone where supported, plain copy elsewhere */
+    SNAPSHOT_HARDLINK, /* hard links, only safe for engines that never rewrite files in place */
+    SNAPSHOT_COPY      /* plain byte copy */
+} snapshot_mode_t;
+
+/* most thread counts a --thread-sweep can hold */
+#define BENCHMARK_MAX_SWEEP 32
+
+/* most families --column-families can spread the keys over, and the measured phases a run keeps
+ * a per-family split of */
+#define BENCHMARK_MAX_COLUMN_FAMILIES 64
+#define BENCHMARK_MAX_CF_PHASES       4
+
+/* most ranges --iter-ranges can split the ITER pass into */
+#define BENCHMARK_MAX_ITER_RANGES 65536
+
+/* most measured ops results_ops lists for one run */
+#define BENCHMARK_MAX_RESULT_OPS 32
+
+/* inter-arrival process of the open-loop load generator */
+typedef enum
+{
+    ARRIVAL_FIXED,  /* evenly spaced arrivals */
+    ARRIVAL_POISSON /* exponentially distributed inter-arrival gaps */
+} arrival_process_t;
+
 typedef struct
 {
     const char *engine_name;
@@ -65,6 +161,103 @@ typedef struct
     int sync_enabled;
     int range_size; /* number of keys to iterate in range queries (default: 100) */
 
+    /* -w scan, every scan covers a key range [lower, upper) of the sequential layout */
+    int scan_min;             /* fewest keys a scan covers (default: range_size) */
+    int scan_max;             /* most keys, the length is drawn uniformly from [min, max] */
+    int64_t scan_prefix_keys; /* > 0, scans cover a whole decimal prefix of this many keys */
+    int scan_direction;       /* SCAN_FORWARD and/or SCAN_REVERSE */
+    int scan_unbounded;       /* seek and count entries instead of setting iterator bounds */
+    size_t scan_readahead;    /* iterator readahead hint of range and scan phases, 0 = default */
+
+    /* key distribution parameters */
+    double zipf_theta;           /* skew of zipfian, scrambled and latest (0 < theta < 1) */
+    double hotspot_key_fraction; /* share of the keyspace that is hot (default: 0.2) */
+    double hotspot_op_fraction;  /* share of the ops that go to the hot keys (default: 0.8) */
+
+    /* concurrent mixed workload, every worker draws its next op from these weights.
+     * all zero keeps the classic mixed workload (PUT phase then GET phase) */
+    int mix_weights[MIX_OP_COUNT];
+    const char *mix_spec; /* original --mix string, for display only */
+
+    /* interval time-series reporting */
+    int report_interval_ms;      /* sample live stats every N ms (0 = disabled) */
+    const char *timeseries_file; /* CSV, or JSON lines for .json/.jsonl (NULL = stderr) */
+
+    /* open-loop load generation, ops are issued on a schedule instead of back to back */
+    double target_rate;        /* intended ops/sec across all threads (0 = closed loop) */
+    arrival_process_t arrival; /* how arrivals are spaced on the schedule */
+
+    int zero_copy_reads; /* use get_pinned when the engine has it (1 = yes, 0 = copying get) */
+
+    /* worker placement and thread scaling sweep */
+    cpu_affinity_t cpu_affinity;           /* how workers are pinned (default: none) */
+    const char *cpu_list;                  /* cpus for AFFINITY_LIST, e.g. 0-7,16-23 */
+    int thread_sweep[BENCHMARK_MAX_SWEEP]; /* thread counts to rerun the measured phase at */
+    int thread_sweep_count;                /* 0 = no sweep */
+
+    /* block cache sweep over the loaded database */
+    double cache_sweep[BENCHMARK_MAX_SWEEP]; /* block cache sizes as fractions of the dataset */
+    int cache_sweep_count;                   /* 0 = no sweep */
+    size_t cgroup_headroom; /* memory.max of a point is its cache plus this, 0 = no cap */
+    const char *sweep_csv_file; /* one row per sweep point, the curves of both sweeps */
+
+    /* dataset lifecycle, load once and measure many times */
+    bench_phase_t phase;           /* load, run or both (default) */
+    int reuse_db;                  /* keep db_path between runs and skip a load already done */
+    int compact_after_load;        /* fully compact the loaded data before measuring */
+    const char *snapshot_dir;      /* snapshot of the loaded db, restored before each run */
+    snapshot_mode_t snapshot_mode; /* how the snapshot is taken and restored */
+    int queue_depth;               /* outstanding requests per worker, 1 = one synchronous call */
+    int engine_stats;              /* enable the engine's own statistics collection (costs ops) */
+    int keep_histograms; /* copy each measured op's merged latency histogram into the results */
+
+    /* value generation */
+    double compression_ratio; /* compressed / raw size the values aim for, 1.0 = incompressible */
+    value_dist_t value_dist;  /* value size distribution */
+    int value_size_min;       /* smallest value, 0 = distribution default */
+    int value_size_max;       /* largest value, 0 = distribution default */
+    int value_size_stddev;    /* normal distribution, 0 = value_size / 4 */
+    const struct value_pool_t *value_pool; /* set by run_benchmark for the duration of a run */
+
+    /* op timing */
+    timer_source_t timer; /* clock read around every timed op */
+    int latency_sample;   /* time 1 in N single ops, every op still counts toward throughput */
+
+    /* time-bounded runs, both apply to the measured phases */
+    double duration_sec; /* workers loop over the keyspace until the deadline, 0 = num_operations */
+    double warmup_sec;   /* ops of the first warmup_sec are run but left out of the stats */
+    int steady_window;   /* report intervals the steady-state window spans */
+    double steady_cv;    /* steady once the window's throughput cv (percent) is at most this */
+
+    /* trace replay */
+    const char *trace_file;      /* -w replay input */
+    double replay_speed;         /* 0 = as fast as possible, 1 = original timing, 2 = twice */
+    int trace_preload;           /* put every traced key before the replay */
+    const struct trace_t *trace; /* set by run_benchmark for the duration of a run */
+
+    /* -w recovery */
+    int64_t recovery_unflushed; /* keys written after the last flush, -1 = all of them */
+
+    /* the final ITER pass, --iter-ranges splits the keyspace into ranges scanned in parallel */
+    int iter_ranges;           /* 0 = one walk from the first key */
+    iter_splits_t iter_splits; /* where the range boundaries come from */
+
+    /* multi-tenant column families, the keys are routed to a family by a hash of the key */
+    int num_column_families;                       /* 1 = the engine's default family only */
+    int cf_weights[BENCHMARK_MAX_COLUMN_FAMILIES]; /* relative share of the keys per family */
+    int cf_key_sizes[BENCHMARK_MAX_COLUMN_FAMILIES];   /* 0 = key_size */
+    int cf_value_sizes[BENCHMARK_MAX_COLUMN_FAMILIES]; /* 0 = the value pool's size */
+    const char *cf_profile; /* original --cf-profile string, for display only */
+
+    /* memory sampler */
+    int mem_interval_ms;           /* sample the resident set every N ms (0 = disabled) */
+    const char *mem_timeline_file; /* CSV, or JSON lines for .json/.jsonl (NULL = none) */
+
+    /* per-phase profiling */
+    int perf_counters;         /* open perf_event counters on every worker */
+    const char *profile_cmd;   /* shell command started at a phase start, SIGINT at its end */
+    const char *profile_phase; /* only hook this phase (e.g. GET), NULL = every phase */
+
     /* engine configuration options */
     size_t memtable_size;     /* memtable/write buffer size in bytes (0 = use default) */
     size_t block_cache_size;  /* block cache size in bytes (0 = use default) */
@@ -138,8 +331,48 @@ typedef struct
     /* Per-CF object store tuning */
     int object_lazy_compaction;     /* -1 = engine default */
     int object_prefetch_compaction; /* -1 = engine default */
+    /* object store suite */
+    int object_cold_cache;      /* wipe the local cache between the load and the read phases */
+    uint64_t object_latency_us; /* delay injected before every connector request */
 } benchmark_config_t;
 
+/* engine-internal statistics (optional get_stats op). a field is -1 when the engine does not
+ * report it. in a phase's stats the counters cover that phase, the gauges are read at its end */
+typedef struct
+{
+    int valid; /* 0 when no snapshot was taken */
+    /* counters */
+    int64_t stall_us;               /* time writes were stopped or slowed down */
+    int64_t flush_write_bytes;      /* bytes written by memtable flushes */
+    int64_t compaction_read_bytes;  /* bytes read by compactions */
+    int64_t compaction_write_bytes; /* bytes written by compactions */
+    int64_t block_cache_hits;
+    int64_t block_cache_misses;
+    int64_t bloom_useful; /* lookups a bloom filter ruled out */
+    /* gauges */
+    int64_t pending_compaction_bytes; /* compaction debt */
+    int64_t immutable_memtables;      /* memtables waiting for a flush */
+    int64_t memtable_bytes;
+    int64_t block_cache_bytes; /* bytes the block cache holds */
+    int64_t l0_files;
+    int64_t table_files;     /* sstables over all levels */
+    int64_t live_data_bytes; /* size of the engine's data files by its own accounting */
+    int64_t num_keys;        /* exact or estimated key count */
+    int64_t tree_depth;      /* b+tree height */
+} engine_stats_t;
+
+/* perf_event counters summed over the workers of a phase, a field is -1 when the counter could
+ * not be opened (no PMU in the guest, perf_event_paranoid) */
+typedef struct
+{
+    int valid; /* 0 without --perf-counters */
+    int64_t cycles;
+    int64_t instructions;
+    int64_t llc_misses; /* last level cache misses */
+    int64_t branch_misses;
+    int64_t context_switches;
+} perf_counts_t;
+
 typedef struct
 {
     double duration_seconds;
@@ -150,16 +383,75 @@ typedef struct
     double p50_latency_us;
     double p95_latency_us;
     double p99_latency_us;
+    double p999_latency_us;  /* p99.9 */
+    double p9999_latency_us; /* p99.99 */
     double min_latency_us;
     double max_latency_us;
+
+    /* open-loop runs only. the fields above are measured from the intended start time
+     * (coordinated-omission corrected), these from the moment the op was actually issued */
+    double uncorrected_avg_us;
+    double uncorrected_p50_us;
+    double uncorrected_p99_us;
+    double uncorrected_p999_us;
+    double uncorrected_max_us;
+
+    /* key stream cost of the phase, measured outside the op latency */
+    double keygen_ns_per_key;
+    double keygen_percent; /* share of the workers' wall time spent generating keys */
+
+    /* worker balance under the shared-cursor scheduler */
+    int64_t thread_ops_min;    /* fewest ops run by one worker */
+    int64_t thread_ops_max;    /* most ops run by one worker */
+    double thread_idle_avg_ms; /* time a worker sat out of work waiting for the phase to end */
+    double thread_idle_max_ms;
+
+    engine_stats_t engine_stats; /* get_stats over the phase */
+    perf_counts_t perf;          /* worker cpu counters over the phase */
+
+    /* --duration / --warmup, duration_seconds above is the measured window */
+    int64_t ops_total;        /* every op the phase ran, warmup included */
+    double warmup_seconds;    /* run before the measured window */
+    int steady_windows;       /* full steady-state windows evaluated, 0 = not tracked */
+    double steady_state_sec;  /* phase time when the window first turned steady, 0 = never */
+    double steady_cv_percent; /* throughput cv of that window, or of the last one */
+
+    size_t peak_rss_bytes; /* sampled peak resident set over the phase, 0 = not sampled */
+    double items_per_op;   /* scan phases, entries the iterator returned per op */
 } operation_stats_t;
 
+/* a latency histogram kept for one op's stats */
+typedef struct
+{
+    const operation_stats_t *stats; /* points into the results */
+    histogram_t *hist;
+} result_hist_t;
+
 typedef struct
 {
     /* mem metrics */
     size_t peak_rss_bytes; /* peak resident set size */
     size_t peak_vms_bytes; /* peak virtual memory size */
 
+    /* memory accounting at the end of the phases, see memstat.h */
+    uint64_t mem_samples;               /* background samples taken, 0 = sampler off */
+    size_t sampled_peak_rss_bytes;      /* largest sampled resident set */
+    char sampled_peak_phase[16];        /* phase it was sampled in, empty = between phases */
+    size_t rss_anon_bytes;              /* anonymous resident pages */
+    size_t rss_file_bytes;              /* file-backed resident pages */
+    char allocator[16];                 /* allocator the stats below are from, empty = none */
+    int64_t alloc_allocated_bytes;      /* a field is -1 when the allocator does not report it */
+    int64_t alloc_active_bytes;
+    int64_t alloc_resident_bytes;
+    int64_t alloc_mapped_bytes;
+    int64_t alloc_retained_bytes;
+    int64_t alloc_peak_allocated_bytes; /* largest sampled allocated */
+    int64_t benchtool_bytes;            /* benchtool's own buffers at the end */
+    int64_t benchtool_peak_bytes;       /* largest total of them */
+    int64_t block_cache_bytes;          /* engine gauges at the end, -1 = not reported */
+    int64_t memtable_bytes;
+    int64_t num_keys;                   /* engine key count, or the PUT ops when it has none */
+
     /* io metrics */
     size_t bytes_read;    /* total bytes read from disk */
     size_t bytes_written; /* total bytes written to disk */
@@ -178,8 +470,88 @@ typedef struct
 
     /* storage size */
     size_t storage_size_bytes; /* total storage size on disk */
+
+    /* block device behind db_path, every request the device served while the phases ran */
+    char device[32];             /* empty when db_path is not on a block device */
+    size_t device_bytes_read;    /* sectors read * 512 */
+    size_t device_bytes_written; /* sectors written * 512 */
+    double device_read_iops;
+    double device_write_iops;
+    uint64_t device_flushes;     /* cache flush requests */
+    double device_util_percent;  /* wall time the device had requests in flight */
+    double device_queue_depth;   /* average requests in flight */
+
+    /* fsync, fdatasync and msync(MS_SYNC) calls, only with the fsync shim preloaded */
+    int has_fsync;
+    uint64_t fsync_count;
+    double fsync_avg_us;
+    double fsync_p50_us;
+    double fsync_p99_us;
+    double fsync_max_us;
 } resource_stats_t;
 
+/* -w recovery, a forked writer is killed with SIGKILL and the parent reopens its database */
+typedef struct
+{
+    int valid;
+    int64_t unflushed_keys;  /* keys written after the last memtable flush before the kill */
+    int64_t acked;           /* puts acknowledged to the writer before it died */
+    int64_t found;           /* acknowledged keys read back intact after the reopen */
+    int64_t lost;            /* acknowledged keys missing after the reopen */
+    int64_t corrupt;         /* acknowledged keys read back with a wrong value */
+    int64_t unacked_found;   /* keys of the write in flight at the kill that survived */
+    double load_ops_per_sec; /* writer throughput up to the kill */
+    double open_ms;          /* open of the killed database, log replay included */
+    double first_get_us;     /* first lookup after that open, the last acknowledged key */
+    double close_ms;         /* clean close of the recovered database */
+    double clean_open_ms;    /* open after the clean close */
+} recovery_stats_t;
+
+/* the final ITER pass, one walk or the ranges of --iter-ranges. counters are 64-bit, a pass
+ * over a billion keys overflows an int */
+typedef struct
+{
+    uint64_t keys;
+    uint64_t bytes;          /* key and value bytes the iterators returned */
+    int ranges;              /* 1 = the single walk */
+    int threads;             /* iterators that ran at once */
+    const char *splits;      /* "engine" or "sampled", NULL for the single walk */
+    uint64_t range_keys_min; /* fewest keys in one range */
+    uint64_t range_keys_max; /* most keys in one range */
+    double range_sec_mean;   /* time one range took, mean and slowest */
+    double range_sec_max;
+} iter_scan_stats_t;
+
+/* one phase of a --cache-sweep point */
+typedef struct
+{
+    operation_stats_t stats;
+    double hit_rate;   /* block cache hits over lookups, -1 when the engine does not count them */
+    size_t bytes_read; /* process disk reads over the phase */
+} cache_sweep_phase_t;
+
+/* --cache-sweep, the loaded database reopened with one block cache size */
+typedef struct
+{
+    double fraction;           /* of cache_sweep_dataset_bytes */
+    size_t cache_bytes;        /* block_cache_size of the reopen */
+    size_t memory_limit_bytes; /* cgroup memory.max while the point ran, 0 = uncapped */
+    cache_sweep_phase_t get;
+    cache_sweep_phase_t range;
+} cache_sweep_point_t;
+
+/* object store connector traffic, counted since the engine was opened */
+typedef struct
+{
+    uint64_t gets;                 /* whole-object downloads */
+    uint64_t range_gets;           /* partial reads */
+    uint64_t bytes_fetched;        /* bytes moved by gets and range gets */
+    uint64_t puts;                 /* completed uploads */
+    uint64_t bytes_uploaded;       /* bytes moved by puts */
+    int64_t uploads_in_flight;     /* uploads started but not yet finished */
+    int64_t max_uploads_in_flight; /* high-water mark of the above */
+} remote_stats_t;
+
 typedef struct
 {
     const char *engine_name;
@@ -188,17 +560,67 @@ typedef struct
     operation_stats_t get_stats;
     operation_stats_t delete_stats;
     operation_stats_t iteration_stats;
-    operation_stats_t seek_stats;  /* seek operation metrics */
-    operation_stats_t range_stats; /* range query metrics */
+    operation_stats_t seek_stats;                 /* seek operation metrics */
+    operation_stats_t range_stats;                /* range query metrics */
+    operation_stats_t scan_stats;                 /* -w scan, forward bounded scans */
+    operation_stats_t reverse_scan_stats;         /* -w scan, reverse bounded scans */
+    operation_stats_t multiget_stats;             /* batched lookups, one sample per batch */
+    operation_stats_t mix_stats;                  /* concurrent mixed phase, all op types */
+    operation_stats_t mix_op_stats[MIX_OP_COUNT]; /* concurrent mixed phase, per op type */
+    int64_t mix_op_counts[MIX_OP_COUNT];
+    double compact_seconds; /* --compact-after-load, time the full compaction took */
+
+    /* -w recovery, the verification pass that reads every acknowledged key is get_stats */
+    recovery_stats_t recovery;
+    iter_scan_stats_t iter_scan; /* the ITER pass, iteration_stats holds its rate */
+
+    /* -w ingest, the bulk load of a sibling database with its own io and space accounting */
+    operation_stats_t ingest_stats;
+    resource_stats_t ingest_resources;
+
+    /* object store runs, connector traffic of the measured phases and the read latency split by
+     * whether the lookup had to fetch from the object store */
+    int has_remote;
+    remote_stats_t remote;
+    operation_stats_t get_hit_stats;  /* served from the local cache or memory */
+    operation_stats_t get_miss_stats; /* issued at least one remote fetch */
+
+    /* --thread-sweep reruns the measured phase on the loaded database at each thread count */
+    const char *sweep_phase;                            /* NULL without a sweep */
+    operation_stats_t sweep_stats[BENCHMARK_MAX_SWEEP]; /* one per config.thread_sweep entry */
+    int sweep_count;
+
+    /* --cache-sweep reopens the loaded database once per cache size */
+    size_t cache_sweep_dataset_bytes; /* database size after the load, the fractions' base */
+    cache_sweep_point_t cache_sweep[BENCHMARK_MAX_SWEEP];
+    int cache_sweep_count;
+
+    /* --column-families, every measured phase split by the family the keys were routed to */
+    const char *cf_phases[BENCHMARK_MAX_CF_PHASES];
+    operation_stats_t cf_stats[BENCHMARK_MAX_CF_PHASES][BENCHMARK_MAX_COLUMN_FAMILIES];
+    int cf_phase_count;
     size_t total_bytes_written;
     size_t total_bytes_read;
     size_t net_logical_data_size;
+    double mean_value_size; /* over the value pool, differs from value_size under a distribution */
     resource_stats_t resources;
+
+    /* config.keep_histograms, the latency histograms behind the measured ops' stats, malloc'd
+     * and freed with the results */
+    result_hist_t hists[BENCHMARK_MAX_RESULT_OPS];
+    int hist_count;
 } benchmark_results_t;
 
 /* storage eng interface */
 typedef struct storage_engine_t storage_engine_t;
 
+/* a finished asynchronous request */
+typedef struct
+{
+    uint64_t tag; /* the tag it was submitted with */
+    int status;   /* 0 on success (key found), -1 otherwise */
+} engine_completion_t;
+
 typedef struct
 {
     int (*open)(storage_engine_t **engine, const char *path, const benchmark_config_t *config);
@@ -211,8 +633,23 @@ typedef struct
     int (*get)(storage_engine_t *engine, const uint8_t *key, size_t key_size, uint8_t **value,
                size_t *value_size);
 
+    /* zero-copy point lookup (optional). *value points into engine-owned memory (a pinned block
+     * or the memory map) and stays valid until release_pinned(engine, pin) */
+    int (*get_pinned)(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                      const uint8_t **value, size_t *value_size, void **pin);
+    void (*release_pinned)(storage_engine_t *engine, void *pin);
+
+    /* batched point lookup (optional). looks up num_keys keys in one call, values[i] receives a
+     * malloc'd copy or NULL when the key is missing. returns the number of keys found, -1 on
+     * error */
+    int (*multi_get)(storage_engine_t *engine, size_t num_keys, const uint8_t *const *keys,
+                     const size_t *key_sizes, uint8_t **values, size_t *value_sizes);
+
     int (*del)(storage_engine_t *engine, const uint8_t *key, size_t key_size);
 
+    /* flush and fully compact (optional), blocks until the engine has finished or queued it */
+    int (*compact)(storage_engine_t *engine);
+
     /* batched operations for better performance */
     int (*batch_begin)(storage_engine_t *engine, void **batch_ctx);
     int (*batch_put)(void *batch_ctx, storage_engine_t *engine, const uint8_t *key, size_t key_size,
@@ -221,6 +658,23 @@ typedef struct
                         size_t key_size);
     int (*batch_commit)(void *batch_ctx);
 
+    /* sorted bulk load (optional). bulk_add must be given keys in strictly ascending order by a
+     * single writer, the data becomes visible when bulk_finish ingests it. bulk_abort (optional)
+     * drops a load after a failed add, bulk_finish of such a load fails without ingesting */
+    int (*bulk_begin)(storage_engine_t *engine, void **bulk_ctx);
+    int (*bulk_add)(void *bulk_ctx, const uint8_t *key, size_t key_size, const uint8_t *value,
+                    size_t value_size);
+    int (*bulk_finish)(void *bulk_ctx);
+    void (*bulk_abort)(void *bulk_ctx);
+
+    /* asynchronous point lookups (optional). queue_open creates a queue for up to depth
+     * outstanding lookups of one worker, queue_get copies the key and returns at once,
+     * queue_reap waits for at least one submitted lookup and returns up to max completions */
+    int (*queue_open)(storage_engine_t *engine, int depth, void **queue);
+    int (*queue_get)(void *queue, const uint8_t *key, size_t key_size, uint64_t tag);
+    int (*queue_reap)(void *queue, engine_completion_t *done, int max);
+    void (*queue_close)(void *queue);
+
     int (*iter_new)(storage_engine_t *engine, void **iter);
     int (*iter_seek_to_first)(void *iter);
     int (*iter_seek)(void *iter, const uint8_t *key, size_t key_size);
@@ -230,8 +684,45 @@ typedef struct
     int (*iter_value)(void *iter, uint8_t **value, size_t *value_size);
     int (*iter_free)(void *iter);
 
+    /* scan extensions (optional), an iterator from iter_new_opts is used and freed like one
+     * from iter_new. iter_new_opts passes a readahead hint in bytes for the iterator's file
+     * reads. iter_seek_bounded limits the iterator to [lower, upper) and positions it on the
+     * first key of the range, or on the last one when reverse is set, the bounds hold for
+     * iter_next and iter_prev until the next seek and a plain seek drops them.
+     * iter_seek_for_prev positions on the last key at or before key, iter_prev steps back and
+     * iter_entry reads the current key and value in one call, both owned by the iterator */
+    int (*iter_new_opts)(storage_engine_t *engine, size_t readahead, void **iter);
+    int (*iter_seek_bounded)(void *iter, const uint8_t *lower, size_t lower_size,
+                             const uint8_t *upper, size_t upper_size, int reverse);
+    int (*iter_seek_for_prev)(void *iter, const uint8_t *key, size_t key_size);
+    int (*iter_prev)(void *iter);
+    int (*iter_entry)(void *iter, uint8_t **key, size_t *key_size, uint8_t **value,
+                      size_t *value_size);
+
     void (*set_sync)(storage_engine_t *engine, int sync_enabled); /* optional */
 
+    /* object store traffic (optional). remote_stats fills the connector counters and returns -1
+     * when the engine has no object store, thread_fetches returns the number of remote fetches
+     * the calling thread has issued so far */
+    int (*remote_stats)(storage_engine_t *engine, remote_stats_t *stats);
+    uint64_t (*thread_fetches)(storage_engine_t *engine);
+
+    /* engine-internal statistics (optional). fills what the engine's native counters offer and
+     * sets the rest to -1, counters are cumulative since open. called from the interval
+     * reporter while the workers run */
+    int (*get_stats)(storage_engine_t *engine, engine_stats_t *stats);
+
+    /* column families (optional). an engine opened with config->num_column_families above 1
+     * keeps that many families next to its default one, column_family returns a view whose ops
+     * act on family index alone. views share the engine's resources and go away with its close,
+     * they are never closed themselves */
+    int (*column_family)(storage_engine_t *engine, int index, storage_engine_t **cf);
+
+    /* range boundaries (optional), up to parts - 1 ascending keys that cut the keyspace into
+     * parts of similar size from what the engine knows of its files. the keys are malloc'd for
+     * the caller, returns how many were filled or -1 when the engine has none to offer */
+    int (*split_keys)(storage_engine_t *engine, int parts, uint8_t **keys, size_t *key_sizes);
+
     const char *name;
 } storage_engine_ops_t;
 
@@ -247,6 +738,159 @@ void generate_csv(FILE *fp, benchmark_results_t *results, benchmark_results_t *b
                   int write_header);
 void free_results(benchmark_results_t *results);
 
+/**
+ * generate_sweep_csv
+ * writes one row per --thread-sweep and --cache-sweep point of the results and the baseline
+ * @param write_header the file is new or empty
+ */
+void generate_sweep_csv(FILE *fp, benchmark_results_t *results, benchmark_results_t *baseline,
+                        int write_header);
+
+/* a measured op of a run, named like its generate_csv row */
+typedef struct
+{
+    char name[32];
+    const operation_stats_t *stats; /* points into the results */
+} result_op_t;
+
+/**
+ * results_ops
+ * lists the measured ops of a run that have a throughput, the rows generate_csv writes for them
+ * apart from the sweep points and the column family split
+ * @param results a finished run
+ * @param ops receives at most BENCHMARK_MAX_RESULT_OPS entries
+ * @return the number of entries filled
+ */
+int results_ops(const benchmark_results_t *results, result_op_t *ops);
+
+/**
+ * results_histogram
+ * @param results a run with config.keep_histograms set
+ * @param stats stats of a measured op, e.g. from results_ops
+ * @return the merged latency histogram of the op in nanoseconds, NULL when none was kept
+ */
+const histogram_t *results_histogram(const benchmark_results_t *results,
+                                     const operation_stats_t *stats);
+
+/**
+ * config_validate
+ * checks the cross-field constraints of a config, for the command line and every matrix cell.
+ * an error is printed for the first one that does not hold
+ * @param config benchmark configuration, scan and column family defaults already applied
+ * @return 0 when the config can run, -1 otherwise
+ */
+int config_validate(const benchmark_config_t *config);
+
+/**
+ * workload_needs_dataset
+ * @param config benchmark configuration
+ * @return 1 when the workload reads back data an earlier load left behind, the keys a
+ * --reuse-db run loads once and keeps
+ */
+int workload_needs_dataset(const benchmark_config_t *config);
+
+/**
+ * workload_to_string
+ * @param type workload type
+ * @return the -w name of the workload
+ */
+const char *workload_to_string(workload_type_t type);
+
+/**
+ * pattern_to_string
+ * @param pattern key pattern
+ * @return the short name of the pattern the CSV uses
+ */
+const char *pattern_to_string(key_pattern_t pattern);
+
+/**
+ * parse_thread_sweep
+ * parses a --thread-sweep argument. a list such as 1,2,4,8 is taken as given, a single count N
+ * expands to the powers of two below N followed by N itself
+ * @param spec the sweep specification
+ * @param counts output array of at most BENCHMARK_MAX_SWEEP thread counts
+ * @return the number of thread counts, -1 on a malformed spec
+ */
+int parse_thread_sweep(const char *spec, int *counts);
+
+/**
+ * parse_cache_sweep
+ * parses a --cache-sweep argument, a comma separated list of block cache sizes as fractions of
+ * the dataset such as 0.01,0.05,0.1,0.5,1
+ * @param spec the sweep specification
+ * @param fractions output array of at most BENCHMARK_MAX_SWEEP fractions above 0
+ * @return the number of fractions, -1 on a malformed spec
+ */
+int parse_cache_sweep(const char *spec, double *fractions);
+
+/**
+ * parse_mix_spec
+ * parses a --mix argument into per-op weights. accepts a YCSB preset
+ * (ycsb-a .. ycsb-f) or a comma separated list such as put=50,get=40,del=5,range=5
+ * @param spec the mix specification
+ * @param weights output array of MIX_OP_COUNT weights
+ * @return 0 on success, -1 on a malformed spec
+ */
+int parse_mix_spec(const char *spec, int *weights);
+const char *mix_op_to_string(mix_op_t op);
+
 const storage_engine_ops_t *get_engine_ops(const char *engine_name);
 
+/*
+ * engine plugins. a plugin is a shared object built with benchtool_engine() in CMakeLists.txt
+ * from an engine source and engine_plugin.c: it exports the engine's get_*_ops() and
+ * benchtool_engine_plugin(), which describes the benchmark.h it was compiled against. plugins
+ * are opened with RTLD_LOCAL and linked -Bsymbolic, so two builds of one engine (and of its
+ * statically linked library) live side by side in one process. bump BENCHTOOL_ENGINE_ABI when
+ * the meaning of storage_engine_ops_t or benchmark_config_t changes without their size
+ */
+#define BENCHTOOL_ENGINE_ABI 1
+#define MAX_ENGINE_PLUGINS   16
+
+typedef struct
+{
+    int abi;                /* BENCHTOOL_ENGINE_ABI of the plugin */
+    size_t config_size;     /* sizeof(benchmark_config_t) */
+    size_t ops_size;        /* sizeof(storage_engine_ops_t) */
+    const char *ops_symbol; /* the exported get_*_ops */
+    const char *version;    /* version of the engine build, "unknown" when not given */
+} engine_plugin_info_t;
+
+/**
+ * engine_plugin_load
+ * opens an engine plugin and registers its ops under a name of its own for -e
+ * @param spec <name>=<path to the shared object>
+ * @return 0 on success, -1 when the plugin cannot be opened, does not match this build or the
+ * name is taken
+ */
+int engine_plugin_load(const char *spec);
+
+/**
+ * engine_plugin_version
+ * @param engine_name an engine name
+ * @return the version a plugin registered under the name reports, NULL for other engines
+ */
+const char *engine_plugin_version(const char *engine_name);
+
+/* resource sampling helpers, shared with the interval reporter */
+void get_memory_usage(size_t *rss_bytes, size_t *vms_bytes);
+void get_io_stats(size_t *bytes_read, size_t *bytes_written);
+
+/**
+ * engine_stats_reset
+ * marks every field of an engine statistics snapshot as not reported (-1), engines call it
+ * before filling in what they have
+ * @param stats the snapshot
+ */
+void engine_stats_reset(engine_stats_t *stats);
+
+/**
+ * sample_engine_stats
+ * takes an engine statistics snapshot
+ * @param engine the engine
+ * @param stats receives the snapshot, valid stays 0 when the engine has no get_stats
+ * @return 0 on success, -1 when the engine reports nothing
+ */
+int sample_engine_stats(storage_engine_t *engine, engine_stats_t *stats);
+
 #endif /* __BENCHMARK_H__ */
@@ -0,0 +1,847 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cfroute.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CFROUTE_SEED 0x4C0F4D1C5EEDULL
+
+_Thread_local int cfroute_last_cf = 0;
+static _Thread_local uint64_t thread_ops[BENCHMARK_MAX_COLUMN_FAMILIES];
+static _Thread_local uint8_t key_buf[CFROUTE_MAX_KEY_SIZE]; /* padded key of a single op */
+
+typedef struct
+{
+    storage_engine_ops_t ops; /* the router's ops, the optional ones follow the base engine */
+    storage_engine_t *base;
+    int num_cfs;
+    storage_engine_t *views[BENCHMARK_MAX_COLUMN_FAMILIES];
+    size_t key_sizes[BENCHMARK_MAX_COLUMN_FAMILIES];   /* 0 = the key as given */
+    size_t value_sizes[BENCHMARK_MAX_COLUMN_FAMILIES]; /* 0 = the value as given */
+    size_t max_key_size;
+    uint8_t slots[CFROUTE_SLOTS]; /* hash slot to family, each family owns its weight's share */
+} cfroute_t;
+
+/* a batch or bulk load, the family sub-contexts are started on their first key */
+typedef struct
+{
+    cfroute_t *r;
+    void *sub[];
+} cfroute_batch_t;
+
+/* how an iterator runs on once its family is exhausted */
+enum
+{
+    CHAIN_NONE,    /* a seek stays in the family of its key */
+    CHAIN_FIRST,   /* seek_to_first, on into the first key of the next family */
+    CHAIN_BOUNDED, /* seek_bounded, on into the same range of the next family */
+};
+
+typedef struct
+{
+    cfroute_t *r;
+    int cf;           /* family the iterator is positioned in */
+    int chain;        /* CHAIN_* */
+    size_t readahead; /* iter_new_opts hint the family iterators are created with */
+    int reverse;      /* direction of a bounded scan */
+    size_t lower_size, upper_size;
+    uint8_t lower[CFROUTE_MAX_KEY_SIZE];
+    uint8_t upper[CFROUTE_MAX_KEY_SIZE];
+    void *sub[];
+} cfroute_iter_t;
+
+static uint64_t cfroute_hash(const uint8_t *key, size_t size)
+{
+    uint64_t h = CFROUTE_SEED ^ size;
+    while (size > 0)
+    {
+        uint64_t w = 0;
+        size_t n = size < 8 ? size : 8;
+        memcpy(&w, key, n);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+        key += n;
+        size -= n;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static int route(const cfroute_t *r, const uint8_t *key, size_t key_size)
+{
+    int cf = r->slots[cfroute_hash(key, key_size) % CFROUTE_SLOTS];
+    thread_ops[cf]++;
+    cfroute_last_cf = cf;
+    return cf;
+}
+
+/* we pad a key shorter than its family's key size in front with '0', buf holds max_key_size */
+static const uint8_t *family_key(const cfroute_t *r, int cf, const uint8_t *key,
+                                 size_t *key_size, uint8_t *buf)
+{
+    size_t want = r->key_sizes[cf];
+    if (want <= *key_size) return key;
+
+    size_t pad = want - *key_size;
+    memset(buf, '0', pad);
+    memcpy(buf + pad, key, *key_size);
+    *key_size = want;
+    return buf;
+}
+
+/* the value pointer comes from the value pool, its slices hold the largest family value */
+static size_t family_value(const cfroute_t *r, int cf, size_t value_size)
+{
+    return r->value_sizes[cf] ? r->value_sizes[cf] : value_size;
+}
+
+static int cfroute_close(storage_engine_t *engine)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int rc = r->base->ops->close(r->base);
+    free(r);
+    free(engine);
+    return rc;
+}
+
+static int cfroute_put(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                       const uint8_t *value, size_t value_size)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int cf = route(r, key, key_size);
+    storage_engine_t *view = r->views[cf];
+    key = family_key(r, cf, key, &key_size, key_buf);
+    return view->ops->put(view, key, key_size, value, family_value(r, cf, value_size));
+}
+
+static int cfroute_get(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                       uint8_t **value, size_t *value_size)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int cf = route(r, key, key_size);
+    storage_engine_t *view = r->views[cf];
+    key = family_key(r, cf, key, &key_size, key_buf);
+    return view->ops->get(view, key, key_size, value, value_size);
+}
+
+static int cfroute_get_pinned(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                              const uint8_t **value, size_t *value_size, void **pin)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int cf = route(r, key, key_size);
+    storage_engine_t *view = r->views[cf];
+    key = family_key(r, cf, key, &key_size, key_buf);
+    return view->ops->get_pinned(view, key, key_size, value, value_size, pin);
+}
+
+/* the pin belongs to the family of the thread's last lookup */
+static void cfroute_release_pinned(storage_engine_t *engine, void *pin)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    storage_engine_t *view = r->views[cfroute_last_cf];
+    view->ops->release_pinned(view, pin);
+}
+
+/* one multi_get per family over the keys routed to it, the values go back in key order */
+static int cfroute_multi_get(storage_engine_t *engine, size_t num_keys,
+                             const uint8_t *const *keys, const size_t *key_sizes,
+                             uint8_t **values, size_t *value_sizes)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int *cfs = malloc(num_keys * sizeof(int));
+    size_t *order = malloc(num_keys * sizeof(size_t));
+    const uint8_t **sub_keys = malloc(num_keys * sizeof(uint8_t *));
+    size_t *sub_key_sizes = malloc(num_keys * sizeof(size_t));
+    uint8_t **sub_values = malloc(num_keys * sizeof(uint8_t *));
+    size_t *sub_value_sizes = malloc(num_keys * sizeof(size_t));
+    uint8_t *padded = r->max_key_size ? malloc(num_keys * r->max_key_size) : NULL;
+
+    int found = -1;
+    if (cfs && order && sub_keys && sub_key_sizes && sub_values && sub_value_sizes &&
+        (padded || !r->max_key_size))
+    {
+        found = 0;
+        for (size_t i = 0; i < num_keys; i++)
+        {
+            cfs[i] = route(r, keys[i], key_sizes[i]);
+            values[i] = NULL;
+            value_sizes[i] = 0;
+        }
+
+        for (int cf = 0; cf < r->num_cfs && found >= 0; cf++)
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < num_keys; i++)
+            {
+                if (cfs[i] != cf) continue;
+                size_t key_size = key_sizes[i];
+                uint8_t *buf = padded ? padded + i * r->max_key_size : NULL;
+                sub_keys[n] = family_key(r, cf, keys[i], &key_size, buf);
+                sub_key_sizes[n] = key_size;
+                order[n++] = i;
+            }
+            if (n == 0) continue;
+
+            storage_engine_t *view = r->views[cf];
+            int rc = view->ops->multi_get(view, n, (const uint8_t *const *)sub_keys,
+                                          sub_key_sizes, sub_values, sub_value_sizes);
+            if (rc < 0)
+            {
+                found = -1;
+                break;
+            }
+            for (size_t j = 0; j < n; j++)
+            {
+                values[order[j]] = sub_values[j];
+                value_sizes[order[j]] = sub_value_sizes[j];
+            }
+            found += rc;
+        }
+    }
+
+    free(cfs);
+    free(order);
+    free(sub_keys);
+    free(sub_key_sizes);
+    free(sub_values);
+    free(sub_value_sizes);
+    free(padded);
+    return found;
+}
+
+static int cfroute_del(storage_engine_t *engine, const uint8_t *key, size_t key_size)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int cf = route(r, key, key_size);
+    storage_engine_t *view = r->views[cf];
+    key = family_key(r, cf, key, &key_size, key_buf);
+    return view->ops->del(view, key, key_size);
+}
+
+static int cfroute_compact(storage_engine_t *engine)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    int rc = 0;
+    for (int cf = 0; cf < r->num_cfs; cf++)
+    {
+        if (r->views[cf]->ops->compact(r->views[cf]) != 0) rc = -1;
+    }
+    return rc;
+}
+
+static cfroute_batch_t *batch_new(cfroute_t *r)
+{
+    cfroute_batch_t *b = calloc(1, sizeof(cfroute_batch_t) + r->num_cfs * sizeof(void *));
+    if (b) b->r = r;
+    return b;
+}
+
+static int cfroute_batch_begin(storage_engine_t *engine, void **batch_ctx)
+{
+    *batch_ctx = batch_new((cfroute_t *)engine->handle);
+    return *batch_ctx ? 0 : -1;
+}
+
+static void *family_batch(cfroute_batch_t *b, int cf)
+{
+    storage_engine_t *view = b->r->views[cf];
+    if (!b->sub[cf] && view->ops->batch_begin(view, &b->sub[cf]) != 0) b->sub[cf] = NULL;
+    return b->sub[cf];
+}
+
+static int cfroute_batch_put(void *batch_ctx, storage_engine_t *engine, const uint8_t *key,
+                             size_t key_size, const uint8_t *value, size_t value_size)
+{
+    (void)engine;
+    cfroute_batch_t *b = (cfroute_batch_t *)batch_ctx;
+    int cf = route(b->r, key, key_size);
+    void *sub = family_batch(b, cf);
+    if (!sub) return -1;
+
+    storage_engine_t *view = b->r->views[cf];
+    key = family_key(b->r, cf, key, &key_size, key_buf);
+    return view->ops->batch_put(sub, view, key, key_size, value,
+                                family_value(b->r, cf, value_size));
+}
+
+static int cfroute_batch_delete(void *batch_ctx, storage_engine_t *engine, const uint8_t *key,
+                                size_t key_size)
+{
+    (void)engine;
+    cfroute_batch_t *b = (cfroute_batch_t *)batch_ctx;
+    int cf = route(b->r, key, key_size);
+    void *sub = family_batch(b, cf);
+    if (!sub) return -1;
+
+    storage_engine_t *view = b->r->views[cf];
+    key = family_key(b->r, cf, key, &key_size, key_buf);
+    return view->ops->batch_delete(sub, view, key, key_size);
+}
+
+static int cfroute_batch_commit(void *batch_ctx)
+{
+    cfroute_batch_t *b = (cfroute_batch_t *)batch_ctx;
+    int rc = 0;
+    for (int cf = 0; cf < b->r->num_cfs; cf++)
+    {
+        if (b->sub[cf] && b->r->views[cf]->ops->batch_commit(b->sub[cf]) != 0) rc = -1;
+    }
+    free(b);
+    return rc;
+}
+
+/* every family sees its share of the ascending keys in ascending order, padding keeps it so */
+static int cfroute_bulk_begin(storage_engine_t *engine, void **bulk_ctx)
+{
+    *bulk_ctx = batch_new((cfroute_t *)engine->handle);
+    return *bulk_ctx ? 0 : -1;
+}
+
+static int cfroute_bulk_add(void *bulk_ctx, const uint8_t *key, size_t key_size,
+                            const uint8_t *value, size_t value_size)
+{
+    cfroute_batch_t *b = (cfroute_batch_t *)bulk_ctx;
+    int cf = route(b->r, key, key_size);
+    storage_engine_t *view = b->r->views[cf];
+    if (!b->sub[cf] && view->ops->bulk_begin(view, &b->sub[cf]) != 0)
+    {
+        b->sub[cf] = NULL;
+        return -1;
+    }
+
+    key = family_key(b->r, cf, key, &key_size, key_buf);
+    return view->ops->bulk_add(b->sub[cf], key, key_size, value,
+                               family_value(b->r, cf, value_size));
+}
+
+static int cfroute_bulk_finish(void *bulk_ctx)
+{
+    cfroute_batch_t *b = (cfroute_batch_t *)bulk_ctx;
+    int rc = 0;
+    for (int cf = 0; cf < b->r->num_cfs; cf++)
+    {
+        if (b->sub[cf] && b->r->views[cf]->ops->bulk_finish(b->sub[cf]) != 0) rc = -1;
+    }
+    free(b);
+    return rc;
+}
+
+/* a failed add drops every family's partial load, none of it is ingested */
+static void cfroute_bulk_abort(void *bulk_ctx)
+{
+    cfroute_batch_t *b = (cfroute_batch_t *)bulk_ctx;
+    for (int cf = 0; cf < b->r->num_cfs; cf++)
+    {
+        if (b->sub[cf]) b->r->views[cf]->ops->bulk_abort(b->sub[cf]);
+    }
+    free(b);
+}
+
+static int cfroute_iter_new(storage_engine_t *engine, void **iter)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    cfroute_iter_t *it = calloc(1, sizeof(cfroute_iter_t) + r->num_cfs * sizeof(void *));
+    if (!it) return -1;
+    it->r = r;
+    *iter = it;
+    return 0;
+}
+
+static int cfroute_iter_new_opts(storage_engine_t *engine, size_t readahead, void **iter)
+{
+    if (cfroute_iter_new(engine, iter) != 0) return -1;
+    ((cfroute_iter_t *)*iter)->readahead = readahead;
+    return 0;
+}
+
+/* family iterators are created on first use, a point seek only ever opens one */
+static void *family_iter(cfroute_iter_t *it, int cf)
+{
+    storage_engine_t *view = it->r->views[cf];
+    if (it->sub[cf]) return it->sub[cf];
+    int rc = it->readahead > 0 && view->ops->iter_new_opts
+                 ? view->ops->iter_new_opts(view, it->readahead, &it->sub[cf])
+                 : view->ops->iter_new(view, &it->sub[cf]);
+    if (rc != 0)
+    {
+        /* a family left out would end the walk early and undercount it, the iterator is done */
+        fprintf(stderr, "Failed to open an iterator on column family %d\n", cf);
+        it->sub[cf] = NULL;
+    }
+    return it->sub[cf];
+}
+
+/* we position on the first key of family cf or of the first non-empty family after it */
+static int chain_from(cfroute_iter_t *it, int cf)
+{
+    for (; cf < it->r->num_cfs; cf++)
+    {
+        const storage_engine_ops_t *ops = it->r->views[cf]->ops;
+        void *sub = family_iter(it, cf);
+        it->cf = cf;
+        if (!sub) return -1;
+        ops->iter_seek_to_first(sub);
+        if (ops->iter_valid(sub)) return 0;
+    }
+    return 0;
+}
+
+/* the keys of a range are spread over every family, we walk the range in each family in turn,
+ * from the first for a forward scan and from the last for a reverse one */
+static int chain_bounded(cfroute_iter_t *it, int cf)
+{
+    uint8_t lower_buf[CFROUTE_MAX_KEY_SIZE];
+    uint8_t upper_buf[CFROUTE_MAX_KEY_SIZE];
+    int step = it->reverse ? -1 : 1;
+    for (; cf >= 0 && cf < it->r->num_cfs; cf += step)
+    {
+        const storage_engine_ops_t *ops = it->r->views[cf]->ops;
+        void *sub = family_iter(it, cf);
+        it->cf = cf;
+        if (!sub) return -1;
+        size_t lower_size = it->lower_size;
+        size_t upper_size = it->upper_size;
+        /* an empty lower bound stays empty, padded it would sort after the family's key 0 */
+        const uint8_t *lower =
+            lower_size > 0 ? family_key(it->r, cf, it->lower, &lower_size, lower_buf) : it->lower;
+        const uint8_t *upper = family_key(it->r, cf, it->upper, &upper_size, upper_buf);
+        ops->iter_seek_bounded(sub, lower, lower_size, upper, upper_size, it->reverse);
+        if (ops->iter_valid(sub)) return 0;
+    }
+    return 0;
+}
+
+static int cfroute_iter_seek_to_first(void *iter)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    it->chain = CHAIN_FIRST;
+    return chain_from(it, 0);
+}
+
+static int cfroute_iter_seek(void *iter, const uint8_t *key, size_t key_size)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    int cf = route(it->r, key, key_size);
+    it->chain = CHAIN_NONE;
+    it->cf = cf;
+
+    void *sub = family_iter(it, cf);
+    if (!sub) return -1;
+    key = family_key(it->r, cf, key, &key_size, key_buf);
+    return it->r->views[cf]->ops->iter_seek(sub, key, key_size);
+}
+
+static int cfroute_iter_seek_for_prev(void *iter, const uint8_t *key, size_t key_size)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    int cf = route(it->r, key, key_size);
+    it->chain = CHAIN_NONE;
+    it->cf = cf;
+
+    void *sub = family_iter(it, cf);
+    if (!sub) return -1;
+    key = family_key(it->r, cf, key, &key_size, key_buf);
+    return it->r->views[cf]->ops->iter_seek_for_prev(sub, key, key_size);
+}
+
+static int cfroute_iter_seek_bounded(void *iter, const uint8_t *lower, size_t lower_size,
+                                     const uint8_t *upper, size_t upper_size, int reverse)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    if (!lower || !upper) return -1;
+    if (lower_size > CFROUTE_MAX_KEY_SIZE || upper_size > CFROUTE_MAX_KEY_SIZE) return -1;
+
+    memcpy(it->lower, lower, lower_size);
+    memcpy(it->upper, upper, upper_size);
+    it->lower_size = lower_size;
+    it->upper_size = upper_size;
+    it->reverse = reverse;
+    it->chain = CHAIN_BOUNDED;
+    return chain_bounded(it, reverse ? it->r->num_cfs - 1 : 0);
+}
+
+static int cfroute_iter_valid(void *iter)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    void *sub = it->sub[it->cf];
+    return sub ? it->r->views[it->cf]->ops->iter_valid(sub) : 0;
+}
+
+static int cfroute_iter_next(void *iter)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    const storage_engine_ops_t *ops = it->r->views[it->cf]->ops;
+    void *sub = it->sub[it->cf];
+    if (!sub) return -1;
+
+    ops->iter_next(sub);
+    if (it->chain == CHAIN_NONE || ops->iter_valid(sub)) return 0;
+    if (it->chain == CHAIN_FIRST && it->cf + 1 < it->r->num_cfs) return chain_from(it, it->cf + 1);
+    if (it->chain == CHAIN_BOUNDED && !it->reverse) return chain_bounded(it, it->cf + 1);
+    return 0;
+}
+
+static int cfroute_iter_prev(void *iter)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    const storage_engine_ops_t *ops = it->r->views[it->cf]->ops;
+    void *sub = it->sub[it->cf];
+    if (!sub) return -1;
+
+    ops->iter_prev(sub);
+    if (it->chain == CHAIN_BOUNDED && it->reverse && !ops->iter_valid(sub))
+    {
+        return chain_bounded(it, it->cf - 1);
+    }
+    return 0;
+}
+
+static int cfroute_iter_key(void *iter, uint8_t **key, size_t *key_size)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    void *sub = it->sub[it->cf];
+    return sub ? it->r->views[it->cf]->ops->iter_key(sub, key, key_size) : -1;
+}
+
+static int cfroute_iter_value(void *iter, uint8_t **value, size_t *value_size)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    void *sub = it->sub[it->cf];
+    return sub ? it->r->views[it->cf]->ops->iter_value(sub, value, value_size) : -1;
+}
+
+static int cfroute_iter_entry(void *iter, uint8_t **key, size_t *key_size, uint8_t **value,
+                              size_t *value_size)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    void *sub = it->sub[it->cf];
+    if (!sub) return -1;
+    return it->r->views[it->cf]->ops->iter_entry(sub, key, key_size, value, value_size);
+}
+
+static int cfroute_iter_free(void *iter)
+{
+    cfroute_iter_t *it = (cfroute_iter_t *)iter;
+    for (int cf = 0; cf < it->r->num_cfs; cf++)
+    {
+        if (it->sub[cf]) it->r->views[cf]->ops->iter_free(it->sub[cf]);
+    }
+    free(it);
+    return 0;
+}
+
+static void cfroute_set_sync(storage_engine_t *engine, int sync_enabled)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    r->base->ops->set_sync(r->base, sync_enabled);
+    for (int cf = 0; cf < r->num_cfs; cf++)
+    {
+        r->views[cf]->ops->set_sync(r->views[cf], sync_enabled);
+    }
+}
+
+static int cfroute_remote_stats(storage_engine_t *engine, remote_stats_t *stats)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    return r->base->ops->remote_stats(r->base, stats);
+}
+
+static uint64_t cfroute_thread_fetches(storage_engine_t *engine)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    return r->base->ops->thread_fetches(r->base);
+}
+
+static void add_gauge(int64_t *sum, int64_t value)
+{
+    if (value < 0) return;
+    *sum = *sum < 0 ? value : *sum + value;
+}
+
+/* the counters are engine wide and come from the base engine, the gauges are the sums over the
+ * families (the deepest tree for the depth), the default family holds no data */
+static int cfroute_get_stats(storage_engine_t *engine, engine_stats_t *stats)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    if (r->base->ops->get_stats(r->base, stats) != 0) return -1;
+
+    stats->pending_compaction_bytes = -1;
+    stats->immutable_memtables = -1;
+    stats->memtable_bytes = -1;
+    stats->l0_files = -1;
+    stats->table_files = -1;
+    stats->live_data_bytes = -1;
+    stats->num_keys = -1;
+    stats->tree_depth = -1;
+    for (int cf = 0; cf < r->num_cfs; cf++)
+    {
+        engine_stats_t fs;
+        engine_stats_reset(&fs);
+        if (r->views[cf]->ops->get_stats(r->views[cf], &fs) != 0) continue;
+        add_gauge(&stats->pending_compaction_bytes, fs.pending_compaction_bytes);
+        add_gauge(&stats->immutable_memtables, fs.immutable_memtables);
+        add_gauge(&stats->memtable_bytes, fs.memtable_bytes);
+        add_gauge(&stats->l0_files, fs.l0_files);
+        add_gauge(&stats->table_files, fs.table_files);
+        add_gauge(&stats->live_data_bytes, fs.live_data_bytes);
+        add_gauge(&stats->num_keys, fs.num_keys);
+        if (fs.tree_depth > stats->tree_depth) stats->tree_depth = fs.tree_depth;
+    }
+    return 0;
+}
+
+static const storage_engine_ops_t cfroute_ops = {
+    .close = cfroute_close,
+    .put = cfroute_put,
+    .get = cfroute_get,
+    .get_pinned = cfroute_get_pinned,
+    .release_pinned = cfroute_release_pinned,
+    .multi_get = cfroute_multi_get,
+    .del = cfroute_del,
+    .compact = cfroute_compact,
+    .batch_begin = cfroute_batch_begin,
+    .batch_put = cfroute_batch_put,
+    .batch_delete = cfroute_batch_delete,
+    .batch_commit = cfroute_batch_commit,
+    .bulk_begin = cfroute_bulk_begin,
+    .bulk_add = cfroute_bulk_add,
+    .bulk_finish = cfroute_bulk_finish,
+    .bulk_abort = cfroute_bulk_abort,
+    .iter_new = cfroute_iter_new,
+    .iter_seek_to_first = cfroute_iter_seek_to_first,
+    .iter_seek = cfroute_iter_seek,
+    .iter_valid = cfroute_iter_valid,
+    .iter_next = cfroute_iter_next,
+    .iter_key = cfroute_iter_key,
+    .iter_value = cfroute_iter_value,
+    .iter_free = cfroute_iter_free,
+    .iter_new_opts = cfroute_iter_new_opts,
+    .iter_seek_bounded = cfroute_iter_seek_bounded,
+    .iter_seek_for_prev = cfroute_iter_seek_for_prev,
+    .iter_prev = cfroute_iter_prev,
+    .iter_entry = cfroute_iter_entry,
+    .set_sync = cfroute_set_sync,
+    .remote_stats = cfroute_remote_stats,
+    .thread_fetches = cfroute_thread_fetches,
+    .get_stats = cfroute_get_stats,
+};
+
+/* the router offers an optional op only where the engine does, the queue ops are left out so
+ * --queue-depth would fall back to helper threads */
+static void match_base_ops(storage_engine_ops_t *ops, const storage_engine_ops_t *base)
+{
+    ops->name = base->name;
+    if (!base->get_pinned || !base->release_pinned)
+    {
+        ops->get_pinned = NULL;
+        ops->release_pinned = NULL;
+    }
+    if (!base->multi_get) ops->multi_get = NULL;
+    if (!base->compact) ops->compact = NULL;
+    if (!base->batch_begin || !base->batch_put || !base->batch_commit)
+    {
+        ops->batch_begin = NULL;
+        ops->batch_put = NULL;
+        ops->batch_commit = NULL;
+    }
+    if (!base->batch_delete) ops->batch_delete = NULL;
+    if (!base->bulk_begin || !base->bulk_add || !base->bulk_finish)
+    {
+        ops->bulk_begin = NULL;
+        ops->bulk_add = NULL;
+        ops->bulk_finish = NULL;
+    }
+    if (!ops->bulk_begin || !base->bulk_abort) ops->bulk_abort = NULL;
+
+    /* a batch or bulk load holds a context per family on one thread, every LMDB context is a
+     * write txn and a second one waits on the single writer lock its own thread holds */
+    if (strcmp(base->name, "lmdb") == 0)
+    {
+        ops->batch_begin = NULL;
+        ops->batch_put = NULL;
+        ops->batch_delete = NULL;
+        ops->batch_commit = NULL;
+        ops->bulk_begin = NULL;
+        ops->bulk_add = NULL;
+        ops->bulk_finish = NULL;
+        ops->bulk_abort = NULL;
+    }
+    if (!base->iter_new_opts) ops->iter_new_opts = NULL;
+    if (!base->iter_seek_bounded) ops->iter_seek_bounded = NULL;
+    if (!base->iter_seek_for_prev) ops->iter_seek_for_prev = NULL;
+    if (!base->iter_prev) ops->iter_prev = NULL;
+    if (!base->iter_entry) ops->iter_entry = NULL;
+    if (!base->set_sync) ops->set_sync = NULL;
+    if (!base->remote_stats) ops->remote_stats = NULL;
+    if (!base->thread_fetches) ops->thread_fetches = NULL;
+    if (!base->get_stats) ops->get_stats = NULL;
+}
+
+int cfroute_open(storage_engine_t *base, const benchmark_config_t *config,
+                 storage_engine_t **engine)
+{
+    int n = config->num_column_families;
+    if (!base->ops->column_family)
+    {
+        fprintf(stderr, "%s does not support column families\n", base->ops->name);
+        return -1;
+    }
+    if (n < 1 || n > BENCHMARK_MAX_COLUMN_FAMILIES) return -1;
+
+    cfroute_t *r = calloc(1, sizeof(cfroute_t));
+    *engine = malloc(sizeof(storage_engine_t));
+    if (!r || !*engine)
+    {
+        free(r);
+        free(*engine);
+        return -1;
+    }
+
+    int64_t total = 0;
+    for (int cf = 0; cf < n; cf++)
+    {
+        if (base->ops->column_family(base, cf, &r->views[cf]) != 0)
+        {
+            fprintf(stderr, "Failed to open column family %d of %s\n", cf, base->ops->name);
+            free(r);
+            free(*engine);
+            return -1;
+        }
+        if (config->cf_key_sizes[cf] > config->key_size)
+        {
+            r->key_sizes[cf] = (size_t)config->cf_key_sizes[cf];
+            if (r->key_sizes[cf] > r->max_key_size) r->max_key_size = r->key_sizes[cf];
+        }
+        if (config->cf_value_sizes[cf] > 0) r->value_sizes[cf] = (size_t)config->cf_value_sizes[cf];
+        total += config->cf_weights[cf];
+    }
+    if (total <= 0)
+    {
+        fprintf(stderr, "Column family weights add up to 0\n");
+        free(r);
+        free(*engine);
+        return -1;
+    }
+
+    /* slot s goes to the family whose cumulative weight range holds s * total / CFROUTE_SLOTS */
+    int cf = 0;
+    int64_t bound = config->cf_weights[0];
+    for (int s = 0; s < CFROUTE_SLOTS; s++)
+    {
+        int64_t point = (int64_t)s * total / CFROUTE_SLOTS;
+        while (point >= bound && cf + 1 < n) bound += config->cf_weights[++cf];
+        r->slots[s] = (uint8_t)cf;
+    }
+
+    r->base = base;
+    r->num_cfs = n;
+    r->ops = cfroute_ops;
+    match_base_ops(&r->ops, base->ops);
+    (*engine)->ops = &r->ops;
+    (*engine)->handle = r;
+    return 0;
+}
+
+int cfroute_is_router(const storage_engine_t *engine)
+{
+    return engine->ops->close == cfroute_close;
+}
+
+storage_engine_t *cfroute_family(storage_engine_t *engine, int cf)
+{
+    cfroute_t *r = (cfroute_t *)engine->handle;
+    return r->views[cf];
+}
+
+const uint64_t *cfroute_thread_ops(void)
+{
+    return thread_ops;
+}
+
+/* a size field of a profile entry, empty or missing keeps the default */
+static int parse_size(const char **p, int *out, int max)
+{
+    if (**p != ':') return 0;
+    (*p)++;
+    char *end = NULL;
+    long v = strtol(*p, &end, 10);
+    if (end == *p) return 0;
+    if (v < 0 || v > max) return -1;
+    *out = (int)v;
+    *p = end;
+    return 0;
+}
+
+int cfroute_parse_profile(const char *spec, benchmark_config_t *config)
+{
+    int weights[BENCHMARK_MAX_COLUMN_FAMILIES];
+    int key_sizes[BENCHMARK_MAX_COLUMN_FAMILIES];
+    int value_sizes[BENCHMARK_MAX_COLUMN_FAMILIES];
+    int entries = 0;
+
+    const char *p = spec;
+    while (*p)
+    {
+        if (entries == BENCHMARK_MAX_COLUMN_FAMILIES) return -1;
+
+        char *end = NULL;
+        long w = strtol(p, &end, 10);
+        if (end == p || w < 0 || w > 1000000) return -1;
+        p = end;
+
+        weights[entries] = (int)w;
+        key_sizes[entries] = 0;
+        value_sizes[entries] = 0;
+        if (parse_size(&p, &key_sizes[entries], CFROUTE_MAX_KEY_SIZE) != 0) return -1;
+        if (parse_size(&p, &value_sizes[entries], 1 << 30) != 0) return -1;
+        entries++;
+
+        if (*p == ',')
+            p++;
+        else if (*p)
+            return -1;
+    }
+    if (entries == 0) return -1;
+
+    int total = 0;
+    for (int cf = 0; cf < config->num_column_families; cf++)
+    {
+        config->cf_weights[cf] = weights[cf % entries];
+        config->cf_key_sizes[cf] = key_sizes[cf % entries];
+        config->cf_value_sizes[cf] = value_sizes[cf % entries];
+        total += config->cf_weights[cf];
+    }
+    return total > 0 ? 0 : -1;
+}
+
+double cfroute_mean_entry(const benchmark_config_t *config, double value_size)
+{
+    double total = 0.0, bytes = 0.0;
+    for (int cf = 0; cf < config->num_column_families; cf++)
+    {
+        double w = config->cf_weights[cf];
+        double k = config->cf_key_sizes[cf] > config->key_size ? config->cf_key_sizes[cf]
+                                                                 : config->key_size;
+        double v = config->cf_value_sizes[cf] > 0 ? config->cf_value_sizes[cf] : value_size;
+        total += w;
+        bytes += w * (k + v);
+    }
+    return total > 0.0 ? bytes / total : config->key_size + value_size;
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CFROUTE_H__
+#define __CFROUTE_H__
+
+#include <stdint.h>
+
+#include "benchmark.h"
+
+/*
+ * --column-families routing. the router is an engine of its own wrapped around an engine that
+ * was opened with several families, every op goes to the family view a hash of its key picks,
+ * weighted by config->cf_weights, so the workload threads stay unaware of the families. on the
+ * way the router applies the family's key and value size: shorter keys are padded in front with
+ * '0', which keeps the order and uniqueness of the zero-padded keys, and a family value size
+ * replaces the one the worker drew. a batch or bulk load keeps one sub-batch per family, a seek
+ * stays inside the family of its key, and a scan from the first key or over a bounded range walks
+ * every family in turn.
+ *
+ * the router counts the keys it routes per family in thread-local counters and remembers the
+ * family of the calling thread's last op, so a worker can attribute its latency samples.
+ */
+#define CFROUTE_SLOTS        4096 /* hash slots the weights are spread over */
+#define CFROUTE_MAX_KEY_SIZE 1024 /* largest family key size */
+
+/* family of the calling thread's last routed op */
+extern _Thread_local int cfroute_last_cf;
+
+/**
+ * cfroute_open
+ * wraps an engine opened with config->num_column_families families
+ * @param base the engine, owned by the router from here on and closed with it
+ * @param config family count, weights and sizes
+ * @param engine the router
+ * @return 0 on success, -1 when the engine has no column families or on allocation failure
+ */
+int cfroute_open(storage_engine_t *base, const benchmark_config_t *config,
+                 storage_engine_t **engine);
+
+/**
+ * cfroute_is_router
+ * @param engine an engine
+ * @return 1 when engine is a router from cfroute_open
+ */
+int cfroute_is_router(const storage_engine_t *engine);
+
+/**
+ * cfroute_family
+ * @param engine a router
+ * @param cf family index
+ * @return the engine's view of family cf, ops on it bypass the routing
+ */
+storage_engine_t *cfroute_family(storage_engine_t *engine, int cf);
+
+/**
+ * cfroute_thread_ops
+ * @return the calling thread's per-family routed op counters, BENCHMARK_MAX_COLUMN_FAMILIES
+ * entries that only grow
+ */
+const uint64_t *cfroute_thread_ops(void);
+
+/**
+ * cfroute_parse_profile
+ * parses a --cf-profile argument, a comma separated list of weight[:key_size[:value_size]]
+ * entries that is repeated over the families when it is shorter than their count. a size of 0
+ * keeps -k or -v
+ * @param spec the profile
+ * @param config num_column_families is read, cf_weights, cf_key_sizes and cf_value_sizes filled
+ * @return 0 on success, -1 on a malformed profile
+ */
+int cfroute_parse_profile(const char *spec, benchmark_config_t *config);
+
+/**
+ * cfroute_mean_entry
+ * logical bytes of the average entry over the families, weighted by their key share
+ * @param config family profile, key size and value size
+ * @param value_size mean value size of the workers' values
+ * @return bytes per entry
+ */
+double cfroute_mean_entry(const benchmark_config_t *config, double value_size);
+
+#endif /* __CFROUTE_H__ */
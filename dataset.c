@@ -0,0 +1,402 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "dataset.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "keygen.h"
+#include "valuegen.h"
+
+#define DATASET_COPY_BUF (1 << 20)
+
+static void marker_path(const char *db_path, char *out, size_t out_size)
+{
+    snprintf(out, out_size, "%s.loaded", db_path);
+}
+
+key_pattern_t dataset_load_pattern(const benchmark_config_t *config)
+{
+    /* like the mix preload, skewed patterns load the whole keyspace sequentially, so do scans,
+     * whose bounds are ranges of key indexes */
+    if (keygen_pattern_is_skewed(config->key_pattern) || config->workload_type == WORKLOAD_SCAN)
+    {
+        return KEY_PATTERN_SEQUENTIAL;
+    }
+    return config->key_pattern;
+}
+
+/* the key layout is part of the shape, random keys are hex and sequential ones decimal */
+static void marker_text(const benchmark_config_t *config, char *out, size_t out_size)
+{
+    size_t min_size, max_size;
+    value_pool_bounds(config, &min_size, &max_size);
+    snprintf(out, out_size,
+             "engine=%s\nnum_operations=%" PRId64
+             "\nkey_size=%d\nkey_pattern=%s\nvalue_size=%d\nvalue_dist=%s %zu-%zu\n"
+             "compression_ratio=%.2f\ncolumn_families=%d %s\n",
+             config->engine_name, config->num_operations, config->key_size,
+             pattern_to_string(dataset_load_pattern(config)), config->value_size,
+             value_dist_name(config->value_dist), min_size, max_size, config->compression_ratio,
+             config->num_column_families, config->cf_profile ? config->cf_profile : "uniform");
+}
+
+int dataset_is_loaded(const benchmark_config_t *config)
+{
+    char path[1024];
+    char expected[512];
+    char found[512];
+    marker_path(config->db_path, path, sizeof(path));
+    marker_text(config, expected, sizeof(expected));
+
+    struct stat st;
+    if (stat(config->db_path, &st) != 0) return 0;
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    size_t n = fread(found, 1, sizeof(found) - 1, fp);
+    fclose(fp);
+    found[n] = '\0';
+    return strcmp(found, expected) == 0;
+}
+
+int dataset_mark_loaded(const benchmark_config_t *config)
+{
+    char path[1024];
+    char text[512];
+    marker_path(config->db_path, path, sizeof(path));
+    marker_text(config, text, sizeof(text));
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    int ok = fputs(text, fp) >= 0;
+    return fclose(fp) == 0 && ok ? 0 : -1;
+}
+
+void dataset_forget(const benchmark_config_t *config)
+{
+    char path[1024];
+    marker_path(config->db_path, path, sizeof(path));
+    unlink(path);
+}
+
+/* we clone with FICLONE where the filesystem can (btrfs, xfs, bcachefs), the copy shares
+ * extents until either side writes. anywhere else it is a plain copy */
+static int copy_file(const char *src, const char *dst, snapshot_mode_t mode)
+{
+    if (mode == SNAPSHOT_HARDLINK) return link(src, dst);
+
+    int in = open(src, O_RDONLY);
+    if (in < 0) return -1;
+    int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0)
+    {
+        close(in);
+        return -1;
+    }
+
+    int rc = 0;
+#ifdef FICLONE
+    if (mode == SNAPSHOT_REFLINK && ioctl(out, FICLONE, in) == 0)
+    {
+        close(in);
+        return close(out);
+    }
+#endif
+
+    char *buf = malloc(DATASET_COPY_BUF);
+    if (!buf) rc = -1;
+    while (rc == 0)
+    {
+        ssize_t n = read(in, buf, DATASET_COPY_BUF);
+        if (n == 0) break;
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            rc = -1;
+            break;
+        }
+
+        /* a write may take less than asked, we go on until the whole read is out */
+        for (ssize_t done = 0; done < n;)
+        {
+            ssize_t w = write(out, buf + done, (size_t)(n - done));
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0)
+            {
+                rc = -1;
+                break;
+            }
+            done += w;
+        }
+    }
+    free(buf);
+    close(in);
+    if (close(out) != 0) rc = -1;
+    return rc;
+}
+
+static int copy_tree(const char *src, const char *dst, snapshot_mode_t mode)
+{
+    struct stat st;
+    if (stat(src, &st) != 0) return -1;
+
+    /* single-file databases (LMDB with MDB_NOSUBDIR), the lock file is not part of the data */
+    if (S_ISREG(st.st_mode)) return copy_file(src, dst, mode);
+
+    if (mkdir(dst, 0755) != 0 && errno != EEXIST) return -1;
+
+    DIR *dir = opendir(src);
+    if (!dir) return -1;
+
+    int rc = 0;
+    struct dirent *entry;
+    while (rc == 0 && (entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char src_path[1024];
+        char dst_path[1024];
+        snprintf(src_path, sizeof(src_path), "%s/%s", src, entry->d_name);
+        snprintf(dst_path, sizeof(dst_path), "%s/%s", dst, entry->d_name);
+
+        if (stat(src_path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode))
+        {
+            rc = copy_tree(src_path, dst_path, mode);
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            rc = copy_file(src_path, dst_path, mode);
+        }
+    }
+
+    closedir(dir);
+    return rc;
+}
+
+int dataset_remove(const char *path)
+{
+    struct stat st;
+    if (lstat(path, &st) != 0) return errno == ENOENT ? 0 : -1;
+    if (!S_ISDIR(st.st_mode)) return unlink(path);
+
+    DIR *dir = opendir(path);
+    if (!dir) return -1;
+
+    int rc = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char child[1024];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (dataset_remove(child) != 0) rc = -1;
+    }
+
+    closedir(dir);
+    if (rmdir(path) != 0) rc = -1;
+    return rc;
+}
+
+int dataset_drop_cache(const char *path)
+{
+    struct stat st;
+    if (lstat(path, &st) != 0) return -1;
+    if (S_ISREG(st.st_mode))
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return -1;
+
+        /* only clean pages can be dropped, so we write the dirty ones back first */
+        int rc = fdatasync(fd);
+        if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) != 0) rc = -1;
+        close(fd);
+        return rc;
+    }
+    if (!S_ISDIR(st.st_mode)) return 0;
+
+    DIR *dir = opendir(path);
+    if (!dir) return -1;
+
+    int rc = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char child[1024];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (dataset_drop_cache(child) != 0) rc = -1;
+    }
+
+    closedir(dir);
+    return rc;
+}
+
+/* the absolute path with symlinks resolved, a path that does not exist yet is resolved through
+ * its parent directory */
+static int resolve_path(const char *path, char *out)
+{
+    if (realpath(path, out)) return 0;
+    if (errno != ENOENT) return -1;
+
+    char parent[PATH_MAX];
+    snprintf(parent, sizeof(parent), "%s", path);
+    size_t len = strlen(parent);
+    while (len > 1 && parent[len - 1] == '/') parent[--len] = '\0';
+    char *slash = strrchr(parent, '/');
+    const char *base = slash ? slash + 1 : parent;
+    const char *dir = ".";
+    if (slash == parent)
+    {
+        dir = "/";
+    }
+    else if (slash)
+    {
+        *slash = '\0';
+        dir = parent;
+    }
+    if (!*base || strcmp(base, ".") == 0 || strcmp(base, "..") == 0) return -1;
+
+    char resolved[PATH_MAX];
+    if (!realpath(dir, resolved)) return -1;
+    int n = snprintf(out, PATH_MAX, "%s/%s", strcmp(resolved, "/") == 0 ? "" : resolved, base);
+    return n < PATH_MAX ? 0 : -1;
+}
+
+/* 1 when inner is outer or lies below it */
+static int path_within(const char *outer, const char *inner)
+{
+    size_t len = strlen(outer);
+    if (strcmp(outer, "/") == 0) return 1;
+    return strncmp(outer, inner, len) == 0 && (inner[len] == '\0' || inner[len] == '/');
+}
+
+/* 1 for a missing path, an empty file or an empty directory */
+static int path_is_empty(const char *path)
+{
+    struct stat st;
+    if (lstat(path, &st) != 0) return errno == ENOENT;
+    if (!S_ISDIR(st.st_mode)) return st.st_size == 0;
+
+    DIR *dir = opendir(path);
+    if (!dir) return 0;
+    int empty = 1;
+    struct dirent *entry;
+    while (empty && (entry = readdir(dir)) != NULL)
+    {
+        empty = strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0;
+    }
+    closedir(dir);
+    return empty;
+}
+
+/* we only ever remove dst when it is a tree of its own: not src, not above or below it, and when
+ * dst_marked is asked for either empty or a dataset we wrote (it has a marker) */
+static int check_replace(const char *src, const char *dst, int dst_marked)
+{
+    char src_real[PATH_MAX];
+    char dst_real[PATH_MAX];
+    if (resolve_path(src, src_real) != 0 || resolve_path(dst, dst_real) != 0)
+    {
+        fprintf(stderr, "Error: cannot resolve %s or %s\n", src, dst);
+        return -1;
+    }
+    if (path_within(dst_real, src_real) || path_within(src_real, dst_real))
+    {
+        fprintf(stderr, "Error: %s and %s must be separate trees, neither inside the other\n",
+                src, dst);
+        return -1;
+    }
+
+    char dst_marker[PATH_MAX + 16];
+    struct stat st;
+    marker_path(dst, dst_marker, sizeof(dst_marker));
+    if (dst_marked && !path_is_empty(dst) && stat(dst_marker, &st) != 0)
+    {
+        fprintf(stderr,
+                "Error: %s exists and is not a benchtool snapshot (no %s), remove it or pick "
+                "another directory\n",
+                dst, dst_marker);
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_check_snapshot(const benchmark_config_t *config)
+{
+    if (!config->snapshot_dir) return 0;
+    return check_replace(config->db_path, config->snapshot_dir, 1);
+}
+
+/* we copy src (and its marker) over dst, the marker goes last so an interrupted copy is never
+ * mistaken for a loaded dataset */
+static int replace_tree(const char *src, const char *dst, snapshot_mode_t mode, int dst_marked)
+{
+    char src_marker[1024];
+    char dst_marker[1024];
+    marker_path(src, src_marker, sizeof(src_marker));
+    marker_path(dst, dst_marker, sizeof(dst_marker));
+
+    if (check_replace(src, dst, dst_marked) != 0) return -1;
+
+    unlink(dst_marker);
+    if (dataset_remove(dst) != 0) return -1;
+    if (copy_tree(src, dst, mode) != 0) return -1;
+
+    struct stat st;
+    if (stat(src_marker, &st) == 0) return copy_file(src_marker, dst_marker, SNAPSHOT_COPY);
+    return 0;
+}
+
+/* LMDB rewrites pages of its data file in place, a hard link would let the runs write into the
+ * snapshot. -e lmdb with hardlink is refused, an lmdb --baseline-engine gets a copy */
+static snapshot_mode_t snapshot_mode(const benchmark_config_t *config)
+{
+    if (config->snapshot_mode == SNAPSHOT_HARDLINK && strcmp(config->engine_name, "lmdb") == 0)
+    {
+        return SNAPSHOT_COPY;
+    }
+    return config->snapshot_mode;
+}
+
+int dataset_snapshot(const benchmark_config_t *config)
+{
+    if (!config->snapshot_dir) return 0;
+    return replace_tree(config->db_path, config->snapshot_dir, snapshot_mode(config), 1);
+}
+
+int dataset_restore(const benchmark_config_t *config)
+{
+    struct stat st;
+    if (!config->snapshot_dir || stat(config->snapshot_dir, &st) != 0) return -1;
+    return replace_tree(config->snapshot_dir, config->db_path, snapshot_mode(config), 0);
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __DATASET_H__
+#define __DATASET_H__
+
+#include "benchmark.h"
+
+/*
+ * loaded dataset bookkeeping for --phase load|run and --reuse-db. a completed load leaves a
+ * marker file next to the database (<db_path>.loaded) recording the engine and the shape of
+ * the data, later runs compare it against their own config to decide whether the load can be
+ * skipped. a snapshot is a copy of the closed, loaded database (and its marker) that a run
+ * restores before it opens the engine, so every trial starts from the same on-disk state.
+ */
+
+/**
+ * dataset_load_pattern
+ * @param config benchmark configuration
+ * @return the key pattern a load phase writes the keyspace with
+ */
+key_pattern_t dataset_load_pattern(const benchmark_config_t *config);
+
+/**
+ * dataset_is_loaded
+ * @param config benchmark configuration
+ * @return 1 when db_path holds a completed load of the same engine, key count, key layout and
+ * sizes
+ */
+int dataset_is_loaded(const benchmark_config_t *config);
+
+/**
+ * dataset_mark_loaded
+ * records a completed load of db_path, call with the engine closed
+ * @param config benchmark configuration
+ * @return 0 on success, -1 on failure
+ */
+int dataset_mark_loaded(const benchmark_config_t *config);
+
+/**
+ * dataset_forget
+ * drops the marker, for runs that delete keys from the loaded dataset
+ * @param config benchmark configuration
+ */
+void dataset_forget(const benchmark_config_t *config);
+
+/**
+ * dataset_snapshot
+ * replaces config->snapshot_dir with a copy of the closed database at db_path
+ * @param config benchmark configuration
+ * @return 0 on success, -1 on failure
+ */
+int dataset_snapshot(const benchmark_config_t *config);
+
+/**
+ * dataset_check_snapshot
+ * checks that config->snapshot_dir can be replaced: it is neither db_path nor above or below it,
+ * and it is missing, empty or an earlier snapshot
+ * @param config benchmark configuration
+ * @return 0 when the snapshot may be written, -1 otherwise
+ */
+int dataset_check_snapshot(const benchmark_config_t *config);
+
+/**
+ * dataset_restore
+ * replaces db_path with a copy of config->snapshot_dir
+ * @param config benchmark configuration
+ * @return 0 on success, -1 when the snapshot is missing or the copy failed
+ */
+int dataset_restore(const benchmark_config_t *config);
+
+/**
+ * dataset_remove
+ * removes a database file or directory tree, a missing path is not an error
+ * @param path path to remove
+ * @return 0 on success, -1 on failure
+ */
+int dataset_remove(const char *path);
+
+/**
+ * dataset_drop_cache
+ * writes back and drops the page cache of every file under path, so the next reads of a closed
+ * database go to the device whatever memory the machine has
+ * @param path database file or directory
+ * @return 0 on success, -1 when a file could not be opened or advised
+ */
+int dataset_drop_cache(const char *path);
+
+#endif /* __DATASET_H__ */
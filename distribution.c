@@ -0,0 +1,92 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "distribution.h"
+
+#include <math.h>
+
+/* zeta(n, theta) = sum_{i=1..n} 1/i^theta */
+static double dist_zeta(uint64_t n, double theta)
+{
+    uint64_t exact = n < DIST_ZETA_EXACT_TERMS ? n : DIST_ZETA_EXACT_TERMS;
+    double sum = 0.0;
+
+    for (uint64_t i = 1; i <= exact; i++)
+    {
+        sum += pow((double)i, -theta);
+    }
+
+    /* the remaining terms are smooth enough for the midpoint integral, the error is far below
+     * what a benchmark can observe and keeps init cheap for billion-key keyspaces */
+    if (n > exact)
+    {
+        sum += (pow((double)n + 0.5, 1.0 - theta) - pow((double)exact + 0.5, 1.0 - theta)) /
+               (1.0 - theta);
+    }
+    return sum;
+}
+
+void zipf_dist_init(zipf_dist_t *z, uint64_t n, double theta)
+{
+    if (n < 1) n = 1;
+
+    z->n = n;
+    z->theta = theta;
+    z->alpha = 1.0 / (1.0 - theta);
+    z->zetan = dist_zeta(n, theta);
+    z->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - dist_zeta(2, theta) / z->zetan);
+    z->second = 1.0 + pow(0.5, theta);
+}
+
+uint64_t zipf_dist_next(const zipf_dist_t *z, double u)
+{
+    double uz = u * z->zetan;
+    if (uz < 1.0) return 0;
+    if (uz < z->second) return 1;
+
+    uint64_t rank = (uint64_t)((double)z->n * pow(z->eta * u - z->eta + 1.0, z->alpha));
+    return rank < z->n ? rank : z->n - 1;
+}
+
+uint64_t dist_scramble(uint64_t rank, uint64_t n)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < 8; i++)
+    {
+        hash ^= (rank >> (i * 8)) & 0xFF;
+        hash *= 0x100000001B3ULL;
+    }
+    return n > 0 ? hash % n : 0;
+}
+
+void hotspot_dist_init(hotspot_dist_t *h, uint64_t n, double key_fraction, double op_fraction)
+{
+    if (n < 1) n = 1;
+
+    h->n = n;
+    h->hot_n = (uint64_t)((double)n * key_fraction);
+    if (h->hot_n < 1) h->hot_n = 1;
+    if (h->hot_n > n) h->hot_n = n;
+    h->op_fraction = op_fraction;
+}
+
+uint64_t hotspot_dist_next(const hotspot_dist_t *h, double u1, double u2)
+{
+    if (u1 < h->op_fraction || h->hot_n == h->n)
+    {
+        return (uint64_t)(u2 * (double)h->hot_n);
+    }
+    return h->hot_n + (uint64_t)(u2 * (double)(h->n - h->hot_n));
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __DISTRIBUTION_H__
+#define __DISTRIBUTION_H__
+
+#include <stdint.h>
+
+/*
+ * key index distributions. every sampler takes a uniform u in [0, 1) from the caller's
+ * per-thread generator and maps it to an index in constant time, all state is precomputed at
+ * init and read-only afterwards.
+ */
+
+/* terms of the zeta sum computed exactly, the tail is closed with the integral approximation */
+#define DIST_ZETA_EXACT_TERMS 65536
+
+/* YCSB-style zipfian over ranks [0, n) (Gray et al., "Quickly generating billion-record
+ * synthetic databases"), rank 0 is the hottest */
+typedef struct
+{
+    uint64_t n;
+    double theta;
+    double alpha;  /* 1 / (1 - theta) */
+    double zetan;  /* zeta(n, theta) */
+    double eta;    /* (1 - (2/n)^(1-theta)) / (1 - zeta(2, theta) / zetan) */
+    double second; /* 1 + 0.5^theta, upper bound of uz for rank 1 */
+} zipf_dist_t;
+
+/**
+ * zipf_dist_init
+ * precomputes a zipfian sampler, O(min(n, DIST_ZETA_EXACT_TERMS))
+ * @param z the sampler
+ * @param n number of ranks
+ * @param theta skew, 0 < theta < 1 (YCSB default 0.99)
+ */
+void zipf_dist_init(zipf_dist_t *z, uint64_t n, double theta);
+
+/**
+ * zipf_dist_next
+ * maps u onto a zipfian distributed rank
+ * @param z the sampler
+ * @param u uniform value in [0, 1)
+ * @return rank in [0, n)
+ */
+uint64_t zipf_dist_next(const zipf_dist_t *z, double u);
+
+/**
+ * dist_scramble
+ * spreads a rank over [0, n) with FNV-1a, so the hot ranks of a zipfian land on keys that are
+ * scattered through the key order instead of being adjacent
+ * @param rank the rank to scatter
+ * @param n size of the keyspace
+ * @return index in [0, n)
+ */
+uint64_t dist_scramble(uint64_t rank, uint64_t n);
+
+/* hotspot, op_fraction of the draws go to the first key_fraction of the keyspace, the rest is
+ * uniform over the remaining keys */
+typedef struct
+{
+    uint64_t n;
+    uint64_t hot_n; /* size of the hot set, at least 1 */
+    double op_fraction;
+} hotspot_dist_t;
+
+/**
+ * hotspot_dist_init
+ * @param h the sampler
+ * @param n size of the keyspace
+ * @param key_fraction share of the keyspace that is hot, in (0, 1]
+ * @param op_fraction share of the draws that go to the hot set, in [0, 1]
+ */
+void hotspot_dist_init(hotspot_dist_t *h, uint64_t n, double key_fraction, double op_fraction);
+
+/**
+ * hotspot_dist_next
+ * @param h the sampler
+ * @param u1 uniform value in [0, 1), picks hot or cold
+ * @param u2 uniform value in [0, 1), picks the key inside the set
+ * @return index in [0, n)
+ */
+uint64_t hotspot_dist_next(const hotspot_dist_t *h, double u1, double u2);
+
+#endif /* __DISTRIBUTION_H__ */
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -23,11 +24,15 @@
 
 const char *lmdb_version_str = MDB_VERSION_STRING;
 
-typedef struct
+typedef struct lmdb_handle_t
 {
     MDB_env *env;
     MDB_dbi dbi;
     int sync_enabled;
+    int named;                        /* dbi is a named database of --column-families */
+    struct lmdb_handle_t *cf_handles; /* --column-families, one copy per named database */
+    storage_engine_t *cf_views;       /* engines over cf_handles */
+    int num_cf_views;
 } lmdb_handle_t;
 
 typedef struct
@@ -36,6 +41,18 @@ typedef struct
     lmdb_handle_t *handle;
 } lmdb_batch_context_t;
 
+/* appends per write txn, bounds the dirty page list of a txn without MDB_WRITEMAP */
+#define LMDB_BULK_TXN_KEYS 65536
+
+typedef struct
+{
+    MDB_txn *txn;
+    MDB_cursor *cursor;
+    lmdb_handle_t *handle;
+    size_t pending; /* appends in the open txn */
+    int failed;     /* an add failed, the load is not committed */
+} lmdb_bulk_context_t;
+
 typedef struct
 {
     MDB_txn *txn;
@@ -43,17 +60,73 @@ typedef struct
     MDB_val key;
     MDB_val value;
     int valid;
+    int bounded; /* iter_seek_bounded, moves outside [lower, upper) end the iteration */
+    uint8_t *lower;
+    size_t lower_size, lower_cap;
+    uint8_t *upper;
+    size_t upper_size, upper_cap;
 } lmdb_iter_t;
 
 static const storage_engine_ops_t lmdb_ops;
 
+/* --column-families, named databases cf_0 .. cf_{n-1} in the same environment, opened in the
+ * txn that opens the main database. each gets a copy of the handle pointing at its dbi */
+static int lmdb_open_named(lmdb_handle_t *handle, MDB_txn *txn, int n)
+{
+    handle->cf_handles = calloc((size_t)n, sizeof(lmdb_handle_t));
+    handle->cf_views = calloc((size_t)n, sizeof(storage_engine_t));
+    if (!handle->cf_handles || !handle->cf_views) return -1;
+
+    for (int i = 0; i < n; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "cf_%d", i);
+        lmdb_handle_t *view = &handle->cf_handles[i];
+        *view = *handle;
+        view->named = 1;
+        view->cf_handles = NULL;
+        view->cf_views = NULL;
+        if (mdb_dbi_open(txn, name, MDB_CREATE, &view->dbi) != 0)
+        {
+            fprintf(stderr, "Failed to open LMDB database %s\n", name);
+            return -1;
+        }
+        handle->cf_views[i].ops = &lmdb_ops;
+        handle->cf_views[i].handle = view;
+    }
+    handle->num_cf_views = n;
+    return 0;
+}
+
+static void lmdb_free_named(lmdb_handle_t *handle)
+{
+    free(handle->cf_handles);
+    free(handle->cf_views);
+}
+
+/* each thread that reads holds a reader slot of its own, --queue-depth reads on helper threads
+ * and a --thread-sweep point can run more workers than -t */
+static unsigned int lmdb_max_readers(const benchmark_config_t *config)
+{
+    int threads = config->num_threads;
+    for (int i = 0; i < config->thread_sweep_count; i++)
+    {
+        if (config->thread_sweep[i] > threads) threads = config->thread_sweep[i];
+    }
+    if (threads <= 0) return 128;
+    int depth = config->queue_depth > 1 ? config->queue_depth : 1;
+    /* with MDB_NOTLS a slot is per read txn, a scan over the families holds one per family */
+    int families = config->num_column_families > 1 ? config->num_column_families : 1;
+    return (unsigned int)threads * (unsigned int)depth * (unsigned int)families * 2;
+}
+
 static int lmdb_open_impl(storage_engine_t **engine, const char *path,
                           const benchmark_config_t *config)
 {
     *engine = malloc(sizeof(storage_engine_t));
     if (!*engine) return -1;
 
-    lmdb_handle_t *handle = malloc(sizeof(lmdb_handle_t));
+    lmdb_handle_t *handle = calloc(1, sizeof(lmdb_handle_t));
     if (!handle)
     {
         free(*engine);
@@ -72,9 +145,15 @@ static int lmdb_open_impl(storage_engine_t **engine, const char *path,
         config->memtable_size > 0 ? config->memtable_size : (size_t)10 * 1024 * 1024 * 1024;
     mdb_env_set_mapsize(handle->env, map_size);
 
-    mdb_env_set_maxreaders(handle->env, config->num_threads > 0 ? config->num_threads * 2 : 128);
+    mdb_env_set_maxreaders(handle->env, lmdb_max_readers(config));
+
+    int num_named = config->num_column_families > 1 ? config->num_column_families : 0;
+    if (num_named) mdb_env_set_maxdbs(handle->env, (MDB_dbi)num_named);
 
     unsigned int env_flags = MDB_NOSUBDIR;
+    /* the column-family router keeps an iterator, and so a read txn, open per family on one
+     * thread. a thread-bound reader slot would refuse the second with MDB_BAD_RSLOT */
+    if (num_named) env_flags |= MDB_NOTLS;
     if (!config->sync_enabled)
     {
         env_flags |= MDB_NOSYNC | MDB_WRITEMAP;
@@ -99,11 +178,14 @@ static int lmdb_open_impl(storage_engine_t **engine, const char *path,
         return -1;
     }
 
+    handle->sync_enabled = config->sync_enabled;
     rc = mdb_dbi_open(txn, NULL, 0, &handle->dbi);
+    if (rc == 0 && num_named && lmdb_open_named(handle, txn, num_named) != 0) rc = -1;
     if (rc != 0)
     {
         mdb_txn_abort(txn);
         mdb_env_close(handle->env);
+        lmdb_free_named(handle);
         free(handle);
         free(*engine);
         return -1;
@@ -113,13 +195,12 @@ static int lmdb_open_impl(storage_engine_t **engine, const char *path,
     if (rc != 0)
     {
         mdb_env_close(handle->env);
+        lmdb_free_named(handle);
         free(handle);
         free(*engine);
         return -1;
     }
 
-    handle->sync_enabled = config->sync_enabled;
-
     (*engine)->handle = handle;
     (*engine)->ops = &lmdb_ops;
 
@@ -142,8 +223,13 @@ static void lmdb_set_sync_mode(storage_engine_t *engine, int sync_enabled)
 static int lmdb_close_impl(storage_engine_t *engine)
 {
     lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
+    for (int i = 0; i < handle->num_cf_views; i++)
+    {
+        mdb_dbi_close(handle->env, handle->cf_handles[i].dbi);
+    }
     mdb_dbi_close(handle->env, handle->dbi);
     mdb_env_close(handle->env);
+    lmdb_free_named(handle);
     free(handle);
     free(engine);
     return 0;
@@ -205,6 +291,72 @@ static int lmdb_get_impl(storage_engine_t *engine, const uint8_t *key, size_t ke
     return 0;
 }
 
+static int lmdb_get_pinned_impl(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                                const uint8_t **value, size_t *value_size, void **pin)
+{
+    lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
+
+    MDB_txn *txn;
+    int rc = mdb_txn_begin(handle->env, NULL, MDB_RDONLY, &txn);
+    if (rc != 0) return -1;
+
+    MDB_val mdb_key = {.mv_size = key_size, .mv_data = (void *)key};
+    MDB_val mdb_value;
+
+    rc = mdb_get(txn, handle->dbi, &mdb_key, &mdb_value);
+    if (rc != 0)
+    {
+        mdb_txn_abort(txn);
+        return -1;
+    }
+
+    /* mv_data points into the memory map, it stays valid while the read txn is open so the
+     * txn is the pin */
+    *value = (const uint8_t *)mdb_value.mv_data;
+    *value_size = mdb_value.mv_size;
+    *pin = txn;
+    return 0;
+}
+
+static void lmdb_release_pinned_impl(storage_engine_t *engine, void *pin)
+{
+    (void)engine;
+    mdb_txn_abort((MDB_txn *)pin);
+}
+
+static int lmdb_multi_get_impl(storage_engine_t *engine, size_t num_keys,
+                               const uint8_t *const *keys, const size_t *key_sizes,
+                               uint8_t **values, size_t *value_sizes)
+{
+    lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
+
+    /* a single read txn for the whole batch instead of one per key */
+    MDB_txn *txn;
+    int rc = mdb_txn_begin(handle->env, NULL, MDB_RDONLY, &txn);
+    if (rc != 0) return -1;
+
+    int found = 0;
+    for (size_t i = 0; i < num_keys; i++)
+    {
+        MDB_val mdb_key = {.mv_size = key_sizes[i], .mv_data = (void *)keys[i]};
+        MDB_val mdb_value;
+
+        values[i] = NULL;
+        value_sizes[i] = 0;
+        if (mdb_get(txn, handle->dbi, &mdb_key, &mdb_value) != 0) continue;
+
+        values[i] = malloc(mdb_value.mv_size);
+        if (!values[i]) continue;
+
+        memcpy(values[i], mdb_value.mv_data, mdb_value.mv_size);
+        value_sizes[i] = mdb_value.mv_size;
+        found++;
+    }
+
+    mdb_txn_abort(txn);
+    return found;
+}
+
 static int lmdb_del_impl(storage_engine_t *engine, const uint8_t *key, size_t key_size)
 {
     lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
@@ -280,11 +432,96 @@ static int lmdb_batch_commit_impl(void *batch_ctx)
     return rc == 0 ? 0 : -1;
 }
 
+static int lmdb_bulk_open_txn(lmdb_bulk_context_t *ctx)
+{
+    int rc = mdb_txn_begin(ctx->handle->env, NULL, 0, &ctx->txn);
+    if (rc != 0)
+    {
+        ctx->txn = NULL;
+        return -1;
+    }
+
+    rc = mdb_cursor_open(ctx->txn, ctx->handle->dbi, &ctx->cursor);
+    if (rc != 0)
+    {
+        mdb_txn_abort(ctx->txn);
+        ctx->txn = NULL;
+        return -1;
+    }
+    ctx->pending = 0;
+    return 0;
+}
+
+static int lmdb_bulk_begin_impl(storage_engine_t *engine, void **bulk_ctx)
+{
+    lmdb_bulk_context_t *ctx = malloc(sizeof(lmdb_bulk_context_t));
+    if (!ctx) return -1;
+
+    ctx->handle = (lmdb_handle_t *)engine->handle;
+    ctx->failed = 0;
+    if (lmdb_bulk_open_txn(ctx) != 0)
+    {
+        free(ctx);
+        return -1;
+    }
+    *bulk_ctx = ctx;
+    return 0;
+}
+
+static int lmdb_bulk_add_impl(void *bulk_ctx, const uint8_t *key, size_t key_size,
+                              const uint8_t *value, size_t value_size)
+{
+    lmdb_bulk_context_t *ctx = (lmdb_bulk_context_t *)bulk_ctx;
+    if (!ctx->txn) return -1;
+
+    MDB_val mdb_key = {.mv_size = key_size, .mv_data = (void *)key};
+    MDB_val mdb_value = {.mv_size = value_size, .mv_data = (void *)value};
+
+    /* sorted input goes to the rightmost leaf, no search and no page splits in the middle */
+    int rc = mdb_cursor_put(ctx->cursor, &mdb_key, &mdb_value, MDB_APPEND);
+    if (rc != 0)
+    {
+        ctx->failed = 1;
+        return -1;
+    }
+
+    if (++ctx->pending < LMDB_BULK_TXN_KEYS) return 0;
+
+    /* commit frees the cursor of a write txn */
+    rc = mdb_txn_commit(ctx->txn);
+    ctx->txn = NULL;
+    if (rc == 0) rc = lmdb_bulk_open_txn(ctx);
+    if (rc != 0) ctx->failed = 1;
+    return rc == 0 ? 0 : -1;
+}
+
+static void lmdb_bulk_abort_impl(void *bulk_ctx)
+{
+    lmdb_bulk_context_t *ctx = (lmdb_bulk_context_t *)bulk_ctx;
+    if (ctx->txn) mdb_txn_abort(ctx->txn);
+    free(ctx);
+}
+
+static int lmdb_bulk_finish_impl(void *bulk_ctx)
+{
+    lmdb_bulk_context_t *ctx = (lmdb_bulk_context_t *)bulk_ctx;
+
+    /* the open txn of a failed load holds a partial batch, it is dropped and not committed */
+    if (ctx->failed || !ctx->txn)
+    {
+        lmdb_bulk_abort_impl(ctx);
+        return -1;
+    }
+    int rc = mdb_txn_commit(ctx->txn);
+    free(ctx);
+    return rc == 0 ? 0 : -1;
+}
+
 static int lmdb_iter_new_impl(storage_engine_t *engine, void **iter)
 {
     lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
 
-    lmdb_iter_t *it = malloc(sizeof(lmdb_iter_t));
+    lmdb_iter_t *it = calloc(1, sizeof(lmdb_iter_t));
     if (!it) return -1;
 
     int rc = mdb_txn_begin(handle->env, NULL, MDB_RDONLY, &it->txn);
@@ -302,20 +539,37 @@ static int lmdb_iter_new_impl(storage_engine_t *engine, void **iter)
         return -1;
     }
 
-    it->valid = 0;
-    memset(&it->key, 0, sizeof(it->key));
-    memset(&it->value, 0, sizeof(it->value));
-
     *iter = it;
     return 0;
 }
 
+/* the default key order of an lmdb database, memcmp with the shorter key first on a tie */
+static int lmdb_key_cmp(const MDB_val *key, const uint8_t *bound, size_t bound_size)
+{
+    size_t n = key->mv_size < bound_size ? key->mv_size : bound_size;
+    int c = n > 0 ? memcmp(key->mv_data, bound, n) : 0;
+    if (c != 0) return c;
+    return key->mv_size < bound_size ? -1 : (key->mv_size > bound_size ? 1 : 0);
+}
+
+/* we record the outcome of a cursor move, a bounded iterator ends outside [lower, upper) */
+static void lmdb_iter_moved(lmdb_iter_t *it, int rc)
+{
+    it->valid = rc == 0;
+    if (!it->valid || !it->bounded) return;
+    if (lmdb_key_cmp(&it->key, it->upper, it->upper_size) >= 0 ||
+        lmdb_key_cmp(&it->key, it->lower, it->lower_size) < 0)
+    {
+        it->valid = 0;
+    }
+}
+
 static int lmdb_iter_seek_to_first_impl(void *iter)
 {
     lmdb_iter_t *it = (lmdb_iter_t *)iter;
 
-    int rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_FIRST);
-    it->valid = (rc == 0);
+    it->bounded = 0;
+    lmdb_iter_moved(it, mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_FIRST));
     return 0;
 }
 
@@ -323,11 +577,83 @@ static int lmdb_iter_seek_impl(void *iter, const uint8_t *key, size_t key_size)
 {
     lmdb_iter_t *it = (lmdb_iter_t *)iter;
 
+    it->bounded = 0;
     it->key.mv_size = key_size;
     it->key.mv_data = (void *)key;
+    lmdb_iter_moved(it, mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_SET_RANGE));
+    return 0;
+}
 
+/* MDB_SET_RANGE lands on the first key at or after key, the one before it is the answer unless
+ * the key itself is there, and past the end the last key is */
+static int lmdb_seek_for_prev(lmdb_iter_t *it, const uint8_t *key, size_t key_size, int inclusive)
+{
+    it->key.mv_size = key_size;
+    it->key.mv_data = (void *)key;
     int rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_SET_RANGE);
-    it->valid = (rc == 0);
+    if (rc == MDB_NOTFOUND) return mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_LAST);
+    if (rc == 0 && (!inclusive || lmdb_key_cmp(&it->key, key, key_size) != 0))
+    {
+        rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_PREV);
+    }
+    return rc;
+}
+
+static int lmdb_iter_seek_for_prev_impl(void *iter, const uint8_t *key, size_t key_size)
+{
+    lmdb_iter_t *it = (lmdb_iter_t *)iter;
+
+    it->bounded = 0;
+    lmdb_iter_moved(it, lmdb_seek_for_prev(it, key, key_size, 1));
+    return 0;
+}
+
+/* the bound keys are copied, the caller's buffers may change before the iterator moves */
+static int lmdb_iter_bound(uint8_t **buf, size_t *size, size_t *cap, const uint8_t *key,
+                           size_t key_size)
+{
+    if (key_size > *cap)
+    {
+        uint8_t *grown = realloc(*buf, key_size);
+        if (!grown) return -1;
+        *buf = grown;
+        *cap = key_size;
+    }
+    if (key_size > 0) memcpy(*buf, key, key_size);
+    *size = key_size;
+    return 0;
+}
+
+static int lmdb_iter_seek_bounded_impl(void *iter, const uint8_t *lower, size_t lower_size,
+                                       const uint8_t *upper, size_t upper_size, int reverse)
+{
+    lmdb_iter_t *it = (lmdb_iter_t *)iter;
+
+    if (!lower || !upper) return -1;
+    if (lmdb_iter_bound(&it->lower, &it->lower_size, &it->lower_cap, lower, lower_size) != 0 ||
+        lmdb_iter_bound(&it->upper, &it->upper_size, &it->upper_cap, upper, upper_size) != 0)
+    {
+        return -1;
+    }
+    it->bounded = 1;
+
+    int rc;
+    if (reverse)
+    {
+        rc = lmdb_seek_for_prev(it, it->upper, it->upper_size, 0);
+    }
+    else if (it->lower_size == 0)
+    {
+        /* MDB_SET_RANGE refuses an empty key, an empty lower bound starts at the first one */
+        rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_FIRST);
+    }
+    else
+    {
+        it->key.mv_size = it->lower_size;
+        it->key.mv_data = it->lower;
+        rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_SET_RANGE);
+    }
+    lmdb_iter_moved(it, rc);
     return 0;
 }
 
@@ -341,21 +667,27 @@ static int lmdb_iter_next_impl(void *iter)
 {
     lmdb_iter_t *it = (lmdb_iter_t *)iter;
 
-    int rc = mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_NEXT);
-    it->valid = (rc == 0);
+    lmdb_iter_moved(it, mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_NEXT));
+    return 0;
+}
+
+static int lmdb_iter_prev_impl(void *iter)
+{
+    lmdb_iter_t *it = (lmdb_iter_t *)iter;
+
+    lmdb_iter_moved(it, mdb_cursor_get(it->cursor, &it->key, &it->value, MDB_PREV));
     return 0;
 }
 
+/* keys and values point into the map, valid until the cursor moves, the read txn keeps the
+ * pages in place */
 static int lmdb_iter_key_impl(void *iter, uint8_t **key, size_t *key_size)
 {
     lmdb_iter_t *it = (lmdb_iter_t *)iter;
 
     if (!it->valid) return -1;
 
-    *key = malloc(it->key.mv_size);
-    if (!*key) return -1;
-
-    memcpy(*key, it->key.mv_data, it->key.mv_size);
+    *key = (uint8_t *)it->key.mv_data;
     *key_size = it->key.mv_size;
     return 0;
 }
@@ -366,10 +698,21 @@ static int lmdb_iter_value_impl(void *iter, uint8_t **value, size_t *value_size)
 
     if (!it->valid) return -1;
 
-    *value = malloc(it->value.mv_size);
-    if (!*value) return -1;
+    *value = (uint8_t *)it->value.mv_data;
+    *value_size = it->value.mv_size;
+    return 0;
+}
+
+static int lmdb_iter_entry_impl(void *iter, uint8_t **key, size_t *key_size, uint8_t **value,
+                                size_t *value_size)
+{
+    lmdb_iter_t *it = (lmdb_iter_t *)iter;
+
+    if (!it->valid) return -1;
 
-    memcpy(*value, it->value.mv_data, it->value.mv_size);
+    *key = (uint8_t *)it->key.mv_data;
+    *key_size = it->key.mv_size;
+    *value = (uint8_t *)it->value.mv_data;
     *value_size = it->value.mv_size;
     return 0;
 }
@@ -380,20 +723,68 @@ static int lmdb_iter_free_impl(void *iter)
 
     mdb_cursor_close(it->cursor);
     mdb_txn_abort(it->txn);
+    free(it->lower);
+    free(it->upper);
     free(it);
     return 0;
 }
 
+/* the b+tree shape from a read txn and the used part of the map, lmdb has no cache, stalls or
+ * compactions to report */
+static int lmdb_get_stats_impl(storage_engine_t *engine, engine_stats_t *stats)
+{
+    lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
+
+    MDB_txn *txn = NULL;
+    if (mdb_txn_begin(handle->env, NULL, MDB_RDONLY, &txn) != 0) return -1;
+
+    MDB_stat st;
+    int rc = mdb_stat(txn, handle->dbi, &st);
+    mdb_txn_abort(txn);
+    if (rc != 0) return -1;
+
+    stats->tree_depth = st.ms_depth;
+    stats->num_keys = (int64_t)st.ms_entries;
+
+    /* a named database only owns its own pages, the main one stands for the whole map */
+    MDB_envinfo info;
+    if (handle->named)
+    {
+        stats->live_data_bytes =
+            (int64_t)(st.ms_branch_pages + st.ms_leaf_pages + st.ms_overflow_pages) * st.ms_psize;
+    }
+    else if (mdb_env_info(handle->env, &info) == 0)
+    {
+        stats->live_data_bytes = (int64_t)(info.me_last_pgno + 1) * st.ms_psize;
+    }
+    return 0;
+}
+
+static int lmdb_column_family_impl(storage_engine_t *engine, int index, storage_engine_t **cf)
+{
+    lmdb_handle_t *handle = (lmdb_handle_t *)engine->handle;
+    if (index < 0 || index >= handle->num_cf_views) return -1;
+    *cf = &handle->cf_views[index];
+    return 0;
+}
+
 static const storage_engine_ops_t lmdb_ops = {
     .open = lmdb_open_impl,
     .close = lmdb_close_impl,
     .put = lmdb_put_impl,
     .get = lmdb_get_impl,
+    .get_pinned = lmdb_get_pinned_impl,
+    .release_pinned = lmdb_release_pinned_impl,
+    .multi_get = lmdb_multi_get_impl,
     .del = lmdb_del_impl,
     .batch_begin = lmdb_batch_begin_impl,
     .batch_put = lmdb_batch_put_impl,
     .batch_delete = lmdb_batch_delete_impl,
     .batch_commit = lmdb_batch_commit_impl,
+    .bulk_begin = lmdb_bulk_begin_impl,
+    .bulk_add = lmdb_bulk_add_impl,
+    .bulk_finish = lmdb_bulk_finish_impl,
+    .bulk_abort = lmdb_bulk_abort_impl,
     .iter_new = lmdb_iter_new_impl,
     .iter_seek_to_first = lmdb_iter_seek_to_first_impl,
     .iter_seek = lmdb_iter_seek_impl,
@@ -402,7 +793,13 @@ static const storage_engine_ops_t lmdb_ops = {
     .iter_key = lmdb_iter_key_impl,
     .iter_value = lmdb_iter_value_impl,
     .iter_free = lmdb_iter_free_impl,
+    .iter_seek_bounded = lmdb_iter_seek_bounded_impl,
+    .iter_seek_for_prev = lmdb_iter_seek_for_prev_impl,
+    .iter_prev = lmdb_iter_prev_impl,
+    .iter_entry = lmdb_iter_entry_impl,
     .set_sync = lmdb_set_sync_mode,
+    .get_stats = lmdb_get_stats_impl,
+    .column_family = lmdb_column_family_impl,
     .name = "lmdb",
 };
 
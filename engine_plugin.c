@@ -0,0 +1,45 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "benchmark.h"
+
+/*
+ * compiled into every engine plugin by benchtool_engine(), which passes the name of the engine's
+ * ops function as BENCHTOOL_ENGINE_OPS and its version as BENCHTOOL_ENGINE_VERSION. the main
+ * binary never links this file
+ */
+#ifndef BENCHTOOL_ENGINE_OPS
+#error "engine plugins are built with benchtool_engine(), which defines BENCHTOOL_ENGINE_OPS"
+#endif
+#ifndef BENCHTOOL_ENGINE_VERSION
+#define BENCHTOOL_ENGINE_VERSION "unknown"
+#endif
+
+#define PLUGIN_STR(x)  #x
+#define PLUGIN_NAME(x) PLUGIN_STR(x)
+
+extern const storage_engine_ops_t *BENCHTOOL_ENGINE_OPS(void);
+
+const engine_plugin_info_t *benchtool_engine_plugin(void)
+{
+    static const engine_plugin_info_t info = {
+        .abi = BENCHTOOL_ENGINE_ABI,
+        .config_size = sizeof(benchmark_config_t),
+        .ops_size = sizeof(storage_engine_ops_t),
+        .ops_symbol = PLUGIN_NAME(BENCHTOOL_ENGINE_OPS),
+        .version = BENCHTOOL_ENGINE_VERSION,
+    };
+    return &info;
+}
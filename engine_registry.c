@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <dlfcn.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "benchmark.h"
@@ -21,8 +23,113 @@ extern const storage_engine_ops_t *get_tidesdb_ops(void);
 extern const storage_engine_ops_t *get_rocksdb_ops(void);
 extern const storage_engine_ops_t *get_lmdb_ops(void);
 
+/* a loaded --engine-plugin, the handle stays open for the life of the process */
+typedef struct
+{
+    char name[64];
+    char version[64];
+    void *handle;
+    const storage_engine_ops_t *ops;
+} engine_plugin_t;
+
+static engine_plugin_t plugins[MAX_ENGINE_PLUGINS];
+static int num_plugins = 0;
+
+static const engine_plugin_t *find_plugin(const char *engine_name)
+{
+    for (int i = 0; i < num_plugins; i++)
+    {
+        if (strcmp(plugins[i].name, engine_name) == 0) return &plugins[i];
+    }
+    return NULL;
+}
+
+int engine_plugin_load(const char *spec)
+{
+    const char *eq = strchr(spec, '=');
+    size_t name_len = eq ? (size_t)(eq - spec) : 0;
+    if (name_len == 0 || name_len >= sizeof(plugins[0].name) || !eq[1])
+    {
+        fprintf(stderr, "Error: --engine-plugin takes <name>=<path>, got %s\n", spec);
+        return -1;
+    }
+    if (num_plugins == MAX_ENGINE_PLUGINS)
+    {
+        fprintf(stderr, "Error: at most %d engine plugins\n", MAX_ENGINE_PLUGINS);
+        return -1;
+    }
+
+    engine_plugin_t *p = &plugins[num_plugins];
+    memcpy(p->name, spec, name_len);
+    p->name[name_len] = '\0';
+    const char *path = eq + 1;
+    if (get_engine_ops(p->name))
+    {
+        fprintf(stderr, "Error: engine %s already exists, give the plugin another name\n",
+                p->name);
+        return -1;
+    }
+
+    /* RTLD_LOCAL keeps the plugin's symbols out of the global scope, so a second build of the same
+     * engine resolves to its own code instead of the first one loaded */
+    p->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!p->handle)
+    {
+        fprintf(stderr, "Error: cannot load engine plugin %s: %s\n", path, dlerror());
+        return -1;
+    }
+
+    const engine_plugin_info_t *(*describe)(void) = NULL;
+    *(void **)&describe = dlsym(p->handle, "benchtool_engine_plugin");
+    const engine_plugin_info_t *info = describe ? describe() : NULL;
+    if (!info)
+    {
+        fprintf(stderr, "Error: %s is not a benchtool engine plugin (see benchtool_engine())\n",
+                path);
+        dlclose(p->handle);
+        return -1;
+    }
+    if (info->abi != BENCHTOOL_ENGINE_ABI || info->config_size != sizeof(benchmark_config_t) ||
+        info->ops_size != sizeof(storage_engine_ops_t))
+    {
+        fprintf(stderr,
+                "Error: engine plugin %s was built against another benchtool (abi %d, config %zu "
+                "bytes, ops %zu bytes; this build has abi %d, %zu and %zu), rebuild it\n",
+                path, info->abi, info->config_size, info->ops_size, BENCHTOOL_ENGINE_ABI,
+                sizeof(benchmark_config_t), sizeof(storage_engine_ops_t));
+        dlclose(p->handle);
+        return -1;
+    }
+
+    const storage_engine_ops_t *(*get_ops)(void) = NULL;
+    *(void **)&get_ops = dlsym(p->handle, info->ops_symbol);
+    p->ops = get_ops ? get_ops() : NULL;
+    if (!p->ops)
+    {
+        fprintf(stderr, "Error: engine plugin %s has no engine behind %s\n", path,
+                info->ops_symbol);
+        dlclose(p->handle);
+        return -1;
+    }
+    snprintf(p->version, sizeof(p->version), "%s", info->version ? info->version : "unknown");
+    num_plugins++;
+    return 0;
+}
+
+const char *engine_plugin_version(const char *engine_name)
+{
+    const engine_plugin_t *p = find_plugin(engine_name);
+    return p ? p->version : NULL;
+}
+
 const storage_engine_ops_t *get_engine_ops(const char *engine_name)
 {
+    const engine_plugin_t *plugin = find_plugin(engine_name);
+    if (plugin)
+    {
+        return plugin->ops;
+    }
+
     if (strcmp(engine_name, "tidesdb") == 0)
     {
         return get_tidesdb_ops();
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "benchmark.h"
 
@@ -36,7 +38,7 @@
 const char *rocksdb_version_str =
     TOSTRING(ROCKSDB_MAJOR) "." TOSTRING(ROCKSDB_MINOR) "." TOSTRING(ROCKSDB_PATCH);
 
-typedef struct
+typedef struct rocksdb_handle_t
 {
     rocksdb_t *db;
     rocksdb_options_t *options;
@@ -45,6 +47,14 @@ typedef struct
     rocksdb_cache_t *cache;
     rocksdb_block_based_table_options_t *table_options;
     rocksdb_filterpolicy_t *filter_policy;
+    char *path;
+    rocksdb_column_family_handle_t *cf;   /* family the ops act on */
+    int cf_id;                            /* 0 for the default family, i + 1 for cf_i */
+    rocksdb_column_family_handle_t **cfs; /* every family of the db, the default one first */
+    int num_cfs;
+    struct rocksdb_handle_t *cf_handles; /* --column-families, one copy per cf_i */
+    storage_engine_t *cf_views;          /* engines over cf_handles */
+    int num_cf_views;
 } rocksdb_handle_t;
 
 typedef struct
@@ -53,15 +63,136 @@ typedef struct
     rocksdb_handle_t *handle;
 } rocksdb_batch_context_t;
 
+/* a bulk load rolls over to a new external sst file at this size, like a compaction output */
+#define ROCKSDB_BULK_FILE_SIZE (64 * 1024 * 1024)
+#define ROCKSDB_BULK_MAX_FILES 4096
+
+typedef struct
+{
+    rocksdb_handle_t *handle;
+    rocksdb_envoptions_t *env_options;
+    rocksdb_sstfilewriter_t *writer;
+    int writer_open; /* the writer has a file that is not finished yet */
+    int num_files;
+    char *files[ROCKSDB_BULK_MAX_FILES];
+} rocksdb_bulk_context_t;
+
+/* lookups queued by queue_get are read by one async_io multi_get at reap time, the reads of
+ * the batch are issued in parallel (io_uring where the build has it) from the calling thread */
+typedef struct
+{
+    rocksdb_handle_t *handle;
+    rocksdb_readoptions_t *roptions;
+    int depth;
+    int pending;
+    char **keys; /* per slot key buffers, reused */
+    size_t *key_caps;
+    size_t *key_sizes;
+    uint64_t *tags;
+    char **values;
+    size_t *value_sizes;
+    char **errs;
+    const rocksdb_column_family_handle_t **cfs; /* the handle's family for every slot */
+} rocksdb_queue_t;
+
 static const storage_engine_ops_t rocksdb_ops;
 
+#define ROCKSDB_CF_NAME_SIZE 32
+
+/* we open the default family, cf_0 .. cf_{wanted-1} when --column-families asks for more than
+ * one, and every other family the database already has, rocksdb refuses to open a database with
+ * a family left out. the handle gets a copy per cf_i pointing at that family */
+static rocksdb_t *rocksdb_open_families(rocksdb_handle_t *handle, const char *path, int wanted,
+                                        char **err)
+{
+    if (wanted < 2) wanted = 0;
+
+    size_t existing = 0;
+    char *list_err = NULL;
+    char **names = rocksdb_list_column_families(handle->options, path, &existing, &list_err);
+    free(list_err); /* a new database has no family list yet */
+    if (!names) existing = 0;
+
+    size_t cap = 1 + (size_t)wanted + existing;
+    const char **all = calloc(cap, sizeof(char *));
+    const rocksdb_options_t **all_options = calloc(cap, sizeof(rocksdb_options_t *));
+    char(*own)[ROCKSDB_CF_NAME_SIZE] = calloc((size_t)wanted + 1, ROCKSDB_CF_NAME_SIZE);
+    handle->cfs = calloc(cap, sizeof(rocksdb_column_family_handle_t *));
+    handle->cf_handles = wanted ? calloc((size_t)wanted, sizeof(rocksdb_handle_t)) : NULL;
+    handle->cf_views = wanted ? calloc((size_t)wanted, sizeof(storage_engine_t)) : NULL;
+
+    rocksdb_t *db = NULL;
+    int views_ok = !wanted || (handle->cf_handles && handle->cf_views);
+    if (all && all_options && own && handle->cfs && views_ok)
+    {
+        int n = 0;
+        all[n++] = "default";
+        for (int i = 0; i < wanted; i++)
+        {
+            snprintf(own[i], ROCKSDB_CF_NAME_SIZE, "cf_%d", i);
+            all[n++] = own[i];
+        }
+        for (size_t i = 0; i < existing; i++)
+        {
+            int known = 0;
+            for (int j = 0; j < n && !known; j++) known = strcmp(all[j], names[i]) == 0;
+            if (!known) all[n++] = names[i];
+        }
+        for (int i = 0; i < n; i++) all_options[i] = handle->options;
+
+        rocksdb_options_set_create_missing_column_families(handle->options, 1);
+        db = rocksdb_open_column_families(handle->options, path, n, all, all_options,
+                                          handle->cfs, err);
+        if (db) handle->num_cfs = n;
+    }
+    else
+    {
+        *err = strdup("out of memory");
+    }
+
+    if (names) rocksdb_list_column_families_destroy(names, existing);
+    free(all);
+    free(all_options);
+    free(own);
+    if (!db) return NULL;
+
+    handle->db = db;
+    handle->cf = handle->cfs[0];
+    handle->cf_id = 0;
+    for (int i = 0; i < wanted; i++)
+    {
+        rocksdb_handle_t *view = &handle->cf_handles[i];
+        *view = *handle;
+        view->cf = handle->cfs[1 + i];
+        view->cf_id = 1 + i;
+        view->cf_handles = NULL;
+        view->cf_views = NULL;
+        view->num_cf_views = 0;
+        handle->cf_views[i].ops = &rocksdb_ops;
+        handle->cf_views[i].handle = view;
+    }
+    handle->num_cf_views = wanted;
+    return db;
+}
+
+static void rocksdb_free_families(rocksdb_handle_t *handle)
+{
+    for (int i = 0; i < handle->num_cfs; i++)
+    {
+        rocksdb_column_family_handle_destroy(handle->cfs[i]);
+    }
+    free(handle->cfs);
+    free(handle->cf_handles);
+    free(handle->cf_views);
+}
+
 static int rocksdb_open_impl(storage_engine_t **engine, const char *path,
                              const benchmark_config_t *config)
 {
     *engine = malloc(sizeof(storage_engine_t));
     if (!*engine) return -1;
 
-    rocksdb_handle_t *handle = malloc(sizeof(rocksdb_handle_t));
+    rocksdb_handle_t *handle = calloc(1, sizeof(rocksdb_handle_t));
     if (!handle)
     {
         free(*engine);
@@ -137,17 +268,33 @@ static int rocksdb_open_impl(storage_engine_t **engine, const char *path,
         rocksdb_options_set_blob_gc_age_cutoff(handle->options, 0.25); /* GC blobs older than 25% */
     }
 
+    /* the statistics object feeds the stall, flush, compaction, cache and bloom counters of
+     * get_stats, it is not free so it stays off unless asked for */
+    if (config->engine_stats)
+    {
+        rocksdb_options_enable_statistics(handle->options);
+    }
+
     handle->roptions = rocksdb_readoptions_create();
     handle->woptions = rocksdb_writeoptions_create();
 
     /* sync mode will be set based on benchmark config */
     rocksdb_writeoptions_set_sync(handle->woptions, 0);
 
+    /* set before the family views copy the handle, their bulk loads write sst files under it.
+     * the views share the string, only the base handle frees it */
+    handle->path = strdup(path);
+
     char *err = NULL;
-    handle->db = rocksdb_open(handle->options, path, &err);
-    if (err)
+    handle->db = rocksdb_open_families(handle, path, config->num_column_families, &err);
+    if (err || !handle->db)
     {
+        if (err) fprintf(stderr, "RocksDB open failed: %s\n", err);
         free(err);
+        free(handle->path);
+        free(handle->cfs);
+        free(handle->cf_handles);
+        free(handle->cf_views);
         rocksdb_options_destroy(handle->options);
         rocksdb_readoptions_destroy(handle->roptions);
         rocksdb_writeoptions_destroy(handle->woptions);
@@ -164,12 +311,15 @@ static int rocksdb_open_impl(storage_engine_t **engine, const char *path,
 static int rocksdb_close_impl(storage_engine_t *engine)
 {
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    /* family handles have to go before the db they belong to */
+    rocksdb_free_families(handle);
     rocksdb_close(handle->db);
     rocksdb_options_destroy(handle->options);
     rocksdb_readoptions_destroy(handle->roptions);
     rocksdb_writeoptions_destroy(handle->woptions);
     if (handle->table_options) rocksdb_block_based_options_destroy(handle->table_options);
     if (handle->cache) rocksdb_cache_destroy(handle->cache);
+    free(handle->path);
     free(handle);
     free(engine);
     return 0;
@@ -188,8 +338,8 @@ static int rocksdb_put_impl(storage_engine_t *engine, const uint8_t *key, size_t
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
     char *err = NULL;
 
-    rocksdb_put(handle->db, handle->woptions, (const char *)key, key_size, (const char *)value,
-                value_size, &err);
+    rocksdb_put_cf(handle->db, handle->woptions, handle->cf, (const char *)key, key_size,
+                   (const char *)value, value_size, &err);
 
     if (err)
     {
@@ -205,8 +355,8 @@ static int rocksdb_get_impl(storage_engine_t *engine, const uint8_t *key, size_t
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
     char *err = NULL;
 
-    char *val =
-        rocksdb_get(handle->db, handle->roptions, (const char *)key, key_size, value_size, &err);
+    char *val = rocksdb_get_cf(handle->db, handle->roptions, handle->cf, (const char *)key,
+                               key_size, value_size, &err);
 
     if (err)
     {
@@ -220,12 +370,83 @@ static int rocksdb_get_impl(storage_engine_t *engine, const uint8_t *key, size_t
     return 0;
 }
 
+static int rocksdb_get_pinned_impl(storage_engine_t *engine, const uint8_t *key, size_t key_size,
+                                   const uint8_t **value, size_t *value_size, void **pin)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    char *err = NULL;
+
+    /* the PinnableSlice references the block cache or memtable directly, no copy */
+    rocksdb_pinnableslice_t *slice = rocksdb_get_pinned_cf(handle->db, handle->roptions,
+                                                           handle->cf, (const char *)key,
+                                                           key_size, &err);
+
+    if (err)
+    {
+        free(err);
+        return -1;
+    }
+
+    if (!slice) return -1;
+
+    *value = (const uint8_t *)rocksdb_pinnableslice_value(slice, value_size);
+    *pin = slice;
+    return 0;
+}
+
+static void rocksdb_release_pinned_impl(storage_engine_t *engine, void *pin)
+{
+    (void)engine;
+    rocksdb_pinnableslice_destroy((rocksdb_pinnableslice_t *)pin);
+}
+
+static int rocksdb_multi_get_impl(storage_engine_t *engine, size_t num_keys,
+                                  const uint8_t *const *keys, const size_t *key_sizes,
+                                  uint8_t **values, size_t *value_sizes)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    char **errs = calloc(num_keys, sizeof(char *));
+    const rocksdb_column_family_handle_t **cfs = malloc(num_keys * sizeof(*cfs));
+    if (!errs || !cfs)
+    {
+        free(errs);
+        free(cfs);
+        return -1;
+    }
+    for (size_t i = 0; i < num_keys; i++) cfs[i] = handle->cf;
+
+    /* MultiGet coalesces the block lookups of the batch (and reads them in parallel when the
+     * build has async_io), which is what a fan-out serving request would use */
+    rocksdb_multi_get_cf(handle->db, handle->roptions, cfs, num_keys, (const char *const *)keys,
+                         key_sizes, (char **)values, value_sizes, errs);
+    free(cfs);
+
+    int found = 0;
+    for (size_t i = 0; i < num_keys; i++)
+    {
+        if (errs[i])
+        {
+            free(errs[i]);
+            free(values[i]);
+            values[i] = NULL;
+            value_sizes[i] = 0;
+        }
+        else if (values[i])
+        {
+            found++;
+        }
+    }
+
+    free(errs);
+    return found;
+}
+
 static int rocksdb_del_impl(storage_engine_t *engine, const uint8_t *key, size_t key_size)
 {
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
     char *err = NULL;
 
-    rocksdb_delete(handle->db, handle->woptions, (const char *)key, key_size, &err);
+    rocksdb_delete_cf(handle->db, handle->woptions, handle->cf, (const char *)key, key_size, &err);
 
     if (err)
     {
@@ -235,6 +456,14 @@ static int rocksdb_del_impl(storage_engine_t *engine, const uint8_t *key, size_t
     return 0;
 }
 
+/* a full-range manual compaction, it flushes the memtable first and blocks until done */
+static int rocksdb_compact_impl(storage_engine_t *engine)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    rocksdb_compact_range_cf(handle->db, handle->cf, NULL, 0, NULL, 0);
+    return 0;
+}
+
 static int rocksdb_batch_begin_impl(storage_engine_t *engine, void **batch_ctx)
 {
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
@@ -259,8 +488,8 @@ static int rocksdb_batch_put_impl(void *batch_ctx, storage_engine_t *engine, con
 {
     (void)engine; /* unused - we have it in ctx */
     rocksdb_batch_context_t *ctx = (rocksdb_batch_context_t *)batch_ctx;
-    rocksdb_writebatch_put(ctx->batch, (const char *)key, key_size, (const char *)value,
-                           value_size);
+    rocksdb_writebatch_put_cf(ctx->batch, ctx->handle->cf, (const char *)key, key_size,
+                              (const char *)value, value_size);
     return 0;
 }
 
@@ -269,7 +498,7 @@ static int rocksdb_batch_delete_impl(void *batch_ctx, storage_engine_t *engine,
 {
     (void)engine; /* unused - we have it in ctx */
     rocksdb_batch_context_t *ctx = (rocksdb_batch_context_t *)batch_ctx;
-    rocksdb_writebatch_delete(ctx->batch, (const char *)key, key_size);
+    rocksdb_writebatch_delete_cf(ctx->batch, ctx->handle->cf, (const char *)key, key_size);
     return 0;
 }
 
@@ -291,51 +520,553 @@ static int rocksdb_batch_commit_impl(void *batch_ctx)
     return 0;
 }
 
-static int rocksdb_iter_new_impl(storage_engine_t *engine, void **iter)
+static void rocksdb_bulk_free(rocksdb_bulk_context_t *ctx)
+{
+    for (int i = 0; i < ctx->num_files; i++)
+    {
+        /* ingest moved the file into the db, the name we wrote it under is only a link now */
+        unlink(ctx->files[i]);
+        free(ctx->files[i]);
+    }
+    rocksdb_sstfilewriter_destroy(ctx->writer);
+    rocksdb_envoptions_destroy(ctx->env_options);
+    free(ctx);
+}
+
+static int rocksdb_bulk_begin_impl(storage_engine_t *engine, void **bulk_ctx)
 {
     rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
-    *iter = rocksdb_create_iterator(handle->db, handle->roptions);
-    return *iter ? 0 : -1;
+    if (!handle->path) return -1;
+
+    rocksdb_bulk_context_t *ctx = calloc(1, sizeof(rocksdb_bulk_context_t));
+    if (!ctx) return -1;
+
+    /* the writer takes the db options, its files use the same table format and compression */
+    ctx->env_options = rocksdb_envoptions_create();
+    ctx->writer = rocksdb_sstfilewriter_create(ctx->env_options, handle->options);
+    ctx->handle = handle;
+    *bulk_ctx = ctx;
+    return 0;
+}
+
+/* we finish the open external file, it is ingested with the others at bulk_finish */
+static int rocksdb_bulk_close_file(rocksdb_bulk_context_t *ctx)
+{
+    char *err = NULL;
+    ctx->writer_open = 0;
+    rocksdb_sstfilewriter_finish(ctx->writer, &err);
+    if (err)
+    {
+        free(err);
+        return -1;
+    }
+    return 0;
+}
+
+static int rocksdb_bulk_add_impl(void *bulk_ctx, const uint8_t *key, size_t key_size,
+                                 const uint8_t *value, size_t value_size)
+{
+    rocksdb_bulk_context_t *ctx = (rocksdb_bulk_context_t *)bulk_ctx;
+    char *err = NULL;
+
+    if (!ctx->writer_open)
+    {
+        if (ctx->num_files == ROCKSDB_BULK_MAX_FILES) return -1;
+
+        char file[1024];
+        snprintf(file, sizeof(file), "%s/bulk_%d_%06d.sst", ctx->handle->path, ctx->handle->cf_id,
+                 ctx->num_files);
+        rocksdb_sstfilewriter_open(ctx->writer, file, &err);
+        if (err)
+        {
+            free(err);
+            return -1;
+        }
+        ctx->files[ctx->num_files++] = strdup(file);
+        ctx->writer_open = 1;
+    }
+
+    rocksdb_sstfilewriter_put(ctx->writer, (const char *)key, key_size, (const char *)value,
+                              value_size, &err);
+    if (err)
+    {
+        free(err);
+        return -1;
+    }
+
+    uint64_t file_size = 0;
+    rocksdb_sstfilewriter_file_size(ctx->writer, &file_size);
+    if (file_size >= ROCKSDB_BULK_FILE_SIZE) return rocksdb_bulk_close_file(ctx);
+    return 0;
+}
+
+/* the written files are unlinked without an ingest */
+static void rocksdb_bulk_abort_impl(void *bulk_ctx)
+{
+    rocksdb_bulk_free((rocksdb_bulk_context_t *)bulk_ctx);
+}
+
+static int rocksdb_bulk_finish_impl(void *bulk_ctx)
+{
+    rocksdb_bulk_context_t *ctx = (rocksdb_bulk_context_t *)bulk_ctx;
+    int rc = 0;
+
+    if (ctx->writer_open) rc = rocksdb_bulk_close_file(ctx);
+
+    if (rc == 0 && ctx->num_files > 0)
+    {
+        /* the files do not overlap, they are moved (hard linked) straight into the bottom level */
+        rocksdb_ingestexternalfileoptions_t *ingest_options =
+            rocksdb_ingestexternalfileoptions_create();
+        rocksdb_ingestexternalfileoptions_set_move_files(ingest_options, 1);
+
+        char *err = NULL;
+        rocksdb_ingest_external_file_cf(ctx->handle->db, ctx->handle->cf,
+                                        (const char *const *)ctx->files, (size_t)ctx->num_files,
+                                        ingest_options, &err);
+        rocksdb_ingestexternalfileoptions_destroy(ingest_options);
+        if (err)
+        {
+            free(err);
+            rc = -1;
+        }
+    }
+
+    rocksdb_bulk_free(ctx);
+    return rc;
+}
+
+static void rocksdb_queue_close_impl(void *queue)
+{
+    rocksdb_queue_t *q = (rocksdb_queue_t *)queue;
+    if (q->keys)
+    {
+        for (int i = 0; i < q->depth; i++) free(q->keys[i]);
+    }
+    if (q->roptions) rocksdb_readoptions_destroy(q->roptions);
+    free(q->keys);
+    free(q->key_caps);
+    free(q->key_sizes);
+    free(q->tags);
+    free(q->values);
+    free(q->value_sizes);
+    free(q->errs);
+    free(q->cfs);
+    free(q);
+}
+
+static int rocksdb_queue_open_impl(storage_engine_t *engine, int depth, void **queue)
+{
+    rocksdb_queue_t *q = calloc(1, sizeof(rocksdb_queue_t));
+    if (!q) return -1;
+
+    q->handle = (rocksdb_handle_t *)engine->handle;
+    q->depth = depth;
+    q->keys = calloc((size_t)depth, sizeof(char *));
+    q->key_caps = calloc((size_t)depth, sizeof(size_t));
+    q->key_sizes = calloc((size_t)depth, sizeof(size_t));
+    q->tags = calloc((size_t)depth, sizeof(uint64_t));
+    q->values = calloc((size_t)depth, sizeof(char *));
+    q->value_sizes = calloc((size_t)depth, sizeof(size_t));
+    q->errs = calloc((size_t)depth, sizeof(char *));
+    q->cfs = calloc((size_t)depth, sizeof(*q->cfs));
+    if (!q->keys || !q->key_caps || !q->key_sizes || !q->tags || !q->values || !q->value_sizes ||
+        !q->errs || !q->cfs)
+    {
+        rocksdb_queue_close_impl(q);
+        return -1;
+    }
+    for (int i = 0; i < depth; i++) q->cfs[i] = q->handle->cf;
+
+    q->roptions = rocksdb_readoptions_create();
+    rocksdb_readoptions_set_async_io(q->roptions, 1);
+    *queue = q;
+    return 0;
+}
+
+static int rocksdb_queue_get_impl(void *queue, const uint8_t *key, size_t key_size, uint64_t tag)
+{
+    rocksdb_queue_t *q = (rocksdb_queue_t *)queue;
+    int slot = q->pending;
+    if (slot == q->depth) return -1;
+
+    if (key_size > q->key_caps[slot])
+    {
+        char *buf = realloc(q->keys[slot], key_size);
+        if (!buf) return -1;
+        q->keys[slot] = buf;
+        q->key_caps[slot] = key_size;
+    }
+    memcpy(q->keys[slot], key, key_size);
+    q->key_sizes[slot] = key_size;
+    q->tags[slot] = tag;
+    q->pending++;
+    return 0;
+}
+
+static int rocksdb_queue_reap_impl(void *queue, engine_completion_t *done, int max)
+{
+    rocksdb_queue_t *q = (rocksdb_queue_t *)queue;
+    int n = q->pending < max ? q->pending : max;
+    if (n <= 0) return 0;
+
+    rocksdb_multi_get_cf(q->handle->db, q->roptions, q->cfs, (size_t)n,
+                         (const char *const *)q->keys, q->key_sizes, q->values, q->value_sizes,
+                         q->errs);
+
+    for (int i = 0; i < n; i++)
+    {
+        done[i].tag = q->tags[i];
+        done[i].status = !q->errs[i] && q->values[i] ? 0 : -1;
+        free(q->errs[i]);
+        free(q->values[i]);
+        q->errs[i] = NULL;
+        q->values[i] = NULL;
+    }
+
+    /* lookups beyond max stay queued, their slots move to the front keeping the buffers */
+    for (int i = n; i < q->pending; i++)
+    {
+        char *key = q->keys[i - n];
+        size_t cap = q->key_caps[i - n];
+        q->keys[i - n] = q->keys[i];
+        q->key_caps[i - n] = q->key_caps[i];
+        q->key_sizes[i - n] = q->key_sizes[i];
+        q->tags[i - n] = q->tags[i];
+        q->keys[i] = key;
+        q->key_caps[i] = cap;
+    }
+    q->pending -= n;
+    return n;
+}
+
+/* rocksdb reads the bounds of an iterator through the slices of the read options it was created
+ * with at every seek and step, so a bounded iterator keeps its own options and the next bounds
+ * are set on them in place before the seek, the way long-lived server scans reuse an iterator.
+ * an iterator created without bounds never checks any, switching between a bounded and a plain
+ * seek recreates it */
+typedef struct
+{
+    rocksdb_iterator_t *it; /* NULL until the first seek after a switch */
+    rocksdb_handle_t *handle;
+    rocksdb_readoptions_t *roptions; /* the iterator's own options, NULL = the handle's */
+    size_t readahead;                /* iter_new_opts hint, 0 = rocksdb default */
+    int bounded;                     /* it checks the bounds below */
+    char *lower;
+    size_t lower_size, lower_cap;
+    char *upper;
+    size_t upper_size, upper_cap;
+} rocksdb_iter_t;
+
+static int rocksdb_iter_new_opts_impl(storage_engine_t *engine, size_t readahead, void **iter)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    rocksdb_iter_t *w = calloc(1, sizeof(rocksdb_iter_t));
+    if (!w) return -1;
+    w->handle = handle;
+    w->readahead = readahead;
+    if (readahead > 0)
+    {
+        w->roptions = rocksdb_readoptions_create();
+        rocksdb_readoptions_set_readahead_size(w->roptions, readahead);
+    }
+    w->it = rocksdb_create_iterator_cf(handle->db, w->roptions ? w->roptions : handle->roptions,
+                                       handle->cf);
+    if (!w->it)
+    {
+        if (w->roptions) rocksdb_readoptions_destroy(w->roptions);
+        free(w);
+        return -1;
+    }
+    *iter = w;
+    return 0;
+}
+
+static int rocksdb_iter_new_impl(storage_engine_t *engine, void **iter)
+{
+    return rocksdb_iter_new_opts_impl(engine, 0, iter);
+}
+
+/* we recreate the iterator when a seek changes between bounded and plain */
+static int rocksdb_iter_mode(rocksdb_iter_t *w, int bounded)
+{
+    if (w->it && w->bounded == bounded) return 0;
+    if (w->it) rocksdb_iter_destroy(w->it);
+    w->it = NULL;
+    w->bounded = bounded;
+
+    if (bounded && !w->roptions)
+    {
+        w->roptions = rocksdb_readoptions_create();
+        if (w->readahead > 0) rocksdb_readoptions_set_readahead_size(w->roptions, w->readahead);
+    }
+    if (w->roptions)
+    {
+        rocksdb_readoptions_set_iterate_lower_bound(w->roptions, bounded ? w->lower : NULL,
+                                                    bounded ? w->lower_size : 0);
+        rocksdb_readoptions_set_iterate_upper_bound(w->roptions, bounded ? w->upper : NULL,
+                                                    bounded ? w->upper_size : 0);
+    }
+    w->it = rocksdb_create_iterator_cf(w->handle->db,
+                                       w->roptions ? w->roptions : w->handle->roptions,
+                                       w->handle->cf);
+    return w->it ? 0 : -1;
+}
+
+/* a bound buffer grows to the largest key it was given, the options point into it */
+static int rocksdb_iter_bound(char **buf, size_t *size, size_t *cap, const uint8_t *key,
+                              size_t key_size)
+{
+    if (key_size > *cap)
+    {
+        char *grown = realloc(*buf, key_size);
+        if (!grown) return -1;
+        *buf = grown;
+        *cap = key_size;
+    }
+    if (key_size > 0) memcpy(*buf, key, key_size);
+    *size = key_size;
+    return 0;
 }
 
 static int rocksdb_iter_seek_to_first_impl(void *iter)
 {
-    rocksdb_iter_seek_to_first((rocksdb_iterator_t *)iter);
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    if (rocksdb_iter_mode(w, 0) != 0) return -1;
+    rocksdb_iter_seek_to_first(w->it);
     return 0;
 }
 
 static int rocksdb_iter_seek_impl(void *iter, const uint8_t *key, size_t key_size)
 {
-    rocksdb_iter_seek((rocksdb_iterator_t *)iter, (const char *)key, key_size);
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    if (rocksdb_iter_mode(w, 0) != 0) return -1;
+    rocksdb_iter_seek(w->it, (const char *)key, key_size);
+    return 0;
+}
+
+static int rocksdb_iter_seek_for_prev_impl(void *iter, const uint8_t *key, size_t key_size)
+{
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    if (rocksdb_iter_mode(w, 0) != 0) return -1;
+    rocksdb_iter_seek_for_prev(w->it, (const char *)key, key_size);
+    return 0;
+}
+
+/* iterate_lower_bound and iterate_upper_bound, a reverse scan starts below upper */
+static int rocksdb_iter_seek_bounded_impl(void *iter, const uint8_t *lower, size_t lower_size,
+                                          const uint8_t *upper, size_t upper_size, int reverse)
+{
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    if (!lower || !upper) return -1;
+    if (rocksdb_iter_bound(&w->lower, &w->lower_size, &w->lower_cap, lower, lower_size) != 0 ||
+        rocksdb_iter_bound(&w->upper, &w->upper_size, &w->upper_cap, upper, upper_size) != 0)
+    {
+        return -1;
+    }
+    if (w->it && w->bounded)
+    {
+        rocksdb_readoptions_set_iterate_lower_bound(w->roptions, w->lower, w->lower_size);
+        rocksdb_readoptions_set_iterate_upper_bound(w->roptions, w->upper, w->upper_size);
+    }
+    else if (rocksdb_iter_mode(w, 1) != 0)
+    {
+        return -1;
+    }
+
+    if (reverse)
+        rocksdb_iter_seek_for_prev(w->it, w->upper, w->upper_size);
+    else
+        rocksdb_iter_seek(w->it, w->lower, w->lower_size);
     return 0;
 }
 
 static int rocksdb_iter_valid_impl(void *iter)
 {
-    return rocksdb_iter_valid((rocksdb_iterator_t *)iter) ? 1 : 0;
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    return w->it && rocksdb_iter_valid(w->it) ? 1 : 0;
 }
 
 static int rocksdb_iter_next_impl(void *iter)
 {
-    rocksdb_iter_next((rocksdb_iterator_t *)iter);
+    rocksdb_iter_next(((rocksdb_iter_t *)iter)->it);
+    return 0;
+}
+
+static int rocksdb_iter_prev_impl(void *iter)
+{
+    rocksdb_iter_prev(((rocksdb_iter_t *)iter)->it);
     return 0;
 }
 
 static int rocksdb_iter_key_impl(void *iter, uint8_t **key, size_t *key_size)
 {
-    *key = (uint8_t *)rocksdb_iter_key((rocksdb_iterator_t *)iter, key_size);
+    *key = (uint8_t *)rocksdb_iter_key(((rocksdb_iter_t *)iter)->it, key_size);
     return 0;
 }
 
 static int rocksdb_iter_value_impl(void *iter, uint8_t **value, size_t *value_size)
 {
-    *value = (uint8_t *)rocksdb_iter_value((rocksdb_iterator_t *)iter, value_size);
+    *value = (uint8_t *)rocksdb_iter_value(((rocksdb_iter_t *)iter)->it, value_size);
+    return 0;
+}
+
+static int rocksdb_iter_entry_impl(void *iter, uint8_t **key, size_t *key_size, uint8_t **value,
+                                   size_t *value_size)
+{
+    rocksdb_iterator_t *it = ((rocksdb_iter_t *)iter)->it;
+    *key = (uint8_t *)rocksdb_iter_key(it, key_size);
+    *value = (uint8_t *)rocksdb_iter_value(it, value_size);
     return 0;
 }
 
 static int rocksdb_iter_free_impl(void *iter)
 {
-    rocksdb_iter_destroy((rocksdb_iterator_t *)iter);
+    rocksdb_iter_t *w = (rocksdb_iter_t *)iter;
+    if (w->it) rocksdb_iter_destroy(w->it);
+    if (w->roptions) rocksdb_readoptions_destroy(w->roptions);
+    free(w->lower);
+    free(w->upper);
+    free(w);
+    return 0;
+}
+
+static int64_t rocksdb_int_property(rocksdb_handle_t *handle, const char *name)
+{
+    uint64_t value = 0;
+    if (rocksdb_property_int_cf(handle->db, handle->cf, name, &value) != 0) return -1;
+    return (int64_t)value;
+}
+
+/* a ticker from the statistics dump, one "<name> COUNT : <n>" line per ticker */
+static int64_t rocksdb_ticker(const char *dump, const char *name)
+{
+    char pattern[128];
+    snprintf(pattern, sizeof(pattern), "%s COUNT : ", name);
+    const char *at = strstr(dump, pattern);
+    if (!at) return -1;
+    return strtoll(at + strlen(pattern), NULL, 10);
+}
+
+static int rocksdb_get_stats_impl(storage_engine_t *engine, engine_stats_t *stats)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+
+    stats->pending_compaction_bytes =
+        rocksdb_int_property(handle, "rocksdb.estimate-pending-compaction-bytes");
+    stats->immutable_memtables = rocksdb_int_property(handle, "rocksdb.num-immutable-mem-table");
+    stats->memtable_bytes = rocksdb_int_property(handle, "rocksdb.cur-size-all-mem-tables");
+    stats->live_data_bytes = rocksdb_int_property(handle, "rocksdb.live-sst-files-size");
+    stats->num_keys = rocksdb_int_property(handle, "rocksdb.estimate-num-keys");
+    if (handle->cache) stats->block_cache_bytes = (int64_t)rocksdb_cache_get_usage(handle->cache);
+
+    /* per level file counts are string properties */
+    int64_t files = 0;
+    for (int level = 0; level < 7; level++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "rocksdb.num-files-at-level%d", level);
+        char *value = rocksdb_property_value_cf(handle->db, handle->cf, name);
+        if (!value) break;
+        int64_t n = strtoll(value, NULL, 10);
+        rocksdb_free(value);
+        if (level == 0) stats->l0_files = n;
+        files += n;
+    }
+    if (stats->l0_files >= 0) stats->table_files = files;
+
+    /* NULL unless the options were opened with --engine-stats */
+    char *dump = rocksdb_options_statistics_get_string(handle->options);
+    if (dump)
+    {
+        stats->stall_us = rocksdb_ticker(dump, "rocksdb.stall.micros");
+        stats->flush_write_bytes = rocksdb_ticker(dump, "rocksdb.flush.write.bytes");
+        stats->compaction_read_bytes = rocksdb_ticker(dump, "rocksdb.compact.read.bytes");
+        stats->compaction_write_bytes = rocksdb_ticker(dump, "rocksdb.compact.write.bytes");
+        stats->block_cache_hits = rocksdb_ticker(dump, "rocksdb.block.cache.hit");
+        stats->block_cache_misses = rocksdb_ticker(dump, "rocksdb.block.cache.miss");
+        stats->bloom_useful = rocksdb_ticker(dump, "rocksdb.bloom.filter.useful");
+        rocksdb_free(dump);
+    }
+    return 0;
+}
+
+typedef struct
+{
+    const char *key;
+    size_t key_size;
+    size_t size;
+} rocksdb_file_ref_t;
+
+static int rocksdb_file_ref_cmp(const void *a, const void *b)
+{
+    const rocksdb_file_ref_t *x = (const rocksdb_file_ref_t *)a;
+    const rocksdb_file_ref_t *y = (const rocksdb_file_ref_t *)b;
+    size_t n = x->key_size < y->key_size ? x->key_size : y->key_size;
+    int c = memcmp(x->key, y->key, n);
+    if (c != 0) return c;
+    return x->key_size < y->key_size ? -1 : (x->key_size > y->key_size ? 1 : 0);
+}
+
+/* the live sst files sorted by their smallest key, a split goes at the file where the running
+ * file size crosses the next 1/parts of the total. files of different levels overlap, so the
+ * parts are only as even as the levels are alike */
+static int rocksdb_split_keys_impl(storage_engine_t *engine, int parts, uint8_t **keys,
+                                   size_t *key_sizes)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+
+    /* live files do not name their family in every release, we only split a single one */
+    if (handle->num_cfs > 1 || parts < 2) return -1;
+
+    const rocksdb_livefiles_t *lf = rocksdb_livefiles(handle->db);
+    if (!lf) return -1;
+    int n = rocksdb_livefiles_count(lf);
+    rocksdb_file_ref_t *files = n > 1 ? malloc((size_t)n * sizeof(rocksdb_file_ref_t)) : NULL;
+    if (!files)
+    {
+        rocksdb_livefiles_destroy(lf);
+        return -1;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < n; i++)
+    {
+        files[i].key = rocksdb_livefiles_smallestkey(lf, i, &files[i].key_size);
+        files[i].size = rocksdb_livefiles_size(lf, i);
+        total += files[i].size;
+    }
+    qsort(files, (size_t)n, sizeof(rocksdb_file_ref_t), rocksdb_file_ref_cmp);
+
+    int count = 0;
+    int next = 1; /* the next part boundary, at total * next / parts */
+    const rocksdb_file_ref_t *last = &files[0];
+    uint64_t run = files[0].size;
+    for (int i = 1; i < n && next < parts; i++)
+    {
+        if ((double)run >= (double)total * next / parts &&
+            rocksdb_file_ref_cmp(&files[i], last) != 0)
+        {
+            while (next < parts && (double)run >= (double)total * next / parts) next++;
+            last = &files[i];
+            keys[count] = malloc(files[i].key_size ? files[i].key_size : 1);
+            if (!keys[count]) break;
+            memcpy(keys[count], files[i].key, files[i].key_size);
+            key_sizes[count++] = files[i].key_size;
+        }
+        run += files[i].size;
+    }
+
+    free(files);
+    rocksdb_livefiles_destroy(lf);
+    return count > 0 ? count : -1;
+}
+
+static int rocksdb_column_family_impl(storage_engine_t *engine, int index, storage_engine_t **cf)
+{
+    rocksdb_handle_t *handle = (rocksdb_handle_t *)engine->handle;
+    if (index < 0 || index >= handle->num_cf_views) return -1;
+    *cf = &handle->cf_views[index];
     return 0;
 }
 
@@ -344,11 +1075,23 @@ static const storage_engine_ops_t rocksdb_ops = {
     .close = rocksdb_close_impl,
     .put = rocksdb_put_impl,
     .get = rocksdb_get_impl,
+    .get_pinned = rocksdb_get_pinned_impl,
+    .release_pinned = rocksdb_release_pinned_impl,
+    .multi_get = rocksdb_multi_get_impl,
     .del = rocksdb_del_impl,
+    .compact = rocksdb_compact_impl,
     .batch_begin = rocksdb_batch_begin_impl,
     .batch_put = rocksdb_batch_put_impl,
     .batch_delete = rocksdb_batch_delete_impl,
     .batch_commit = rocksdb_batch_commit_impl,
+    .bulk_begin = rocksdb_bulk_begin_impl,
+    .bulk_add = rocksdb_bulk_add_impl,
+    .bulk_finish = rocksdb_bulk_finish_impl,
+    .bulk_abort = rocksdb_bulk_abort_impl,
+    .queue_open = rocksdb_queue_open_impl,
+    .queue_get = rocksdb_queue_get_impl,
+    .queue_reap = rocksdb_queue_reap_impl,
+    .queue_close = rocksdb_queue_close_impl,
     .iter_new = rocksdb_iter_new_impl,
     .iter_seek_to_first = rocksdb_iter_seek_to_first_impl,
     .iter_seek = rocksdb_iter_seek_impl,
@@ -357,7 +1100,15 @@ static const storage_engine_ops_t rocksdb_ops = {
     .iter_key = rocksdb_iter_key_impl,
     .iter_value = rocksdb_iter_value_impl,
     .iter_free = rocksdb_iter_free_impl,
+    .iter_new_opts = rocksdb_iter_new_opts_impl,
+    .iter_seek_bounded = rocksdb_iter_seek_bounded_impl,
+    .iter_seek_for_prev = rocksdb_iter_seek_for_prev_impl,
+    .iter_prev = rocksdb_iter_prev_impl,
+    .iter_entry = rocksdb_iter_entry_impl,
     .set_sync = rocksdb_set_sync_mode,
+    .get_stats = rocksdb_get_stats_impl,
+    .column_family = rocksdb_column_family_impl,
+    .split_keys = rocksdb_split_keys_impl,
     .name = "RocksDB"};
 
 const storage_engine_ops_t *get_rocksdb_ops(void)
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 #include <tidesdb/objstore.h>
 #include <tidesdb/tidesdb.h>
 #ifdef BENCHTOOL_WITH_S3
@@ -25,7 +28,149 @@
 
 #include "benchmark.h"
 
+/* counting shim in front of the object store connector. every request is forwarded to the real
+ * connector after the configured delay, which lets the fs backend stand in for a remote store */
 typedef struct
+{
+    tidesdb_objstore_t *inner;
+    uint64_t latency_us;
+    atomic_uint_fast64_t gets;
+    atomic_uint_fast64_t range_gets;
+    atomic_uint_fast64_t bytes_fetched;
+    atomic_uint_fast64_t puts;
+    atomic_uint_fast64_t bytes_uploaded;
+    atomic_int_fast64_t uploads_in_flight;
+    atomic_int_fast64_t max_uploads_in_flight;
+} objstore_probe_t;
+
+/* remote fetches issued by the current thread, lets a worker tell a cache hit from a miss */
+static _Thread_local uint64_t probe_thread_fetches = 0;
+
+static void probe_delay(const objstore_probe_t *probe)
+{
+    if (probe->latency_us == 0) return;
+    struct timespec ts;
+    ts.tv_sec = (time_t)(probe->latency_us / 1000000);
+    ts.tv_nsec = (long)(probe->latency_us % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+}
+
+static uint64_t probe_file_size(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    return (uint64_t)st.st_size;
+}
+
+static int probe_put_file(void *ctx, const char *key, const char *local_path)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    int_fast64_t in_flight = atomic_fetch_add(&probe->uploads_in_flight, 1) + 1;
+    int_fast64_t max = atomic_load(&probe->max_uploads_in_flight);
+    while (in_flight > max &&
+           !atomic_compare_exchange_weak(&probe->max_uploads_in_flight, &max, in_flight))
+        ;
+
+    probe_delay(probe);
+    int rc = probe->inner->put_file(probe->inner->ctx, key, local_path);
+    if (rc == 0)
+    {
+        atomic_fetch_add(&probe->puts, 1);
+        atomic_fetch_add(&probe->bytes_uploaded, probe_file_size(local_path));
+    }
+    atomic_fetch_sub(&probe->uploads_in_flight, 1);
+    return rc;
+}
+
+static int probe_get_file(void *ctx, const char *key, const char *local_path)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    probe_delay(probe);
+    probe_thread_fetches++;
+    int rc = probe->inner->get_file(probe->inner->ctx, key, local_path);
+    if (rc == 0)
+    {
+        atomic_fetch_add(&probe->gets, 1);
+        atomic_fetch_add(&probe->bytes_fetched, probe_file_size(local_path));
+    }
+    return rc;
+}
+
+static int64_t probe_range_get(void *ctx, const char *key, uint64_t offset, uint8_t *buf,
+                               size_t len)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    probe_delay(probe);
+    probe_thread_fetches++;
+    int64_t n = probe->inner->range_get(probe->inner->ctx, key, offset, buf, len);
+    if (n >= 0)
+    {
+        atomic_fetch_add(&probe->range_gets, 1);
+        atomic_fetch_add(&probe->bytes_fetched, (uint64_t)n);
+    }
+    return n;
+}
+
+static int probe_delete_object(void *ctx, const char *key)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    probe_delay(probe);
+    return probe->inner->delete_object(probe->inner->ctx, key);
+}
+
+static int probe_exists(void *ctx, const char *key)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    probe_delay(probe);
+    return probe->inner->exists(probe->inner->ctx, key);
+}
+
+/* tidesdb destroys the connector it was given on close, we take the real one down with it */
+static void probe_destroy(void *ctx)
+{
+    objstore_probe_t *probe = (objstore_probe_t *)ctx;
+    tidesdb_objstore_t *inner = probe->inner;
+    if (inner->destroy) inner->destroy(inner->ctx);
+    free(inner);
+    free(probe);
+}
+
+/**
+ * probe_wrap
+ * puts a counting probe in front of a connector. the returned connector is a copy of inner with
+ * the request callbacks pointed at the probe
+ * @param inner the real connector, owned by the returned one from here on
+ * @param latency_us delay injected before every request
+ * @param probe_out receives the probe for reading the counters
+ * @return the wrapped connector, NULL on allocation failure (inner is left untouched)
+ */
+static tidesdb_objstore_t *probe_wrap(tidesdb_objstore_t *inner, uint64_t latency_us,
+                                      objstore_probe_t **probe_out)
+{
+    objstore_probe_t *probe = calloc(1, sizeof(objstore_probe_t));
+    tidesdb_objstore_t *outer = malloc(sizeof(tidesdb_objstore_t));
+    if (!probe || !outer)
+    {
+        free(probe);
+        free(outer);
+        return NULL;
+    }
+    probe->inner = inner;
+    probe->latency_us = latency_us;
+
+    *outer = *inner;
+    outer->ctx = probe;
+    outer->put_file = probe_put_file;
+    outer->get_file = probe_get_file;
+    outer->range_get = probe_range_get;
+    outer->delete_object = probe_delete_object;
+    outer->exists = probe_exists;
+    outer->destroy = probe_destroy;
+    *probe_out = probe;
+    return outer;
+}
+
+typedef struct tidesdb_handle_t
 {
     tidesdb_t *db;
     tidesdb_column_family_t *cf;
@@ -35,6 +180,10 @@ typedef struct
     int txn_key_initialized;                  /* flag to track if key was created */
     tidesdb_objstore_config_t os_cfg;         /* object store config (when active) */
     int os_cfg_initialized;                   /* 1 when os_cfg is populated for this db */
+    objstore_probe_t *probe;                  /* connector counters (NULL without object store) */
+    struct tidesdb_handle_t *cf_handles;      /* --column-families, one copy per family */
+    storage_engine_t *cf_views;               /* engines over cf_handles */
+    int num_cf_views;
 } tidesdb_handle_t;
 
 static int parse_sync_mode(const char *name, tidesdb_sync_mode_t *out)
@@ -100,6 +249,11 @@ typedef struct
 {
     tidesdb_iter_t *iter;
     tidesdb_txn_t *txn; /* read-only transaction for consistent iteration */
+    int bounded;        /* iter_seek_bounded, keys outside [lower, upper) end the iteration */
+    uint8_t *lower;
+    size_t lower_size, lower_cap;
+    uint8_t *upper;
+    size_t upper_size, upper_cap;
 } tidesdb_iter_wrapper_t;
 
 static const storage_engine_ops_t tidesdb_ops;
@@ -118,6 +272,42 @@ static void thread_local_txn_destructor(void *data)
     }
 }
 
+static int tidesdb_close_impl(storage_engine_t *engine);
+
+/* --column-families, we create cf_0 .. cf_{n-1} next to the default family and give each a copy
+ * of the handle pointing at it. the copies share the db and the thread-local transactions, a
+ * transaction spans families so puts through different views can reuse it */
+static int open_column_families(tidesdb_handle_t *handle, int n)
+{
+    handle->cf_handles = calloc((size_t)n, sizeof(tidesdb_handle_t));
+    handle->cf_views = calloc((size_t)n, sizeof(storage_engine_t));
+    if (!handle->cf_handles || !handle->cf_views) return -1;
+
+    for (int i = 0; i < n; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "cf_%d", i);
+        /* the family already exists when the database is reused */
+        (void)tidesdb_create_column_family(handle->db, name, &handle->cf_config);
+
+        tidesdb_handle_t *view = &handle->cf_handles[i];
+        *view = *handle;
+        view->cf = tidesdb_get_column_family(handle->db, name);
+        view->cf_handles = NULL;
+        view->cf_views = NULL;
+        view->num_cf_views = 0;
+        if (!view->cf)
+        {
+            fprintf(stderr, "Failed to open column family %s\n", name);
+            return -1;
+        }
+        handle->cf_views[i].ops = &tidesdb_ops;
+        handle->cf_views[i].handle = view;
+    }
+    handle->num_cf_views = n;
+    return 0;
+}
+
 static int tidesdb_open_impl(storage_engine_t **engine, const char *path,
                              const benchmark_config_t *config)
 {
@@ -132,6 +322,7 @@ static int tidesdb_open_impl(storage_engine_t **engine, const char *path,
     }
 
     handle->os_cfg_initialized = 0;
+    handle->probe = NULL;
 
     tidesdb_config_t tdb_config = tidesdb_default_config();
     tdb_config.db_path = (char *)path; /* tidesdb_open makes its own copy */
@@ -237,6 +428,17 @@ static int tidesdb_open_impl(storage_engine_t **engine, const char *path,
             return -1;
         }
 
+        tidesdb_objstore_t *wrapped = probe_wrap(os, config->object_latency_us, &handle->probe);
+        if (!wrapped)
+        {
+            os->destroy(os->ctx);
+            free(os);
+            free(handle);
+            free(*engine);
+            return -1;
+        }
+        os = wrapped;
+
         handle->os_cfg = tidesdb_objstore_default_config();
         if (config->object_local_cache_path)
             handle->os_cfg.local_cache_path = config->object_local_cache_path;
@@ -377,6 +579,17 @@ static int tidesdb_open_impl(storage_engine_t **engine, const char *path,
     (*engine)->handle = handle;
     (*engine)->ops = &tidesdb_ops;
 
+    handle->cf_handles = NULL;
+    handle->cf_views = NULL;
+    handle->num_cf_views = 0;
+    if (config->num_column_families > 1 &&
+        open_column_families(handle, config->num_column_families) != 0)
+    {
+        tidesdb_close_impl(*engine);
+        *engine = NULL;
+        return -1;
+    }
+
     return 0;
 }
 
@@ -410,6 +623,8 @@ static int tidesdb_close_impl(storage_engine_t *engine)
 
     /* tidesdb_close() frees db_path internally, so we don't free it here */
     tidesdb_close(handle->db);
+    free(handle->cf_handles);
+    free(handle->cf_views);
     free(handle);
     free(engine);
     return 0;
@@ -516,6 +731,38 @@ static int tidesdb_get_impl(storage_engine_t *engine, const uint8_t *key, size_t
     return result;
 }
 
+static int tidesdb_multi_get_impl(storage_engine_t *engine, size_t num_keys,
+                                  const uint8_t *const *keys, const size_t *key_sizes,
+                                  uint8_t **values, size_t *value_sizes)
+{
+    tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
+    thread_local_txn_t *tl_txn = NULL;
+    tidesdb_txn_t *txn = get_or_create_txn(handle, &tl_txn);
+    if (!txn) return -1;
+
+    /* one read txn for the whole batch, every key sees the same snapshot */
+    int found = 0;
+    for (size_t i = 0; i < num_keys; i++)
+    {
+        values[i] = NULL;
+        value_sizes[i] = 0;
+        int rc = tidesdb_txn_get(txn, handle->cf, keys[i], key_sizes[i], &values[i],
+                                 &value_sizes[i]);
+        if (rc == 0) found++;
+    }
+
+    if (tl_txn)
+    {
+        tl_txn->committed = 1;
+    }
+    else
+    {
+        tidesdb_txn_free(txn);
+    }
+
+    return found;
+}
+
 static int tidesdb_del_impl(storage_engine_t *engine, const uint8_t *key, size_t key_size)
 {
     tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
@@ -538,6 +785,17 @@ static int tidesdb_del_impl(storage_engine_t *engine, const uint8_t *key, size_t
     return result;
 }
 
+/* we flush the active memtable and then queue a compaction of every level, the close that ends
+ * a load waits for the background work to drain */
+static int tidesdb_compact_impl(storage_engine_t *engine)
+{
+    tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
+
+    int result = tidesdb_flush_memtable(handle->cf);
+    if (result == 0) result = tidesdb_compact(handle->cf);
+    return result;
+}
+
 static int tidesdb_batch_begin_impl(storage_engine_t *engine, void **batch_ctx)
 {
     tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
@@ -582,7 +840,7 @@ static int tidesdb_iter_new_impl(storage_engine_t *engine, void **iter)
     tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
 
     /* we allocate wrapper to hold both iterator and transaction */
-    tidesdb_iter_wrapper_t *wrapper = malloc(sizeof(tidesdb_iter_wrapper_t));
+    tidesdb_iter_wrapper_t *wrapper = calloc(1, sizeof(tidesdb_iter_wrapper_t));
     if (!wrapper) return -1;
 
     /* we create a fresh read-only transaction for this iteration */
@@ -609,6 +867,7 @@ static int tidesdb_iter_seek_to_first_impl(void *iter)
     if (!iter) return -1;
     tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
     if (!wrapper->iter) return -1;
+    wrapper->bounded = 0;
     return tidesdb_iter_seek_to_first(wrapper->iter);
 }
 
@@ -617,15 +876,94 @@ static int tidesdb_iter_seek_impl(void *iter, const uint8_t *key, size_t key_siz
     if (!iter) return -1;
     tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
     if (!wrapper->iter) return -1;
+    wrapper->bounded = 0;
     return tidesdb_iter_seek(wrapper->iter, key, key_size);
 }
 
+static int tidesdb_iter_seek_for_prev_impl(void *iter, const uint8_t *key, size_t key_size)
+{
+    if (!iter) return -1;
+    tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
+    if (!wrapper->iter) return -1;
+    wrapper->bounded = 0;
+    return tidesdb_iter_seek_for_prev(wrapper->iter, key, key_size);
+}
+
+/* the default comparator's order, memcmp with the shorter key first on a tie */
+static int tidesdb_key_cmp(const uint8_t *key, size_t key_size, const uint8_t *bound,
+                           size_t bound_size)
+{
+    size_t n = key_size < bound_size ? key_size : bound_size;
+    int c = n > 0 ? memcmp(key, bound, n) : 0;
+    if (c != 0) return c;
+    return key_size < bound_size ? -1 : (key_size > bound_size ? 1 : 0);
+}
+
+/* we copy the bounds, the caller's buffers may change before the iterator moves */
+static int tidesdb_iter_bound(uint8_t **buf, size_t *size, size_t *cap, const uint8_t *key,
+                              size_t key_size)
+{
+    if (key_size > *cap)
+    {
+        uint8_t *grown = realloc(*buf, key_size);
+        if (!grown) return -1;
+        *buf = grown;
+        *cap = key_size;
+    }
+    if (key_size > 0) memcpy(*buf, key, key_size);
+    *size = key_size;
+    return 0;
+}
+
+static int tidesdb_iter_seek_bounded_impl(void *iter, const uint8_t *lower, size_t lower_size,
+                                          const uint8_t *upper, size_t upper_size, int reverse)
+{
+    if (!iter || !lower || !upper) return -1;
+    tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
+    if (!wrapper->iter) return -1;
+
+    if (tidesdb_iter_bound(&wrapper->lower, &wrapper->lower_size, &wrapper->lower_cap, lower,
+                           lower_size) != 0 ||
+        tidesdb_iter_bound(&wrapper->upper, &wrapper->upper_size, &wrapper->upper_cap, upper,
+                           upper_size) != 0)
+    {
+        return -1;
+    }
+    wrapper->bounded = 1;
+
+    /* an empty lower bound starts at the first key */
+    if (!reverse && wrapper->lower_size == 0) return tidesdb_iter_seek_to_first(wrapper->iter);
+    if (!reverse) return tidesdb_iter_seek(wrapper->iter, wrapper->lower, wrapper->lower_size);
+
+    /* upper is exclusive, seek_for_prev may land on it and we step back once */
+    if (tidesdb_iter_seek_for_prev(wrapper->iter, wrapper->upper, wrapper->upper_size) != 0)
+    {
+        return -1;
+    }
+    uint8_t *key = NULL;
+    size_t key_size = 0;
+    if (tidesdb_iter_valid(wrapper->iter) &&
+        tidesdb_iter_key(wrapper->iter, &key, &key_size) == 0 &&
+        tidesdb_key_cmp(key, key_size, wrapper->upper, wrapper->upper_size) >= 0)
+    {
+        tidesdb_iter_prev(wrapper->iter);
+    }
+    return 0;
+}
+
 static int tidesdb_iter_valid_impl(void *iter)
 {
     if (!iter) return 0;
     tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
     if (!wrapper->iter) return 0;
-    return tidesdb_iter_valid(wrapper->iter);
+    if (!tidesdb_iter_valid(wrapper->iter)) return 0;
+    if (!wrapper->bounded) return 1;
+
+    uint8_t *key = NULL;
+    size_t key_size = 0;
+    if (tidesdb_iter_key(wrapper->iter, &key, &key_size) != 0) return 0;
+    return tidesdb_key_cmp(key, key_size, wrapper->lower, wrapper->lower_size) >= 0 &&
+           tidesdb_key_cmp(key, key_size, wrapper->upper, wrapper->upper_size) < 0;
 }
 
 static int tidesdb_iter_next_impl(void *iter)
@@ -636,6 +974,14 @@ static int tidesdb_iter_next_impl(void *iter)
     return tidesdb_iter_next(wrapper->iter);
 }
 
+static int tidesdb_iter_prev_impl(void *iter)
+{
+    if (!iter) return -1;
+    tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
+    if (!wrapper->iter) return -1;
+    return tidesdb_iter_prev(wrapper->iter);
+}
+
 static int tidesdb_iter_key_impl(void *iter, uint8_t **key, size_t *key_size)
 {
     if (!iter || !key || !key_size) return -1;
@@ -652,6 +998,16 @@ static int tidesdb_iter_value_impl(void *iter, uint8_t **value, size_t *value_si
     return tidesdb_iter_value(wrapper->iter, value, value_size);
 }
 
+static int tidesdb_iter_entry_impl(void *iter, uint8_t **key, size_t *key_size, uint8_t **value,
+                                   size_t *value_size)
+{
+    if (!iter || !key || !key_size || !value || !value_size) return -1;
+    tidesdb_iter_wrapper_t *wrapper = (tidesdb_iter_wrapper_t *)iter;
+    if (!wrapper->iter) return -1;
+    if (tidesdb_iter_key(wrapper->iter, key, key_size) != 0) return -1;
+    return tidesdb_iter_value(wrapper->iter, value, value_size);
+}
+
 static int tidesdb_iter_free_impl(void *iter)
 {
     if (!iter) return 0;
@@ -670,17 +1026,83 @@ static int tidesdb_iter_free_impl(void *iter)
         wrapper->txn = NULL;
     }
 
+    free(wrapper->lower);
+    free(wrapper->upper);
+
     free(wrapper);
 
     return 0;
 }
 
+static int tidesdb_remote_stats_impl(storage_engine_t *engine, remote_stats_t *stats)
+{
+    tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
+    objstore_probe_t *probe = handle->probe;
+    if (!probe) return -1;
+
+    stats->gets = atomic_load(&probe->gets);
+    stats->range_gets = atomic_load(&probe->range_gets);
+    stats->bytes_fetched = atomic_load(&probe->bytes_fetched);
+    stats->puts = atomic_load(&probe->puts);
+    stats->bytes_uploaded = atomic_load(&probe->bytes_uploaded);
+    stats->uploads_in_flight = atomic_load(&probe->uploads_in_flight);
+    stats->max_uploads_in_flight = atomic_load(&probe->max_uploads_in_flight);
+    return 0;
+}
+
+/* column family layout and block cache counters, tidesdb keeps no stall or compaction byte
+ * counters so those stay -1 */
+static int tidesdb_get_stats_impl(storage_engine_t *engine, engine_stats_t *stats)
+{
+    tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
+
+    tidesdb_stats_t *cf_stats = NULL;
+    if (tidesdb_get_stats(handle->cf, &cf_stats) != 0 || !cf_stats) return -1;
+
+    int64_t files = 0, bytes = 0;
+    for (int i = 0; i < cf_stats->num_levels; i++)
+    {
+        files += cf_stats->level_num_sstables[i];
+        bytes += (int64_t)cf_stats->level_sizes[i];
+    }
+    stats->memtable_bytes = (int64_t)cf_stats->memtable_size;
+    stats->l0_files = cf_stats->num_levels > 0 ? cf_stats->level_num_sstables[0] : 0;
+    stats->table_files = files;
+    stats->live_data_bytes = bytes;
+    tidesdb_free_stats(cf_stats);
+
+    tidesdb_cache_stats_t cache_stats;
+    if (tidesdb_get_cache_stats(handle->db, &cache_stats) == 0 && cache_stats.enabled)
+    {
+        stats->block_cache_hits = (int64_t)cache_stats.hits;
+        stats->block_cache_misses = (int64_t)cache_stats.misses;
+        stats->block_cache_bytes = (int64_t)cache_stats.total_bytes;
+    }
+    return 0;
+}
+
+static uint64_t tidesdb_thread_fetches_impl(storage_engine_t *engine)
+{
+    (void)engine;
+    return probe_thread_fetches;
+}
+
+static int tidesdb_column_family_impl(storage_engine_t *engine, int index, storage_engine_t **cf)
+{
+    tidesdb_handle_t *handle = (tidesdb_handle_t *)engine->handle;
+    if (index < 0 || index >= handle->num_cf_views) return -1;
+    *cf = &handle->cf_views[index];
+    return 0;
+}
+
 static const storage_engine_ops_t tidesdb_ops = {
     .open = tidesdb_open_impl,
     .close = tidesdb_close_impl,
     .put = tidesdb_put_impl,
     .get = tidesdb_get_impl,
+    .multi_get = tidesdb_multi_get_impl,
     .del = tidesdb_del_impl,
+    .compact = tidesdb_compact_impl,
     .batch_begin = tidesdb_batch_begin_impl,
     .batch_put = tidesdb_batch_put_impl,
     .batch_delete = tidesdb_batch_delete_impl,
@@ -693,7 +1115,15 @@ static const storage_engine_ops_t tidesdb_ops = {
     .iter_key = tidesdb_iter_key_impl,
     .iter_value = tidesdb_iter_value_impl,
     .iter_free = tidesdb_iter_free_impl,
+    .iter_seek_bounded = tidesdb_iter_seek_bounded_impl,
+    .iter_seek_for_prev = tidesdb_iter_seek_for_prev_impl,
+    .iter_prev = tidesdb_iter_prev_impl,
+    .iter_entry = tidesdb_iter_entry_impl,
     .set_sync = tidesdb_set_sync_mode,
+    .remote_stats = tidesdb_remote_stats_impl,
+    .thread_fetches = tidesdb_thread_fetches_impl,
+    .get_stats = tidesdb_get_stats_impl,
+    .column_family = tidesdb_column_family_impl,
     .name = "TidesDB"};
 
 const storage_engine_ops_t *get_tidesdb_ops(void)
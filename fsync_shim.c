@@ -0,0 +1,95 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * LD_PRELOAD shim timing every fsync, fdatasync and msync(MS_SYNC) of the process.
+ *
+ *   LD_PRELOAD=./build/libbenchtool_fsync.so ./build/benchtool -e rocksdb --sync ...
+ *
+ * calls go straight to the next definition in the lookup order, the shim only adds two clock
+ * reads and a histogram update under a mutex, which is noise next to a device flush. benchtool
+ * finds benchtool_fsync_snapshot() with dlsym and reports the calls of the measured phases.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dlfcn.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "histogram.h"
+
+static histogram_t sync_hist;
+static pthread_mutex_t sync_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int (*real_fsync)(int);
+static int (*real_fdatasync)(int);
+static int (*real_msync)(void *, size_t, int);
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void record(uint64_t start_ns)
+{
+    uint64_t ns = now_ns() - start_ns;
+    pthread_mutex_lock(&sync_lock);
+    histogram_record(&sync_hist, ns);
+    pthread_mutex_unlock(&sync_lock);
+}
+
+int fsync(int fd)
+{
+    if (!real_fsync) *(void **)&real_fsync = dlsym(RTLD_NEXT, "fsync");
+    uint64_t start = now_ns();
+    int rc = real_fsync(fd);
+    record(start);
+    return rc;
+}
+
+int fdatasync(int fd)
+{
+    if (!real_fdatasync) *(void **)&real_fdatasync = dlsym(RTLD_NEXT, "fdatasync");
+    uint64_t start = now_ns();
+    int rc = real_fdatasync(fd);
+    record(start);
+    return rc;
+}
+
+int msync(void *addr, size_t length, int flags)
+{
+    if (!real_msync) *(void **)&real_msync = dlsym(RTLD_NEXT, "msync");
+    if (!(flags & MS_SYNC)) return real_msync(addr, length, flags);
+
+    /* lmdb with MDB_WRITEMAP commits through a synchronous msync instead of fdatasync */
+    uint64_t start = now_ns();
+    int rc = real_msync(addr, length, flags);
+    record(start);
+    return rc;
+}
+
+int benchtool_fsync_snapshot(histogram_t *h)
+{
+    pthread_mutex_lock(&sync_lock);
+    memcpy(h, &sync_hist, sizeof(*h));
+    pthread_mutex_unlock(&sync_lock);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "histogram.h"
+
+#include <math.h>
+#include <string.h>
+
+void histogram_init(histogram_t *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void histogram_merge(histogram_t *dst, const histogram_t *src)
+{
+    if (src->count == 0) return;
+
+    for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        dst->buckets[i] += src->buckets[i];
+    }
+
+    if (dst->count == 0 || src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->sum += src->sum;
+    dst->sum_sq += src->sum_sq;
+}
+
+/**
+ * histogram_snapshot_add
+ * adds the live counts of a histogram still being written by another thread into dst.
+ * only count, max and buckets are read, min and the sums are left untouched
+ * @param dst snapshot accumulator, owned by the caller
+ * @param src histogram owned by a running worker
+ */
+void histogram_snapshot_add(histogram_t *dst, const histogram_t *src)
+{
+    uint64_t max = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+    if (max > dst->max) dst->max = max;
+    dst->count += __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+
+    for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        dst->buckets[i] += __atomic_load_n(&src->buckets[i], __ATOMIC_RELAXED);
+    }
+}
+
+uint64_t histogram_bucket_upper_value(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKET_COUNT) return (uint64_t)index;
+
+    int shift = index / HISTOGRAM_SUB_BUCKET_HALF - 1;
+    uint64_t sub = (uint64_t)(index % HISTOGRAM_SUB_BUCKET_HALF + HISTOGRAM_SUB_BUCKET_HALF);
+    return ((sub + 1) << shift) - 1;
+}
+
+/**
+ * histogram_delta
+ * computes what was recorded between two snapshots. the count is re-derived from the buckets
+ * (the snapshot counters are read independently) and min/max come from the bucket bounds
+ * @param dst interval histogram
+ * @param cur newer snapshot
+ * @param prev older snapshot
+ */
+void histogram_delta(histogram_t *dst, const histogram_t *cur, const histogram_t *prev)
+{
+    int lowest = -1, highest = -1;
+
+    memset(dst, 0, sizeof(*dst));
+    for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        uint64_t n = cur->buckets[i] > prev->buckets[i] ? cur->buckets[i] - prev->buckets[i] : 0;
+        if (n == 0) continue;
+        dst->buckets[i] = n;
+        dst->count += n;
+        if (lowest < 0) lowest = i;
+        highest = i;
+    }
+
+    if (dst->count == 0) return;
+    dst->min = lowest > 0 ? histogram_bucket_upper_value(lowest - 1) + 1 : 0;
+    dst->max = histogram_bucket_upper_value(highest);
+    if (dst->max > cur->max) dst->max = cur->max;
+}
+
+/**
+ * histogram_value_at_percentile
+ * returns the value below which the given percentage of recorded values fall, reported as the
+ * highest value equivalent to the matching bucket and clamped to the recorded min/max
+ * @param h the histogram
+ * @param percentile percentile in [0, 100]
+ * @return value at percentile, 0 if the histogram is empty
+ */
+uint64_t histogram_value_at_percentile(const histogram_t *h, double percentile)
+{
+    if (h->count == 0) return 0;
+    if (percentile >= 100.0) return h->max;
+    if (percentile <= 0.0) return h->min;
+
+    uint64_t target = (uint64_t)ceil((percentile / 100.0) * (double)h->count);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        seen += h->buckets[i];
+        if (seen >= target)
+        {
+            uint64_t value = histogram_bucket_upper_value(i);
+            if (value > h->max) value = h->max;
+            if (value < h->min) value = h->min;
+            return value;
+        }
+    }
+    return h->max;
+}
+
+double histogram_mean(const histogram_t *h)
+{
+    return h->count > 0 ? h->sum / (double)h->count : 0.0;
+}
+
+double histogram_stddev(const histogram_t *h)
+{
+    if (h->count == 0) return 0.0;
+
+    double mean = h->sum / (double)h->count;
+    double variance = h->sum_sq / (double)h->count - mean * mean;
+    return variance > 0.0 ? sqrt(variance) : 0.0;
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <stdint.h>
+
+/*
+ * fixed-size log-linear latency histogram (HDR style).
+ * values below 2^HISTOGRAM_SUB_BUCKET_BITS are recorded exactly, above that every
+ * power-of-two range is split into HISTOGRAM_SUB_BUCKET_HALF linear sub-buckets, so the
+ * relative error of any reported value is bounded by 1/HISTOGRAM_SUB_BUCKET_HALF (~1.6%).
+ * one histogram covers the full uint64 range in ~30 KB, is owned by a single writer
+ * thread and is merged by simply adding bucket counts.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS  7
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_SUB_BUCKET_HALF  (HISTOGRAM_SUB_BUCKET_COUNT / 2)
+#define HISTOGRAM_BUCKET_COUNT \
+    ((64 - HISTOGRAM_SUB_BUCKET_BITS + 2) * HISTOGRAM_SUB_BUCKET_HALF)
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;    /* sum of recorded values */
+    double sum_sq; /* sum of squared values, for stddev */
+    uint64_t buckets[HISTOGRAM_BUCKET_COUNT];
+} histogram_t;
+
+/**
+ * histogram_bucket_index
+ * maps a value onto its bucket
+ * @param value the value to map
+ * @return bucket index in [0, HISTOGRAM_BUCKET_COUNT)
+ */
+static inline int histogram_bucket_index(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKET_COUNT) return (int)value;
+
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - (HISTOGRAM_SUB_BUCKET_BITS - 1);
+    return shift * HISTOGRAM_SUB_BUCKET_HALF + (int)(value >> shift);
+}
+
+/**
+ * histogram_record_n
+ * records one value that stands for n sampled ones, the hot path of every benchmark thread. the
+ * owning thread is the only writer, count and buckets are published with relaxed stores so a
+ * reporter thread can take consistent-enough snapshots with histogram_snapshot() while the
+ * phase is running
+ * @param h the histogram (owned by the calling thread)
+ * @param value the value to record
+ * @param n weight of the value, 1 unless ops are sampled
+ */
+static inline void histogram_record_n(histogram_t *h, uint64_t value, uint64_t n)
+{
+    int idx = histogram_bucket_index(value);
+    __atomic_store_n(&h->buckets[idx], h->buckets[idx] + n, __ATOMIC_RELAXED);
+    if (h->count == 0 || value < h->min) h->min = value;
+    if (value > h->max) __atomic_store_n(&h->max, value, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->count, h->count + n, __ATOMIC_RELAXED);
+    h->sum += (double)value * (double)n;
+    h->sum_sq += (double)value * (double)value * (double)n;
+}
+
+/**
+ * histogram_record
+ * records one value
+ * @param h the histogram (owned by the calling thread)
+ * @param value the value to record
+ */
+static inline void histogram_record(histogram_t *h, uint64_t value)
+{
+    histogram_record_n(h, value, 1);
+}
+
+void histogram_init(histogram_t *h);
+void histogram_merge(histogram_t *dst, const histogram_t *src);
+void histogram_snapshot_add(histogram_t *dst, const histogram_t *src);
+void histogram_delta(histogram_t *dst, const histogram_t *cur, const histogram_t *prev);
+uint64_t histogram_value_at_percentile(const histogram_t *h, double percentile);
+
+/**
+ * histogram_bucket_upper_value
+ * @param index bucket index in [0, HISTOGRAM_BUCKET_COUNT)
+ * @return the highest value that maps onto the bucket, the top bucket wraps to UINT64_MAX
+ */
+uint64_t histogram_bucket_upper_value(int index);
+double histogram_mean(const histogram_t *h);
+double histogram_stddev(const histogram_t *h);
+
+#endif /* __HISTOGRAM_H__ */
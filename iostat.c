@@ -0,0 +1,121 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "iostat.h"
+
+#include <dlfcn.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <time.h>
+
+typedef int (*fsync_snapshot_fn)(histogram_t *h);
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* st_dev of path, walking up to the nearest existing parent */
+static int path_device(const char *path, dev_t *dev)
+{
+    char buf[PATH_MAX];
+    struct stat st;
+
+    snprintf(buf, sizeof(buf), "%s", path);
+    while (stat(buf, &st) != 0)
+    {
+        char tmp[PATH_MAX];
+        snprintf(tmp, sizeof(tmp), "%s", buf);
+        const char *parent = dirname(tmp);
+        if (strcmp(parent, buf) == 0) return -1; /* nothing left to walk up to */
+        snprintf(buf, sizeof(buf), "%s", parent);
+    }
+    *dev = st.st_dev;
+    return 0;
+}
+
+int iostat_sample(const char *path, iostat_sample_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->time_us = now_us();
+
+    dev_t dev;
+    if (path_device(path, &dev) != 0) return -1;
+
+    /* overlay, tmpfs and btrfs subvolumes report an anonymous device with no stat file */
+    char sys_path[128];
+    unsigned int maj = major(dev), min = minor(dev);
+    if (maj == 0) return -1;
+    snprintf(sys_path, sizeof(sys_path), "/sys/dev/block/%u:%u/stat", maj, min);
+
+    FILE *fp = fopen(sys_path, "r");
+    if (!fp) return -1;
+
+    /* reads merges sectors ticks, writes merges sectors ticks, in_flight io_ticks queue, then
+     * four discard fields and two flush fields on newer kernels */
+    unsigned long long f[17] = {0};
+    int n = fscanf(fp, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu "
+                   "%llu %llu %llu",
+                   &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6], &f[7], &f[8], &f[9], &f[10],
+                   &f[11], &f[12], &f[13], &f[14], &f[15], &f[16]);
+    fclose(fp);
+    if (n < 11) return -1;
+
+    s->reads = f[0];
+    s->sectors_read = f[2];
+    s->writes = f[4];
+    s->sectors_written = f[6];
+    s->io_ticks_ms = f[9];
+    s->queue_ms = f[10];
+    s->flushes = n >= 16 ? f[15] : 0;
+
+    /* the device name is the last component of the /sys/dev/block symlink target */
+    char link[128], target[PATH_MAX];
+    snprintf(link, sizeof(link), "/sys/dev/block/%u:%u", maj, min);
+    if (realpath(link, target))
+    {
+        snprintf(s->device, sizeof(s->device), "%s", basename(target));
+    }
+    else
+    {
+        snprintf(s->device, sizeof(s->device), "%u:%u", maj, min);
+    }
+    s->valid = 1;
+    return 0;
+}
+
+int iostat_fsync_snapshot(histogram_t *h)
+{
+    static fsync_snapshot_fn fn = NULL;
+    static int resolved = 0;
+
+    if (!resolved)
+    {
+        *(void **)&fn = dlsym(RTLD_DEFAULT, IOSTAT_FSYNC_SYMBOL);
+        resolved = 1;
+    }
+    if (!fn) return -1;
+    return fn(h);
+}
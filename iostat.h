@@ -0,0 +1,70 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __IOSTAT_H__
+#define __IOSTAT_H__
+
+#include <stdint.h>
+
+#include "histogram.h"
+
+/*
+ * block-level io accounting for the device behind the database path. /proc/self/io only sees
+ * what this process pushed past the page cache, the device counters in
+ * /sys/dev/block/<major>:<minor>/stat see every request the kernel issued for the filesystem,
+ * including writeback and journal traffic and regardless of which process caused it.
+ *
+ * fsync cost comes from the benchtool_fsync LD_PRELOAD shim (fsync_shim.c), which times every
+ * fsync, fdatasync and msync(MS_SYNC) into a histogram that benchtool looks up with dlsym.
+ * without the shim preloaded, iostat_fsync_snapshot() reports nothing.
+ */
+#define IOSTAT_SECTOR_BYTES 512 /* the stat file counts 512-byte sectors on every device */
+
+/* name of the histogram snapshot function exported by the shim */
+#define IOSTAT_FSYNC_SYMBOL "benchtool_fsync_snapshot"
+
+typedef struct
+{
+    int valid;          /* 0 when the path is not backed by a block device */
+    char device[32];    /* kernel name, e.g. nvme0n1p2 */
+    double time_us;     /* when the sample was taken */
+    uint64_t reads;     /* completed read requests */
+    uint64_t sectors_read;
+    uint64_t writes;    /* completed write requests */
+    uint64_t sectors_written;
+    uint64_t flushes;   /* completed cache flush requests, 0 on kernels before 5.5 */
+    uint64_t io_ticks_ms; /* time the device had at least one request in flight */
+    uint64_t queue_ms;    /* request time weighted by the number in flight */
+} iostat_sample_t;
+
+/**
+ * iostat_sample
+ * reads the device counters of the filesystem holding path. a path that does not exist yet is
+ * resolved through its parent directory
+ * @param path the database path
+ * @param s the sample, valid = 0 when there is no block device behind path
+ * @return 0 on success, -1 when no device counters could be read
+ */
+int iostat_sample(const char *path, iostat_sample_t *s);
+
+/**
+ * iostat_fsync_snapshot
+ * copies the fsync latency histogram (nanoseconds) recorded by the preloaded shim
+ * @param h the snapshot
+ * @return 0 on success, -1 when the shim is not loaded
+ */
+int iostat_fsync_snapshot(histogram_t *h);
+
+#endif /* __IOSTAT_H__ */
@@ -0,0 +1,289 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "keygen.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* two digit lookup table, the decimal formatter emits digits pairwise from it */
+static const char keygen_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char keygen_hex_digits[] = "0123456789abcdef";
+
+static uint64_t keygen_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t keygen_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+uint64_t keygen_rand(keygen_t *kg)
+{
+    uint64_t *s = kg->rng;
+    uint64_t result = keygen_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = keygen_rotl(s[3], 45);
+    return result;
+}
+
+/* uniform double in [0, 1) from the top 53 bits */
+static inline double keygen_rand_double(keygen_t *kg)
+{
+    return (double)(keygen_rand(kg) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* writes v in decimal right to left ending before end, returns the first digit */
+static char *keygen_format_dec(uint64_t v, char *end)
+{
+    while (v >= 100)
+    {
+        unsigned r = (unsigned)(v % 100);
+        v /= 100;
+        end -= 2;
+        memcpy(end, &keygen_digit_pairs[r * 2], 2);
+    }
+    if (v >= 10)
+    {
+        end -= 2;
+        memcpy(end, &keygen_digit_pairs[v * 2], 2);
+    }
+    else
+    {
+        *--end = (char)('0' + v);
+    }
+    return end;
+}
+
+/* writes v in lower-case hex right to left ending before end, returns the first digit */
+static char *keygen_format_hex(uint64_t v, char *end)
+{
+    do
+    {
+        *--end = keygen_hex_digits[v & 0xF];
+        v >>= 4;
+    } while (v);
+    return end;
+}
+
+/* emits the digits with the semantics of snprintf(key, width + 1, "%0*...", width, v), zero
+ * padded to width characters while longer numbers keep their leading digits */
+static void keygen_emit(uint8_t *key, int width, const char *digits, const char *end)
+{
+    int ndigits = (int)(end - digits);
+    if (ndigits >= width)
+    {
+        memcpy(key, digits, (size_t)width);
+    }
+    else
+    {
+        memset(key, '0', (size_t)(width - ndigits));
+        memcpy(key + width - ndigits, digits, (size_t)ndigits);
+    }
+    key[width] = '\0';
+}
+
+static void keygen_one(keygen_t *kg, uint8_t *key, int64_t index, uint64_t now)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    uint64_t key_num = 0;
+
+    /* we ensure we have space for null terminator */
+    int available_digits = kg->key_size - 1;
+
+    switch (kg->pattern)
+    {
+        case KEY_PATTERN_RANDOM:
+            /* byte-reverse the index for a pseudo-random but unique distribution (full 64-bit) */
+            key_num = (uint64_t)index;
+            key_num = ((key_num & 0xFFFFFFFF00000000ULL) >> 32) |
+                      ((key_num & 0x00000000FFFFFFFFULL) << 32);
+            key_num = ((key_num & 0xFFFF0000FFFF0000ULL) >> 16) |
+                      ((key_num & 0x0000FFFF0000FFFFULL) << 16);
+            key_num =
+                ((key_num & 0xFF00FF00FF00FF00ULL) >> 8) | ((key_num & 0x00FF00FF00FF00FFULL) << 8);
+            keygen_emit(key, available_digits, keygen_format_hex(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_ZIPFIAN:
+            /* zipfian over the sequential keyspace, the hot keys are the lowest indexes */
+            /* intentionally creates duplicates for hot-key simulation */
+            key_num = zipf_dist_next(&kg->zipf, keygen_rand_double(kg));
+            keygen_emit(key, available_digits, keygen_format_dec(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_SCRAMBLED_ZIPFIAN:
+            /* same skew, the hashed rank scatters the hot keys through the key order */
+            key_num = zipf_dist_next(&kg->zipf, keygen_rand_double(kg));
+            key_num = dist_scramble(key_num, kg->zipf.n);
+            keygen_emit(key, available_digits, keygen_format_dec(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_LATEST:
+        {
+            /* zipfian counted back from the newest key, follows inserts of a mixed phase */
+            int64_t newest = (kg->frontier ? atomic_load(kg->frontier) : kg->max_operations) - 1;
+            uint64_t rank = zipf_dist_next(&kg->zipf, keygen_rand_double(kg));
+            key_num = newest > 0 && rank < (uint64_t)newest ? (uint64_t)newest - rank : 0;
+            keygen_emit(key, available_digits, keygen_format_dec(key_num, end), end);
+            break;
+        }
+
+        case KEY_PATTERN_HOTSPOT:
+        {
+            double u1 = keygen_rand_double(kg);
+            key_num = hotspot_dist_next(&kg->hotspot, u1, keygen_rand_double(kg));
+            keygen_emit(key, available_digits, keygen_format_dec(key_num, end), end);
+            break;
+        }
+
+        case KEY_PATTERN_UNIFORM:
+            /* true uniform random, may have collisions */
+            key_num = keygen_rand(kg);
+            keygen_emit(key, available_digits, keygen_format_hex(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_TIMESTAMP:
+            /* monotonically increasing timestamp-like keys */
+            key_num = (now << 32) | (uint64_t)index;
+            keygen_emit(key, available_digits, keygen_format_hex(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_REVERSE:
+            /* reverse sequential */
+            key_num = (uint64_t)(kg->max_operations - index);
+            keygen_emit(key, available_digits, keygen_format_dec(key_num, end), end);
+            break;
+
+        case KEY_PATTERN_SEQUENTIAL:
+        default:
+            /* sequential use index directly for uniqueness */
+            if (index < 0)
+            {
+                snprintf((char *)key, (size_t)kg->key_size, "%0*" PRId64, available_digits, index);
+                break;
+            }
+            keygen_emit(key, available_digits, keygen_format_dec((uint64_t)index, end), end);
+            break;
+    }
+}
+
+int keygen_init(keygen_t *kg, const benchmark_config_t *config, uint64_t seed)
+{
+    memset(kg, 0, sizeof(*kg));
+    kg->key_size = config->key_size;
+    kg->pattern = config->key_pattern;
+    kg->max_operations = config->num_operations;
+
+    /* we expand the seed with splitmix64, xoshiro must not start from an all-zero state */
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        kg->rng[i] = z ^ (z >> 31);
+    }
+
+    uint64_t n = config->num_operations > 0 ? (uint64_t)config->num_operations : 1;
+    if (keygen_pattern_is_skewed(kg->pattern) && kg->pattern != KEY_PATTERN_HOTSPOT)
+    {
+        zipf_dist_init(&kg->zipf, n, config->zipf_theta);
+    }
+    if (kg->pattern == KEY_PATTERN_HOTSPOT)
+    {
+        hotspot_dist_init(&kg->hotspot, n, config->hotspot_key_fraction,
+                          config->hotspot_op_fraction);
+    }
+
+    kg->arena = malloc((size_t)KEYGEN_BLOCK_KEYS * (size_t)kg->key_size);
+    return kg->arena ? 0 : -1;
+}
+
+void keygen_free(keygen_t *kg)
+{
+    free(kg->arena);
+    kg->arena = NULL;
+    kg->arena_count = 0;
+}
+
+void keygen_fill(keygen_t *kg, int64_t first_index)
+{
+    uint64_t start = keygen_now_ns();
+    uint64_t now = kg->pattern == KEY_PATTERN_TIMESTAMP ? (uint64_t)time(NULL) : 0;
+    uint8_t *key = kg->arena;
+
+    for (int64_t i = 0; i < KEYGEN_BLOCK_KEYS; i++)
+    {
+        keygen_one(kg, key, first_index + i, now);
+        key += kg->key_size;
+    }
+
+    kg->arena_first = first_index;
+    kg->arena_count = KEYGEN_BLOCK_KEYS;
+    kg->gen_ns += keygen_now_ns() - start;
+    kg->gen_keys += KEYGEN_BLOCK_KEYS;
+}
+
+void keygen_format(keygen_t *kg, uint8_t *key, int64_t index)
+{
+    uint64_t now = kg->pattern == KEY_PATTERN_TIMESTAMP ? (uint64_t)time(NULL) : 0;
+    keygen_one(kg, key, index, now);
+}
+
+int keygen_pattern_is_skewed(key_pattern_t pattern)
+{
+    return pattern == KEY_PATTERN_ZIPFIAN || pattern == KEY_PATTERN_SCRAMBLED_ZIPFIAN ||
+           pattern == KEY_PATTERN_LATEST || pattern == KEY_PATTERN_HOTSPOT;
+}
+
+void keygen_format_index(keygen_t *kg, uint8_t *key, int64_t index)
+{
+    if (!keygen_pattern_is_skewed(kg->pattern) && kg->pattern != KEY_PATTERN_UNIFORM)
+    {
+        keygen_format(kg, key, index);
+        return;
+    }
+
+    /* sampled patterns have no layout of their own, fresh keys use the sequential one */
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    if (index < 0) index = 0;
+    keygen_emit(key, kg->key_size - 1, keygen_format_dec((uint64_t)index, end), end);
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __KEYGEN_H__
+#define __KEYGEN_H__
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "benchmark.h"
+#include "distribution.h"
+
+/*
+ * per-thread key stream. keys of a streaming phase are formatted a block at a time into a small
+ * contiguous arena (KEYGEN_BLOCK_KEYS * key_size bytes, L1/L2 resident for common key sizes)
+ * with table driven digit formatting instead of one snprintf per op. random patterns draw from a
+ * per-thread xoshiro256** generator, so threads never share PRNG state. the bytes produced for
+ * every deterministic pattern are identical to the former snprintf based generate_key().
+ */
+#define KEYGEN_BLOCK_KEYS 1024
+
+typedef struct
+{
+    int key_size;
+    key_pattern_t pattern;
+    int64_t max_operations;
+    uint64_t rng[4]; /* xoshiro256** state */
+
+    /* samplers of the distribution patterns, precomputed for the keyspace */
+    zipf_dist_t zipf;
+    hotspot_dist_t hotspot;
+    const atomic_int_fast64_t *frontier; /* latest pattern, next index to insert (NULL = fixed) */
+
+    uint8_t *arena;      /* KEYGEN_BLOCK_KEYS formatted keys */
+    int64_t arena_first; /* index of the first key in the arena */
+    int64_t arena_count; /* number of valid keys in the arena, 0 = empty */
+
+    /* generation cost, measured around every block fill */
+    uint64_t gen_ns;
+    uint64_t gen_keys;
+} keygen_t;
+
+/**
+ * keygen_init
+ * initializes a key stream for one worker thread
+ * @param kg the key stream
+ * @param config key size, pattern, keyspace size and distribution parameters
+ * @param seed per-thread seed for the random patterns
+ * @return 0 on success, -1 on allocation failure
+ */
+int keygen_init(keygen_t *kg, const benchmark_config_t *config, uint64_t seed);
+
+/**
+ * keygen_free
+ * releases the arena of a key stream
+ * @param kg the key stream
+ */
+void keygen_free(keygen_t *kg);
+
+/**
+ * keygen_fill
+ * formats the block of keys starting at first_index into the arena
+ * @param kg the key stream
+ * @param first_index index of the first key of the block
+ */
+void keygen_fill(keygen_t *kg, int64_t first_index);
+
+/**
+ * keygen_key
+ * returns the key for index from the arena, refilling the arena with the block starting at
+ * index on a miss. meant for workers walking their index range in order, the pointer stays
+ * valid until the next call
+ * @param kg the key stream
+ * @param index key index
+ * @return the key, key_size bytes
+ */
+static inline const uint8_t *keygen_key(keygen_t *kg, int64_t index)
+{
+    int64_t slot = index - kg->arena_first;
+    if (slot < 0 || slot >= kg->arena_count)
+    {
+        keygen_fill(kg, index);
+        slot = 0;
+    }
+    return kg->arena + slot * kg->key_size;
+}
+
+/**
+ * keygen_format
+ * formats a single key into a caller buffer, for random access workers (mixed workload)
+ * @param kg the key stream
+ * @param key output buffer of key_size bytes
+ * @param index key index
+ */
+void keygen_format(keygen_t *kg, uint8_t *key, int64_t index);
+
+/**
+ * keygen_format_index
+ * formats the key of index itself, for fresh inserts. the sampled patterns (zipfian, uniform,
+ * ...) ignore the index in keygen_format, here they fall back to the sequential layout
+ * @param kg the key stream
+ * @param key output buffer of key_size bytes
+ * @param index key index
+ */
+void keygen_format_index(keygen_t *kg, uint8_t *key, int64_t index);
+
+/**
+ * keygen_pattern_is_skewed
+ * the skewed patterns draw indexes of the sequential keyspace [0, max_operations) from a
+ * distribution, so a keyspace loaded with the sequential layout serves them without misses
+ * @param pattern key pattern
+ * @return 1 for zipfian, scrambled, latest and hotspot, 0 otherwise
+ */
+int keygen_pattern_is_skewed(key_pattern_t pattern);
+
+/**
+ * keygen_rand
+ * next value of the per-thread xoshiro256** generator
+ * @param kg the key stream
+ * @return uniformly distributed 64 bit value
+ */
+uint64_t keygen_rand(keygen_t *kg);
+
+#endif /* __KEYGEN_H__ */
@@ -16,13 +16,47 @@
 #include <dirent.h>
 #include <getopt.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "affinity.h"
+#include "asyncq.h"
 #include "benchmark.h"
+#include "cfroute.h"
+#include "dataset.h"
+#include "matrix.h"
+#include "record.h"
+#include "reporter.h"
+#include "timing.h"
+#include "trace.h"
+#include "valuegen.h"
+
+/* seconds with an optional s, m or h suffix, -1 when the text is not a duration */
+static double parse_seconds(const char *text)
+{
+    char *end = NULL;
+    double value = strtod(text, &end);
+    if (end == text || value < 0.0) return -1.0;
+    if (*end == 'm') return end[1] ? -1.0 : value * 60.0;
+    if (*end == 'h') return end[1] ? -1.0 : value * 3600.0;
+    if (*end == 's') end++;
+    return *end ? -1.0 : value;
+}
+
+/* a CSV file gets its header when it does not exist yet or is empty */
+static int csv_needs_header(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 1;
+    fseek(fp, 0, SEEK_END);
+    int empty = ftell(fp) == 0;
+    fclose(fp);
+    return empty;
+}
 
 static void print_usage(const char *prog)
 {
@@ -36,7 +70,7 @@ static void print_usage(const char *prog)
     printf("Options:\n");
     printf(
         "  -e, --engine <name>       Storage engine to benchmark (tidesdb, "
-        "rocksdb, lmdb)\n");
+        "rocksdb, lmdb or a plugin)\n");
     printf("  -o, --operations <num>    Number of operations (default: 100000)\n");
     printf("  -k, --key-size <bytes>    Key size in bytes (default: 16)\n");
     printf("  -v, --value-size <bytes>  Value size in bytes (default: 100)\n");
@@ -44,19 +78,121 @@ static void print_usage(const char *prog)
     printf("  -b, --batch-size <num>    Batch size for operations (default: 1)\n");
     printf("  -d, --db-path <path>      Database path (default: ./bench_db)\n");
     printf("  -c, --compare             Compare against RocksDB baseline\n");
+    printf("  --engine-plugin <n>=<so>  Load an engine plugin built with benchtool_engine() as "
+           "engine n\n");
+    printf("  --baseline-engine <name>  Compare against this engine instead (implies -c)\n");
+    printf("  --matrix <file>           Run a matrix of engines, workloads, threads, value sizes "
+           "and knob sets\n");
     printf("  -r, --report <file>       Output report to file (default: stdout)\n");
     printf("  --csv <file>              Export results to CSV file for graphing\n");
+    printf("  --results-json <file>     Store every trial with its latency histograms as JSON\n");
+    printf("  --compare-to <file>       Check this run against a --results-json baseline, exit 2 "
+           "on a\n"
+           "                            regression\n");
+    printf("  --trials <n>              Repeat the run n times (default: 1, 5 with "
+           "--compare-to)\n");
+    printf("  --regress-threshold <pct> Smallest median change that is a regression (default: "
+           "5)\n");
+    printf("  --alpha <p>               Significance level of the regression test (default: "
+           "0.05)\n");
     printf("  --test-name <name>        Tag results with a test name in CSV output\n");
     printf("  -s, --sequential          Use sequential keys instead of random\n");
     printf(
         "  -p, --pattern <type>      Key pattern: seq, random, zipfian, "
         "uniform, timestamp, "
-        "reverse (default: random)\n");
+        "reverse,\n"
+        "                            scrambled, latest, hotspot (default: random)\n");
+    printf("  --zipf-theta <theta>      Skew of zipfian/scrambled/latest, 0-1 (default: 0.99)\n");
+    printf("  --hotspot-keys <frac>     Hot share of the keyspace for hotspot (default: 0.2)\n");
+    printf("  --hotspot-ops <frac>      Share of ops on the hot keys for hotspot (default: 0.8)\n");
     printf(
         "  -w, --workload <type>     Workload type: write, read, mixed, "
-        "delete, seek, range (default: mixed)\n");
+        "delete, seek, range, scan, multiget, ingest, replay, recovery (default: mixed)\n");
+    printf(
+        "  --mix <spec>              Concurrent op mix for -w mixed, e.g. "
+        "put=50,get=40,del=5,range=5\n"
+        "                            or a YCSB preset ycsb-a..ycsb-f (ops: put get del range rmw "
+        "insert)\n");
+    printf(
+        "  --report-interval <ms>    Emit time-series throughput/latency every N ms (0 = "
+        "off)\n");
+    printf(
+        "  --timeseries-file <file>  Time-series output, CSV or JSON lines for "
+        "*.json/*.jsonl (default: stderr)\n");
+    printf(
+        "  --target-rate <ops/s>     Open-loop mode, issue ops at this total rate and measure "
+        "latency\n"
+        "                            from the intended start (0 = closed loop, default)\n");
+    printf("  --arrival <type>          Open-loop arrivals: fixed, poisson (default: fixed)\n");
+    printf("  --zero-copy-reads         Read values in place (RocksDB PinnableSlice, LMDB map)\n");
+    printf(
+        "  --cpu-affinity <mode>     Pin worker threads: none, compact, scatter or a cpu list "
+        "such as\n"
+        "                            0-7,16-23 (default: none)\n");
+    printf(
+        "  --thread-sweep <list>     Rerun the measured phase at each thread count, e.g. 1,2,4,8 "
+        "or\n"
+        "                            N for 1,2,4,...,N, on one loaded database\n");
+    printf(
+        "  --cache-sweep <list>      Reopen with each block cache size, as fractions of the "
+        "dataset,\n"
+        "                            e.g. 0.01,0.1,0.5,1, and measure GET and RANGE\n");
+    printf("  --cgroup-headroom <bytes> Cap the cgroup at cache + bytes per cache sweep point\n");
+    printf("  --sweep-csv <file>        Write every thread and cache sweep point as a CSV row\n");
+    printf(
+        "  --phase <phase>           load (load, compact, snapshot), run (measure a loaded db) "
+        "or\n"
+        "                            all (default)\n");
+    printf("  --reuse-db                Keep the database, skip the load if it is already done\n");
+    printf("  --compact-after-load      Fully compact the loaded data before measuring\n");
+    printf("  --snapshot <dir>          Snapshot the loaded db here, --phase run restores it\n");
+    printf("  --snapshot-mode <mode>    reflink, hardlink or copy (default: reflink)\n");
+    printf(
+        "  --queue-depth <num>       Outstanding PUT/GET requests per thread, async mode above 1 "
+        "(default: 1)\n");
+    printf("  --engine-stats            Enable the engine's own statistics (RocksDB tickers)\n");
+    printf("  --perf-counters           Count cycles, instructions, cache and branch misses\n");
+    printf("  --profile-cmd <cmd>       Run cmd (e.g. perf record -p $BENCHTOOL_PID) per phase\n");
+    printf("  --profile-phase <op>      Only run --profile-cmd for this phase, e.g. GET\n");
+    printf("  --compression-ratio <r>   Compressed / raw value size (default: 0.5)\n");
+    printf("  --value-dist <dist>       fixed, uniform, normal or pareto sizes (default: fixed)\n");
+    printf("  --value-size-min <bytes>  Smallest value of --value-dist\n");
+    printf("  --value-size-max <bytes>  Largest value of --value-dist\n");
+    printf("  --value-size-stddev <n>   Standard deviation of normal sizes (default: size / 4)\n");
+    printf("  --timer <source>          Op clock: monotonic or tsc (default: monotonic)\n");
+    printf("  --latency-sample <n>      Time 1 in n ops, throughput counts all (default: 1)\n");
+    printf("  --duration <time>         Run each measured phase this long, e.g. 300, 30m, 6h\n");
+    printf("  --warmup <time>           Run this long before measuring (default: 0)\n");
+    printf("  --steady-window <n>       Intervals in the steady-state window (default: 10)\n");
+    printf("  --steady-cv <percent>     Steady below this throughput cv (default: 5)\n");
+    printf("  --trace <file>            Trace -w replay runs, or --convert-trace writes\n");
+    printf("  --replay-speed <x>        1 = original timing, 2 = twice as fast, 0 = flat out\n");
+    printf("  --trace-preload           Put every key of the trace before the replay\n");
+    printf("  --convert-trace <file>    Convert a trace to --trace and exit\n");
+    printf("  --trace-format <fmt>      --convert-trace input: text or rocksdb (default: text)\n");
+    printf("  --column-families <n>     Spread the keys over n column families (default: 1)\n");
+    printf("  --cf-profile <list>       Per-family weight[:key_size[:value_size]], e.g. "
+           "8:16:64,1:32:4096\n");
+    printf("  --mem-interval <ms>       Sample RSS and allocator stats every N ms (default: 100, "
+           "0 = off)\n");
+    printf("  --mem-timeline <file>     Memory samples, CSV or JSON lines for *.json/*.jsonl\n");
+    printf("  --recovery-unflushed <n>  -w recovery flushes all but the last n keys before the "
+           "kill\n");
     printf("  --sync                    Enable fsync for durable writes (slower)\n");
     printf("  --range-size <num>        Number of keys per range query (default: 100)\n");
+    printf("  --scan-length <n|min-max> Keys per -w scan, drawn uniformly (default: range size)\n");
+    printf("  --scan-prefix <keys>      -w scan walks whole decimal prefixes of this many keys, "
+           "rounded up to a power of 10\n");
+    printf("  --scan-direction <dir>    -w scan direction: forward, reverse, both (default: "
+           "both)\n");
+    printf("  --scan-unbounded          -w scan seeks and counts instead of setting iterator "
+           "bounds\n");
+    printf("  --scan-readahead <bytes>  Iterator readahead of range and scan phases (0 = engine "
+           "default)\n");
+    printf("  --iter-ranges <k>         Split the final ITER pass into k ranges scanned on -t "
+           "threads\n");
+    printf("  --iter-splits <src>       --iter-ranges boundaries: auto (engine, else sampled) or "
+           "sample\n");
     printf("  --memtable-size <bytes>   Memtable/write buffer size in bytes (0 = default)\n");
     printf("  --block-cache-size <bytes> Block cache size in bytes (0 = default)\n");
     printf("  --rocksdb-blobdb          Enable RocksDB BlobDB for large values\n");
@@ -127,6 +263,8 @@ static void print_usage(const char *prog)
     printf("  --object-replica-replay-wal <0|1>       Replay WAL on replicas (default 1)\n");
     printf("  --object-lazy-compaction <0|1>          Less aggressive compaction (per-CF)\n");
     printf("  --object-prefetch-compaction <0|1>      Parallel input prefetch (per-CF)\n");
+    printf("  --object-cold-cache                     Evict the local cache before the reads\n");
+    printf("  --object-latency-us <us>                Delay injected per connector request\n");
     printf("\n  -h, --help                Show this help message\n\n");
     printf("Examples:\n");
     printf("  %s -e tidesdb -o 1000000 -k 16 -v 100\n", prog);
@@ -134,6 +272,10 @@ static void print_usage(const char *prog)
     printf("  %s -e rocksdb -w write -o 1000000\n", prog);
     printf("  %s -e tidesdb --unified-memtable -o 1000000\n", prog);
     printf("  %s -e tidesdb --object-store fs --object-store-fs-path /tmp/objs -o 100000\n", prog);
+    printf(
+        "  %s -e tidesdb -w read --reuse-db --object-store fs --object-store-fs-path /tmp/objs "
+        "--object-local-cache-path /tmp/cache --object-cold-cache --object-latency-us 2000\n",
+        prog);
     printf("  %s -e tidesdb --compression zstd --sync-mode interval --sync-interval-us 500000\n",
            prog);
 }
@@ -146,6 +288,30 @@ int main(int argc, char **argv)
                                  .value_size = 100,
                                  .num_threads = 4,
                                  .batch_size = 1,
+                                 .queue_depth = 1,
+                                 .engine_stats = 0,
+                                 .perf_counters = 0,
+                                 .profile_cmd = NULL,
+                                 .profile_phase = NULL,
+                                 .compression_ratio = 0.5,
+                                 .value_dist = VALUE_DIST_FIXED,
+                                 .value_size_min = 0,
+                                 .value_size_max = 0,
+                                 .value_size_stddev = 0,
+                                 .timer = TIMER_MONOTONIC,
+                                 .latency_sample = 1,
+                                 .duration_sec = 0.0,
+                                 .warmup_sec = 0.0,
+                                 .steady_window = 10,
+                                 .steady_cv = 5.0,
+                                 .trace_file = NULL,
+                                 .replay_speed = 0.0,
+                                 .trace_preload = 0,
+                                 .num_column_families = 1,
+                                 .cf_profile = NULL,
+                                 .mem_interval_ms = 100,
+                                 .mem_timeline_file = NULL,
+                                 .recovery_unflushed = -1,
                                  .db_path = "./bench_db",
                                  .compare_mode = 0,
                                  .report_file = NULL,
@@ -155,6 +321,10 @@ int main(int argc, char **argv)
                                  .workload_type = WORKLOAD_MIXED,
                                  .sync_enabled = 0,
                                  .range_size = 100,
+                                 .scan_direction = SCAN_FORWARD | SCAN_REVERSE,
+                                 .zipf_theta = 0.99,
+                                 .hotspot_key_fraction = 0.2,
+                                 .hotspot_op_fraction = 0.8,
                                  .memtable_size = 0,
                                  .block_cache_size = 0,
                                  .enable_blobdb = -1,
@@ -214,7 +384,9 @@ int main(int argc, char **argv)
                                  .object_replica_sync_interval_us = 0,
                                  .object_replica_replay_wal = -1,
                                  .object_lazy_compaction = -1,
-                                 .object_prefetch_compaction = -1};
+                                 .object_prefetch_compaction = -1,
+                                 .object_cold_cache = 0,
+                                 .object_latency_us = 0};
 
     enum
     {
@@ -273,7 +445,69 @@ int main(int argc, char **argv)
         OPT_OBJECT_REPLICA_SYNC_INTERVAL_US,
         OPT_OBJECT_REPLICA_REPLAY_WAL,
         OPT_OBJECT_LAZY_COMPACTION,
-        OPT_OBJECT_PREFETCH_COMPACTION
+        OPT_OBJECT_PREFETCH_COMPACTION,
+        OPT_MIX,
+        OPT_REPORT_INTERVAL,
+        OPT_TIMESERIES_FILE,
+        OPT_TARGET_RATE,
+        OPT_ARRIVAL,
+        OPT_ZIPF_THETA,
+        OPT_HOTSPOT_KEYS,
+        OPT_HOTSPOT_OPS,
+        OPT_ZERO_COPY_READS,
+        OPT_CPU_AFFINITY,
+        OPT_THREAD_SWEEP,
+        OPT_CACHE_SWEEP,
+        OPT_CGROUP_HEADROOM,
+        OPT_SWEEP_CSV,
+        OPT_PHASE,
+        OPT_REUSE_DB,
+        OPT_COMPACT_AFTER_LOAD,
+        OPT_SNAPSHOT,
+        OPT_SNAPSHOT_MODE,
+        OPT_QUEUE_DEPTH,
+        OPT_OBJECT_COLD_CACHE,
+        OPT_OBJECT_LATENCY_US,
+        OPT_ENGINE_STATS,
+        OPT_PERF_COUNTERS,
+        OPT_PROFILE_CMD,
+        OPT_PROFILE_PHASE,
+        OPT_COMPRESSION_RATIO,
+        OPT_VALUE_DIST,
+        OPT_VALUE_SIZE_MIN,
+        OPT_VALUE_SIZE_MAX,
+        OPT_VALUE_SIZE_STDDEV,
+        OPT_TIMER,
+        OPT_LATENCY_SAMPLE,
+        OPT_DURATION,
+        OPT_WARMUP,
+        OPT_STEADY_WINDOW,
+        OPT_STEADY_CV,
+        OPT_TRACE,
+        OPT_REPLAY_SPEED,
+        OPT_TRACE_PRELOAD,
+        OPT_CONVERT_TRACE,
+        OPT_TRACE_FORMAT,
+        OPT_COLUMN_FAMILIES,
+        OPT_CF_PROFILE,
+        OPT_MEM_INTERVAL,
+        OPT_MEM_TIMELINE,
+        OPT_RECOVERY_UNFLUSHED,
+        OPT_SCAN_LENGTH,
+        OPT_SCAN_PREFIX,
+        OPT_SCAN_DIRECTION,
+        OPT_SCAN_UNBOUNDED,
+        OPT_SCAN_READAHEAD,
+        OPT_ITER_RANGES,
+        OPT_ITER_SPLITS,
+        OPT_MATRIX,
+        OPT_RESULTS_JSON,
+        OPT_COMPARE_TO,
+        OPT_TRIALS,
+        OPT_REGRESS_THRESHOLD,
+        OPT_ALPHA,
+        OPT_ENGINE_PLUGIN,
+        OPT_BASELINE_ENGINE
     };
 
     static struct option long_options[] = {
@@ -360,11 +594,82 @@ int main(int argc, char **argv)
         {"object-replica-replay-wal", required_argument, 0, OPT_OBJECT_REPLICA_REPLAY_WAL},
         {"object-lazy-compaction", required_argument, 0, OPT_OBJECT_LAZY_COMPACTION},
         {"object-prefetch-compaction", required_argument, 0, OPT_OBJECT_PREFETCH_COMPACTION},
+        {"mix", required_argument, 0, OPT_MIX},
+        {"report-interval", required_argument, 0, OPT_REPORT_INTERVAL},
+        {"timeseries-file", required_argument, 0, OPT_TIMESERIES_FILE},
+        {"target-rate", required_argument, 0, OPT_TARGET_RATE},
+        {"arrival", required_argument, 0, OPT_ARRIVAL},
+        {"zipf-theta", required_argument, 0, OPT_ZIPF_THETA},
+        {"hotspot-keys", required_argument, 0, OPT_HOTSPOT_KEYS},
+        {"hotspot-ops", required_argument, 0, OPT_HOTSPOT_OPS},
+        {"zero-copy-reads", no_argument, 0, OPT_ZERO_COPY_READS},
+        {"cpu-affinity", required_argument, 0, OPT_CPU_AFFINITY},
+        {"thread-sweep", required_argument, 0, OPT_THREAD_SWEEP},
+        {"cache-sweep", required_argument, 0, OPT_CACHE_SWEEP},
+        {"cgroup-headroom", required_argument, 0, OPT_CGROUP_HEADROOM},
+        {"sweep-csv", required_argument, 0, OPT_SWEEP_CSV},
+        {"phase", required_argument, 0, OPT_PHASE},
+        {"reuse-db", no_argument, 0, OPT_REUSE_DB},
+        {"compact-after-load", no_argument, 0, OPT_COMPACT_AFTER_LOAD},
+        {"snapshot", required_argument, 0, OPT_SNAPSHOT},
+        {"snapshot-mode", required_argument, 0, OPT_SNAPSHOT_MODE},
+        {"queue-depth", required_argument, 0, OPT_QUEUE_DEPTH},
+        {"object-cold-cache", no_argument, 0, OPT_OBJECT_COLD_CACHE},
+        {"object-latency-us", required_argument, 0, OPT_OBJECT_LATENCY_US},
+        {"engine-stats", no_argument, 0, OPT_ENGINE_STATS},
+        {"perf-counters", no_argument, 0, OPT_PERF_COUNTERS},
+        {"profile-cmd", required_argument, 0, OPT_PROFILE_CMD},
+        {"profile-phase", required_argument, 0, OPT_PROFILE_PHASE},
+        {"compression-ratio", required_argument, 0, OPT_COMPRESSION_RATIO},
+        {"value-dist", required_argument, 0, OPT_VALUE_DIST},
+        {"value-size-min", required_argument, 0, OPT_VALUE_SIZE_MIN},
+        {"value-size-max", required_argument, 0, OPT_VALUE_SIZE_MAX},
+        {"value-size-stddev", required_argument, 0, OPT_VALUE_SIZE_STDDEV},
+        {"timer", required_argument, 0, OPT_TIMER},
+        {"latency-sample", required_argument, 0, OPT_LATENCY_SAMPLE},
+        {"duration", required_argument, 0, OPT_DURATION},
+        {"warmup", required_argument, 0, OPT_WARMUP},
+        {"steady-window", required_argument, 0, OPT_STEADY_WINDOW},
+        {"steady-cv", required_argument, 0, OPT_STEADY_CV},
+        {"trace", required_argument, 0, OPT_TRACE},
+        {"replay-speed", required_argument, 0, OPT_REPLAY_SPEED},
+        {"trace-preload", no_argument, 0, OPT_TRACE_PRELOAD},
+        {"convert-trace", required_argument, 0, OPT_CONVERT_TRACE},
+        {"trace-format", required_argument, 0, OPT_TRACE_FORMAT},
+        {"column-families", required_argument, 0, OPT_COLUMN_FAMILIES},
+        {"cf-profile", required_argument, 0, OPT_CF_PROFILE},
+        {"mem-interval", required_argument, 0, OPT_MEM_INTERVAL},
+        {"mem-timeline", required_argument, 0, OPT_MEM_TIMELINE},
+        {"recovery-unflushed", required_argument, 0, OPT_RECOVERY_UNFLUSHED},
+        {"scan-length", required_argument, 0, OPT_SCAN_LENGTH},
+        {"scan-prefix", required_argument, 0, OPT_SCAN_PREFIX},
+        {"scan-direction", required_argument, 0, OPT_SCAN_DIRECTION},
+        {"scan-unbounded", no_argument, 0, OPT_SCAN_UNBOUNDED},
+        {"scan-readahead", required_argument, 0, OPT_SCAN_READAHEAD},
+        {"iter-ranges", required_argument, 0, OPT_ITER_RANGES},
+        {"iter-splits", required_argument, 0, OPT_ITER_SPLITS},
+        {"matrix", required_argument, 0, OPT_MATRIX},
+        {"results-json", required_argument, 0, OPT_RESULTS_JSON},
+        {"compare-to", required_argument, 0, OPT_COMPARE_TO},
+        {"trials", required_argument, 0, OPT_TRIALS},
+        {"regress-threshold", required_argument, 0, OPT_REGRESS_THRESHOLD},
+        {"alpha", required_argument, 0, OPT_ALPHA},
+        {"engine-plugin", required_argument, 0, OPT_ENGINE_PLUGIN},
+        {"baseline-engine", required_argument, 0, OPT_BASELINE_ENGINE},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}};
 
     int opt;
     int option_index = 0;
+    const char *convert_input = NULL; /* --convert-trace source */
+    const char *trace_format = "text";
+    const char *matrix_file = NULL;
+    const char *results_json = NULL; /* --results-json record of the trials */
+    const char *compare_to = NULL;   /* --compare-to baseline record */
+    int num_trials = 0;              /* 0 = 1, or 5 against a baseline */
+    double regress_threshold = 5.0;
+    double alpha = 0.05;
+    const char *baseline_engine_name = NULL; /* --baseline-engine, NULL = tidesdb/rocksdb pair */
 
     while ((opt = getopt_long(argc, argv, "e:o:k:v:t:b:d:cr:sp:w:R:M:C:h", long_options,
                               &option_index)) != -1)
@@ -420,6 +725,12 @@ int main(int argc, char **argv)
                     config.key_pattern = KEY_PATTERN_TIMESTAMP;
                 else if (strcmp(optarg, "reverse") == 0)
                     config.key_pattern = KEY_PATTERN_REVERSE;
+                else if (strcmp(optarg, "scrambled") == 0)
+                    config.key_pattern = KEY_PATTERN_SCRAMBLED_ZIPFIAN;
+                else if (strcmp(optarg, "latest") == 0)
+                    config.key_pattern = KEY_PATTERN_LATEST;
+                else if (strcmp(optarg, "hotspot") == 0)
+                    config.key_pattern = KEY_PATTERN_HOTSPOT;
                 else
                 {
                     fprintf(stderr, "Invalid key pattern: %s\n", optarg);
@@ -439,6 +750,16 @@ int main(int argc, char **argv)
                     config.workload_type = WORKLOAD_SEEK;
                 else if (strcmp(optarg, "range") == 0)
                     config.workload_type = WORKLOAD_RANGE;
+                else if (strcmp(optarg, "scan") == 0)
+                    config.workload_type = WORKLOAD_SCAN;
+                else if (strcmp(optarg, "multiget") == 0)
+                    config.workload_type = WORKLOAD_MULTIGET;
+                else if (strcmp(optarg, "ingest") == 0)
+                    config.workload_type = WORKLOAD_INGEST;
+                else if (strcmp(optarg, "replay") == 0)
+                    config.workload_type = WORKLOAD_REPLAY;
+                else if (strcmp(optarg, "recovery") == 0)
+                    config.workload_type = WORKLOAD_RECOVERY;
                 else
                 {
                     fprintf(stderr, "Invalid workload type: %s\n", optarg);
@@ -643,16 +964,440 @@ int main(int argc, char **argv)
             case OPT_OBJECT_PREFETCH_COMPACTION:
                 config.object_prefetch_compaction = atoi(optarg);
                 break;
+            case OPT_MIX:
+                if (parse_mix_spec(optarg, config.mix_weights) != 0)
+                {
+                    fprintf(stderr, "Invalid mix spec: %s\n", optarg);
+                    return 1;
+                }
+                config.mix_spec = optarg;
+                break;
+            case OPT_REPORT_INTERVAL:
+                config.report_interval_ms = atoi(optarg);
+                break;
+            case OPT_TIMESERIES_FILE:
+                config.timeseries_file = optarg;
+                break;
+            case OPT_TARGET_RATE:
+                config.target_rate = atof(optarg);
+                break;
+            case OPT_ARRIVAL:
+                if (strcmp(optarg, "fixed") == 0)
+                    config.arrival = ARRIVAL_FIXED;
+                else if (strcmp(optarg, "poisson") == 0)
+                    config.arrival = ARRIVAL_POISSON;
+                else
+                {
+                    fprintf(stderr, "Invalid arrival process: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_ZIPF_THETA:
+                config.zipf_theta = atof(optarg);
+                break;
+            case OPT_HOTSPOT_KEYS:
+                config.hotspot_key_fraction = atof(optarg);
+                break;
+            case OPT_HOTSPOT_OPS:
+                config.hotspot_op_fraction = atof(optarg);
+                break;
+            case OPT_ZERO_COPY_READS:
+                config.zero_copy_reads = 1;
+                break;
+            case OPT_CPU_AFFINITY:
+                if (affinity_parse(optarg, &config.cpu_affinity) != 0)
+                {
+                    fprintf(stderr, "Invalid cpu affinity: %s\n", optarg);
+                    return 1;
+                }
+                config.cpu_list = optarg;
+                break;
+            case OPT_THREAD_SWEEP:
+                config.thread_sweep_count = parse_thread_sweep(optarg, config.thread_sweep);
+                if (config.thread_sweep_count < 0)
+                {
+                    fprintf(stderr, "Invalid thread sweep: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_CACHE_SWEEP:
+                config.cache_sweep_count = parse_cache_sweep(optarg, config.cache_sweep);
+                if (config.cache_sweep_count < 0)
+                {
+                    fprintf(stderr, "Invalid cache sweep: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_CGROUP_HEADROOM:
+                config.cgroup_headroom = (size_t)atoll(optarg);
+                break;
+            case OPT_SWEEP_CSV:
+                config.sweep_csv_file = optarg;
+                break;
+            case OPT_PHASE:
+                if (strcmp(optarg, "load") == 0)
+                    config.phase = BENCH_PHASE_LOAD;
+                else if (strcmp(optarg, "run") == 0)
+                    config.phase = BENCH_PHASE_RUN;
+                else if (strcmp(optarg, "all") == 0)
+                    config.phase = BENCH_PHASE_ALL;
+                else
+                {
+                    fprintf(stderr, "Invalid phase: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_REUSE_DB:
+                config.reuse_db = 1;
+                break;
+            case OPT_COMPACT_AFTER_LOAD:
+                config.compact_after_load = 1;
+                break;
+            case OPT_SNAPSHOT:
+                config.snapshot_dir = optarg;
+                break;
+            case OPT_SNAPSHOT_MODE:
+                if (strcmp(optarg, "reflink") == 0)
+                    config.snapshot_mode = SNAPSHOT_REFLINK;
+                else if (strcmp(optarg, "hardlink") == 0)
+                    config.snapshot_mode = SNAPSHOT_HARDLINK;
+                else if (strcmp(optarg, "copy") == 0)
+                    config.snapshot_mode = SNAPSHOT_COPY;
+                else
+                {
+                    fprintf(stderr, "Invalid snapshot mode: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_QUEUE_DEPTH:
+                config.queue_depth = atoi(optarg);
+                break;
+            case OPT_OBJECT_COLD_CACHE:
+                config.object_cold_cache = 1;
+                break;
+            case OPT_OBJECT_LATENCY_US:
+                config.object_latency_us = (uint64_t)strtoull(optarg, NULL, 10);
+                break;
+            case OPT_ENGINE_STATS:
+                config.engine_stats = 1;
+                break;
+            case OPT_PERF_COUNTERS:
+                config.perf_counters = 1;
+                break;
+            case OPT_PROFILE_CMD:
+                config.profile_cmd = optarg;
+                break;
+            case OPT_PROFILE_PHASE:
+                config.profile_phase = optarg;
+                break;
+            case OPT_COMPRESSION_RATIO:
+                config.compression_ratio = atof(optarg);
+                break;
+            case OPT_VALUE_DIST:
+                if (strcmp(optarg, "fixed") == 0)
+                    config.value_dist = VALUE_DIST_FIXED;
+                else if (strcmp(optarg, "uniform") == 0)
+                    config.value_dist = VALUE_DIST_UNIFORM;
+                else if (strcmp(optarg, "normal") == 0)
+                    config.value_dist = VALUE_DIST_NORMAL;
+                else if (strcmp(optarg, "pareto") == 0)
+                    config.value_dist = VALUE_DIST_PARETO;
+                else
+                {
+                    fprintf(stderr, "Invalid value distribution: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_VALUE_SIZE_MIN:
+                config.value_size_min = atoi(optarg);
+                break;
+            case OPT_VALUE_SIZE_MAX:
+                config.value_size_max = atoi(optarg);
+                break;
+            case OPT_VALUE_SIZE_STDDEV:
+                config.value_size_stddev = atoi(optarg);
+                break;
+            case OPT_TIMER:
+                if (strcmp(optarg, "monotonic") == 0)
+                    config.timer = TIMER_MONOTONIC;
+                else if (strcmp(optarg, "tsc") == 0)
+                    config.timer = TIMER_TSC;
+                else
+                {
+                    fprintf(stderr, "Invalid timer: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_LATENCY_SAMPLE:
+                config.latency_sample = atoi(optarg);
+                break;
+            case OPT_DURATION:
+            case OPT_WARMUP:
+            {
+                double seconds = parse_seconds(optarg);
+                if (seconds < 0.0)
+                {
+                    fprintf(stderr, "Invalid time: %s\n", optarg);
+                    return 1;
+                }
+                if (opt == OPT_DURATION)
+                    config.duration_sec = seconds;
+                else
+                    config.warmup_sec = seconds;
+                break;
+            }
+            case OPT_STEADY_WINDOW:
+                config.steady_window = atoi(optarg);
+                break;
+            case OPT_STEADY_CV:
+                config.steady_cv = atof(optarg);
+                break;
+            case OPT_TRACE:
+                config.trace_file = optarg;
+                break;
+            case OPT_REPLAY_SPEED:
+                config.replay_speed = atof(optarg);
+                break;
+            case OPT_TRACE_PRELOAD:
+                config.trace_preload = 1;
+                break;
+            case OPT_CONVERT_TRACE:
+                convert_input = optarg;
+                break;
+            case OPT_TRACE_FORMAT:
+                if (strcmp(optarg, "text") != 0 && strcmp(optarg, "rocksdb") != 0)
+                {
+                    fprintf(stderr, "Invalid trace format: %s\n", optarg);
+                    return 1;
+                }
+                trace_format = optarg;
+                break;
+            case OPT_COLUMN_FAMILIES:
+                config.num_column_families = atoi(optarg);
+                break;
+            case OPT_CF_PROFILE:
+                config.cf_profile = optarg;
+                break;
+            case OPT_MEM_INTERVAL:
+                config.mem_interval_ms = atoi(optarg);
+                break;
+            case OPT_MEM_TIMELINE:
+                config.mem_timeline_file = optarg;
+                break;
+            case OPT_RECOVERY_UNFLUSHED:
+                config.recovery_unflushed = atoll(optarg);
+                if (config.recovery_unflushed < 0)
+                {
+                    fprintf(stderr, "Invalid --recovery-unflushed: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SCAN_LENGTH:
+            {
+                char *end = NULL;
+                long min = strtol(optarg, &end, 10);
+                long max = *end == '-' ? strtol(end + 1, &end, 10) : min;
+                if (*end != '\0' || min < 1 || max < min || max > INT_MAX)
+                {
+                    fprintf(stderr, "Invalid --scan-length: %s (n or min-max)\n", optarg);
+                    return 1;
+                }
+                config.scan_min = (int)min;
+                config.scan_max = (int)max;
+                break;
+            }
+            case OPT_SCAN_PREFIX:
+                config.scan_prefix_keys = atoll(optarg);
+                if (config.scan_prefix_keys < 1)
+                {
+                    fprintf(stderr, "Invalid --scan-prefix: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SCAN_DIRECTION:
+                if (strcmp(optarg, "forward") == 0)
+                    config.scan_direction = SCAN_FORWARD;
+                else if (strcmp(optarg, "reverse") == 0)
+                    config.scan_direction = SCAN_REVERSE;
+                else if (strcmp(optarg, "both") == 0)
+                    config.scan_direction = SCAN_FORWARD | SCAN_REVERSE;
+                else
+                {
+                    fprintf(stderr, "Invalid --scan-direction: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SCAN_UNBOUNDED:
+                config.scan_unbounded = 1;
+                break;
+            case OPT_SCAN_READAHEAD:
+                config.scan_readahead = (size_t)atoll(optarg);
+                break;
+            case OPT_ITER_RANGES:
+                config.iter_ranges = atoi(optarg);
+                if (config.iter_ranges < 0 || config.iter_ranges > BENCHMARK_MAX_ITER_RANGES)
+                {
+                    fprintf(stderr, "Invalid --iter-ranges: %s (0-%d)\n", optarg,
+                            BENCHMARK_MAX_ITER_RANGES);
+                    return 1;
+                }
+                break;
+            case OPT_ITER_SPLITS:
+                if (strcmp(optarg, "auto") == 0)
+                    config.iter_splits = ITER_SPLITS_AUTO;
+                else if (strcmp(optarg, "sample") == 0)
+                    config.iter_splits = ITER_SPLITS_SAMPLE;
+                else
+                {
+                    fprintf(stderr, "Invalid --iter-splits: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_MATRIX:
+                matrix_file = optarg;
+                break;
+            case OPT_RESULTS_JSON:
+                results_json = optarg;
+                break;
+            case OPT_COMPARE_TO:
+                compare_to = optarg;
+                break;
+            case OPT_TRIALS:
+                num_trials = atoi(optarg);
+                if (num_trials < 1 || num_trials > RECORD_MAX_TRIALS)
+                {
+                    fprintf(stderr, "Invalid --trials: %s (1-%d)\n", optarg, RECORD_MAX_TRIALS);
+                    return 1;
+                }
+                break;
+            case OPT_REGRESS_THRESHOLD:
+                regress_threshold = atof(optarg);
+                if (regress_threshold < 0.0)
+                {
+                    fprintf(stderr, "Invalid --regress-threshold: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_ENGINE_PLUGIN:
+                if (engine_plugin_load(optarg) != 0) return 1;
+                break;
+            case OPT_BASELINE_ENGINE:
+                baseline_engine_name = optarg;
+                config.compare_mode = 1;
+                break;
+            case OPT_ALPHA:
+                alpha = atof(optarg);
+                if (alpha <= 0.0 || alpha >= 1.0)
+                {
+                    fprintf(stderr, "Invalid --alpha: %s (between 0 and 1)\n", optarg);
+                    return 1;
+                }
+                break;
             default:
                 print_usage(argv[0]);
                 return 1;
         }
     }
 
-    if (config.num_operations <= 0LL || config.key_size <= 0 || config.value_size <= 0 ||
-        config.num_threads <= 0 || config.batch_size <= 0)
+    /* a conversion only writes the trace, nothing is benchmarked */
+    if (convert_input)
+    {
+        if (!config.trace_file)
+        {
+            fprintf(stderr, "Error: --convert-trace needs --trace for the output file\n");
+            return 1;
+        }
+        return trace_convert(convert_input, trace_format, config.trace_file) == 0 ? 0 : 1;
+    }
+
+    /* scans without --scan-length cover range size keys */
+    if (config.scan_min == 0)
+    {
+        config.scan_min = config.range_size;
+        config.scan_max = config.range_size;
+    }
+
+    if (config.num_column_families < 1 ||
+        config.num_column_families > BENCHMARK_MAX_COLUMN_FAMILIES)
+    {
+        fprintf(stderr, "Error: --column-families must be in [1, %d]\n",
+                BENCHMARK_MAX_COLUMN_FAMILIES);
+        return 1;
+    }
+
+    /* families share the keys evenly and keep -k and -v unless a profile says otherwise */
+    for (int cf = 0; cf < config.num_column_families; cf++) config.cf_weights[cf] = 1;
+    if (config.cf_profile &&
+        (config.num_column_families < 2 || cfroute_parse_profile(config.cf_profile, &config) != 0))
+    {
+        fprintf(stderr,
+                "Error: --cf-profile needs --column-families of at least 2 and a list of "
+                "weight[:key_size[:value_size]] entries (key sizes up to %d)\n",
+                CFROUTE_MAX_KEY_SIZE);
+        return 1;
+    }
+
+    if (config_validate(&config) != 0) return 1;
+
+    /* steady-state detection runs on the interval reporter, time-bounded runs always get one */
+    if ((config.duration_sec > 0.0 || config.warmup_sec > 0.0) && config.report_interval_ms == 0)
+    {
+        config.report_interval_ms = 1000;
+    }
+
+    timer_source_t requested_timer = config.timer;
+    config.timer = timing_init(requested_timer);
+    if (config.timer != requested_timer)
+    {
+        fprintf(stderr, "Warning: no invariant TSC on this CPU, timing with %s\n",
+                timing_source_name(config.timer));
+    }
+
+    /* a matrix runs every cell on top of this config and writes one summary of them */
+    if (matrix_file)
+    {
+        static matrix_t matrix;
+        if (config.compare_mode || config.phase != BENCH_PHASE_ALL || config.snapshot_dir)
+        {
+            fprintf(stderr, "Error: --matrix loads the datasets of its cells itself, drop -c, "
+                            "--phase and --snapshot\n");
+            return 1;
+        }
+        if (matrix_load(matrix_file, &config, &matrix) != 0) return 1;
+        return matrix_run(&matrix, &config) == 0 ? 0 : 1;
+    }
+
+    if (baseline_engine_name && !get_engine_ops(baseline_engine_name))
+    {
+        fprintf(stderr, "Error: unknown --baseline-engine %s\n", baseline_engine_name);
+        return 1;
+    }
+
+    /* the baseline record is read before anything runs, a bad path fails fast */
+    static record_t baseline_record;
+    if (compare_to && record_load(compare_to, &baseline_record) != 0) return 1;
+    if (num_trials == 0) num_trials = compare_to ? 5 : 1;
+    if (num_trials > 1 && config.phase == BENCH_PHASE_LOAD)
+    {
+        fprintf(stderr, "Error: --trials repeats the measured phase, --phase load has none\n");
+        return 1;
+    }
+    if (compare_to && strcmp(baseline_record.engine, config.engine_name) != 0)
+    {
+        fprintf(stderr, "Warning: %s was recorded with %s, this run uses %s\n", compare_to,
+                baseline_record.engine, config.engine_name);
+    }
+    config.keep_histograms = results_json != NULL;
+
+    if (config.phase == BENCH_PHASE_RUN && !config.snapshot_dir && !dataset_is_loaded(&config))
+    {
+        fprintf(stderr, "Error: --phase run needs a db loaded with --phase load or a --snapshot\n");
+        return 1;
+    }
+
+    /* the snapshot directory is replaced after the load, we refuse one that is not ours first */
+    if (config.snapshot_dir && config.phase != BENCH_PHASE_RUN && dataset_check_snapshot(&config))
     {
-        fprintf(stderr, "Error: All numeric parameters must be positive\n");
         return 1;
     }
 
@@ -663,7 +1408,54 @@ int main(int argc, char **argv)
     printf("  Operations: %" PRId64 "\n", config.num_operations);
     printf("  Key Size: %d bytes\n", config.key_size);
     printf("  Value Size: %d bytes\n", config.value_size);
+    if (config.value_dist != VALUE_DIST_FIXED)
+    {
+        size_t min_size, max_size;
+        value_pool_bounds(&config, &min_size, &max_size);
+        printf("  Value Sizes: %s, %zu-%zu bytes\n", value_dist_name(config.value_dist), min_size,
+               max_size);
+    }
+    printf("  Compression Ratio: %.2f\n", config.compression_ratio);
+    printf("  Timer: %s (%.0f ns per read)\n", timing_source_name(config.timer),
+           timing_clock.read_ns);
+    if (config.latency_sample > 1)
+    {
+        printf("  Latency Sampling: 1 in %d ops\n", config.latency_sample);
+    }
+    if (config.duration_sec > 0.0)
+    {
+        printf("  Duration: %.0f s per measured phase\n", config.duration_sec);
+    }
+    if (config.warmup_sec > 0.0) printf("  Warmup: %.0f s\n", config.warmup_sec);
     printf("  Threads: %d\n", config.num_threads);
+    if (config.cpu_affinity != AFFINITY_NONE)
+    {
+        printf("  CPU Affinity: %s\n", config.cpu_affinity == AFFINITY_LIST
+                                           ? config.cpu_list
+                                           : affinity_to_string(config.cpu_affinity));
+    }
+    if (config.thread_sweep_count > 0)
+    {
+        printf("  Thread Sweep:");
+        for (int i = 0; i < config.thread_sweep_count; i++)
+        {
+            printf("%s%d", i ? "," : " ", config.thread_sweep[i]);
+        }
+        printf("\n");
+    }
+    if (config.cache_sweep_count > 0)
+    {
+        printf("  Cache Sweep:");
+        for (int i = 0; i < config.cache_sweep_count; i++)
+        {
+            printf("%s%g", i ? "," : " ", config.cache_sweep[i]);
+        }
+        if (config.cgroup_headroom > 0)
+            printf(" of the dataset, cgroup capped at cache + %zu bytes\n",
+                   config.cgroup_headroom);
+        else
+            printf(" of the dataset\n");
+    }
     printf("  Batch Size: %d\n", config.batch_size);
     if (config.test_name)
     {
@@ -690,56 +1482,225 @@ int main(int argc, char **argv)
         case KEY_PATTERN_REVERSE:
             pattern_name = "Reverse Sequential";
             break;
+        case KEY_PATTERN_SCRAMBLED_ZIPFIAN:
+            pattern_name = "Scrambled Zipfian (scattered hot keys)";
+            break;
+        case KEY_PATTERN_LATEST:
+            pattern_name = "Latest (recent keys)";
+            break;
+        case KEY_PATTERN_HOTSPOT:
+            pattern_name = "Hotspot";
+            break;
         default:
             pattern_name = "Unknown";
             break;
     }
     printf("  Key Pattern: %s\n", pattern_name);
-    printf("  Workload: %s\n", config.workload_type == WORKLOAD_WRITE    ? "Write-only"
-                               : config.workload_type == WORKLOAD_READ   ? "Read-only"
-                               : config.workload_type == WORKLOAD_DELETE ? "Delete-only"
-                               : config.workload_type == WORKLOAD_SEEK   ? "Seek"
-                               : config.workload_type == WORKLOAD_RANGE  ? "Range Query"
-                                                                         : "Mixed");
+    if (config.key_pattern == KEY_PATTERN_ZIPFIAN ||
+        config.key_pattern == KEY_PATTERN_SCRAMBLED_ZIPFIAN ||
+        config.key_pattern == KEY_PATTERN_LATEST)
+    {
+        printf("  Zipf Theta: %.2f\n", config.zipf_theta);
+    }
+    else if (config.key_pattern == KEY_PATTERN_HOTSPOT)
+    {
+        printf("  Hotspot: %.0f%% of ops on %.0f%% of keys\n", config.hotspot_op_fraction * 100.0,
+               config.hotspot_key_fraction * 100.0);
+    }
+    printf("  Workload: %s\n", config.workload_type == WORKLOAD_WRITE      ? "Write-only"
+                               : config.workload_type == WORKLOAD_READ     ? "Read-only"
+                               : config.workload_type == WORKLOAD_DELETE   ? "Delete-only"
+                               : config.workload_type == WORKLOAD_SEEK     ? "Seek"
+                               : config.workload_type == WORKLOAD_RANGE    ? "Range Query"
+                               : config.workload_type == WORKLOAD_MULTIGET ? "Multi-Get"
+                               : config.workload_type == WORKLOAD_INGEST   ? "PUT vs Bulk Ingest"
+                               : config.workload_type == WORKLOAD_REPLAY   ? "Trace Replay"
+                               : config.workload_type == WORKLOAD_RECOVERY ? "Crash Recovery"
+                               : config.workload_type == WORKLOAD_SCAN     ? "Bounded Scan"
+                                                                           : "Mixed");
+    if (config.workload_type == WORKLOAD_REPLAY)
+    {
+        printf("  Trace: %s", config.trace_file);
+        if (config.replay_speed > 0.0)
+            printf(" (%.2fx original timing)", config.replay_speed);
+        else
+            printf(" (as fast as possible)");
+        printf("%s\n", config.trace_preload ? ", preloaded" : "");
+    }
+    if (config.workload_type == WORKLOAD_MULTIGET)
+    {
+        printf("  Multi-Get Batch: %d keys\n", config.batch_size > 1 ? config.batch_size : 1);
+    }
+    if (config.workload_type == WORKLOAD_SCAN)
+    {
+        printf("  Scans: ");
+        if (config.scan_prefix_keys > 0)
+            printf("prefixes of at least %" PRId64 " keys", config.scan_prefix_keys);
+        else if (config.scan_min == config.scan_max)
+            printf("%d keys", config.scan_min);
+        else
+            printf("%d-%d keys", config.scan_min, config.scan_max);
+        printf(", %s, %s\n",
+               config.scan_direction == SCAN_FORWARD   ? "forward"
+               : config.scan_direction == SCAN_REVERSE ? "reverse"
+                                                       : "forward and reverse",
+               config.scan_unbounded ? "seek and count" : "iterator bounds");
+    }
+    if (config.scan_readahead > 0)
+    {
+        printf("  Iterator Readahead: %zu bytes\n", config.scan_readahead);
+    }
+    if (config.iter_ranges > 1)
+    {
+        printf("  Parallel ITER: %d ranges on %d threads, %s split keys\n", config.iter_ranges,
+               config.num_threads, config.iter_splits == ITER_SPLITS_SAMPLE ? "sampled" : "auto");
+    }
+    if (config.mix_spec)
+    {
+        printf("  Mix: %s%s\n", config.mix_spec,
+               config.workload_type == WORKLOAD_MIXED ? "" : " (ignored, needs -w mixed)");
+    }
+    if (config.target_rate > 0.0)
+    {
+        printf("  Target Rate: %.0f ops/sec (%s arrivals)\n", config.target_rate,
+               config.arrival == ARRIVAL_POISSON ? "poisson" : "fixed");
+    }
     printf("  Sync Mode: %s\n", config.sync_enabled ? "Enabled (durable)" : "Disabled (fast)");
+    if (config.phase != BENCH_PHASE_ALL || config.reuse_db)
+    {
+        printf("  Phase: %s%s\n",
+               config.phase == BENCH_PHASE_LOAD  ? "load"
+               : config.phase == BENCH_PHASE_RUN ? "run"
+                                                 : "all",
+               config.reuse_db ? " (reusing loaded db)" : "");
+    }
+    if (config.compact_after_load) printf("  Compact After Load: Enabled\n");
+    if (config.engine_stats) printf("  Engine Statistics: Enabled\n");
+    if (config.perf_counters) printf("  Perf Counters: Enabled\n");
+    if (config.profile_cmd)
+    {
+        printf("  Profile Command: %s (%s)\n", config.profile_cmd,
+               config.profile_phase ? config.profile_phase : "every phase");
+    }
+    if (config.object_store_backend && strcmp(config.object_store_backend, "none") != 0)
+    {
+        printf("  Object Store: %s, cache %s%s", config.object_store_backend,
+               config.object_local_cache_path ? config.object_local_cache_path : config.db_path,
+               config.object_cold_cache ? " (evicted before the reads)" : "");
+        if (config.object_latency_us > 0)
+        {
+            printf(", +%" PRIu64 " μs per request", config.object_latency_us);
+        }
+        printf("\n");
+    }
+    if (config.queue_depth > 1)
+    {
+        const storage_engine_ops_t *queue_ops = get_engine_ops(config.engine_name);
+        printf("  Queue Depth: %d per thread (GET: %s, PUT: helper threads)\n", config.queue_depth,
+               queue_ops ? asyncq_mode(queue_ops, ASYNCQ_GET) : "helper threads");
+    }
+    if (config.num_column_families > 1)
+    {
+        printf("  Column Families: %d (profile %s)\n", config.num_column_families,
+               config.cf_profile ? config.cf_profile : "uniform");
+    }
+    if (config.workload_type == WORKLOAD_RECOVERY)
+    {
+        printf("  Recovery: one writer killed with SIGKILL after %" PRId64 " keys, ",
+               config.num_operations);
+        if (config.recovery_unflushed >= 0)
+            printf("%" PRId64 " written after a flush\n", config.recovery_unflushed);
+        else
+            printf("none flushed\n");
+    }
+    if (config.mem_interval_ms > 0)
+    {
+        printf("  Memory Sampling: every %d ms%s%s\n", config.mem_interval_ms,
+               config.mem_timeline_file ? ", timeline " : "",
+               config.mem_timeline_file ? config.mem_timeline_file : "");
+    }
+    if (config.snapshot_dir)
+    {
+        static const char *snapshot_modes[] = {"reflink", "hardlink", "copy"};
+        printf("  Snapshot: %s (%s)\n", config.snapshot_dir, snapshot_modes[config.snapshot_mode]);
+    }
+    if (config.zero_copy_reads)
+    {
+        const storage_engine_ops_t *read_ops = get_engine_ops(config.engine_name);
+        printf("  Zero-Copy Reads: %s\n",
+               read_ops && read_ops->get_pinned ? "Enabled (pinned)"
+                                                : "Not supported by engine, using copying get");
+    }
     printf("\n");
 
-    benchmark_results_t *results = NULL;
+    benchmark_results_t *trials[RECORD_MAX_TRIALS] = {NULL};
     benchmark_results_t *baseline_results = NULL;
 
-    if (run_benchmark(&config, &results) != 0)
+    for (int t = 0; t < num_trials; t++)
     {
-        fprintf(stderr, "Benchmark failed\n");
-        return 1;
+        /* every trial starts from an empty database unless the dataset is meant to persist */
+        if (t > 0)
+        {
+            printf("\n=== Trial %d of %d ===\n\n", t + 1, num_trials);
+            if (!config.reuse_db && config.phase == BENCH_PHASE_ALL &&
+                dataset_remove(config.db_path) != 0)
+            {
+                fprintf(stderr, "Warning: Failed to clean database path for trial %d\n", t + 1);
+            }
+        }
+        if (run_benchmark(&config, &trials[t]) != 0)
+        {
+            fprintf(stderr, "Benchmark failed\n");
+            for (int i = 0; i < t; i++) free_results(trials[i]);
+            return 1;
+        }
     }
+    benchmark_results_t *results = trials[0];
 
     if (config.compare_mode)
     {
-        const char *baseline_engine = NULL;
-        if (strcmp(config.engine_name, "rocksdb") == 0)
+        /* --baseline-engine picks any engine, a plugin build of the same engine makes an A/B of
+         * two versions on the same key and value streams */
+        const char *baseline_engine = baseline_engine_name;
+        if (!baseline_engine && strcmp(config.engine_name, "rocksdb") == 0)
         {
             baseline_engine = "tidesdb";
         }
-        else if (strcmp(config.engine_name, "tidesdb") == 0)
+        else if (!baseline_engine && strcmp(config.engine_name, "tidesdb") == 0)
         {
             baseline_engine = "rocksdb";
         }
 
         if (baseline_engine)
         {
-            printf("\n=== Cleaning database for baseline comparison ===\n");
+            benchmark_config_t baseline_config = config;
+            baseline_config.engine_name = baseline_engine;
 
-            char rm_cmd[2048];
-            snprintf(rm_cmd, sizeof(rm_cmd), "rm -rf %s", config.db_path);
-            int rm_result = system(rm_cmd);
-            if (rm_result != 0)
+            /* a reused or snapshotted dataset belongs to one engine, the baseline keeps its own */
+            static char baseline_db_path[1024];
+            static char baseline_snapshot[1024];
+            if (config.reuse_db || config.phase != BENCH_PHASE_ALL)
             {
-                fprintf(stderr, "Warning: Failed to clean database path for baseline\n");
+                snprintf(baseline_db_path, sizeof(baseline_db_path), "%s_%s", config.db_path,
+                         baseline_engine);
+                baseline_config.db_path = baseline_db_path;
+                if (config.snapshot_dir)
+                {
+                    snprintf(baseline_snapshot, sizeof(baseline_snapshot), "%s_%s",
+                             config.snapshot_dir, baseline_engine);
+                    baseline_config.snapshot_dir = baseline_snapshot;
+                }
+            }
+            else
+            {
+                printf("\n=== Cleaning database for baseline comparison ===\n");
+                if (dataset_remove(config.db_path) != 0)
+                {
+                    fprintf(stderr, "Warning: Failed to clean database path for baseline\n");
+                }
             }
 
             printf("\n=== Running %s Baseline ===\n\n", baseline_engine);
-            benchmark_config_t baseline_config = config;
-            baseline_config.engine_name = baseline_engine;
 
             if (run_benchmark(&baseline_config, &baseline_results) != 0)
             {
@@ -772,39 +1733,55 @@ int main(int argc, char **argv)
 
     if (config.csv_file)
     {
-        /* we need to check if CSV file is empty to determine if we need to write header */
-        int write_header = 0;
-        FILE *check_fp = fopen(config.csv_file, "r");
-        if (check_fp)
+        int write_header = csv_needs_header(config.csv_file);
+        FILE *csv_fp = fopen(config.csv_file, "a");
+        if (csv_fp)
         {
-            fseek(check_fp, 0, SEEK_END);
-            if (ftell(check_fp) == 0)
+            for (int t = 0; t < num_trials; t++)
             {
-                write_header = 1;
+                generate_csv(csv_fp, trials[t], t == 0 ? baseline_results : NULL,
+                             write_header && t == 0);
             }
-            fclose(check_fp);
+            fclose(csv_fp);
+            printf("CSV exported to: %s\n", config.csv_file);
         }
         else
         {
-            /* file doesnt exist yet, we need to write header */
-            write_header = 1;
+            fprintf(stderr, "Failed to open CSV file: %s\n", config.csv_file);
         }
+    }
 
-        FILE *csv_fp = fopen(config.csv_file, "a");
+    if (config.sweep_csv_file && (results->sweep_count > 0 || results->cache_sweep_count > 0))
+    {
+        int write_header = csv_needs_header(config.sweep_csv_file);
+        FILE *csv_fp = fopen(config.sweep_csv_file, "a");
         if (csv_fp)
         {
-            generate_csv(csv_fp, results, baseline_results, write_header);
+            generate_sweep_csv(csv_fp, results, baseline_results, write_header);
             fclose(csv_fp);
-            printf("CSV exported to: %s\n", config.csv_file);
+            printf("Sweep CSV exported to: %s\n", config.sweep_csv_file);
         }
         else
         {
-            fprintf(stderr, "Failed to open CSV file: %s\n", config.csv_file);
+            fprintf(stderr, "Failed to open CSV file: %s\n", config.sweep_csv_file);
         }
     }
 
-    free_results(results);
+    if (results_json && record_write(results_json, trials, num_trials) == 0)
+    {
+        printf("Results record written to: %s\n", results_json);
+    }
+
+    int regressions = 0;
+    if (compare_to)
+    {
+        regressions = record_compare(stdout, &baseline_record, trials, num_trials,
+                                     regress_threshold, alpha);
+    }
+
+    for (int t = 0; t < num_trials; t++) free_results(trials[t]);
     if (baseline_results) free_results(baseline_results);
 
-    return 0;
+    /* a regression fails the run so CI can gate on the exit code */
+    return regressions > 0 ? 2 : 0;
 }
@@ -0,0 +1,754 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "matrix.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataset.h"
+
+/* summed up values of a cell's trials, one per metric */
+#define MATRIX_METRICS 16
+
+#define METRIC_OPS 0 /* ops_per_sec */
+#define METRIC_P99 6 /* p99_us */
+
+static const char *metric_names[MATRIX_METRICS] = {
+    "ops_per_sec", "duration_sec", "avg_latency_us", "cv_percent", "p50_us",
+    "p95_us", "p99_us", "p999_us", "max_us", "peak_rss_mb", "disk_write_mb",
+    "cpu_percent", "db_size_mb", "write_amp", "read_amp", "space_amp"};
+
+/* two-sided 95% quantiles of Student's t for 1 to 30 degrees of freedom */
+static const double t95[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                               2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                               2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                               2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+
+typedef enum
+{
+    KNOB_INT,
+    KNOB_INT64,
+    KNOB_SIZE, /* bytes, with an optional K, M or G suffix */
+    KNOB_DOUBLE,
+    KNOB_STRING
+} knob_type_t;
+
+/* the settings a knob set can carry, named after their long options */
+static const struct
+{
+    const char *name;
+    knob_type_t type;
+    size_t offset;
+} knob_fields[] = {
+    {"operations", KNOB_INT64, offsetof(benchmark_config_t, num_operations)},
+    {"key-size", KNOB_INT, offsetof(benchmark_config_t, key_size)},
+    {"batch-size", KNOB_INT, offsetof(benchmark_config_t, batch_size)},
+    {"range-size", KNOB_INT, offsetof(benchmark_config_t, range_size)},
+    {"sync", KNOB_INT, offsetof(benchmark_config_t, sync_enabled)},
+    {"queue-depth", KNOB_INT, offsetof(benchmark_config_t, queue_depth)},
+    {"compact-after-load", KNOB_INT, offsetof(benchmark_config_t, compact_after_load)},
+    {"compression-ratio", KNOB_DOUBLE, offsetof(benchmark_config_t, compression_ratio)},
+    {"memtable-size", KNOB_SIZE, offsetof(benchmark_config_t, memtable_size)},
+    {"block-cache-size", KNOB_SIZE, offsetof(benchmark_config_t, block_cache_size)},
+    {"rocksdb-blobdb", KNOB_INT, offsetof(benchmark_config_t, enable_blobdb)},
+    {"bloom-filters", KNOB_INT, offsetof(benchmark_config_t, enable_bloom_filter)},
+    {"block-indexes", KNOB_INT, offsetof(benchmark_config_t, enable_block_indexes)},
+    {"bloom-fpr", KNOB_DOUBLE, offsetof(benchmark_config_t, bloom_fpr)},
+    {"use-btree", KNOB_INT, offsetof(benchmark_config_t, use_btree)},
+    {"num-flush-threads", KNOB_INT, offsetof(benchmark_config_t, num_flush_threads)},
+    {"num-compaction-threads", KNOB_INT, offsetof(benchmark_config_t, num_compaction_threads)},
+    {"max-open-sstables", KNOB_SIZE, offsetof(benchmark_config_t, max_open_sstables)},
+    {"max-memory-usage", KNOB_SIZE, offsetof(benchmark_config_t, max_memory_usage)},
+    {"compression", KNOB_STRING, offsetof(benchmark_config_t, compression_algorithm)},
+    {"skip-list-max-level", KNOB_INT, offsetof(benchmark_config_t, skip_list_max_level)},
+    {"level-size-ratio", KNOB_SIZE, offsetof(benchmark_config_t, level_size_ratio)},
+    {"sync-mode", KNOB_STRING, offsetof(benchmark_config_t, sync_mode)},
+    {"unified-memtable", KNOB_INT, offsetof(benchmark_config_t, unified_memtable)},
+    {"unified-memtable-size", KNOB_SIZE,
+     offsetof(benchmark_config_t, unified_memtable_write_buffer_size)},
+};
+
+#define KNOB_FIELD_COUNT (sizeof(knob_fields) / sizeof(knob_fields[0]))
+
+typedef struct
+{
+    double mean;
+    double stddev;
+    double ci95; /* half width of the interval around the mean */
+} matrix_summary_t;
+
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+/* names end up in test names, file names and JSON strings unquoted */
+static int valid_name(const char *s)
+{
+    if (!*s || strlen(s) >= MATRIX_NAME_SIZE) return 0;
+    for (; *s; s++)
+    {
+        if (!isalnum((unsigned char)*s) && *s != '_' && *s != '-' && *s != '.') return 0;
+    }
+    return 1;
+}
+
+/* splits a comma separated list in place, -1 when it has more than max entries or an empty one */
+static int split_list(char *s, char **items, int max)
+{
+    int n = 0;
+    char *save = NULL;
+    for (char *t = strtok_r(s, ",", &save); t; t = strtok_r(NULL, ",", &save))
+    {
+        if (n == max) return -1;
+        items[n] = trim(t);
+        if (!*items[n]) return -1;
+        n++;
+    }
+    return n;
+}
+
+static int parse_positive(const char *s, int *out)
+{
+    char *end = NULL;
+    long v = strtol(s, &end, 10);
+    if (end == s || *end || v <= 0 || v > 1 << 30) return -1;
+    *out = (int)v;
+    return 0;
+}
+
+static int parse_workload(const char *s, workload_type_t *out)
+{
+    for (int w = WORKLOAD_WRITE; w <= WORKLOAD_SCAN; w++)
+    {
+        if (strcmp(s, workload_to_string((workload_type_t)w)) == 0)
+        {
+            *out = (workload_type_t)w;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int matrix_apply_knob(const matrix_knob_t *knob, benchmark_config_t *config)
+{
+    for (int i = 0; i < knob->num_settings; i++)
+    {
+        size_t f = 0;
+        while (f < KNOB_FIELD_COUNT && strcmp(knob_fields[f].name, knob->keys[i]) != 0) f++;
+        if (f == KNOB_FIELD_COUNT)
+        {
+            fprintf(stderr, "Error: knob set %s: unknown option %s\n", knob->name, knob->keys[i]);
+            return -1;
+        }
+
+        const char *text = knob->values[i];
+        void *field = (char *)config + knob_fields[f].offset;
+        char *end = NULL;
+        int bad = 0;
+        if (knob_fields[f].type == KNOB_STRING)
+        {
+            *(const char **)field = text;
+            continue;
+        }
+
+        double v = strtod(text, &end);
+        bad = end == text || v < 0.0;
+        if (!bad && knob_fields[f].type == KNOB_SIZE && *end)
+        {
+            double scale = *end == 'K' ? 1024.0
+                           : *end == 'M' ? 1024.0 * 1024.0
+                           : *end == 'G' ? 1024.0 * 1024.0 * 1024.0
+                                         : 0.0;
+            bad = scale == 0.0 || end[1] != '\0';
+            v *= scale;
+        }
+        else if (!bad)
+        {
+            bad = *end != '\0';
+        }
+        if (!bad && knob_fields[f].type != KNOB_DOUBLE) bad = v != floor(v);
+        if (bad)
+        {
+            fprintf(stderr, "Error: knob set %s: invalid %s=%s\n", knob->name, knob->keys[i],
+                    text);
+            return -1;
+        }
+
+        switch (knob_fields[f].type)
+        {
+            case KNOB_INT:
+                *(int *)field = (int)v;
+                break;
+            case KNOB_INT64:
+                *(int64_t *)field = (int64_t)v;
+                break;
+            case KNOB_SIZE:
+                *(size_t *)field = (size_t)v;
+                break;
+            default:
+                *(double *)field = v;
+                break;
+        }
+    }
+    return 0;
+}
+
+/* "knob <name> = opt=value opt=value ..." */
+static int parse_knob(matrix_t *m, char *name, char *settings)
+{
+    if (m->num_knobs == MATRIX_MAX_KNOBS || !valid_name(name)) return -1;
+    for (int k = 0; k < m->num_knobs; k++)
+    {
+        if (strcmp(m->knobs[k].name, name) == 0) return -1;
+    }
+
+    matrix_knob_t *knob = &m->knobs[m->num_knobs];
+    memset(knob, 0, sizeof(*knob));
+    snprintf(knob->name, sizeof(knob->name), "%s", name);
+
+    char *save = NULL;
+    for (char *t = strtok_r(settings, " \t", &save); t; t = strtok_r(NULL, " \t", &save))
+    {
+        char *eq = strchr(t, '=');
+        if (!eq || eq == t || !eq[1] || knob->num_settings == MATRIX_MAX_SETTINGS) return -1;
+        *eq = '\0';
+        if (strlen(t) >= MATRIX_NAME_SIZE || strlen(eq + 1) >= MATRIX_NAME_SIZE) return -1;
+        snprintf(knob->keys[knob->num_settings], MATRIX_NAME_SIZE, "%s", t);
+        snprintf(knob->values[knob->num_settings], MATRIX_NAME_SIZE, "%s", eq + 1);
+        knob->num_settings++;
+    }
+    m->num_knobs++;
+    return 0;
+}
+
+static int parse_line(matrix_t *m, char *key, char *value)
+{
+    char *items[MATRIX_MAX_VALUES];
+    int n;
+
+    if (strncmp(key, "knob", 4) == 0 && isspace((unsigned char)key[4]))
+    {
+        return parse_knob(m, trim(key + 4), value);
+    }
+    if (strcmp(key, "trials") == 0)
+    {
+        return parse_positive(value, &m->trials) != 0 || m->trials > MATRIX_MAX_TRIALS ? -1 : 0;
+    }
+    if (strcmp(key, "name") == 0)
+    {
+        if (!valid_name(value)) return -1;
+        snprintf(m->name, sizeof(m->name), "%s", value);
+        return 0;
+    }
+    if (strcmp(key, "db") == 0 || strcmp(key, "csv") == 0 || strcmp(key, "json") == 0)
+    {
+        char *out = key[0] == 'd' ? m->db_path : key[0] == 'c' ? m->csv_file : m->json_file;
+        if (!*value || strlen(value) >= sizeof(m->db_path)) return -1;
+        snprintf(out, sizeof(m->db_path), "%s", value);
+        return 0;
+    }
+
+    n = split_list(value, items, MATRIX_MAX_VALUES);
+    if (n <= 0) return -1;
+    for (int i = 0; i < n; i++)
+    {
+        if (strcmp(key, "engines") == 0)
+        {
+            if (!valid_name(items[i]) || !get_engine_ops(items[i])) return -1;
+            snprintf(m->engines[i], MATRIX_NAME_SIZE, "%s", items[i]);
+        }
+        else if (strcmp(key, "workloads") == 0)
+        {
+            if (parse_workload(items[i], &m->workloads[i]) != 0) return -1;
+        }
+        else if (strcmp(key, "threads") == 0)
+        {
+            if (parse_positive(items[i], &m->threads[i]) != 0) return -1;
+        }
+        else if (strcmp(key, "value_sizes") == 0)
+        {
+            if (parse_positive(items[i], &m->value_sizes[i]) != 0) return -1;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    if (strcmp(key, "engines") == 0)
+        m->num_engines = n;
+    else if (strcmp(key, "workloads") == 0)
+        m->num_workloads = n;
+    else if (strcmp(key, "threads") == 0)
+        m->num_threads = n;
+    else
+        m->num_value_sizes = n;
+    return 0;
+}
+
+int matrix_load(const char *path, const benchmark_config_t *base, matrix_t *m)
+{
+    memset(m, 0, sizeof(*m));
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        fprintf(stderr, "Error: cannot open matrix file %s\n", path);
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0;
+    int line_no = 0, rc = 0;
+    while (getline(&line, &line_cap, fp) > 0)
+    {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *text = trim(line);
+        if (!*text) continue;
+
+        char *eq = strchr(text, '=');
+        if (eq) *eq = '\0';
+        if (!eq || parse_line(m, trim(text), trim(eq + 1)) != 0)
+        {
+            fprintf(stderr, "Error: %s:%d: invalid matrix line\n", path, line_no);
+            rc = -1;
+            break;
+        }
+    }
+    free(line);
+    fclose(fp);
+    if (rc != 0) return -1;
+
+    /* what the file leaves out comes from the command line */
+    if (m->num_engines == 0)
+    {
+        snprintf(m->engines[0], MATRIX_NAME_SIZE, "%s", base->engine_name);
+        m->num_engines = 1;
+    }
+    if (m->num_workloads == 0)
+    {
+        m->workloads[0] = base->workload_type;
+        m->num_workloads = 1;
+    }
+    if (m->num_threads == 0)
+    {
+        m->threads[0] = base->num_threads;
+        m->num_threads = 1;
+    }
+    if (m->num_value_sizes == 0)
+    {
+        m->value_sizes[0] = base->value_size;
+        m->num_value_sizes = 1;
+    }
+    if (m->num_knobs == 0)
+    {
+        snprintf(m->knobs[0].name, MATRIX_NAME_SIZE, "default");
+        m->num_knobs = 1;
+    }
+    if (m->trials == 0) m->trials = 1;
+    if (!m->db_path[0]) snprintf(m->db_path, sizeof(m->db_path), "%s", base->db_path);
+
+    for (int k = 0; k < m->num_knobs; k++)
+    {
+        benchmark_config_t check = *base;
+        if (matrix_apply_knob(&m->knobs[k], &check) != 0) return -1;
+        if (check.num_operations <= 0 || check.key_size <= 0 || check.batch_size <= 0 ||
+            check.queue_depth <= 0 || check.compression_ratio <= 0.0 ||
+            check.compression_ratio > 1.0)
+        {
+            fprintf(stderr, "Error: knob set %s: sizes and counts must be positive\n",
+                    m->knobs[k].name);
+            return -1;
+        }
+    }
+    for (int w = 0; w < m->num_workloads; w++)
+    {
+        if (m->workloads[w] == WORKLOAD_REPLAY && !base->trace_file)
+        {
+            fprintf(stderr, "Error: a matrix with the replay workload needs --trace\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void summarize(const double *v, int n, matrix_summary_t *s)
+{
+    s->mean = 0.0;
+    s->stddev = 0.0;
+    s->ci95 = 0.0;
+    if (n == 0) return;
+
+    for (int i = 0; i < n; i++) s->mean += v[i];
+    s->mean /= n;
+    if (n < 2) return;
+
+    double sq = 0.0;
+    for (int i = 0; i < n; i++) sq += (v[i] - s->mean) * (v[i] - s->mean);
+    s->stddev = sqrt(sq / (n - 1));
+    double t = n - 1 <= 30 ? t95[n - 2] : 1.96;
+    s->ci95 = t * s->stddev / sqrt((double)n);
+}
+
+/* the metrics of one op of one trial, in metric_names order */
+static void metric_values(const benchmark_results_t *r, const operation_stats_t *st, double *v)
+{
+    const double mb = 1024.0 * 1024.0;
+    v[0] = st->ops_per_second;
+    v[1] = st->duration_seconds;
+    v[2] = st->avg_latency_us;
+    v[3] = st->cv_percent;
+    v[4] = st->p50_latency_us;
+    v[5] = st->p95_latency_us;
+    v[6] = st->p99_latency_us;
+    v[7] = st->p999_latency_us;
+    v[8] = st->max_latency_us;
+    v[9] = r->resources.peak_rss_bytes / mb;
+    v[10] = r->resources.bytes_written / mb;
+    v[11] = r->resources.cpu_percent;
+    v[12] = r->resources.storage_size_bytes / mb;
+    v[13] = r->resources.write_amplification;
+    v[14] = r->resources.read_amplification;
+    v[15] = r->resources.space_amplification;
+}
+
+static const operation_stats_t *find_op(const benchmark_results_t *r, const char *name)
+{
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int n = results_ops(r, ops);
+    for (int i = 0; i < n; i++)
+    {
+        if (strcmp(ops[i].name, name) == 0) return ops[i].stats;
+    }
+    return NULL;
+}
+
+static void write_csv_header(FILE *fp)
+{
+    fprintf(fp, "engine,test_name,operation,workload,threads,value_size,knob,trials");
+    for (int i = 0; i < MATRIX_METRICS; i++)
+    {
+        fprintf(fp, ",%s,%s_stddev,%s_ci95", metric_names[i], metric_names[i], metric_names[i]);
+    }
+    fprintf(fp, "\n");
+}
+
+/* one cell of the matrix, the values every dimension took */
+typedef struct
+{
+    const benchmark_config_t *config;
+    const matrix_knob_t *knob;
+    int shared_db;
+    benchmark_results_t *trials[MATRIX_MAX_TRIALS];
+    int num_trials;
+} matrix_cell_t;
+
+/* one metric of an op over the trials that ran it, returns how many did */
+static int op_values(const matrix_cell_t *c, const char *op, int metric, double *v)
+{
+    int n = 0;
+    for (int t = 0; t < c->num_trials; t++)
+    {
+        const operation_stats_t *st = find_op(c->trials[t], op);
+        if (!st) continue;
+        double all[MATRIX_METRICS];
+        metric_values(c->trials[t], st, all);
+        v[n++] = all[metric];
+    }
+    return n;
+}
+
+static void write_json_cell(FILE *fp, const matrix_cell_t *c, int first)
+{
+    const benchmark_config_t *cfg = c->config;
+    fprintf(fp,
+            "%s\n    {\"engine\": \"%s\", \"version\": \"%s\", \"test_name\": \"%s\", "
+            "\"workload\": \"%s\", \"threads\": %d, \"value_size\": %d, \"knob\": \"%s\", "
+            "\"settings\": {",
+            first ? "" : ",", cfg->engine_name, get_engine_version(cfg->engine_name),
+            cfg->test_name, workload_to_string(cfg->workload_type), cfg->num_threads,
+            cfg->value_size, c->knob->name);
+    for (int i = 0; i < c->knob->num_settings; i++)
+    {
+        fprintf(fp, "%s\"%s\": \"%s\"", i ? ", " : "", c->knob->keys[i], c->knob->values[i]);
+    }
+    fprintf(fp, "}, \"dataset\": \"%s\", \"trials\": %d, \"ops\": [",
+            c->shared_db ? "shared" : "fresh", c->num_trials);
+
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int num_ops = c->num_trials > 0 ? results_ops(c->trials[0], ops) : 0;
+    for (int o = 0; o < num_ops; o++)
+    {
+        fprintf(fp, "%s\n      {\"operation\": \"%s\"", o ? "," : "", ops[o].name);
+        for (int m = 0; m < MATRIX_METRICS; m++)
+        {
+            double v[MATRIX_MAX_TRIALS];
+            int n = op_values(c, ops[o].name, m, v);
+            matrix_summary_t s;
+            summarize(v, n, &s);
+            fprintf(fp,
+                    ", \"%s\": {\"mean\": %.4f, \"stddev\": %.4f, \"ci95\": %.4f, "
+                    "\"trials\": [",
+                    metric_names[m], s.mean, s.stddev, s.ci95);
+            for (int i = 0; i < n; i++) fprintf(fp, "%s%.4f", i ? ", " : "", v[i]);
+            fprintf(fp, "]}");
+        }
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "%s]}", num_ops > 0 ? "\n    " : "");
+}
+
+/* writes the cell's CSV rows and prints its summary */
+static void write_cell(FILE *csv, const matrix_cell_t *c)
+{
+    const benchmark_config_t *cfg = c->config;
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int num_ops = c->num_trials > 0 ? results_ops(c->trials[0], ops) : 0;
+
+    for (int o = 0; o < num_ops; o++)
+    {
+        matrix_summary_t s[MATRIX_METRICS];
+        int n = 0;
+        for (int m = 0; m < MATRIX_METRICS; m++)
+        {
+            double v[MATRIX_MAX_TRIALS];
+            n = op_values(c, ops[o].name, m, v);
+            summarize(v, n, &s[m]);
+        }
+
+        const matrix_summary_t *ops_s = &s[METRIC_OPS];
+        const matrix_summary_t *p99_s = &s[METRIC_P99];
+        double ops_ci = ops_s->mean > 0.0 ? 100.0 * ops_s->ci95 / ops_s->mean : 0.0;
+        double p99_ci = p99_s->mean > 0.0 ? 100.0 * p99_s->ci95 / p99_s->mean : 0.0;
+        printf("  %-10s %12.0f ops/sec +/- %.1f%%, p99 %.2f μs +/- %.1f%% over %d trial%s\n",
+               ops[o].name, ops_s->mean, ops_ci, p99_s->mean, p99_ci, n, n == 1 ? "" : "s");
+        if (!csv) continue;
+
+        fprintf(csv, "%s,%s,%s,%s,%d,%d,%s,%d", cfg->engine_name, cfg->test_name, ops[o].name,
+                workload_to_string(cfg->workload_type), cfg->num_threads, cfg->value_size,
+                c->knob->name, n);
+        for (int m = 0; m < MATRIX_METRICS; m++)
+        {
+            fprintf(csv, ",%.4f,%.4f,%.4f", s[m].mean, s[m].stddev, s[m].ci95);
+        }
+        fprintf(csv, "\n");
+    }
+}
+
+/**
+ * run_cell
+ * runs the trials of one cell
+ * @param config the cell's config, db_path and reuse_db are set here
+ * @param shared database of the cell's engine, value size and knob set
+ * @param fresh database of cells that write their own data
+ * @return 0 when every trial ran, -1 otherwise
+ */
+static int run_cell(const matrix_t *m, benchmark_config_t *config, const matrix_knob_t *knob,
+                    const char *shared, const char *fresh, int index, int total, FILE *csv,
+                    FILE *json, int first)
+{
+    matrix_cell_t cell = {.config = config, .knob = knob};
+    cell.shared_db = workload_needs_dataset(config);
+    config->db_path = cell.shared_db ? shared : fresh;
+    config->reuse_db = cell.shared_db;
+
+    int rc = 0;
+    for (int t = 0; t < m->trials; t++)
+    {
+        printf("\n=== Matrix cell %d/%d: %s %s, trial %d/%d ===\n\n", index, total,
+               config->engine_name, config->test_name, t + 1, m->trials);
+        if (!cell.shared_db)
+        {
+            dataset_forget(config);
+            dataset_remove(fresh);
+        }
+
+        /* run_benchmark may rewrite its config (a replay's op count) */
+        benchmark_config_t trial_config = *config;
+        if (run_benchmark(&trial_config, &cell.trials[cell.num_trials]) != 0)
+        {
+            fprintf(stderr, "Matrix cell %s on %s failed in trial %d\n", config->test_name,
+                    config->engine_name, t + 1);
+            rc = -1;
+            break;
+        }
+        cell.num_trials++;
+    }
+    if (!cell.shared_db) dataset_remove(fresh);
+
+    printf("\n=== Matrix cell %d/%d: %s %s ===\n", index, total, config->engine_name,
+           config->test_name);
+    write_cell(csv, &cell);
+    if (json) write_json_cell(json, &cell, first);
+
+    for (int t = 0; t < cell.num_trials; t++) free_results(cell.trials[t]);
+    return rc;
+}
+
+/* the config of the cell at engine e, value size v, knob set k, workload w and thread count t */
+static void cell_config(const matrix_t *m, const benchmark_config_t *base, int e, int v, int k,
+                        int w, int t, benchmark_config_t *config)
+{
+    *config = *base;
+    config->engine_name = m->engines[e];
+    config->value_size = m->value_sizes[v];
+    config->workload_type = m->workloads[w];
+    config->num_threads = m->threads[t];
+    config->compare_mode = 0;
+    config->snapshot_dir = NULL;
+    matrix_apply_knob(&m->knobs[k], config);
+}
+
+/* a knob set can reach combinations the command line refuses, every cell is checked before the
+ * first one runs */
+static int validate_cells(const matrix_t *m, const benchmark_config_t *base)
+{
+    int rc = 0;
+    for (int e = 0; e < m->num_engines; e++)
+    {
+        for (int v = 0; v < m->num_value_sizes; v++)
+        {
+            for (int k = 0; k < m->num_knobs; k++)
+            {
+                for (int w = 0; w < m->num_workloads; w++)
+                {
+                    for (int t = 0; t < m->num_threads; t++)
+                    {
+                        benchmark_config_t config;
+                        cell_config(m, base, e, v, k, w, t, &config);
+                        if (config_validate(&config) == 0) continue;
+                        fprintf(stderr, "Error: matrix cell %s %s t%d v%d %s is not runnable\n",
+                                m->engines[e], workload_to_string(m->workloads[w]),
+                                m->threads[t], m->value_sizes[v], m->knobs[k].name);
+                        rc = -1;
+                    }
+                }
+            }
+        }
+    }
+    return rc;
+}
+
+int matrix_run(const matrix_t *m, const benchmark_config_t *base)
+{
+    if (validate_cells(m, base) != 0) return -1;
+
+    FILE *csv = NULL;
+    FILE *json = NULL;
+    if (m->csv_file[0] && !(csv = fopen(m->csv_file, "w")))
+    {
+        fprintf(stderr, "Failed to open CSV file: %s\n", m->csv_file);
+        return -1;
+    }
+    if (m->json_file[0] && !(json = fopen(m->json_file, "w")))
+    {
+        fprintf(stderr, "Failed to open JSON file: %s\n", m->json_file);
+        if (csv) fclose(csv);
+        return -1;
+    }
+    if (csv) write_csv_header(csv);
+    if (json) fprintf(json, "{\"trials\": %d, \"cells\": [", m->trials);
+
+    int total = m->num_engines * m->num_value_sizes * m->num_knobs * m->num_workloads *
+                m->num_threads;
+    int index = 0, rc = 0;
+    printf("=== Run Matrix: %d cells, %d trial%s each ===\n", total, m->trials,
+           m->trials == 1 ? "" : "s");
+
+    /* the dimensions that shape a dataset are the outer loops, so its cells run back to back */
+    for (int e = 0; e < m->num_engines; e++)
+    {
+        for (int v = 0; v < m->num_value_sizes; v++)
+        {
+            for (int k = 0; k < m->num_knobs; k++)
+            {
+                char shared[1100], fresh[1200];
+                snprintf(shared, sizeof(shared), "%s_%s_v%d_%s", m->db_path, m->engines[e],
+                         m->value_sizes[v], m->knobs[k].name);
+                snprintf(fresh, sizeof(fresh), "%s_scratch", shared);
+
+                /* a delete empties the shared dataset, those cells run after the others */
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    for (int w = 0; w < m->num_workloads; w++)
+                    {
+                        if ((m->workloads[w] == WORKLOAD_DELETE) != pass) continue;
+                        for (int t = 0; t < m->num_threads; t++)
+                        {
+                            benchmark_config_t config;
+                            cell_config(m, base, e, v, k, w, t, &config);
+
+                            char test_name[256];
+                            snprintf(test_name, sizeof(test_name), "%s%s%s_t%d_v%d%s%s",
+                                     m->name, m->name[0] ? "_" : "",
+                                     workload_to_string(config.workload_type), config.num_threads,
+                                     config.value_size, m->num_knobs > 1 ? "_" : "",
+                                     m->num_knobs > 1 ? m->knobs[k].name : "");
+                            config.test_name = test_name;
+
+                            index++;
+                            if (run_cell(m, &config, &m->knobs[k], shared, fresh, index, total,
+                                         csv, json, index == 1) != 0)
+                            {
+                                rc = -1;
+                            }
+                            if (csv) fflush(csv);
+                        }
+                    }
+                }
+
+                /* the shared dataset stays for a later --reuse-db run only when one was asked */
+                if (!base->reuse_db)
+                {
+                    benchmark_config_t done = *base;
+                    done.engine_name = m->engines[e];
+                    done.value_size = m->value_sizes[v];
+                    matrix_apply_knob(&m->knobs[k], &done);
+                    done.db_path = shared;
+                    dataset_forget(&done);
+                    dataset_remove(shared);
+                }
+            }
+        }
+    }
+
+    if (json)
+    {
+        fprintf(json, "\n]}\n");
+        if (fclose(json) != 0) rc = -1;
+        printf("JSON exported to: %s\n", m->json_file);
+    }
+    if (csv)
+    {
+        if (fclose(csv) != 0) rc = -1;
+        printf("CSV exported to: %s\n", m->csv_file);
+    }
+    return rc;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __MATRIX_H__
+#define __MATRIX_H__
+
+#include "benchmark.h"
+
+/*
+ * --matrix run files. a matrix crosses engines, workloads, thread counts, value sizes and named
+ * knob sets, and every cell of it runs in this process on top of the command line config, as
+ * many times as the matrix asks. the file is read line by line, '#' starts a comment:
+ *
+ *   engines = tidesdb, rocksdb, lmdb
+ *   workloads = write, read, seek
+ *   threads = 1, 8
+ *   value_sizes = 100, 4096
+ *   trials = 3
+ *   knob default =
+ *   knob small_cache = block-cache-size=64M bloom-filters=0
+ *   csv = matrix.csv
+ *   json = matrix.json
+ *
+ * a knob set is a list of option=value settings named after the long options they stand for.
+ * cells of workloads that read a loaded dataset share one database per engine, value size and
+ * knob set through the --reuse-db marker, so the dataset is loaded once and again only after a
+ * delete emptied it, the other cells start every trial from an empty database of their own.
+ * the trials of a cell are summed up per op as mean, standard deviation and the half width of
+ * a 95% confidence interval (Student's t), in one CSV row per cell and op that
+ * plot_tidesdb_rocksdb.py reads like a benchtool --csv file, and in a JSON document that keeps
+ * the value of every trial.
+ */
+#define MATRIX_MAX_VALUES   16  /* entries of one list */
+#define MATRIX_MAX_KNOBS    16  /* knob sets */
+#define MATRIX_MAX_SETTINGS 16  /* settings of one knob set */
+#define MATRIX_MAX_TRIALS   100 /* trials of one cell */
+#define MATRIX_NAME_SIZE    64
+
+typedef struct
+{
+    char name[MATRIX_NAME_SIZE];
+    char keys[MATRIX_MAX_SETTINGS][MATRIX_NAME_SIZE];
+    char values[MATRIX_MAX_SETTINGS][MATRIX_NAME_SIZE];
+    int num_settings;
+} matrix_knob_t;
+
+typedef struct
+{
+    char engines[MATRIX_MAX_VALUES][MATRIX_NAME_SIZE];
+    int num_engines;
+    workload_type_t workloads[MATRIX_MAX_VALUES];
+    int num_workloads;
+    int threads[MATRIX_MAX_VALUES];
+    int num_threads;
+    int value_sizes[MATRIX_MAX_VALUES];
+    int num_value_sizes;
+    matrix_knob_t knobs[MATRIX_MAX_KNOBS];
+    int num_knobs;
+    int trials;
+    char name[MATRIX_NAME_SIZE]; /* test name prefix, empty = none */
+    char db_path[1024];          /* base of the cell databases, empty = the config's db_path */
+    char csv_file[1024];         /* per op summary, empty = none */
+    char json_file[1024];        /* summary with every trial, empty = none */
+} matrix_t;
+
+/**
+ * matrix_load
+ * parses a matrix file. a list the file leaves out is taken from the config (-e, -w, -t, -v),
+ * the trial count defaults to 1 and a matrix without knob sets has one empty set named default
+ * @param path the matrix file
+ * @param base command line config, the knob sets are checked against it
+ * @param m the parsed matrix
+ * @return 0 on success, -1 on a malformed file or an engine that is not built in
+ */
+int matrix_load(const char *path, const benchmark_config_t *base, matrix_t *m);
+
+/**
+ * matrix_apply_knob
+ * applies the settings of a knob set, string values point into the knob set
+ * @param knob the knob set
+ * @param config config to change
+ * @return 0 on success, -1 on an unknown option or a malformed value
+ */
+int matrix_apply_knob(const matrix_knob_t *knob, benchmark_config_t *config);
+
+/**
+ * matrix_run
+ * runs every cell of the matrix and writes its summaries. nothing runs unless every cell passes
+ * config_validate
+ * @param m a matrix from matrix_load
+ * @param base command line config every cell starts from
+ * @return 0 when every trial ran, -1 when a cell is invalid, a trial failed or a summary could
+ * not be written
+ */
+int matrix_run(const matrix_t *m, const benchmark_config_t *base);
+
+#endif /* __MATRIX_H__ */
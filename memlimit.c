@@ -0,0 +1,83 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "memlimit.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MEMLIMIT_CGROUP_ROOT "/sys/fs/cgroup"
+
+/* we replace the contents of a cgroup control file, the kernel takes the value in one write */
+static int write_control(const char *path, const char *value)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    int rc = fputs(value, fp) < 0 ? -1 : 0;
+    if (fclose(fp) != 0) rc = -1;
+    return rc;
+}
+
+int memlimit_open(memlimit_t *m)
+{
+    memset(m, 0, sizeof(*m));
+
+    /* cgroup v2 has a single hierarchy, listed as 0::<path> */
+    FILE *fp = fopen("/proc/self/cgroup", "r");
+    if (!fp) return -1;
+    char line[1024];
+    const char *rel = "";
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (strncmp(line, "0::", 3) != 0) continue;
+        /* a path longer than line would be read cut short, that is another cgroup's file */
+        if (!strchr(line, '\n') && !feof(fp)) break;
+        line[strcspn(line, "\n")] = '\0';
+        rel = line + 3;
+        break;
+    }
+    fclose(fp);
+    if (rel[0] != '/') return -1;
+
+    /* the root cgroup has no memory.max, a process there cannot be capped this way */
+    int n = snprintf(m->path, sizeof(m->path), "%s%s/memory.max", MEMLIMIT_CGROUP_ROOT,
+                     strcmp(rel, "/") == 0 ? "" : rel);
+    if (n < 0 || (size_t)n >= sizeof(m->path)) return -1;
+    fp = fopen(m->path, "r");
+    if (!fp) return -1;
+    if (!fgets(m->saved, sizeof(m->saved), fp)) m->saved[0] = '\0';
+    fclose(fp);
+    m->saved[strcspn(m->saved, "\n")] = '\0';
+    if (m->saved[0] == '\0') return -1;
+
+    /* writing the value back unchanged tells us whether we may write at all */
+    return write_control(m->path, m->saved);
+}
+
+int memlimit_set(memlimit_t *m, size_t bytes)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%" PRIu64, (uint64_t)bytes);
+    return write_control(m->path, value);
+}
+
+void memlimit_restore(memlimit_t *m)
+{
+    if (m->saved[0] && write_control(m->path, m->saved) != 0)
+    {
+        fprintf(stderr, "Warning: could not restore %s to %s\n", m->path, m->saved);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __MEMLIMIT_H__
+#define __MEMLIMIT_H__
+
+#include <stddef.h>
+
+/*
+ * cgroup v2 memory cap for the --cache-sweep points. the limit goes on the memory.max of the
+ * cgroup the process already runs in, which only works where that file is writable, e.g. in a
+ * container or under systemd-run --user --scope -p Delegate=yes. page cache is charged to the
+ * cgroup, so a cap at the block cache plus some headroom keeps the kernel from serving the
+ * misses of a small cache out of memory the cache was not given. lowering the limit below the
+ * current usage makes the kernel reclaim first, file pages before anything else.
+ */
+
+typedef struct
+{
+    char path[1024]; /* memory.max of the process's cgroup */
+    char saved[64];  /* its value when memlimit_open ran, written back by memlimit_restore */
+} memlimit_t;
+
+/**
+ * memlimit_open
+ * finds the process's cgroup v2 memory.max and checks it can be written
+ * @param m the limit
+ * @return 0 on success, -1 without cgroup v2, a memory controller or write access
+ */
+int memlimit_open(memlimit_t *m);
+
+/**
+ * memlimit_set
+ * @param m the limit
+ * @param bytes new memory.max of the cgroup
+ * @return 0 on success, -1 when the kernel refused the value
+ */
+int memlimit_set(memlimit_t *m, size_t bytes);
+
+/**
+ * memlimit_restore
+ * writes back the memory.max memlimit_open found
+ * @param m the limit
+ */
+void memlimit_restore(memlimit_t *m);
+
+#endif /* __MEMLIMIT_H__ */
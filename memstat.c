@@ -0,0 +1,363 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "memstat.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define MEMSTAT_HAVE_MALLINFO2 1
+#endif
+
+typedef int (*mallctl_fn)(const char *name, void *oldp, size_t *oldlenp, void *newp,
+                          size_t newlen);
+typedef int (*tc_property_fn)(const char *property, size_t *value);
+typedef void (*mi_process_info_fn)(size_t *elapsed_msecs, size_t *user_msecs,
+                                   size_t *system_msecs, size_t *current_rss, size_t *peak_rss,
+                                   size_t *current_commit, size_t *peak_commit,
+                                   size_t *page_faults);
+
+static atomic_int_fast64_t tracked_bytes = 0;
+static atomic_int_fast64_t tracked_peak = 0;
+
+static double monotonic_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int has_suffix(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+int memstat_read_proc(memstat_proc_t *p)
+{
+    memset(p, 0, sizeof(*p));
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp) return -1;
+
+    static const struct
+    {
+        const char *key;
+        size_t offset;
+    } lines[] = {
+        {"VmRSS:", offsetof(memstat_proc_t, rss)},
+        {"VmHWM:", offsetof(memstat_proc_t, hwm)},
+        {"RssAnon:", offsetof(memstat_proc_t, anon)},
+        {"RssFile:", offsetof(memstat_proc_t, file)},
+        {"VmSize:", offsetof(memstat_proc_t, vms)},
+    };
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp))
+    {
+        for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+        {
+            size_t n = strlen(lines[i].key);
+            if (strncmp(line, lines[i].key, n) != 0) continue;
+            size_t kb = 0;
+            sscanf(line + n, "%zu", &kb);
+            *(size_t *)((char *)p + lines[i].offset) = kb * 1024;
+            break;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static int64_t jemalloc_stat(mallctl_fn mallctl, const char *name)
+{
+    size_t value = 0, len = sizeof(value);
+    return mallctl(name, &value, &len, NULL, 0) == 0 ? (int64_t)value : -1;
+}
+
+static int64_t tcmalloc_stat(tc_property_fn property, const char *name)
+{
+    size_t value = 0;
+    return property(name, &value) ? (int64_t)value : -1;
+}
+
+int memstat_read_allocator(memstat_alloc_t *a)
+{
+    memset(a, 0, sizeof(*a));
+    a->allocated = a->active = a->resident = a->mapped = a->retained = -1;
+
+    /* jemalloc caches its statistics until the epoch is advanced, a build with a symbol prefix
+     * exports je_mallctl */
+    mallctl_fn mallctl = (mallctl_fn)dlsym(RTLD_DEFAULT, "mallctl");
+    if (!mallctl) mallctl = (mallctl_fn)dlsym(RTLD_DEFAULT, "je_mallctl");
+    if (mallctl)
+    {
+        uint64_t epoch = 1;
+        size_t len = sizeof(epoch);
+        if (mallctl("epoch", &epoch, &len, &epoch, sizeof(epoch)) == 0)
+        {
+            snprintf(a->name, sizeof(a->name), "jemalloc");
+            a->allocated = jemalloc_stat(mallctl, "stats.allocated");
+            a->active = jemalloc_stat(mallctl, "stats.active");
+            a->resident = jemalloc_stat(mallctl, "stats.resident");
+            a->mapped = jemalloc_stat(mallctl, "stats.mapped");
+            a->retained = jemalloc_stat(mallctl, "stats.retained");
+            return 0;
+        }
+    }
+
+    tc_property_fn property =
+        (tc_property_fn)dlsym(RTLD_DEFAULT, "MallocExtension_GetNumericProperty");
+    if (property)
+    {
+        int64_t heap = tcmalloc_stat(property, "generic.heap_size");
+        int64_t unmapped = tcmalloc_stat(property, "tcmalloc.pageheap_unmapped_bytes");
+        int64_t free_bytes = tcmalloc_stat(property, "tcmalloc.pageheap_free_bytes");
+        snprintf(a->name, sizeof(a->name), "tcmalloc");
+        a->allocated = tcmalloc_stat(property, "generic.current_allocated_bytes");
+        a->mapped = heap;
+        a->retained = unmapped;
+        if (heap >= 0 && unmapped >= 0)
+        {
+            a->resident = heap - unmapped;
+            if (free_bytes >= 0) a->active = heap - unmapped - free_bytes;
+        }
+        return 0;
+    }
+
+    /* mimalloc only reports what it has committed, not what is allocated out of it */
+    mi_process_info_fn process_info = (mi_process_info_fn)dlsym(RTLD_DEFAULT, "mi_process_info");
+    if (process_info)
+    {
+        size_t elapsed, user, sys, rss, peak_rss, commit = 0, peak_commit, faults;
+        process_info(&elapsed, &user, &sys, &rss, &peak_rss, &commit, &peak_commit, &faults);
+        snprintf(a->name, sizeof(a->name), "mimalloc");
+        a->mapped = (int64_t)commit;
+        return 0;
+    }
+
+#ifdef MEMSTAT_HAVE_MALLINFO2
+    /* arena bytes plus mmapped chunks, glibc has no notion of what of that is resident */
+    struct mallinfo2 mi = mallinfo2();
+    snprintf(a->name, sizeof(a->name), "glibc");
+    a->allocated = (int64_t)(mi.uordblks + mi.hblkhd);
+    a->mapped = (int64_t)(mi.arena + mi.hblkhd);
+    a->retained = (int64_t)mi.fordblks;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/* VmHWM falls back to the current resident set, Linux 4.0+ */
+static void memstat_reset_peak(void)
+{
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+    if (!fp) return;
+    fputs("5", fp);
+    fclose(fp);
+}
+
+void memstat_track(int64_t bytes)
+{
+    int64_t now = atomic_fetch_add(&tracked_bytes, bytes) + bytes;
+    int64_t peak = atomic_load(&tracked_peak);
+    while (now > peak && !atomic_compare_exchange_weak(&tracked_peak, &peak, now))
+    {
+    }
+}
+
+int64_t memstat_tracked(int64_t *peak)
+{
+    if (peak) *peak = atomic_load(&tracked_peak);
+    return atomic_load(&tracked_bytes);
+}
+
+static double to_mb(int64_t bytes)
+{
+    return bytes < 0 ? -1.0 : bytes / (1024.0 * 1024.0);
+}
+
+/* we read one sample, fold it into the peaks and write its timeline row */
+static void memstat_sample(memstat_sampler_t *s)
+{
+    memstat_proc_t p;
+    if (memstat_read_proc(&p) != 0) return;
+    memstat_alloc_t a;
+    memstat_read_allocator(&a);
+    int64_t bench = memstat_tracked(NULL);
+
+    pthread_mutex_lock(&s->lock);
+    double elapsed = monotonic_seconds() - s->start_sec;
+    const char *phase = s->phase ? s->phase : "";
+    s->samples++;
+    if (p.rss > s->peak_rss)
+    {
+        s->peak_rss = p.rss;
+        snprintf(s->peak_phase, sizeof(s->peak_phase), "%s", phase);
+    }
+    if (p.rss > s->phase_peak) s->phase_peak = p.rss;
+    if (a.allocated > s->peak_allocated) s->peak_allocated = a.allocated;
+
+    if (s->fp && s->json)
+    {
+        fprintf(s->fp,
+                "{\"engine\":\"%s\",\"test_name\":\"%s\",\"operation\":\"%s\","
+                "\"elapsed_sec\":%.3f,\"rss_mb\":%.2f,\"anon_mb\":%.2f,\"file_mb\":%.2f,"
+                "\"allocated_mb\":%.2f,\"allocator_resident_mb\":%.2f,\"benchtool_mb\":%.2f}\n",
+                s->engine, s->test_name, phase, elapsed, to_mb((int64_t)p.rss),
+                to_mb((int64_t)p.anon), to_mb((int64_t)p.file), to_mb(a.allocated),
+                to_mb(a.resident), to_mb(bench));
+    }
+    else if (s->fp)
+    {
+        fprintf(s->fp, "%s,%s,%s,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", s->engine, s->test_name,
+                phase, elapsed, to_mb((int64_t)p.rss), to_mb((int64_t)p.anon),
+                to_mb((int64_t)p.file), to_mb(a.allocated), to_mb(a.resident), to_mb(bench));
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void *memstat_thread(void *arg)
+{
+    memstat_sampler_t *s = (memstat_sampler_t *)arg;
+    long interval_ns = (long)s->interval_ms * 1000000L;
+
+    pthread_mutex_lock(&s->lock);
+    while (!s->stop)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += interval_ns / 1000000000L;
+        deadline.tv_nsec += interval_ns % 1000000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        int rc = 0;
+        while (!s->stop && rc != ETIMEDOUT)
+        {
+            rc = pthread_cond_timedwait(&s->cond, &s->lock, &deadline);
+        }
+        if (s->stop) break;
+
+        pthread_mutex_unlock(&s->lock);
+        memstat_sample(s);
+        pthread_mutex_lock(&s->lock);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+int memstat_start(memstat_sampler_t *s, const benchmark_config_t *config)
+{
+    memset(s, 0, sizeof(*s));
+    if (config->mem_interval_ms <= 0) return 0;
+
+    memstat_reset_peak();
+    s->interval_ms = config->mem_interval_ms;
+    s->engine = config->engine_name;
+    s->test_name = config->test_name ? config->test_name : "";
+    s->peak_allocated = -1;
+    if (config->mem_timeline_file)
+    {
+        s->json = has_suffix(config->mem_timeline_file, ".json") ||
+                  has_suffix(config->mem_timeline_file, ".jsonl");
+        s->fp = fopen(config->mem_timeline_file, "a");
+        if (!s->fp)
+        {
+            fprintf(stderr, "Failed to open memory timeline file: %s\n",
+                    config->mem_timeline_file);
+        }
+        else if (!s->json && ftell(s->fp) == 0)
+        {
+            fprintf(s->fp,
+                    "engine,test_name,operation,elapsed_sec,rss_mb,anon_mb,file_mb,allocated_mb,"
+                    "allocator_resident_mb,benchtool_mb\n");
+        }
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&s->lock, NULL);
+    s->start_sec = monotonic_seconds();
+
+    if (pthread_create(&s->thread, NULL, memstat_thread, s) != 0)
+    {
+        fprintf(stderr, "Failed to start the memory sampler\n");
+        pthread_cond_destroy(&s->cond);
+        pthread_mutex_destroy(&s->lock);
+        if (s->fp) fclose(s->fp);
+        memset(s, 0, sizeof(*s));
+        return -1;
+    }
+    s->running = 1;
+    memstat_sample(s);
+    return 0;
+}
+
+void memstat_phase_begin(memstat_sampler_t *s, const char *phase)
+{
+    if (!s->running) return;
+    pthread_mutex_lock(&s->lock);
+    s->phase = phase;
+    s->phase_peak = 0;
+    pthread_mutex_unlock(&s->lock);
+    memstat_sample(s);
+}
+
+size_t memstat_phase_end(memstat_sampler_t *s)
+{
+    if (!s->running) return 0;
+    memstat_sample(s);
+    pthread_mutex_lock(&s->lock);
+    size_t peak = s->phase_peak;
+    s->phase = NULL;
+    pthread_mutex_unlock(&s->lock);
+    return peak;
+}
+
+void memstat_stop(memstat_sampler_t *s)
+{
+    if (!s->running) return;
+
+    memstat_sample(s);
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_signal(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->thread, NULL);
+    s->running = 0;
+
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+    if (s->fp) fclose(s->fp);
+    s->fp = NULL;
+}
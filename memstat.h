@@ -0,0 +1,147 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __MEMSTAT_H__
+#define __MEMSTAT_H__
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "benchmark.h"
+
+/*
+ * memory accounting. a background thread reads /proc/self/status every config->mem_interval_ms
+ * for the resident set split into anonymous and file pages, keeps the peak of the run and of
+ * every phase, and optionally writes each sample to config->mem_timeline_file. the kernel's own
+ * high-water mark (VmHWM, reset when the sampler starts on kernels that support it) catches what
+ * falls between two samples, so the reported peak is the larger of both.
+ *
+ * allocator statistics come from whichever allocator the process ended up with, linked in or
+ * LD_PRELOADed: jemalloc (mallctl), tcmalloc (MallocExtension_GetNumericProperty), mimalloc
+ * (mi_process_info) or glibc (mallinfo2). the entry points are looked up with dlsym, so the build
+ * never depends on any of them. benchtool's own large buffers (worker slabs with their
+ * histograms, key arenas and the value pool) are counted by memstat_track so the report can
+ * split them off the engine's share of the resident set.
+ */
+#define MEMSTAT_NAME_SIZE 16
+
+/* /proc/self/status memory lines, bytes */
+typedef struct
+{
+    size_t rss;  /* VmRSS */
+    size_t hwm;  /* VmHWM, peak resident set since start or the last memstat_reset_peak */
+    size_t anon; /* RssAnon, heap, stacks and anonymous mappings */
+    size_t file; /* RssFile, mapped files such as an LMDB map or RocksDB mmap reads */
+    size_t vms;  /* VmSize */
+} memstat_proc_t;
+
+/* allocator counters, a field is -1 when the allocator does not report it */
+typedef struct
+{
+    char name[MEMSTAT_NAME_SIZE]; /* empty when no allocator statistics are available */
+    int64_t allocated;            /* bytes handed out to the program and not yet freed */
+    int64_t active;               /* bytes of the pages holding them, allocated plus slack */
+    int64_t resident;             /* allocator memory in RAM, metadata included */
+    int64_t mapped;               /* address space the allocator holds */
+    int64_t retained;             /* returned to the kernel but kept as address space */
+} memstat_alloc_t;
+
+typedef struct
+{
+    int interval_ms;
+    FILE *fp;
+    int json;
+    const char *engine;
+    const char *test_name;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int stop;
+    int running;
+
+    /* guarded by lock */
+    double start_sec;
+    const char *phase; /* running phase, NULL between phases */
+    uint64_t samples;
+    size_t peak_rss;
+    char peak_phase[MEMSTAT_NAME_SIZE]; /* phase of the sampled peak */
+    int64_t peak_allocated;             /* -1 when the allocator does not report it */
+    size_t phase_peak;                  /* peak of the running phase */
+} memstat_sampler_t;
+
+/**
+ * memstat_read_proc
+ * @param p the memory lines of /proc/self/status
+ * @return 0 on success, -1 when the file cannot be read
+ */
+int memstat_read_proc(memstat_proc_t *p);
+
+/**
+ * memstat_read_allocator
+ * @param a the allocator's counters, refreshed first where the allocator caches them
+ * @return 0 on success, -1 when no supported allocator statistics are available
+ */
+int memstat_read_allocator(memstat_alloc_t *a);
+
+/**
+ * memstat_track
+ * counts a benchtool buffer of bytes, negative when it is freed
+ * @param bytes size of the buffer
+ */
+void memstat_track(int64_t bytes);
+
+/**
+ * memstat_tracked
+ * @param peak receives the largest total so far, may be NULL
+ * @return bytes of benchtool buffers currently counted
+ */
+int64_t memstat_tracked(int64_t *peak);
+
+/**
+ * memstat_start
+ * resets VmHWM and starts the sampler, a no-op when config->mem_interval_ms is 0
+ * @param s sampler state, owned by the caller until memstat_stop
+ * @param config interval, timeline file, engine and test names
+ * @return 0 on success (or when disabled), -1 when the thread cannot be started
+ */
+int memstat_start(memstat_sampler_t *s, const benchmark_config_t *config);
+
+/**
+ * memstat_phase_begin
+ * takes a sample and attributes the following ones to phase
+ * @param s the sampler
+ * @param phase operation name, must stay valid until memstat_phase_end
+ */
+void memstat_phase_begin(memstat_sampler_t *s, const char *phase);
+
+/**
+ * memstat_phase_end
+ * takes a sample and closes the running phase
+ * @param s the sampler
+ * @return the sampled peak resident set of the phase, 0 when the sampler is off
+ */
+size_t memstat_phase_end(memstat_sampler_t *s);
+
+/**
+ * memstat_stop
+ * takes a last sample and joins the sampler thread
+ * @param s sampler started with memstat_start
+ */
+void memstat_stop(memstat_sampler_t *s);
+
+#endif /* __MEMSTAT_H__ */
@@ -835,16 +835,48 @@ def plot_sync_writes(df):
         print('  - 16_sync_write_performance.png (no sync data found, skipped)')
 
 
+# ═══════════════════════════════════════════════
+# Plot 17: Throughput Over Time (from --report-interval time-series)
+# ═══════════════════════════════════════════════
+def plot_timeseries(ts):
+    phases = [p for p in ts['operation'].unique()]
+    if not phases:
+        print('  - 17_throughput_over_time.png (empty time-series, skipped)')
+        return
+    fig, axes = plt.subplots(2, len(phases), figsize=(8 * len(phases), 9), squeeze=False)
+    fig.suptitle('Throughput and p99 Latency Over Time')
+    colors = {'tidesdb': TIDES, 'rocksdb': ROCKS}
+    for col, phase in enumerate(phases):
+        a1, a2 = axes[0][col], axes[1][col]
+        sub = ts[ts['operation'] == phase]
+        for (engine, test_name), g in sub.groupby(['engine', 'test_name'], dropna=False):
+            label = engine if pd.isna(test_name) or test_name == '' else f'{engine} {test_name}'
+            c = colors.get(engine)
+            a1.plot(g['elapsed_sec'], g['ops_per_sec'], label=label, color=c, lw=1.2)
+            a2.plot(g['elapsed_sec'], g['p99_us'], label=label, color=c, lw=1.2)
+        a1.set_title(f'{phase} throughput')
+        a1.set_ylabel('ops/sec')
+        a2.set_title(f'{phase} p99 latency')
+        a2.set_ylabel('p99 (us)')
+        a2.set_yscale('log')
+        for ax in (a1, a2):
+            ax.set_xlabel('elapsed (s)')
+            ax.legend(loc='best')
+    fig.tight_layout(rect=[0, 0, 1, .94])
+    save(fig, '17_throughput_over_time.png')
+
+
 # ═══════════════════════════════════════════════
 # Main
 # ═══════════════════════════════════════════════
 def main():
+    ts_path = sys.argv[2] if len(sys.argv) > 2 else None
     if len(sys.argv) > 1:
         csv_path = sys.argv[1]
     else:
         csvs = sorted(glob.glob('tidesdb_rocksdb_benchmark_results_*.csv'))
         if not csvs:
-            print('Usage: python3 plot_tidesdb_rocksdb.py <csv_file>')
+            print('Usage: python3 plot_tidesdb_rocksdb.py <csv_file> [timeseries_csv]')
             sys.exit(1)
         csv_path = csvs[-1]
 
@@ -871,6 +903,9 @@ def main():
     plot_duration(df)
     plot_cv(df)
     plot_sync_writes(df)
+    if ts_path:
+        print(f'Loading time-series: {ts_path}')
+        plot_timeseries(pd.read_csv(ts_path))
 
     n = len([f for f in os.listdir(OUT_DIR) if f.endswith('.png')])
     print(f'\nDone! {n} plots saved to {OUT_DIR}/')
@@ -0,0 +1,216 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "profile.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef __linux__
+/* in perf_counts_t field order after valid */
+static const struct
+{
+    uint32_t type;
+    uint64_t config;
+} counter_events[PROFILE_NUM_COUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+static int open_counter(uint32_t type, uint64_t config, int exclude_kernel)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = exclude_kernel;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static int64_t *count_field(perf_counts_t *counts, int i)
+{
+    int64_t *fields[PROFILE_NUM_COUNTERS] = {&counts->cycles, &counts->instructions,
+                                             &counts->llc_misses, &counts->branch_misses,
+                                             &counts->context_switches};
+    return fields[i];
+}
+
+int profile_counters_open(profile_counters_t *pc)
+{
+    int opened = 0;
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        pc->fds[i] = -1;
+#ifdef __linux__
+        pc->fds[i] = open_counter(counter_events[i].type, counter_events[i].config, 0);
+        /* perf_event_paranoid 2 only lets unprivileged users count user space */
+        if (pc->fds[i] < 0 && (errno == EACCES || errno == EPERM))
+        {
+            pc->fds[i] = open_counter(counter_events[i].type, counter_events[i].config, 1);
+        }
+        if (pc->fds[i] >= 0) opened++;
+#endif
+    }
+    return opened;
+}
+
+void profile_counters_enable(profile_counters_t *pc)
+{
+#ifdef __linux__
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)pc;
+#endif
+}
+
+void profile_counters_disable(profile_counters_t *pc)
+{
+#ifdef __linux__
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        if (pc->fds[i] >= 0) ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+#else
+    (void)pc;
+#endif
+}
+
+void profile_counters_read(const profile_counters_t *pc, perf_counts_t *counts)
+{
+    counts->valid = 1;
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        int64_t *field = count_field(counts, i);
+        uint64_t value[3]; /* value, time_enabled, time_running */
+
+        *field = -1;
+        if (pc->fds[i] < 0 || read(pc->fds[i], value, sizeof(value)) != sizeof(value)) continue;
+        if (value[2] == 0)
+        {
+            *field = 0; /* never scheduled onto the PMU */
+        }
+        else if (value[2] < value[1])
+        {
+            *field = (int64_t)((double)value[0] * (double)value[1] / (double)value[2]);
+        }
+        else
+        {
+            *field = (int64_t)value[0];
+        }
+    }
+}
+
+void profile_counters_close(profile_counters_t *pc)
+{
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+        pc->fds[i] = -1;
+    }
+}
+
+void profile_counts_add(perf_counts_t *dst, const perf_counts_t *src)
+{
+    perf_counts_t add = *src;
+    int first = !dst->valid;
+    dst->valid = 1;
+    for (int i = 0; i < PROFILE_NUM_COUNTERS; i++)
+    {
+        int64_t *d = count_field(dst, i);
+        int64_t s = *count_field(&add, i);
+        if (first)
+        {
+            *d = s;
+        }
+        else if (*d < 0 || s < 0)
+        {
+            *d = -1;
+        }
+        else
+        {
+            *d += s;
+        }
+    }
+}
+
+pid_t profile_hook_start(const char *cmd, const char *phase)
+{
+    char self[32];
+    snprintf(self, sizeof(self), "%d", (int)getpid());
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        fprintf(stderr, "Warning: could not start the profile command: %s\n", strerror(errno));
+        return -1;
+    }
+    if (pid == 0)
+    {
+        /* its own process group, so SIGINT reaches the profiler and not just the shell */
+        setpgid(0, 0);
+        setenv("BENCHTOOL_PID", self, 1);
+        setenv("BENCHTOOL_PHASE", phase, 1);
+        execl("/bin/sh", "sh", "-c", cmd, (char *)NULL);
+        _exit(127);
+    }
+    setpgid(pid, pid);
+
+    struct timespec settle = {0, PROFILE_HOOK_SETTLE_MS * 1000000L};
+    nanosleep(&settle, NULL);
+    return pid;
+}
+
+void profile_hook_stop(pid_t pid)
+{
+    if (pid <= 0) return;
+
+    kill(-pid, SIGINT);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+    {
+        fprintf(stderr, "Warning: the profile command could not be run\n");
+    }
+}
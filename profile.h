@@ -0,0 +1,102 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include <sys/types.h>
+
+#include "benchmark.h"
+
+/*
+ * per-phase profiling. every worker opens its own perf_event counters (cycles, instructions,
+ * LLC misses, branch misses, context switches) on itself, counting only while it runs the phase,
+ * so the numbers leave out the load, the teardown and the engine's background threads. when the
+ * kernel multiplexes the PMU, counts are scaled by time_enabled / time_running.
+ *
+ * the profiler hook runs an external command (typically perf record -p $BENCHTOOL_PID) in its
+ * own process group for the duration of one phase and stops it with SIGINT.
+ */
+#define PROFILE_NUM_COUNTERS   5
+#define PROFILE_HOOK_SETTLE_MS 100 /* time the hook gets to attach */
+
+typedef struct
+{
+    int fds[PROFILE_NUM_COUNTERS]; /* -1 = counter not available */
+} profile_counters_t;
+
+/**
+ * profile_counters_open
+ * opens the counters on the calling thread, disabled. counters the kernel refuses stay closed
+ * @param pc the counter set
+ * @return number of counters opened
+ */
+int profile_counters_open(profile_counters_t *pc);
+
+/**
+ * profile_counters_enable
+ * resets and starts every open counter
+ * @param pc the counter set
+ */
+void profile_counters_enable(profile_counters_t *pc);
+
+/**
+ * profile_counters_disable
+ * stops every open counter
+ * @param pc the counter set
+ */
+void profile_counters_disable(profile_counters_t *pc);
+
+/**
+ * profile_counters_read
+ * reads the scaled counts, -1 for counters that are not open
+ * @param pc the counter set
+ * @param counts the counts, valid = 1
+ */
+void profile_counters_read(const profile_counters_t *pc, perf_counts_t *counts);
+
+/**
+ * profile_counters_close
+ * closes every open counter
+ * @param pc the counter set
+ */
+void profile_counters_close(profile_counters_t *pc);
+
+/**
+ * profile_counts_add
+ * adds one worker's counts into a phase total, a field missing on any worker becomes -1
+ * @param dst the phase total, start from a zeroed perf_counts_t
+ * @param src the worker's counts
+ */
+void profile_counts_add(perf_counts_t *dst, const perf_counts_t *src);
+
+/**
+ * profile_hook_start
+ * runs cmd through /bin/sh with BENCHTOOL_PID and BENCHTOOL_PHASE in the environment, then gives
+ * it PROFILE_HOOK_SETTLE_MS to attach before the phase starts
+ * @param cmd the profiler command
+ * @param phase operation name of the phase, e.g. "PUT"
+ * @return pid of the hook, -1 when it could not be started
+ */
+pid_t profile_hook_start(const char *cmd, const char *phase);
+
+/**
+ * profile_hook_stop
+ * sends SIGINT to the hook's process group and waits for it to exit
+ * @param pid pid returned by profile_hook_start, -1 is ignored
+ */
+void profile_hook_stop(pid_t pid);
+
+#endif /* __PROFILE_H__ */
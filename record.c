@@ -0,0 +1,704 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "record.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "valuegen.h"
+
+#define RECORD_FORMAT    "benchtool-result-1"
+#define RECORD_MAX_BYTES (256 << 20) /* largest record record_load reads */
+#define RECORD_MAX_DEPTH 32
+#define RECORD_EXACT_MAX 50 /* largest sample the exact U distribution is computed for */
+
+/* host fingerprint of a record */
+typedef struct
+{
+    char hostname[256];
+    char os[256]; /* kernel name and release */
+    char machine[sizeof(((struct utsname *)0)->machine)];
+    char cpu[256]; /* model name of the first cpu */
+    long cpus;
+    long memory_mb;
+} host_info_t;
+
+static void read_host(host_info_t *h)
+{
+    memset(h, 0, sizeof(*h));
+    struct utsname u;
+    if (uname(&u) == 0)
+    {
+        snprintf(h->hostname, sizeof(h->hostname), "%s", u.nodename);
+        snprintf(h->os, sizeof(h->os), "%s %s", u.sysname, u.release);
+        snprintf(h->machine, sizeof(h->machine), "%s", u.machine);
+    }
+
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    if (fp)
+    {
+        char line[512];
+        while (fgets(line, sizeof(line), fp))
+        {
+            char *colon = strchr(line, ':');
+            if (strncmp(line, "model name", 10) != 0 || !colon) continue;
+            colon++;
+            while (*colon == ' ' || *colon == '\t') colon++;
+            colon[strcspn(colon, "\n")] = '\0';
+            snprintf(h->cpu, sizeof(h->cpu), "%s", colon);
+            break;
+        }
+        fclose(fp);
+    }
+
+    h->cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) h->memory_mb = (long)((double)pages * page_size / (1 << 20));
+}
+
+static void write_string(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (const unsigned char *p = (const unsigned char *)(s ? s : ""); *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            fprintf(fp, "\\%c", *p);
+        else if (*p < 0x20)
+            fprintf(fp, "\\u%04x", *p);
+        else
+            fputc(*p, fp);
+    }
+    fputc('"', fp);
+}
+
+static void write_config(FILE *fp, const benchmark_config_t *c)
+{
+    size_t min_size, max_size;
+    value_pool_bounds(c, &min_size, &max_size);
+    fprintf(fp, "  \"config\": {\"workload\": \"%s\", \"pattern\": \"%s\", ",
+            workload_to_string(c->workload_type), pattern_to_string(c->key_pattern));
+    fprintf(fp,
+            "\"num_operations\": %" PRId64
+            ", \"threads\": %d, \"key_size\": %d, \"value_size\": %d, "
+            "\"value_dist\": \"%s\", \"value_size_min\": %zu, \"value_size_max\": %zu, "
+            "\"compression_ratio\": %.2f, \"batch_size\": %d, \"range_size\": %d, ",
+            c->num_operations, c->num_threads, c->key_size, c->value_size,
+            value_dist_name(c->value_dist), min_size, max_size, c->compression_ratio,
+            c->batch_size, c->range_size);
+    fprintf(fp,
+            "\"sync\": %d, \"target_rate\": %.2f, \"duration_sec\": %.2f, \"warmup_sec\": %.2f, "
+            "\"queue_depth\": %d, \"column_families\": %d, \"memtable_size\": %zu, "
+            "\"block_cache_size\": %zu, \"bloom_filters\": %d, \"block_indexes\": %d, "
+            "\"use_btree\": %d, \"compression\": ",
+            c->sync_enabled, c->target_rate, c->duration_sec, c->warmup_sec, c->queue_depth,
+            c->num_column_families, c->memtable_size, c->block_cache_size,
+            c->enable_bloom_filter, c->enable_block_indexes, c->use_btree);
+    write_string(fp, c->compression_algorithm ? c->compression_algorithm : "default");
+    fprintf(fp, "},\n");
+}
+
+static void write_histogram(FILE *fp, const histogram_t *h)
+{
+    fprintf(fp,
+            ", \"histogram\": {\"unit\": \"ns\", \"count\": %" PRIu64 ", \"min\": %" PRIu64
+            ", \"max\": %" PRIu64 ", \"sum\": %.0f, \"buckets\": [",
+            h->count, h->min, h->max, h->sum);
+    int first = 1;
+    for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        if (h->buckets[i] == 0) continue;
+        fprintf(fp, "%s[%" PRIu64 ", %" PRIu64 "]", first ? "" : ", ",
+                histogram_bucket_upper_value(i), h->buckets[i]);
+        first = 0;
+    }
+    fprintf(fp, "]}");
+}
+
+static void write_trial(FILE *fp, const benchmark_results_t *r)
+{
+    const double mb = 1024.0 * 1024.0;
+    fprintf(fp,
+            "    {\"peak_rss_mb\": %.2f, \"db_size_mb\": %.2f, \"disk_write_mb\": %.2f, "
+            "\"cpu_percent\": %.1f, \"write_amp\": %.2f, \"space_amp\": %.2f, \"ops\": [",
+            r->resources.peak_rss_bytes / mb, r->resources.storage_size_bytes / mb,
+            r->resources.bytes_written / mb, r->resources.cpu_percent,
+            r->resources.write_amplification, r->resources.space_amplification);
+
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int n = results_ops(r, ops);
+    for (int i = 0; i < n; i++)
+    {
+        const operation_stats_t *st = ops[i].stats;
+        fprintf(fp,
+                "%s\n      {\"operation\": \"%s\", \"ops_per_sec\": %.2f, \"duration_sec\": "
+                "%.3f, \"avg_latency_us\": %.2f, \"stddev_us\": %.2f, \"p50_us\": %.2f, "
+                "\"p95_us\": %.2f, \"p99_us\": %.2f, \"p999_us\": %.2f, \"p9999_us\": %.2f, "
+                "\"min_us\": %.2f, \"max_us\": %.2f",
+                i ? "," : "", ops[i].name, st->ops_per_second, st->duration_seconds,
+                st->avg_latency_us, st->std_dev_us, st->p50_latency_us, st->p95_latency_us,
+                st->p99_latency_us, st->p999_latency_us, st->p9999_latency_us,
+                st->min_latency_us, st->max_latency_us);
+        const histogram_t *h = results_histogram(r, st);
+        if (h) write_histogram(fp, h);
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "%s]}", n > 0 ? "\n    " : "");
+}
+
+static const operation_stats_t *find_op(const benchmark_results_t *r, const char *name)
+{
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int n = results_ops(r, ops);
+    for (int i = 0; i < n; i++)
+    {
+        if (strcmp(ops[i].name, name) == 0) return ops[i].stats;
+    }
+    return NULL;
+}
+
+/* the ops of the first trial that every trial ran, the ones a comparison can use */
+static int common_ops(benchmark_results_t *const *trials, int num_trials, result_op_t *ops)
+{
+    int n = results_ops(trials[0], ops), kept = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int everywhere = 1;
+        for (int t = 1; t < num_trials && everywhere; t++)
+        {
+            everywhere = find_op(trials[t], ops[i].name) != NULL;
+        }
+        if (everywhere) ops[kept++] = ops[i];
+    }
+    return kept;
+}
+
+int record_write(const char *path, benchmark_results_t *const *trials, int num_trials)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "Failed to open results file: %s\n", path);
+        return -1;
+    }
+
+    const benchmark_results_t *first = trials[0];
+    host_info_t host;
+    read_host(&host);
+    char stamp[32] = "";
+    time_t now = time(NULL);
+    struct tm tm;
+    if (gmtime_r(&now, &tm)) strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+    fprintf(fp, "{\n  \"format\": \"%s\",\n  \"engine\": ", RECORD_FORMAT);
+    write_string(fp, first->engine_name);
+    fprintf(fp, ",\n  \"version\": ");
+    write_string(fp, get_engine_version(first->engine_name));
+    fprintf(fp, ",\n  \"test_name\": ");
+    write_string(fp, first->config.test_name);
+    fprintf(fp, ",\n  \"timestamp\": \"%s\",\n  \"host\": {\"hostname\": ", stamp);
+    write_string(fp, host.hostname);
+    fprintf(fp, ", \"os\": ");
+    write_string(fp, host.os);
+    fprintf(fp, ", \"machine\": ");
+    write_string(fp, host.machine);
+    fprintf(fp, ", \"cpu\": ");
+    write_string(fp, host.cpu);
+    fprintf(fp, ", \"cpus\": %ld, \"memory_mb\": %ld},\n", host.cpus, host.memory_mb);
+    write_config(fp, &first->config);
+
+    fprintf(fp, "  \"trials\": [\n");
+    for (int t = 0; t < num_trials; t++)
+    {
+        write_trial(fp, trials[t]);
+        fprintf(fp, "%s\n", t + 1 < num_trials ? "," : "");
+    }
+    fprintf(fp, "  ],\n  \"samples\": {");
+
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int n = common_ops(trials, num_trials, ops);
+    for (int i = 0; i < n; i++)
+    {
+        fprintf(fp, "%s\n    \"%s\": {\"ops_per_sec\": [", i ? "," : "", ops[i].name);
+        for (int t = 0; t < num_trials; t++)
+        {
+            fprintf(fp, "%s%.2f", t ? ", " : "", find_op(trials[t], ops[i].name)->ops_per_second);
+        }
+        fprintf(fp, "], \"p99_us\": [");
+        for (int t = 0; t < num_trials; t++)
+        {
+            fprintf(fp, "%s%.2f", t ? ", " : "", find_op(trials[t], ops[i].name)->p99_latency_us);
+        }
+        fprintf(fp, "]}");
+    }
+    fprintf(fp, "%s}\n}\n", n > 0 ? "\n  " : "");
+
+    if (fclose(fp) != 0)
+    {
+        fprintf(stderr, "Failed to write results file: %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/* a cursor over the record text, the reader only descends into what record_t keeps */
+typedef struct
+{
+    const char *p;
+    const char *end;
+} json_cursor_t;
+
+static void skip_ws(json_cursor_t *c)
+{
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r'))
+    {
+        c->p++;
+    }
+}
+
+static int expect(json_cursor_t *c, char ch)
+{
+    skip_ws(c);
+    if (c->p >= c->end || *c->p != ch) return -1;
+    c->p++;
+    return 0;
+}
+
+/* a string into out, truncated to out_size; escapes other than \" and \\ become '?' */
+static int parse_string(json_cursor_t *c, char *out, size_t out_size)
+{
+    if (expect(c, '"') != 0) return -1;
+    size_t n = 0;
+    while (c->p < c->end && *c->p != '"')
+    {
+        char ch = *c->p++;
+        if (ch == '\\')
+        {
+            if (c->p >= c->end) return -1;
+            ch = *c->p++;
+            if (ch == 'u')
+            {
+                if (c->end - c->p < 4) return -1;
+                c->p += 4;
+                ch = '?';
+            }
+            else if (ch != '"' && ch != '\\' && ch != '/')
+            {
+                ch = '?';
+            }
+        }
+        if (out && n + 1 < out_size) out[n++] = ch;
+    }
+    if (out && out_size > 0) out[n] = '\0';
+    return expect(c, '"');
+}
+
+static int parse_number(json_cursor_t *c, double *v)
+{
+    skip_ws(c);
+    char *end = NULL;
+    *v = strtod(c->p, &end);
+    if (end == c->p || end > c->end) return -1;
+    c->p = end;
+    return 0;
+}
+
+/* steps over any value */
+static int skip_value(json_cursor_t *c, int depth)
+{
+    skip_ws(c);
+    if (c->p >= c->end || depth > RECORD_MAX_DEPTH) return -1;
+    char open = *c->p;
+    if (open == '"') return parse_string(c, NULL, 0);
+    if (open != '{' && open != '[')
+    {
+        if (strncmp(c->p, "true", 4) == 0 || strncmp(c->p, "null", 4) == 0)
+        {
+            c->p += 4;
+            return 0;
+        }
+        if (strncmp(c->p, "false", 5) == 0)
+        {
+            c->p += 5;
+            return 0;
+        }
+        double v;
+        return parse_number(c, &v);
+    }
+
+    char close = open == '{' ? '}' : ']';
+    c->p++;
+    skip_ws(c);
+    if (c->p < c->end && *c->p == close)
+    {
+        c->p++;
+        return 0;
+    }
+    for (;;)
+    {
+        if (open == '{' && (parse_string(c, NULL, 0) != 0 || expect(c, ':') != 0)) return -1;
+        if (skip_value(c, depth + 1) != 0) return -1;
+        skip_ws(c);
+        if (c->p < c->end && *c->p == ',')
+        {
+            c->p++;
+            continue;
+        }
+        return expect(c, close);
+    }
+}
+
+/* walks the members of an object, member is called with the cursor on each value */
+static int parse_object(json_cursor_t *c, int (*member)(json_cursor_t *, const char *, void *),
+                        void *arg)
+{
+    if (expect(c, '{') != 0) return -1;
+    skip_ws(c);
+    if (c->p < c->end && *c->p == '}')
+    {
+        c->p++;
+        return 0;
+    }
+    for (;;)
+    {
+        char key[64];
+        if (parse_string(c, key, sizeof(key)) != 0 || expect(c, ':') != 0) return -1;
+        if (member(c, key, arg) != 0) return -1;
+        skip_ws(c);
+        if (c->p < c->end && *c->p == ',')
+        {
+            c->p++;
+            continue;
+        }
+        return expect(c, '}');
+    }
+}
+
+static int parse_samples(json_cursor_t *c, double *out, int *n)
+{
+    *n = 0;
+    if (expect(c, '[') != 0) return -1;
+    skip_ws(c);
+    if (c->p < c->end && *c->p == ']')
+    {
+        c->p++;
+        return 0;
+    }
+    for (;;)
+    {
+        double v;
+        if (parse_number(c, &v) != 0) return -1;
+        if (*n < RECORD_MAX_TRIALS) out[(*n)++] = v;
+        skip_ws(c);
+        if (c->p < c->end && *c->p == ',')
+        {
+            c->p++;
+            continue;
+        }
+        return expect(c, ']');
+    }
+}
+
+static int op_member(json_cursor_t *c, const char *key, void *arg)
+{
+    record_op_t *op = arg;
+    if (strcmp(key, "ops_per_sec") == 0)
+    {
+        return parse_samples(c, op->ops_per_sec, &op->num_ops_per_sec);
+    }
+    if (strcmp(key, "p99_us") == 0) return parse_samples(c, op->p99_us, &op->num_p99);
+    return skip_value(c, 0);
+}
+
+static int samples_member(json_cursor_t *c, const char *key, void *arg)
+{
+    record_t *rec = arg;
+    if (rec->num_ops == BENCHMARK_MAX_RESULT_OPS) return skip_value(c, 0);
+    record_op_t *op = &rec->ops[rec->num_ops++];
+    snprintf(op->name, sizeof(op->name), "%s", key);
+    return parse_object(c, op_member, op);
+}
+
+static int host_member(json_cursor_t *c, const char *key, void *arg)
+{
+    record_t *rec = arg;
+    if (strcmp(key, "hostname") == 0) return parse_string(c, rec->hostname, sizeof(rec->hostname));
+    if (strcmp(key, "cpu") == 0) return parse_string(c, rec->cpu, sizeof(rec->cpu));
+    return skip_value(c, 0);
+}
+
+static int record_member(json_cursor_t *c, const char *key, void *arg)
+{
+    record_t *rec = arg;
+    char format[64];
+    if (strcmp(key, "format") == 0)
+    {
+        if (parse_string(c, format, sizeof(format)) != 0) return -1;
+        return strcmp(format, RECORD_FORMAT) == 0 ? 0 : -1;
+    }
+    if (strcmp(key, "engine") == 0) return parse_string(c, rec->engine, sizeof(rec->engine));
+    if (strcmp(key, "version") == 0) return parse_string(c, rec->version, sizeof(rec->version));
+    if (strcmp(key, "host") == 0) return parse_object(c, host_member, rec);
+    if (strcmp(key, "samples") == 0) return parse_object(c, samples_member, rec);
+    return skip_value(c, 0);
+}
+
+int record_load(const char *path, record_t *rec)
+{
+    memset(rec, 0, sizeof(*rec));
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        fprintf(stderr, "Error: cannot open result record %s\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    /* terminated, strtod and strncmp must stop at the end of a truncated record */
+    char *text = size > 0 && size <= RECORD_MAX_BYTES ? malloc((size_t)size + 1) : NULL;
+    int rc = -1;
+    if (text && fread(text, 1, (size_t)size, fp) == (size_t)size)
+    {
+        text[size] = '\0';
+        json_cursor_t c = {text, text + size};
+        rc = parse_object(&c, record_member, rec);
+    }
+    free(text);
+    fclose(fp);
+
+    if (rc != 0 || !rec->engine[0])
+    {
+        fprintf(stderr, "Error: %s is not a benchtool result record\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double median(const double *v, int n)
+{
+    double sorted[RECORD_MAX_TRIALS];
+    memcpy(sorted, v, (size_t)n * sizeof(double));
+    qsort(sorted, (size_t)n, sizeof(double), cmp_double);
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+}
+
+/* P(U <= u) for tie-free samples of m and n, the share of the orderings of the pooled sample
+ * whose U is at most u. f[i][u] counts the orderings of i x's and the j y's so far */
+static double exact_lower_tail(int m, int n, double u_obs)
+{
+    int umax = m * n;
+    double *f = calloc((size_t)(m + 1) * (size_t)(umax + 1), sizeof(double));
+    if (!f) return 1.0;
+    for (int i = 0; i <= m; i++) f[(size_t)i * (umax + 1)] = 1.0;
+
+    /* an ordering ends in a y (U unchanged) or in an x above all j y's (U grows by j) */
+    for (int j = 1; j <= n; j++)
+    {
+        for (int i = 1; i <= m; i++)
+        {
+            double *row = &f[(size_t)i * (umax + 1)];
+            const double *prev = &f[(size_t)(i - 1) * (umax + 1)];
+            for (int u = umax; u >= j; u--) row[u] += prev[u - j];
+        }
+    }
+
+    const double *last = &f[(size_t)m * (umax + 1)];
+    double below = 0.0, total = 0.0;
+    for (int u = 0; u <= umax; u++)
+    {
+        total += last[u];
+        if (u <= u_obs + 1e-9) below += last[u];
+    }
+    free(f);
+    return total > 0.0 ? below / total : 1.0;
+}
+
+/**
+ * mann_whitney_less
+ * one-sided Mann-Whitney U test of x being stochastically smaller than y
+ * @return the p-value, P(U <= U_obs) under the null hypothesis of one distribution
+ */
+static double mann_whitney_less(const double *x, int m, const double *y, int n)
+{
+    if (m == 0 || n == 0) return 1.0;
+
+    /* U counts the pairs with x above y, ties count half */
+    double u = 0.0;
+    int ties = 0;
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (x[i] > y[j])
+                u += 1.0;
+            else if (x[i] == y[j])
+            {
+                u += 0.5;
+                ties = 1;
+            }
+        }
+    }
+    if (!ties && m <= RECORD_EXACT_MAX && n <= RECORD_EXACT_MAX)
+    {
+        return exact_lower_tail(m, n, u);
+    }
+
+    /* normal approximation, the variance shrinks by the tied groups of the pooled sample */
+    double pooled[2 * RECORD_MAX_TRIALS];
+    int total = m + n;
+    memcpy(pooled, x, (size_t)m * sizeof(double));
+    memcpy(pooled + m, y, (size_t)n * sizeof(double));
+    qsort(pooled, (size_t)total, sizeof(double), cmp_double);
+    double tie_sum = 0.0;
+    for (int i = 0; i < total;)
+    {
+        int k = i;
+        while (k < total && pooled[k] == pooled[i]) k++;
+        double t = k - i;
+        tie_sum += t * t * t - t;
+        i = k;
+    }
+    double mean = m * (double)n / 2.0;
+    double var = m * (double)n / 12.0 * ((total + 1) - tie_sum / ((double)total * (total - 1)));
+    if (var <= 0.0) return 1.0;
+    double z = (u - mean + 0.5) / sqrt(var);
+    return 0.5 * erfc(-z / sqrt(2.0));
+}
+
+static const record_op_t *find_record_op(const record_t *rec, const char *name)
+{
+    for (int i = 0; i < rec->num_ops; i++)
+    {
+        if (strcmp(rec->ops[i].name, name) == 0) return &rec->ops[i];
+    }
+    return NULL;
+}
+
+/* one metric of one op, higher_better for throughput. returns 1 on a regression */
+static int compare_metric(FILE *fp, const char *op, const char *metric, const double *base,
+                          int num_base, const double *cur, int num_cur, int higher_better,
+                          double threshold_pct, double alpha)
+{
+    double base_med = median(base, num_base);
+    double cur_med = median(cur, num_cur);
+    double change = base_med != 0.0 ? 100.0 * (cur_med - base_med) / base_med : 0.0;
+
+    /* worse means lower throughput or higher latency */
+    double p_worse = higher_better ? mann_whitney_less(cur, num_cur, base, num_base)
+                                   : mann_whitney_less(base, num_base, cur, num_cur);
+    double p_better = higher_better ? mann_whitney_less(base, num_base, cur, num_cur)
+                                    : mann_whitney_less(cur, num_cur, base, num_base);
+    double worse_pct = higher_better ? -change : change;
+
+    const char *verdict = "ok";
+    double p = p_worse;
+    if (worse_pct > threshold_pct && p_worse < alpha)
+    {
+        verdict = "REGRESSION";
+    }
+    else if (-worse_pct > threshold_pct && p_better < alpha)
+    {
+        verdict = "improved";
+        p = p_better;
+    }
+    else if (-worse_pct > 0.0)
+    {
+        p = p_better;
+    }
+
+    fprintf(fp, "  %-10s %-8s %14.2f %14.2f %+8.1f%% %8.4f  %s\n", op, metric, base_med, cur_med,
+            change, p, verdict);
+    return verdict[0] == 'R';
+}
+
+int record_compare(FILE *fp, const record_t *baseline, benchmark_results_t *const *trials,
+                   int num_trials, double threshold_pct, double alpha)
+{
+    const benchmark_results_t *first = trials[0];
+    host_info_t host;
+    read_host(&host);
+
+    fprintf(fp, "\n=== Regression Check ===\n");
+    fprintf(fp, "Baseline: %s v%s on %s\n", baseline->engine, baseline->version,
+            baseline->hostname);
+    fprintf(fp, "Current:  %s v%s on %s, %d trial%s\n", first->engine_name,
+            get_engine_version(first->engine_name), host.hostname, num_trials,
+            num_trials == 1 ? "" : "s");
+    fprintf(fp, "Threshold: %.1f%% change of the median, one-sided Mann-Whitney U at alpha %.3f\n",
+            threshold_pct, alpha);
+    if (strcmp(baseline->hostname, host.hostname) != 0 || strcmp(baseline->cpu, host.cpu) != 0)
+    {
+        fprintf(fp, "Warning: the baseline was recorded on another host (%s)\n",
+                baseline->cpu[0] ? baseline->cpu : "unknown cpu");
+    }
+    fprintf(fp, "\n  %-10s %-8s %14s %14s %9s %8s  %s\n", "Op", "Metric", "Baseline", "Current",
+            "Change", "p", "Verdict");
+
+    result_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int n = common_ops(trials, num_trials, ops);
+    int regressions = 0, compared = 0;
+    for (int i = 0; i < n; i++)
+    {
+        const record_op_t *base = find_record_op(baseline, ops[i].name);
+        if (!base) continue;
+
+        double tput[RECORD_MAX_TRIALS], p99[RECORD_MAX_TRIALS];
+        for (int t = 0; t < num_trials; t++)
+        {
+            const operation_stats_t *st = find_op(trials[t], ops[i].name);
+            tput[t] = st->ops_per_second;
+            p99[t] = st->p99_latency_us;
+        }
+        if (base->num_ops_per_sec > 0)
+        {
+            regressions += compare_metric(fp, ops[i].name, "ops/sec", base->ops_per_sec,
+                                          base->num_ops_per_sec, tput, num_trials, 1,
+                                          threshold_pct, alpha);
+            compared++;
+        }
+        /* an op without latency samples (ITER) has no p99 to compare */
+        if (base->num_p99 > 0 && median(p99, num_trials) > 0.0)
+        {
+            regressions += compare_metric(fp, ops[i].name, "p99 us", base->p99_us, base->num_p99,
+                                          p99, num_trials, 0, threshold_pct, alpha);
+            compared++;
+        }
+    }
+
+    if (compared == 0)
+    {
+        fprintf(fp, "  no op of this run is in the baseline\n");
+    }
+    fprintf(fp, "\n%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+    return regressions;
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __RECORD_H__
+#define __RECORD_H__
+
+#include <stdio.h>
+
+#include "benchmark.h"
+
+/*
+ * result records. --results-json stores the trials of a run as one JSON document: the engine and
+ * its version, a fingerprint of the host (name, kernel, cpu model and count, memory), the config,
+ * and for every trial and measured op its stats and full latency histogram (the non-empty
+ * buckets as [highest value in ns, count] pairs). the per-trial throughput and p99 of each op
+ * are repeated under "samples", which is all --compare-to reads back.
+ *
+ * --compare-to checks the trials of this run against the samples of a stored record with a
+ * one-sided Mann-Whitney U test per op, exact for small tie-free samples and normal-approximated
+ * with a tie correction otherwise. an op regresses when its median throughput dropped (or its
+ * median p99 rose) by more than the threshold and the test rejects "no worse" at alpha. with
+ * alpha 0.05 that takes at least 4 trials on each side, 3 against 3 cannot get below 0.05.
+ */
+#define RECORD_MAX_TRIALS 100
+
+typedef struct
+{
+    char name[32];
+    double ops_per_sec[RECORD_MAX_TRIALS];
+    int num_ops_per_sec;
+    double p99_us[RECORD_MAX_TRIALS];
+    int num_p99;
+} record_op_t;
+
+typedef struct
+{
+    char engine[64];
+    char version[64];
+    char hostname[256];
+    char cpu[256];
+    record_op_t ops[BENCHMARK_MAX_RESULT_OPS];
+    int num_ops;
+} record_t;
+
+/**
+ * record_write
+ * stores the trials of a run, histograms are written for the runs that kept them
+ * @param path output file
+ * @param trials finished runs of the same config
+ * @param num_trials number of runs
+ * @return 0 on success, -1 when the file cannot be written
+ */
+int record_write(const char *path, benchmark_results_t *const *trials, int num_trials);
+
+/**
+ * record_load
+ * reads the engine, host and samples of a record from record_write
+ * @param path the record
+ * @param rec the parsed record
+ * @return 0 on success, -1 when the file is missing or not a record
+ */
+int record_load(const char *path, record_t *rec);
+
+/**
+ * record_compare
+ * tests the trials of this run against a stored record and prints one line per op and metric
+ * @param fp output stream
+ * @param baseline the stored record
+ * @param trials finished runs of this config
+ * @param num_trials number of runs
+ * @param threshold_pct smallest change of the median, in percent, that counts
+ * @param alpha significance level of the one-sided tests
+ * @return the number of regressions
+ */
+int record_compare(FILE *fp, const record_t *baseline, benchmark_results_t *const *trials,
+                   int num_trials, double threshold_pct, double alpha);
+
+#endif /* __RECORD_H__ */
@@ -0,0 +1,305 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "reporter.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double monotonic_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int has_suffix(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+/* zeroes when the engine has no object store, returns 1 when the counters are real */
+static int sample_remote(const reporter_t *r, remote_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!r->engine || !r->engine->ops->remote_stats) return 0;
+    if (r->engine->ops->remote_stats(r->engine, stats) == 0) return 1;
+    memset(stats, 0, sizeof(*stats));
+    return 0;
+}
+
+/* we push one full interval into the steady-state window and evaluate it once it is full,
+ * returns 1 on the tick the phase turns steady */
+static int reporter_steady(reporter_t *r, double elapsed_sec, double ops_per_sec, uint64_t ops)
+{
+    int size = r->config->steady_window;
+    if (size < 2 || size > REPORTER_MAX_STEADY_WINDOW) return 0;
+
+    if (ops == 0)
+    {
+        r->window_count = 0; /* an idle interval breaks the window */
+        return 0;
+    }
+    r->window[r->window_next] = ops_per_sec;
+    r->window_next = (r->window_next + 1) % size;
+    if (r->window_count < size) r->window_count++;
+    if (r->window_count < size) return 0;
+
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < size; i++)
+    {
+        sum += r->window[i];
+        sum_sq += r->window[i] * r->window[i];
+    }
+    double mean = sum / size;
+    double var = sum_sq / size - mean * mean;
+    double cv = mean > 0.0 ? 100.0 * sqrt(var > 0.0 ? var : 0.0) / mean : 0.0;
+
+    r->steady_windows++;
+    if (r->steady_sec > 0.0) return 0;
+    r->steady_cv = cv;
+    if (cv > r->config->steady_cv) return 0;
+    r->steady_sec = elapsed_sec;
+    return 1;
+}
+
+/* we take a merged snapshot of all live histograms and writes the interval since the last one.
+ * full is 0 for the partial tail at the end of the phase */
+static void reporter_tick(reporter_t *r, double now, int full)
+{
+    memset(r->cur, 0, sizeof(*r->cur));
+    for (int i = 0; i < r->num_hists; i++)
+    {
+        histogram_snapshot_add(r->cur, r->hists[i]);
+    }
+    histogram_delta(r->interval, r->cur, r->prev);
+
+    size_t rss = 0, vms = 0, io_read = 0, io_write = 0;
+    get_memory_usage(&rss, &vms);
+    get_io_stats(&io_read, &io_write);
+    remote_stats_t remote;
+    sample_remote(r, &remote);
+    engine_stats_t es = {0};
+    if (r->engine) sample_engine_stats(r->engine, &es);
+
+    double interval_sec = now - r->last_sec;
+    double elapsed_sec = now - r->start_sec;
+    double ops_per_sec = interval_sec > 0 ? r->interval->count / interval_sec : 0.0;
+    double p50_us = histogram_value_at_percentile(r->interval, 50.0) / 1000.0;
+    double p99_us = histogram_value_at_percentile(r->interval, 99.0) / 1000.0;
+    double max_us = r->interval->max / 1000.0;
+    int steady = full && reporter_steady(r, elapsed_sec, ops_per_sec, r->interval->count);
+    double rss_mb = rss / (1024.0 * 1024.0);
+    double read_mb = (io_read - r->last_io_read) / (1024.0 * 1024.0);
+    double write_mb = (io_write - r->last_io_write) / (1024.0 * 1024.0);
+    uint64_t remote_gets = (remote.gets + remote.range_gets) -
+                           (r->last_remote.gets + r->last_remote.range_gets);
+    double remote_mb = (remote.bytes_fetched - r->last_remote.bytes_fetched) / (1024.0 * 1024.0);
+    /* -1 when the engine does not report it */
+    double stall_ms = es.valid && es.stall_us >= 0 && r->last_engine.stall_us >= 0
+                          ? (es.stall_us - r->last_engine.stall_us) / 1000.0
+                          : -1.0;
+    double pending_mb = es.valid && es.pending_compaction_bytes >= 0
+                            ? es.pending_compaction_bytes / (1024.0 * 1024.0)
+                            : -1.0;
+    long long immutable = es.valid ? (long long)es.immutable_memtables : -1;
+    long long l0_files = es.valid ? (long long)es.l0_files : -1;
+    const char *engine = r->config->engine_name;
+    const char *test_name = r->config->test_name ? r->config->test_name : "";
+
+    if (r->fp && r->json)
+    {
+        fprintf(r->fp,
+                "{\"engine\":\"%s\",\"test_name\":\"%s\",\"operation\":\"%s\","
+                "\"elapsed_sec\":%.3f,\"interval_sec\":%.3f,\"ops\":%llu,\"ops_per_sec\":%.2f,"
+                "\"p50_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f,\"rss_mb\":%.2f,"
+                "\"disk_read_mb\":%.2f,\"disk_write_mb\":%.2f,\"remote_gets\":%llu,"
+                "\"remote_mb\":%.2f,\"upload_backlog\":%lld,\"stall_ms\":%.2f,"
+                "\"pending_compaction_mb\":%.2f,\"immutable_memtables\":%lld,"
+                "\"l0_files\":%lld}\n",
+                engine, test_name, r->phase, elapsed_sec, interval_sec,
+                (unsigned long long)r->interval->count, ops_per_sec, p50_us, p99_us, max_us,
+                rss_mb, read_mb, write_mb, (unsigned long long)remote_gets, remote_mb,
+                (long long)remote.uploads_in_flight, stall_ms, pending_mb, immutable, l0_files);
+        fflush(r->fp);
+    }
+    else if (r->fp)
+    {
+        fprintf(r->fp,
+                "%s,%s,%s,%.3f,%.3f,%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%llu,%.2f,%lld,%.2f,"
+                "%.2f,%lld,%lld\n",
+                engine, test_name, r->phase, elapsed_sec, interval_sec,
+                (unsigned long long)r->interval->count, ops_per_sec, p50_us, p99_us, max_us,
+                rss_mb, read_mb, write_mb, (unsigned long long)remote_gets, remote_mb,
+                (long long)remote.uploads_in_flight, stall_ms, pending_mb, immutable, l0_files);
+        fflush(r->fp);
+    }
+    else
+    {
+        fprintf(stderr, "\n    [%7.1fs] %s %.0f ops/sec p99 %.2f μs rss %.1f MB w %.1f MB",
+                elapsed_sec, r->phase, ops_per_sec, p99_us, rss_mb, write_mb);
+        if (r->has_remote)
+        {
+            fprintf(stderr, " remote %llu gets %.1f MB backlog %lld",
+                    (unsigned long long)remote_gets, remote_mb,
+                    (long long)remote.uploads_in_flight);
+        }
+        if (stall_ms > 0.0) fprintf(stderr, " stall %.1f ms", stall_ms);
+        if (l0_files >= 0) fprintf(stderr, " L0 %lld", l0_files);
+        if (steady) fprintf(stderr, " [steady, cv %.1f%%]", r->steady_cv);
+    }
+
+    histogram_t *tmp = r->prev;
+    r->prev = r->cur;
+    r->cur = tmp;
+    r->last_sec = now;
+    r->last_io_read = io_read;
+    r->last_io_write = io_write;
+    r->last_remote = remote;
+    if (es.valid) r->last_engine = es;
+}
+
+static void *reporter_thread(void *arg)
+{
+    reporter_t *r = (reporter_t *)arg;
+    long interval_ns = (long)r->config->report_interval_ms * 1000000L;
+
+    pthread_mutex_lock(&r->lock);
+    while (!r->stop)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += interval_ns / 1000000000L;
+        deadline.tv_nsec += interval_ns % 1000000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        int rc = 0;
+        while (!r->stop && rc != ETIMEDOUT)
+        {
+            rc = pthread_cond_timedwait(&r->cond, &r->lock, &deadline);
+        }
+        if (r->stop) break;
+
+        pthread_mutex_unlock(&r->lock);
+        reporter_tick(r, monotonic_seconds(), 1);
+        pthread_mutex_lock(&r->lock);
+    }
+    pthread_mutex_unlock(&r->lock);
+    return NULL;
+}
+
+int reporter_start(reporter_t *r, const benchmark_config_t *config, const char *phase,
+                   storage_engine_t *engine, histogram_t *const *hists, int num_hists)
+{
+    memset(r, 0, sizeof(*r));
+    if (config->report_interval_ms <= 0) return 0;
+
+    r->config = config;
+    r->phase = phase;
+    r->engine = engine;
+    r->hists = hists;
+    r->num_hists = num_hists;
+    r->prev = calloc(1, sizeof(histogram_t));
+    r->cur = calloc(1, sizeof(histogram_t));
+    r->interval = calloc(1, sizeof(histogram_t));
+    if (!r->prev || !r->cur || !r->interval)
+    {
+        free(r->prev);
+        free(r->cur);
+        free(r->interval);
+        return -1;
+    }
+
+    if (config->timeseries_file)
+    {
+        r->json = has_suffix(config->timeseries_file, ".json") ||
+                  has_suffix(config->timeseries_file, ".jsonl");
+        r->fp = fopen(config->timeseries_file, "a");
+        if (!r->fp)
+        {
+            fprintf(stderr, "Failed to open time-series file: %s\n", config->timeseries_file);
+        }
+        else if (!r->json && ftell(r->fp) == 0)
+        {
+            fprintf(r->fp,
+                    "engine,test_name,operation,elapsed_sec,interval_sec,ops,ops_per_sec,p50_us,"
+                    "p99_us,max_us,rss_mb,disk_read_mb,disk_write_mb,remote_gets,remote_mb,"
+                    "upload_backlog,stall_ms,pending_compaction_mb,immutable_memtables,"
+                    "l0_files\n");
+        }
+    }
+
+    get_io_stats(&r->last_io_read, &r->last_io_write);
+    r->has_remote = sample_remote(r, &r->last_remote);
+    if (!engine || sample_engine_stats(engine, &r->last_engine) != 0)
+    {
+        engine_stats_reset(&r->last_engine);
+    }
+    r->start_sec = monotonic_seconds();
+    r->last_sec = r->start_sec;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&r->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&r->lock, NULL);
+
+    if (pthread_create(&r->thread, NULL, reporter_thread, r) != 0)
+    {
+        fprintf(stderr, "Failed to start interval reporter\n");
+        reporter_stop(r);
+        return -1;
+    }
+    r->running = 1;
+    return 0;
+}
+
+void reporter_stop(reporter_t *r)
+{
+    if (!r->prev) return;
+
+    if (r->running)
+    {
+        pthread_mutex_lock(&r->lock);
+        r->stop = 1;
+        pthread_cond_signal(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+        pthread_join(r->thread, NULL);
+        r->running = 0;
+
+        /* the tail of the phase that did not fill a whole interval */
+        double now = monotonic_seconds();
+        if (now - r->last_sec > 0.001) reporter_tick(r, now, 0);
+        if (!r->fp) fprintf(stderr, "\n");
+    }
+
+    pthread_cond_destroy(&r->cond);
+    pthread_mutex_destroy(&r->lock);
+    if (r->fp) fclose(r->fp);
+    free(r->prev);
+    free(r->cur);
+    free(r->interval);
+    r->prev = r->cur = r->interval = NULL;
+    r->fp = NULL;
+}
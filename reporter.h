@@ -0,0 +1,96 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __REPORTER_H__
+#define __REPORTER_H__
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "histogram.h"
+
+/*
+ * interval reporter, a background thread that snapshots the live per-thread histograms of the
+ * running phase every config->report_interval_ms and emits one time-series row per interval
+ * (ops/s, p50/p99/max, RSS, /proc/self/io deltas, object store fetches and upload backlog, and
+ * the engine's write stall, compaction debt and flush queue). rows go to config->timeseries_file
+ * as CSV, or as JSON lines when the file name ends in .json/.jsonl, otherwise a short progress
+ * line is printed to stderr.
+ *
+ * every full interval also feeds a sliding window of config->steady_window throughput samples.
+ * the phase is in steady state from the first tick where the window's coefficient of variation
+ * is at most config->steady_cv percent. intervals without ops (a warmup, which is not recorded)
+ * never count toward a steady window.
+ */
+#define REPORTER_MAX_STEADY_WINDOW 256
+typedef struct
+{
+    const benchmark_config_t *config;
+    const char *phase;        /* operation name of the running phase, e.g. "PUT" */
+    storage_engine_t *engine; /* sampled for object store traffic, NULL = none */
+    histogram_t *const *hists;
+    int num_hists;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int stop;
+    int running;
+
+    FILE *fp;
+    int json;
+    histogram_t *prev; /* merged snapshot at the previous tick */
+    histogram_t *cur;  /* merged snapshot at this tick */
+    histogram_t *interval;
+    double start_sec;
+    double last_sec;
+    size_t last_io_read;
+    size_t last_io_write;
+    remote_stats_t last_remote;
+    int has_remote; /* the engine reports object store counters */
+    engine_stats_t last_engine;
+
+    /* steady-state detection */
+    double window[REPORTER_MAX_STEADY_WINDOW]; /* ops/s of the last full intervals, a ring */
+    int window_count;
+    int window_next;
+    int steady_windows;  /* full windows evaluated */
+    double steady_sec;   /* elapsed phase time when the window first turned steady, 0 = never */
+    double steady_cv;    /* cv percent of that window, or of the last one evaluated */
+} reporter_t;
+
+/**
+ * reporter_start
+ * starts the reporter for one phase, a no-op when config->report_interval_ms is 0
+ * @param r reporter state, owned by the caller for the duration of the phase
+ * @param config benchmark configuration
+ * @param phase operation name used in the emitted rows
+ * @param engine engine of the phase, its object store counters are sampled when it has them
+ * @param hists per-thread histograms being written by the workers
+ * @param num_hists number of histograms
+ * @return 0 on success (or when disabled), -1 on failure
+ */
+int reporter_start(reporter_t *r, const benchmark_config_t *config, const char *phase,
+                   storage_engine_t *engine, histogram_t *const *hists, int num_hists);
+
+/**
+ * reporter_stop
+ * emits the final partial interval and joins the reporter thread
+ * @param r reporter started with reporter_start
+ */
+void reporter_stop(reporter_t *r);
+
+#endif /* __REPORTER_H__ */
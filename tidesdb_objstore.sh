@@ -0,0 +1,143 @@
+#!/bin/bash
+
+set -e
+
+BENCH="./build/benchtool"
+DB_PATH="${BENCHTOOL_DB_PATH:-db-bench}"
+OBJ_PATH="${DB_PATH}_objects"
+CACHE_PATH="${DB_PATH}_cache"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS="tidesdb_objstore_${TIMESTAMP}.txt"
+CSV_FILE="tidesdb_objstore_${TIMESTAMP}.csv"
+TIMESERIES_FILE="tidesdb_objstore_${TIMESTAMP}_timeseries.csv"
+
+DEFAULT_KEYS=1000000
+DEFAULT_THREADS=4
+DEFAULT_VALUE_SIZE=1024
+LATENCIES="0 1000 10000"
+
+# Parse command line arguments
+show_usage() {
+    echo "Usage: $0 [OPTIONS]"
+    echo ""
+    echo "Options:"
+    echo "  -k, --keys <count>          Number of keys to benchmark (default: 1000000)"
+    echo "  -t, --threads <n>           Number of threads (default: 4)"
+    echo "  -l, --latencies <list>      Injected per-request latencies in μs (default: \"0 1000 10000\")"
+    echo "  -h, --help                  Show this help message"
+    echo ""
+    echo "Examples:"
+    echo "  $0                          # 1M keys at 0, 1 ms and 10 ms per request"
+    echo "  $0 -k 250000 -l \"0 20000\"   # smaller dataset, local vs a slow remote"
+    exit 0
+}
+
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        -k|--keys)
+            DEFAULT_KEYS="$2"
+            shift 2
+            ;;
+        -t|--threads)
+            DEFAULT_THREADS="$2"
+            shift 2
+            ;;
+        -l|--latencies)
+            LATENCIES="$2"
+            shift 2
+            ;;
+        -h|--help)
+            show_usage
+            ;;
+        *)
+            echo "Unknown option: $1"
+            show_usage
+            ;;
+    esac
+done
+
+if [ ! -f "$BENCH" ]; then
+    echo "Error: benchtool not found at $BENCH"
+    echo "Please build first: mkdir -p build && cd build && cmake .. && make"
+    exit 1
+fi
+
+> "$RESULTS"
+> "$CSV_FILE"
+
+log() {
+    echo "$1" | tee -a "$RESULTS"
+}
+
+log "*------------------------------------------*"
+log "RUNNER: TidesDB Object Store (warm vs cold cache)"
+log "Date: $(date)"
+log "Parameters:"
+log "  Keys: $DEFAULT_KEYS"
+log "  Threads: $DEFAULT_THREADS"
+log "  Value Size: $DEFAULT_VALUE_SIZE"
+log "  Injected Latencies (μs): $LATENCIES"
+log "Environment:"
+log "  Hostname: $(hostname)"
+log "  Kernel: $(uname -r)"
+log "  CPU: $(grep 'model name' /proc/cpuinfo | head -1 | cut -d: -f2 | xargs)"
+log "  CPU Cores: $(nproc)"
+log "  Memory: $(free -h | grep Mem | awk '{print $2}')"
+log "Results:"
+log "  Text: $RESULTS"
+log "  CSV:  $CSV_FILE"
+log "  Time series: $TIMESERIES_FILE"
+log "*------------------------------------------*"
+log ""
+
+cleanup_db() {
+    rm -rf "$DB_PATH" "$OBJ_PATH" "$CACHE_PATH"
+    if [ -d "$DB_PATH" ] || [ -d "$OBJ_PATH" ] || [ -d "$CACHE_PATH" ]; then
+        log "Warning: Failed to remove $DB_PATH, $OBJ_PATH or $CACHE_PATH"
+        return 1
+    fi
+    mkdir -p "$OBJ_PATH"
+    sync
+    return 0
+}
+
+# Load once per latency, then measure every read workload warm and cold on the same objects
+run_latency() {
+    local latency="$1"
+    local common="-e tidesdb -o $DEFAULT_KEYS -t $DEFAULT_THREADS -v $DEFAULT_VALUE_SIZE -d $DB_PATH \
+        --object-store fs --object-store-fs-path $OBJ_PATH --object-local-cache-path $CACHE_PATH \
+        --object-latency-us $latency --report-interval 1000 --timeseries-file $TIMESERIES_FILE \
+        --csv $CSV_FILE"
+
+    log ""
+    log "*------------------------------------------*"
+    log "TEST: injected latency ${latency} μs"
+    log "*------------------------------------------*"
+
+    cleanup_db || exit 1
+    log "Loading..."
+    $BENCH $common -w read --phase load --test-name "lat${latency}_load" 2>&1 | tee -a "$RESULTS"
+
+    for workload in read seek range; do
+        log "Running $workload (warm cache)..."
+        $BENCH $common -w $workload --phase run --test-name "lat${latency}_${workload}_warm" 2>&1 | tee -a "$RESULTS"
+
+        log "Running $workload (cold cache)..."
+        $BENCH $common -w $workload --phase run --object-cold-cache \
+            --test-name "lat${latency}_${workload}_cold" 2>&1 | tee -a "$RESULTS"
+    done
+
+    cleanup_db || exit 1
+    log ""
+}
+
+for latency in $LATENCIES; do
+    run_latency "$latency"
+done
+
+log "*------------------------------------------*"
+log "Suite complete"
+log "  Text: $RESULTS"
+log "  CSV:  $CSV_FILE"
+log "  Time series: $TIMESERIES_FILE"
+log "*------------------------------------------*"
@@ -26,6 +26,15 @@ if [ ! -f "$BENCH" ]; then
     exit 1
 fi
 
+# time every fsync/fdatasync when the shim was built next to benchtool
+FSYNC_SHIM="./build/libbenchtool_fsync.so"
+if [ -f "$FSYNC_SHIM" ]; then
+    export LD_PRELOAD="$FSYNC_SHIM${LD_PRELOAD:+:$LD_PRELOAD}"
+    SYNC_TIMING="$FSYNC_SHIM"
+else
+    SYNC_TIMING="unavailable (shim not built)"
+fi
+
 > "$RESULTS"
 > "$CSV_FILE"
 
@@ -40,6 +49,7 @@ log "*------------------------------------------*"
 log "RUNNER: TidesDB vs RocksDB (Synced)"
 log "Date: $(date)"
 log "Sync Mode: $SYNC_MODE"
+log "Sync Timing: $SYNC_TIMING"
 log "Parameters:"
 log "  Default Batch Size: $DEFAULT_BATCH_SIZE"
 log "  Default Threads: $DEFAULT_THREADS"
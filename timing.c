@@ -0,0 +1,89 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "timing.h"
+
+#if TIMING_HAVE_TSC
+#include <cpuid.h>
+#endif
+
+timing_clock_t timing_clock;
+
+#if TIMING_HAVE_TSC
+/* cpuid 0x80000007 edx bit 8, the tsc ticks at a constant rate in every p-, c- and t-state */
+static int has_invariant_tsc(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return 0;
+    return (edx & (1u << 8)) != 0;
+}
+
+/* we take the tsc rate over a short sleep, bracketing each monotonic read with two tsc reads */
+static double calibrate_tsc(uint64_t *base_tsc, double *base_us)
+{
+    uint64_t t0 = __rdtsc();
+    double m0 = timing_monotonic_us();
+    uint64_t t1 = __rdtsc();
+
+    struct timespec pause = {0, TIMING_CALIBRATE_MS * 1000000L};
+    nanosleep(&pause, NULL);
+
+    uint64_t t2 = __rdtsc();
+    double m1 = timing_monotonic_us();
+    uint64_t t3 = __rdtsc();
+
+    uint64_t start = t0 + (t1 - t0) / 2;
+    uint64_t end = t2 + (t3 - t2) / 2;
+    if (end <= start || m1 <= m0) return 0.0;
+
+    *base_tsc = start;
+    *base_us = m0;
+    return (m1 - m0) / (double)(end - start);
+}
+#endif
+
+static double measure_read_ns(void)
+{
+    double sink = 0.0;
+    double start = timing_monotonic_us();
+    for (int i = 0; i < TIMING_COST_SAMPLES; i++) sink += timing_now_us();
+    double end = timing_monotonic_us();
+    (void)sink;
+    return (end - start) * 1000.0 / TIMING_COST_SAMPLES;
+}
+
+timer_source_t timing_init(timer_source_t source)
+{
+    timing_clock_t clk = {.source = TIMER_MONOTONIC};
+
+#if TIMING_HAVE_TSC
+    if (source == TIMER_TSC && has_invariant_tsc())
+    {
+        clk.us_per_tick = calibrate_tsc(&clk.base_tsc, &clk.base_us);
+        if (clk.us_per_tick > 0.0) clk.source = TIMER_TSC;
+    }
+#else
+    (void)source;
+#endif
+
+    timing_clock = clk;
+    timing_clock.read_ns = measure_read_ns();
+    return timing_clock.source;
+}
+
+const char *timing_source_name(timer_source_t source)
+{
+    return source == TIMER_TSC ? "tsc" : "monotonic";
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __TIMING_H__
+#define __TIMING_H__
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIMING_HAVE_TSC 1
+#else
+#define TIMING_HAVE_TSC 0
+#endif
+
+#include "benchmark.h"
+
+/*
+ * op timestamps. the default source is CLOCK_MONOTONIC, a vDSO call with nanosecond resolution
+ * that never steps with the wall clock. TIMER_TSC reads the time stamp counter instead and
+ * converts it with a rate calibrated against CLOCK_MONOTONIC, which roughly halves the cost of a
+ * read. it is only used on cpus that advertise an invariant tsc, so the rate holds across cores,
+ * frequency changes and idle states.
+ *
+ * the clock is process wide, zero-initialised it is CLOCK_MONOTONIC, so code that runs before
+ * timing_init() still gets valid stamps.
+ */
+#define TIMING_CALIBRATE_MS  20   /* tsc calibration window */
+#define TIMING_COST_SAMPLES  4096 /* clock reads timed for the per-read cost */
+
+typedef struct
+{
+    timer_source_t source;
+    uint64_t base_tsc;  /* tsc at calibration */
+    double base_us;     /* CLOCK_MONOTONIC at calibration */
+    double us_per_tick; /* calibrated tsc rate */
+    double read_ns;     /* measured cost of one timing_now_us() */
+} timing_clock_t;
+
+extern timing_clock_t timing_clock;
+
+/**
+ * timing_monotonic_us
+ * @return CLOCK_MONOTONIC in microseconds, with the nanoseconds as the fraction
+ */
+static inline double timing_monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+/**
+ * timing_now_us
+ * reads the configured clock, the hot path of every timed op
+ * @return current time in microseconds on the CLOCK_MONOTONIC time base
+ */
+static inline double timing_now_us(void)
+{
+#if TIMING_HAVE_TSC
+    if (timing_clock.source == TIMER_TSC)
+    {
+        return timing_clock.base_us + (double)(__rdtsc() - timing_clock.base_tsc) *
+                                          timing_clock.us_per_tick;
+    }
+#endif
+    return timing_monotonic_us();
+}
+
+/**
+ * timing_init
+ * selects the clock and measures what one read costs. a tsc request falls back to
+ * CLOCK_MONOTONIC on cpus without an invariant tsc
+ * @param source the requested clock
+ * @return the clock in use
+ */
+timer_source_t timing_init(timer_source_t source);
+
+/**
+ * timing_source_name
+ * @param source a clock
+ * @return its command line name
+ */
+const char *timing_source_name(timer_source_t source);
+
+#endif /* __TIMING_H__ */
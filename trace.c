@@ -0,0 +1,773 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "trace.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TRACE_RECORD_HEADER 8   /* op, pad, key_size, value_size */
+#define TRACE_SEEK_KEYS     1   /* keys a converted RocksDB iterator seek reads */
+#define TRACE_TEXT_VALUE    100 /* text format default PUT value size and SEEK length */
+
+/* RocksDB trace record types and query payload fields (rocksdb/trace_record.h) */
+#define ROCKS_TRACE_BEGIN         1
+#define ROCKS_TRACE_END           2
+#define ROCKS_TRACE_WRITE         3
+#define ROCKS_TRACE_GET           4
+#define ROCKS_TRACE_SEEK          5
+#define ROCKS_TRACE_SEEK_FOR_PREV 6
+#define ROCKS_TRACE_MULTIGET      13
+#define ROCKS_TRACE_RECORD_HEADER 13 /* fixed64 ts, type, fixed32 payload length */
+#define ROCKS_WRITE_BATCH_HEADER  12 /* fixed64 sequence, fixed32 count */
+
+enum
+{
+    ROCKS_FIELD_WRITE_BATCH = 1,
+    ROCKS_FIELD_GET_CF = 2,
+    ROCKS_FIELD_GET_KEY = 3,
+    ROCKS_FIELD_ITER_CF = 4,
+    ROCKS_FIELD_ITER_KEY = 5,
+    ROCKS_FIELD_ITER_LOWER = 6,
+    ROCKS_FIELD_ITER_UPPER = 7,
+    ROCKS_FIELD_MULTIGET_SIZE = 8,
+    ROCKS_FIELD_MULTIGET_CFS = 9,
+    ROCKS_FIELD_MULTIGET_KEYS = 10
+};
+
+static const char *trace_op_names[TRACE_OP_COUNT] = {"put", "get", "delete", "seek"};
+
+const char *trace_op_name(trace_op_t op)
+{
+    if ((int)op < 0 || op >= TRACE_OP_COUNT) return "unknown";
+    return trace_op_names[op];
+}
+
+static void encode_header(uint8_t *out, uint32_t flags, uint64_t num_records,
+                          uint64_t index_offset, uint32_t max_key_size, uint32_t max_value_size)
+{
+    uint32_t version = TRACE_VERSION;
+    memset(out, 0, TRACE_HEADER_SIZE);
+    memcpy(out, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    memcpy(out + 8, &version, 4);
+    memcpy(out + 12, &flags, 4);
+    memcpy(out + 16, &num_records, 8);
+    memcpy(out + 24, &index_offset, 8);
+    memcpy(out + 32, &max_key_size, 4);
+    memcpy(out + 36, &max_value_size, 4);
+}
+
+int trace_writer_open(trace_writer_t *w, const char *path, int timestamps)
+{
+    memset(w, 0, sizeof(*w));
+    w->flags = timestamps ? TRACE_FLAG_TIMESTAMPS : 0;
+    w->fp = fopen(path, "wb");
+    if (!w->fp)
+    {
+        fprintf(stderr, "Failed to create trace %s\n", path);
+        return -1;
+    }
+
+    /* the header is rewritten with the final counts on close */
+    uint8_t header[TRACE_HEADER_SIZE];
+    encode_header(header, w->flags, 0, 0, 0, 0);
+    if (fwrite(header, 1, sizeof(header), w->fp) != sizeof(header))
+    {
+        fclose(w->fp);
+        w->fp = NULL;
+        return -1;
+    }
+    w->offset = TRACE_HEADER_SIZE;
+    return 0;
+}
+
+int trace_writer_add(trace_writer_t *w, const trace_record_t *rec)
+{
+    if ((int)rec->op < 0 || rec->op >= TRACE_OP_COUNT || rec->key_size == 0 ||
+        rec->key_size > TRACE_MAX_KEY_SIZE)
+    {
+        return -1;
+    }
+
+    if (w->num_records % TRACE_BLOCK_RECORDS == 0)
+    {
+        if (w->num_blocks == w->blocks_cap)
+        {
+            uint64_t cap = w->blocks_cap ? w->blocks_cap * 2 : 1024;
+            uint64_t *blocks = realloc(w->blocks, cap * sizeof(uint64_t));
+            if (!blocks) return -1;
+            w->blocks = blocks;
+            w->blocks_cap = cap;
+        }
+        w->blocks[w->num_blocks++] = w->offset;
+    }
+
+    uint8_t header[TRACE_RECORD_HEADER + 8];
+    uint16_t key_size = (uint16_t)rec->key_size;
+    size_t header_size = TRACE_RECORD_HEADER;
+    header[0] = (uint8_t)rec->op;
+    header[1] = 0;
+    memcpy(header + 2, &key_size, 2);
+    memcpy(header + 4, &rec->value_size, 4);
+
+    if (w->flags & TRACE_FLAG_TIMESTAMPS)
+    {
+        /* captures from several threads interleave slightly out of order, replay needs a
+         * schedule that never goes backwards */
+        if (w->num_records == 0) w->first_ts = rec->ts_us;
+        uint64_t ts = rec->ts_us > w->first_ts ? rec->ts_us - w->first_ts : 0;
+        if (ts < w->last_ts) ts = w->last_ts;
+        w->last_ts = ts;
+        memcpy(header + TRACE_RECORD_HEADER, &ts, 8);
+        header_size += 8;
+    }
+
+    if (fwrite(header, 1, header_size, w->fp) != header_size ||
+        fwrite(rec->key, 1, rec->key_size, w->fp) != rec->key_size)
+    {
+        return -1;
+    }
+
+    w->offset += header_size + rec->key_size;
+    w->num_records++;
+    if (rec->key_size > w->max_key_size) w->max_key_size = (uint32_t)rec->key_size;
+    if (rec->op == TRACE_OP_PUT && rec->value_size > w->max_value_size)
+    {
+        w->max_value_size = rec->value_size;
+    }
+    return 0;
+}
+
+int trace_writer_close(trace_writer_t *w)
+{
+    int rc = 0;
+    uint8_t header[TRACE_HEADER_SIZE];
+    encode_header(header, w->flags, w->num_records, w->offset, w->max_key_size,
+                  w->max_value_size);
+
+    if (fwrite(&w->num_blocks, sizeof(uint64_t), 1, w->fp) != 1 ||
+        fwrite(w->blocks, sizeof(uint64_t), w->num_blocks, w->fp) != w->num_blocks ||
+        fseek(w->fp, 0, SEEK_SET) != 0 ||
+        fwrite(header, 1, sizeof(header), w->fp) != sizeof(header))
+    {
+        rc = -1;
+    }
+    if (fclose(w->fp) != 0) rc = -1;
+    free(w->blocks);
+    w->fp = NULL;
+    w->blocks = NULL;
+    return rc;
+}
+
+/* decodes the record at pos, -1 when it runs past the record area */
+static int decode_record(const trace_t *trace, uint64_t pos, trace_record_t *rec, uint64_t *size)
+{
+    const uint8_t *end = trace->map + trace->index_offset;
+    const uint8_t *p = trace->map + pos;
+    size_t header_size = TRACE_RECORD_HEADER + ((trace->flags & TRACE_FLAG_TIMESTAMPS) ? 8 : 0);
+    if (pos < TRACE_HEADER_SIZE || pos > trace->index_offset || (size_t)(end - p) < header_size)
+    {
+        return -1;
+    }
+
+    uint16_t key_size;
+    memcpy(&key_size, p + 2, 2);
+    if ((size_t)(end - p) - header_size < key_size || p[0] >= TRACE_OP_COUNT) return -1;
+
+    rec->op = (trace_op_t)p[0];
+    memcpy(&rec->value_size, p + 4, 4);
+    rec->ts_us = 0;
+    if (trace->flags & TRACE_FLAG_TIMESTAMPS) memcpy(&rec->ts_us, p + TRACE_RECORD_HEADER, 8);
+    rec->key = p + header_size;
+    rec->key_size = key_size;
+    *size = header_size + key_size;
+    return 0;
+}
+
+static uint64_t block_offset(const trace_t *trace, uint64_t block)
+{
+    uint64_t offset;
+    memcpy(&offset, trace->blocks + block * sizeof(uint64_t), sizeof(uint64_t));
+    return offset;
+}
+
+int trace_read(const trace_t *trace, trace_cursor_t *cursor, uint64_t index, trace_record_t *rec)
+{
+    uint64_t size;
+
+    if (cursor->pos == 0 || cursor->next != index)
+    {
+        uint64_t block = index / TRACE_BLOCK_RECORDS;
+        cursor->pos = block_offset(trace, block);
+        for (uint64_t at = block * TRACE_BLOCK_RECORDS; at < index; at++)
+        {
+            if (decode_record(trace, cursor->pos, rec, &size) != 0) return -1;
+            cursor->pos += size;
+        }
+        cursor->next = index;
+    }
+
+    if (decode_record(trace, cursor->pos, rec, &size) != 0) return -1;
+    cursor->pos += size;
+    cursor->next++;
+
+    /* at a block boundary we ask for the next block, its pages arrive while this one runs */
+    if (cursor->next % TRACE_BLOCK_RECORDS == 0 && cursor->next < trace->num_records)
+    {
+        uint64_t block = cursor->next / TRACE_BLOCK_RECORDS;
+        uint64_t start = block_offset(trace, block);
+        uint64_t end = block + 1 < trace->num_blocks ? block_offset(trace, block + 1)
+                                                     : trace->index_offset;
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t aligned = start / page * page;
+        madvise((void *)(trace->map + aligned), end - aligned, MADV_WILLNEED);
+    }
+    return 0;
+}
+
+int trace_open(trace_t *trace, const char *path)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->fd = open(path, O_RDONLY);
+    if (trace->fd < 0)
+    {
+        fprintf(stderr, "Failed to open trace %s\n", path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(trace->fd, &st) != 0 || (size_t)st.st_size < TRACE_HEADER_SIZE + sizeof(uint64_t))
+    {
+        fprintf(stderr, "Trace %s is too short\n", path);
+        close(trace->fd);
+        return -1;
+    }
+    trace->map_size = (size_t)st.st_size;
+    void *map = mmap(NULL, trace->map_size, PROT_READ, MAP_SHARED, trace->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map trace %s\n", path);
+        close(trace->fd);
+        return -1;
+    }
+    trace->map = map;
+
+    uint32_t version;
+    memcpy(&version, trace->map + 8, 4);
+    memcpy(&trace->flags, trace->map + 12, 4);
+    memcpy(&trace->num_records, trace->map + 16, 8);
+    memcpy(&trace->index_offset, trace->map + 24, 8);
+    memcpy(&trace->max_key_size, trace->map + 32, 4);
+    memcpy(&trace->max_value_size, trace->map + 36, 4);
+
+    int valid = memcmp(trace->map, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0 &&
+                version == TRACE_VERSION && trace->num_records > 0 &&
+                trace->index_offset >= TRACE_HEADER_SIZE &&
+                trace->index_offset <= trace->map_size - sizeof(uint64_t);
+    if (valid)
+    {
+        memcpy(&trace->num_blocks, trace->map + trace->index_offset, 8);
+        trace->blocks = trace->map + trace->index_offset + sizeof(uint64_t);
+        uint64_t index_room = (trace->map_size - trace->index_offset) / sizeof(uint64_t) - 1;
+        valid = trace->num_blocks ==
+                    (trace->num_records + TRACE_BLOCK_RECORDS - 1) / TRACE_BLOCK_RECORDS &&
+                trace->num_blocks <= index_room;
+    }
+
+    /* the last record both checks the tail of the file and gives the span of the timestamps */
+    trace_cursor_t cursor = {0, 0};
+    trace_record_t last;
+    if (valid && trace_read(trace, &cursor, trace->num_records - 1, &last) != 0) valid = 0;
+    if (!valid)
+    {
+        fprintf(stderr, "%s is not a valid trace, convert it with --convert-trace\n", path);
+        trace_close(trace);
+        return -1;
+    }
+    trace->span_us = last.ts_us;
+    return 0;
+}
+
+void trace_close(trace_t *trace)
+{
+    if (trace->map) munmap((void *)trace->map, trace->map_size);
+    if (trace->fd >= 0) close(trace->fd);
+    memset(trace, 0, sizeof(*trace));
+    trace->fd = -1;
+}
+
+static int hex_digit(int c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    c = tolower(c);
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+/* a text key is taken verbatim, or decoded when it starts with 0x */
+static int parse_text_key(const char *token, uint8_t *out, size_t *out_size)
+{
+    size_t len = strlen(token);
+    if (len > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+    {
+        if ((len - 2) % 2 != 0 || (len - 2) / 2 > TRACE_MAX_KEY_SIZE) return -1;
+        for (size_t i = 2; i < len; i += 2)
+        {
+            int hi = hex_digit(token[i]), lo = hex_digit(token[i + 1]);
+            if (hi < 0 || lo < 0) return -1;
+            out[(i - 2) / 2] = (uint8_t)(hi << 4 | lo);
+        }
+        *out_size = (len - 2) / 2;
+        return 0;
+    }
+    if (len > TRACE_MAX_KEY_SIZE) return -1;
+    memcpy(out, token, len);
+    *out_size = len;
+    return 0;
+}
+
+static int parse_text_op(const char *token, trace_op_t *op)
+{
+    if (strcasecmp(token, "put") == 0 || strcasecmp(token, "set") == 0)
+        *op = TRACE_OP_PUT;
+    else if (strcasecmp(token, "get") == 0)
+        *op = TRACE_OP_GET;
+    else if (strcasecmp(token, "delete") == 0 || strcasecmp(token, "del") == 0)
+        *op = TRACE_OP_DELETE;
+    else if (strcasecmp(token, "seek") == 0 || strcasecmp(token, "scan") == 0)
+        *op = TRACE_OP_SEEK;
+    else
+        return -1;
+    return 0;
+}
+
+/* lines of "op key [value_size] [ts_us]", # starts a comment. the first record decides whether
+ * the trace is timed, after that every record has to carry a timestamp too */
+static int convert_text(FILE *in, const char *output, uint64_t *converted)
+{
+    trace_writer_t w;
+    int opened = 0, rc = 0;
+    char *line = NULL;
+    size_t line_cap = 0;
+    uint64_t line_no = 0;
+    uint8_t *key = malloc(TRACE_MAX_KEY_SIZE);
+    if (!key) return -1;
+
+    while (getline(&line, &line_cap, in) > 0)
+    {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *save = NULL;
+        char *tokens[5];
+        int n = 0;
+        for (char *t = strtok_r(line, " \t\r\n", &save); t && n < 5;
+             t = strtok_r(NULL, " \t\r\n", &save))
+        {
+            tokens[n++] = t;
+        }
+        if (n == 0) continue;
+
+        trace_record_t rec = {0};
+        char *end = NULL;
+        int bad = n < 2 || n > 4 || parse_text_op(tokens[0], &rec.op) != 0 ||
+                  parse_text_key(tokens[1], key, &rec.key_size) != 0 || rec.key_size == 0;
+        rec.key = key;
+        rec.value_size = rec.op == TRACE_OP_PUT || rec.op == TRACE_OP_SEEK ? TRACE_TEXT_VALUE : 0;
+        if (!bad && n >= 3)
+        {
+            unsigned long long v = strtoull(tokens[2], &end, 10);
+            bad = *end != '\0' || v > UINT32_MAX;
+            rec.value_size = (uint32_t)v;
+        }
+        if (!bad && n == 4)
+        {
+            rec.ts_us = strtoull(tokens[3], &end, 10);
+            bad = *end != '\0';
+        }
+
+        if (!bad && !opened)
+        {
+            if (trace_writer_open(&w, output, n == 4) != 0)
+            {
+                rc = -1;
+                break;
+            }
+            opened = 1;
+        }
+        if (!bad && (n == 4) != ((w.flags & TRACE_FLAG_TIMESTAMPS) != 0)) bad = 1;
+        if (bad || trace_writer_add(&w, &rec) != 0)
+        {
+            fprintf(stderr, "Invalid trace line %" PRIu64 "\n", line_no);
+            rc = -1;
+            break;
+        }
+    }
+
+    free(line);
+    free(key);
+    if (!opened)
+    {
+        if (rc == 0) fprintf(stderr, "The text trace holds no records\n");
+        return -1;
+    }
+    *converted = w.num_records;
+    if (trace_writer_close(&w) != 0) rc = -1;
+    return rc;
+}
+
+/* bounded reader over a RocksDB payload */
+typedef struct
+{
+    const uint8_t *p;
+    const uint8_t *end;
+} rocks_slice_t;
+
+static int rocks_fixed32(rocks_slice_t *s, uint32_t *v)
+{
+    if (s->end - s->p < 4) return -1;
+    *v = (uint32_t)s->p[0] | (uint32_t)s->p[1] << 8 | (uint32_t)s->p[2] << 16 |
+         (uint32_t)s->p[3] << 24;
+    s->p += 4;
+    return 0;
+}
+
+static uint64_t rocks_decode_fixed64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+static int rocks_varint32(rocks_slice_t *s, uint32_t *v)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift <= 28 && s->p < s->end; shift += 7)
+    {
+        uint8_t byte = *s->p++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *v = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int rocks_prefixed(rocks_slice_t *s, rocks_slice_t *out)
+{
+    uint32_t len;
+    if (rocks_varint32(s, &len) != 0 || (uint64_t)(s->end - s->p) < len) return -1;
+    out->p = s->p;
+    out->end = s->p + len;
+    s->p += len;
+    return 0;
+}
+
+typedef struct
+{
+    trace_writer_t *w;
+    uint64_t ts_us;
+    uint64_t skipped; /* ops that have no trace equivalent (merges into ranges, ...) */
+} rocks_ctx_t;
+
+static int rocks_emit(rocks_ctx_t *rc, trace_op_t op, const rocks_slice_t *key,
+                      uint32_t value_size)
+{
+    size_t key_size = (size_t)(key->end - key->p);
+    if (key_size == 0 || key_size > TRACE_MAX_KEY_SIZE)
+    {
+        rc->skipped++;
+        return 0;
+    }
+    trace_record_t rec = {op, key->p, key_size, value_size, rc->ts_us};
+    return trace_writer_add(rc->w, &rec);
+}
+
+/* walks a WriteBatch rep, PUTs for values and merges, DELETEs for point deletions. we stop at
+ * the first tag we do not know, its layout decides where the next record starts */
+static int rocks_write_batch(rocks_ctx_t *rc, rocks_slice_t batch)
+{
+    if (batch.end - batch.p < ROCKS_WRITE_BATCH_HEADER) return -1;
+    batch.p += ROCKS_WRITE_BATCH_HEADER;
+
+    while (batch.p < batch.end)
+    {
+        uint8_t tag = *batch.p++;
+        uint32_t cf;
+        rocks_slice_t key, value;
+
+        switch (tag)
+        {
+            case 0x5:  /* column family value */
+            case 0x6:  /* column family merge */
+            case 0x10: /* column family blob index */
+            case 0x17: /* column family wide column entity */
+                if (rocks_varint32(&batch, &cf) != 0) return -1;
+                /* fall through */
+            case 0x1:  /* value */
+            case 0x2:  /* merge */
+            case 0x11: /* blob index */
+            case 0x16: /* wide column entity */
+                if (rocks_prefixed(&batch, &key) != 0 || rocks_prefixed(&batch, &value) != 0)
+                    return -1;
+                if (rocks_emit(rc, TRACE_OP_PUT, &key, (uint32_t)(value.end - value.p)) != 0)
+                    return -1;
+                break;
+            case 0x4: /* column family deletion */
+            case 0x8: /* column family single deletion */
+                if (rocks_varint32(&batch, &cf) != 0) return -1;
+                /* fall through */
+            case 0x0: /* deletion */
+            case 0x7: /* single deletion */
+                if (rocks_prefixed(&batch, &key) != 0) return -1;
+                if (rocks_emit(rc, TRACE_OP_DELETE, &key, 0) != 0) return -1;
+                break;
+            case 0xE: /* column family range deletion */
+                if (rocks_varint32(&batch, &cf) != 0) return -1;
+                /* fall through */
+            case 0xF: /* range deletion, no point op stands for it */
+                if (rocks_prefixed(&batch, &key) != 0 || rocks_prefixed(&batch, &value) != 0)
+                    return -1;
+                rc->skipped++;
+                break;
+            case 0x3: /* log data */
+            case 0xA: /* end prepare xid */
+            case 0xB: /* commit xid */
+            case 0xC: /* rollback xid */
+                if (rocks_prefixed(&batch, &key) != 0) return -1;
+                break;
+            case 0x15: /* commit xid and timestamp */
+                if (rocks_prefixed(&batch, &key) != 0 || rocks_prefixed(&batch, &value) != 0)
+                    return -1;
+                break;
+            case 0x9:  /* begin prepare xid */
+            case 0xD:  /* noop */
+            case 0x12: /* begin persisted prepare xid */
+            case 0x13: /* begin unprepare xid */
+                break;
+            default:
+                rc->skipped++;
+                return 0;
+        }
+    }
+    return 0;
+}
+
+/* trace format 0.2 payloads start with a bitmap of the fields present, in bit order */
+static int rocks_query(rocks_ctx_t *rc, uint8_t type, rocks_slice_t payload, int has_map)
+{
+    if (!has_map)
+    {
+        /* format 0.1, a write is the bare batch and a lookup is cf id then key */
+        uint32_t cf;
+        if (type == ROCKS_TRACE_WRITE) return rocks_write_batch(rc, payload);
+        if (type == ROCKS_TRACE_MULTIGET || rocks_fixed32(&payload, &cf) != 0)
+        {
+            rc->skipped++;
+            return 0;
+        }
+        return type == ROCKS_TRACE_GET ? rocks_emit(rc, TRACE_OP_GET, &payload, 0)
+                                       : rocks_emit(rc, TRACE_OP_SEEK, &payload, TRACE_SEEK_KEYS);
+    }
+
+    if (payload.end - payload.p < 8) return -1;
+    uint64_t map = rocks_decode_fixed64(payload.p);
+    payload.p += 8;
+    uint32_t multiget_size = 0;
+
+    for (int field = 0; field < 64 && map; field++)
+    {
+        if (!(map & (1ULL << field))) continue;
+        map &= ~(1ULL << field);
+
+        uint32_t u32;
+        rocks_slice_t s;
+        switch (field)
+        {
+            case ROCKS_FIELD_GET_CF:
+            case ROCKS_FIELD_ITER_CF:
+                if (rocks_fixed32(&payload, &u32) != 0) return -1;
+                break;
+            case ROCKS_FIELD_MULTIGET_SIZE:
+                if (rocks_fixed32(&payload, &multiget_size) != 0) return -1;
+                break;
+            case ROCKS_FIELD_WRITE_BATCH:
+                if (rocks_prefixed(&payload, &s) != 0 || rocks_write_batch(rc, s) != 0) return -1;
+                break;
+            case ROCKS_FIELD_GET_KEY:
+                if (rocks_prefixed(&payload, &s) != 0 || rocks_emit(rc, TRACE_OP_GET, &s, 0) != 0)
+                    return -1;
+                break;
+            case ROCKS_FIELD_ITER_KEY:
+                if (rocks_prefixed(&payload, &s) != 0 ||
+                    rocks_emit(rc, TRACE_OP_SEEK, &s, TRACE_SEEK_KEYS) != 0)
+                    return -1;
+                break;
+            case ROCKS_FIELD_MULTIGET_KEYS:
+            {
+                /* one length-prefixed blob holding multiget_size length-prefixed keys */
+                rocks_slice_t key;
+                if (rocks_prefixed(&payload, &s) != 0) return -1;
+                for (uint32_t k = 0; k < multiget_size; k++)
+                {
+                    if (rocks_prefixed(&s, &key) != 0 ||
+                        rocks_emit(rc, TRACE_OP_GET, &key, 0) != 0)
+                        return -1;
+                }
+                break;
+            }
+            case ROCKS_FIELD_ITER_LOWER:
+            case ROCKS_FIELD_ITER_UPPER:
+            case ROCKS_FIELD_MULTIGET_CFS:
+                if (rocks_prefixed(&payload, &s) != 0) return -1;
+                break;
+            default:
+                /* a field from a newer format, we cannot tell its size */
+                rc->skipped++;
+                return 0;
+        }
+    }
+    return 0;
+}
+
+/* a trace from DB::StartTrace, fixed64 ts, type, fixed32 length and the payload per record */
+static int convert_rocksdb(FILE *in, const char *output, uint64_t *converted, uint64_t *skipped)
+{
+    trace_writer_t w;
+    if (trace_writer_open(&w, output, 1) != 0) return -1;
+
+    rocks_ctx_t rc = {&w, 0, 0};
+    uint8_t header[ROCKS_TRACE_RECORD_HEADER];
+    uint8_t *payload = NULL;
+    size_t payload_cap = 0;
+    int has_map = 0, begun = 0, err = 0;
+
+    while (fread(header, 1, sizeof(header), in) == sizeof(header))
+    {
+        uint8_t type = header[8];
+        uint32_t len = (uint32_t)header[9] | (uint32_t)header[10] << 8 |
+                       (uint32_t)header[11] << 16 | (uint32_t)header[12] << 24;
+        if (len > payload_cap)
+        {
+            uint8_t *grown = realloc(payload, len);
+            if (!grown)
+            {
+                err = 1;
+                break;
+            }
+            payload = grown;
+            payload_cap = len;
+        }
+        if (fread(payload, 1, len, in) != len)
+        {
+            fprintf(stderr, "The RocksDB trace ends inside a record\n");
+            err = 1;
+            break;
+        }
+
+        rocks_slice_t s = {payload, payload + len};
+        rc.ts_us = rocks_decode_fixed64(header);
+
+        if (type == ROCKS_TRACE_BEGIN)
+        {
+            /* the header names the trace format, 0.2 and later carry the payload bitmap */
+            char text[256];
+            size_t n = len < sizeof(text) - 1 ? len : sizeof(text) - 1;
+            memcpy(text, payload, n);
+            text[n] = '\0';
+            const char *version = strstr(text, "Trace Version: ");
+            unsigned major = 0, minor = 0;
+            if (version) sscanf(version + 15, "%u.%u", &major, &minor);
+            has_map = major > 0 || minor >= 2;
+            begun = 1;
+            continue;
+        }
+        if (!begun)
+        {
+            fprintf(stderr, "Not a RocksDB trace, the header record is missing\n");
+            err = 1;
+            break;
+        }
+        if (type == ROCKS_TRACE_END) break;
+        if (type != ROCKS_TRACE_WRITE && type != ROCKS_TRACE_GET && type != ROCKS_TRACE_SEEK &&
+            type != ROCKS_TRACE_SEEK_FOR_PREV && type != ROCKS_TRACE_MULTIGET)
+        {
+            rc.skipped++;
+            continue;
+        }
+        if (rocks_query(&rc, type, s, has_map) != 0)
+        {
+            fprintf(stderr, "Malformed RocksDB trace record at ts %" PRIu64 "\n", rc.ts_us);
+            err = 1;
+            break;
+        }
+    }
+
+    free(payload);
+    *converted = w.num_records;
+    *skipped = rc.skipped;
+    if (trace_writer_close(&w) != 0) err = 1;
+    if (!err && w.num_records == 0)
+    {
+        fprintf(stderr, "The RocksDB trace holds no replayable records\n");
+        err = 1;
+    }
+    return err ? -1 : 0;
+}
+
+int trace_convert(const char *input, const char *format, const char *output)
+{
+    FILE *in = fopen(input, "rb");
+    if (!in)
+    {
+        fprintf(stderr, "Failed to open %s\n", input);
+        return -1;
+    }
+
+    uint64_t converted = 0, skipped = 0;
+    int rc;
+    if (strcmp(format, "rocksdb") == 0)
+    {
+        rc = convert_rocksdb(in, output, &converted, &skipped);
+    }
+    else
+    {
+        rc = convert_text(in, output, &converted);
+    }
+    fclose(in);
+
+    if (rc != 0)
+    {
+        unlink(output);
+        return -1;
+    }
+    printf("Converted %" PRIu64 " records from %s to %s", converted, input, output);
+    if (skipped > 0) printf(" (%" PRIu64 " ops without an equivalent skipped)", skipped);
+    printf("\n");
+    return 0;
+}
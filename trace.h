@@ -0,0 +1,172 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * op traces for -w replay. a trace file is a header, the records back to back and a block
+ * index, all in host byte order:
+ *
+ *   header  "BTTRACE\0", u32 version, u32 flags, u64 num_records, u64 index_offset,
+ *           u32 max_key_size, u32 max_value_size
+ *   record  u8 op, u8 pad, u16 key_size, u32 value_size, [u64 ts_us], key bytes
+ *   index   u64 num_blocks, u64 offset of every TRACE_BLOCK_RECORDS-th record
+ *
+ * ts_us is present when the header has TRACE_FLAG_TIMESTAMPS and counts from the first record.
+ * value_size is the value length of a PUT and the keys to scan of a SEEK. replay maps the file
+ * and workers claim whole blocks, the index turns a claimed block into a file offset so no
+ * thread ever reads another's records and the page cache does the I/O.
+ */
+#define TRACE_MAGIC           "BTTRACE"
+#define TRACE_VERSION         1
+#define TRACE_FLAG_TIMESTAMPS 0x1
+#define TRACE_BLOCK_RECORDS   1024 /* records per index entry, one worker chunk */
+#define TRACE_HEADER_SIZE     40
+#define TRACE_MAX_KEY_SIZE    UINT16_MAX
+
+typedef enum
+{
+    TRACE_OP_PUT,
+    TRACE_OP_GET,
+    TRACE_OP_DELETE,
+    TRACE_OP_SEEK, /* seek to the key and read value_size keys */
+    TRACE_OP_COUNT
+} trace_op_t;
+
+/* one decoded record, key points into the mapping (or the caller's buffer for the writer) */
+typedef struct
+{
+    trace_op_t op;
+    const uint8_t *key;
+    size_t key_size;
+    uint32_t value_size;
+    uint64_t ts_us;
+} trace_record_t;
+
+typedef struct trace_t
+{
+    int fd;
+    const uint8_t *map;
+    size_t map_size;
+    uint32_t flags;
+    uint64_t num_records;
+    uint64_t index_offset; /* end of the records */
+    uint64_t num_blocks;
+    const uint8_t *blocks; /* num_blocks u64 record offsets, read with memcpy */
+    uint32_t max_key_size;
+    uint32_t max_value_size;
+    uint64_t span_us; /* timestamp of the last record */
+} trace_t;
+
+/* a worker's read position, pos is the file offset of record next */
+typedef struct
+{
+    uint64_t pos;
+    uint64_t next;
+} trace_cursor_t;
+
+typedef struct
+{
+    FILE *fp;
+    uint32_t flags;
+    uint64_t num_records;
+    uint64_t offset; /* file offset of the next record */
+    uint64_t *blocks;
+    uint64_t num_blocks;
+    uint64_t blocks_cap;
+    uint32_t max_key_size;
+    uint32_t max_value_size;
+    uint64_t first_ts;
+    uint64_t last_ts;
+} trace_writer_t;
+
+/**
+ * trace_writer_open
+ * creates a trace file, records are appended with trace_writer_add
+ * @param w the writer
+ * @param path output file
+ * @param timestamps 1 to store a timestamp per record
+ * @return 0 on success, -1 on failure
+ */
+int trace_writer_open(trace_writer_t *w, const char *path, int timestamps);
+
+/**
+ * trace_writer_add
+ * appends a record, timestamps are rebased onto the first record and never go backwards
+ * @param w the writer
+ * @param rec the record
+ * @return 0 on success, -1 on a write error or an invalid record
+ */
+int trace_writer_add(trace_writer_t *w, const trace_record_t *rec);
+
+/**
+ * trace_writer_close
+ * writes the block index, completes the header and closes the file
+ * @param w the writer
+ * @return 0 on success, -1 on a write error
+ */
+int trace_writer_close(trace_writer_t *w);
+
+/**
+ * trace_open
+ * maps a trace file and validates its header and index
+ * @param trace the trace
+ * @param path trace file
+ * @return 0 on success, -1 on failure
+ */
+int trace_open(trace_t *trace, const char *path);
+
+/**
+ * trace_close
+ * unmaps the trace
+ * @param trace the trace
+ */
+void trace_close(trace_t *trace);
+
+/**
+ * trace_read
+ * decodes record index. reading the record after the last one costs a header decode, any
+ * other index goes through the block index and skips the records in front of it in its block
+ * @param trace the trace
+ * @param cursor the caller's position, zero-initialised before the first read
+ * @param index record to read, below num_records
+ * @param rec the decoded record
+ * @return 0 on success, -1 on a truncated record
+ */
+int trace_read(const trace_t *trace, trace_cursor_t *cursor, uint64_t index, trace_record_t *rec);
+
+/**
+ * trace_convert
+ * converts a text or RocksDB trace into a benchtool trace
+ * @param input source trace
+ * @param format "text" or "rocksdb"
+ * @param output trace file to write
+ * @return 0 on success, -1 on failure
+ */
+int trace_convert(const char *input, const char *format, const char *output);
+
+/**
+ * trace_op_name
+ * @param op a trace op
+ * @return its text format name
+ */
+const char *trace_op_name(trace_op_t op);
+
+#endif /* __TRACE_H__ */
@@ -0,0 +1,194 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "valuegen.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VALUEGEN_SEED_OFFSET 0x5851F42D4C957F2DULL /* decorrelates the offset and size hashes */
+#define VALUEGEN_TWO_PI      6.283185307179586
+
+static inline uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* uniform in (0, 1), never 0 so the pareto and normal transforms stay finite */
+static inline double unit_open(uint64_t h)
+{
+    return ((double)(h >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+void value_pool_bounds(const benchmark_config_t *config, size_t *min_size, size_t *max_size)
+{
+    size_t v = config->value_size > 0 ? (size_t)config->value_size : 1;
+    size_t lo = 1, hi = v;
+
+    switch (config->value_dist)
+    {
+        case VALUE_DIST_UNIFORM:
+            hi = 2 * v - 1; /* mean v */
+            break;
+        case VALUE_DIST_NORMAL:
+            hi = 2 * v;
+            break;
+        case VALUE_DIST_PARETO:
+            lo = v / 2 > 0 ? v / 2 : 1; /* shape 2 for a mean of v */
+            hi = 64 * v;
+            break;
+        default:
+            lo = v;
+            break;
+    }
+    if (config->value_dist != VALUE_DIST_FIXED)
+    {
+        if (config->value_size_min > 0) lo = (size_t)config->value_size_min;
+        if (config->value_size_max > 0) hi = (size_t)config->value_size_max;
+    }
+    *min_size = lo;
+    *max_size = hi > lo ? hi : lo;
+}
+
+static void fill_pool(uint8_t *data, size_t size, double ratio)
+{
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    size_t random_len = (size_t)ceil(ratio * VALUEGEN_FRAGMENT);
+    if (random_len < 1) random_len = 1;
+    if (random_len > VALUEGEN_FRAGMENT) random_len = VALUEGEN_FRAGMENT;
+
+    for (size_t off = 0; off < size; off += VALUEGEN_FRAGMENT)
+    {
+        size_t frag = size - off < VALUEGEN_FRAGMENT ? size - off : VALUEGEN_FRAGMENT;
+        uint8_t *p = data + off;
+
+        /* the random prefix of the fragment, then copies of it up to the fragment size */
+        for (size_t i = 0; i < random_len && i < frag; i += 8)
+        {
+            state = splitmix64(state);
+            size_t n = frag - i < 8 ? frag - i : 8;
+            if (n > random_len - i) n = random_len - i;
+            memcpy(p + i, &state, n);
+        }
+        for (size_t i = random_len; i < frag; i++) p[i] = p[i % random_len];
+    }
+}
+
+int value_pool_init(value_pool_t *pool, const benchmark_config_t *config)
+{
+    memset(pool, 0, sizeof(*pool));
+    pool->dist = config->value_dist;
+    pool->target_mean = config->value_size > 0 ? config->value_size : 1;
+    value_pool_bounds(config, &pool->min_size, &pool->max_size);
+
+    pool->stddev = config->value_size_stddev > 0 ? config->value_size_stddev
+                                                 : pool->target_mean / 4.0;
+    /* mean of a pareto is shape * scale / (shape - 1), we solve for the configured mean */
+    double scale = (double)pool->min_size;
+    pool->shape = pool->target_mean > scale ? pool->target_mean / (pool->target_mean - scale)
+                                            : 64.0;
+
+    /* a --cf-profile value size replaces the drawn one, its values are sliced from here too */
+    pool->span = pool->max_size;
+    for (int i = 0; i < config->num_column_families && i < BENCHMARK_MAX_COLUMN_FAMILIES; i++)
+    {
+        if ((size_t)config->cf_value_sizes[i] > pool->span)
+        {
+            pool->span = (size_t)config->cf_value_sizes[i];
+        }
+    }
+
+    double ratio = config->compression_ratio > 0.0 ? config->compression_ratio : 1.0;
+    pool->size = VALUEGEN_WINDOW + pool->span;
+    pool->data = malloc(pool->size);
+    if (!pool->data) return -1;
+    fill_pool(pool->data, pool->size, ratio);
+
+    double total = 0.0;
+    for (int64_t i = 0; i < VALUEGEN_MEAN_SAMPLES; i++) total += (double)value_pool_size(pool, i);
+    pool->mean_size = total / VALUEGEN_MEAN_SAMPLES;
+    return 0;
+}
+
+void value_pool_free(value_pool_t *pool)
+{
+    free(pool->data);
+    memset(pool, 0, sizeof(*pool));
+}
+
+size_t value_pool_size(const value_pool_t *pool, int64_t index)
+{
+    if (pool->dist == VALUE_DIST_FIXED || pool->min_size == pool->max_size) return pool->min_size;
+
+    uint64_t h = splitmix64((uint64_t)index ^ VALUEGEN_SEED_OFFSET);
+    double u = unit_open(h);
+    double x;
+
+    switch (pool->dist)
+    {
+        case VALUE_DIST_UNIFORM:
+            x = pool->min_size + u * (double)(pool->max_size - pool->min_size + 1);
+            break;
+        case VALUE_DIST_NORMAL:
+        {
+            /* box-muller on two independent hashes of the index */
+            double u2 = unit_open(splitmix64(h));
+            double z = sqrt(-2.0 * log(u)) * cos(VALUEGEN_TWO_PI * u2);
+            x = pool->target_mean + pool->stddev * z;
+            break;
+        }
+        case VALUE_DIST_PARETO:
+            x = (double)pool->min_size / pow(u, 1.0 / pool->shape);
+            break;
+        default:
+            x = pool->target_mean;
+            break;
+    }
+
+    if (x < (double)pool->min_size) return pool->min_size;
+    if (x > (double)pool->max_size) return pool->max_size;
+    return (size_t)x;
+}
+
+const uint8_t *value_pool_slice(const value_pool_t *pool, int64_t index)
+{
+    uint64_t offset = splitmix64((uint64_t)index) % VALUEGEN_WINDOW;
+    return pool->data + offset;
+}
+
+const uint8_t *value_pool_get(const value_pool_t *pool, int64_t index, size_t *size)
+{
+    *size = value_pool_size(pool, index);
+    return value_pool_slice(pool, index);
+}
+
+const char *value_dist_name(value_dist_t dist)
+{
+    switch (dist)
+    {
+        case VALUE_DIST_UNIFORM:
+            return "uniform";
+        case VALUE_DIST_NORMAL:
+            return "normal";
+        case VALUE_DIST_PARETO:
+            return "pareto";
+        default:
+            return "fixed";
+    }
+}
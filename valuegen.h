@@ -0,0 +1,112 @@
+/**
+ * Copyright 2024 Alex Gaetano Padula (TidesDB)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __VALUEGEN_H__
+#define __VALUEGEN_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "benchmark.h"
+
+/*
+ * shared value pool. one read-only buffer is filled once per run and every value is a slice of
+ * it, so an op costs a hash instead of a byte loop and engines get a pointer that needs no copy.
+ * the pool is built from VALUEGEN_FRAGMENT byte fragments whose first compression_ratio share is
+ * random and whose rest repeats that random prefix (the db_bench --compression_ratio scheme), so a
+ * block compressor shrinks values to about compression_ratio of their size.
+ *
+ * the slice offset and the value size are both pure functions of the key index, so every thread
+ * and every rerun produces the same bytes for the same key.
+ */
+#define VALUEGEN_FRAGMENT     128
+#define VALUEGEN_WINDOW       (1 << 20) /* slices start anywhere in the first 1 MiB */
+#define VALUEGEN_MEAN_SAMPLES 65536     /* indexes sampled for the mean value size */
+
+typedef struct value_pool_t
+{
+    uint8_t *data;
+    size_t size; /* VALUEGEN_WINDOW + span */
+    value_dist_t dist;
+    size_t min_size;
+    size_t max_size;
+    size_t span;        /* readable bytes behind a slice, max_size or a larger family value */
+    double target_mean; /* value_size */
+    double stddev;      /* normal */
+    double shape;       /* pareto */
+    double mean_size;   /* measured over VALUEGEN_MEAN_SAMPLES indexes */
+} value_pool_t;
+
+/**
+ * value_pool_bounds
+ * resolves the size range of the configured distribution, filling in the defaults
+ * @param config value size, distribution and the optional min/max
+ * @param min_size smallest value
+ * @param max_size largest value
+ */
+void value_pool_bounds(const benchmark_config_t *config, size_t *min_size, size_t *max_size);
+
+/**
+ * value_pool_init
+ * allocates and fills the pool for the configured sizes and compression ratio
+ * @param pool the pool
+ * @param config value size, distribution and compression ratio
+ * @return 0 on success, -1 on allocation failure
+ */
+int value_pool_init(value_pool_t *pool, const benchmark_config_t *config);
+
+/**
+ * value_pool_free
+ * releases the pool
+ * @param pool the pool
+ */
+void value_pool_free(value_pool_t *pool);
+
+/**
+ * value_pool_size
+ * size of the value stored under a key index
+ * @param pool the pool
+ * @param index the key index
+ * @return size in bytes, within [min_size, max_size]
+ */
+size_t value_pool_size(const value_pool_t *pool, int64_t index);
+
+/**
+ * value_pool_slice
+ * the bytes of the value stored under a key index, for callers that bring their own size
+ * @param pool the pool
+ * @param index the key index
+ * @return span readable bytes, valid until value_pool_free
+ */
+const uint8_t *value_pool_slice(const value_pool_t *pool, int64_t index);
+
+/**
+ * value_pool_get
+ * the value stored under a key index, a slice of the pool valid until value_pool_free
+ * @param pool the pool
+ * @param index the key index
+ * @param size set to the value size
+ * @return the value bytes
+ */
+const uint8_t *value_pool_get(const value_pool_t *pool, int64_t index, size_t *size);
+
+/**
+ * value_dist_name
+ * @param dist a value size distribution
+ * @return its command line name
+ */
+const char *value_dist_name(value_dist_t dist);
+
+#endif /* __VALUEGEN_H__ */